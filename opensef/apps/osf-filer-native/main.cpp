@@ -76,6 +76,11 @@ public:
     // Subscribe to activation requests
     subscribeToEvents(desktop);
 
+    // Pathfinder results come back on the Qt event loop
+    Pathfinder::shared().setExecutor([this](std::function<void()> task) {
+      QMetaObject::invokeMethod(this, std::move(task), Qt::QueuedConnection);
+    });
+
     registerTypes();
     applicationDidFinishLaunching();
 
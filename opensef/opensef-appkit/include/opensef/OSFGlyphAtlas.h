@@ -0,0 +1,131 @@
+/**
+ * OSFGlyphAtlas.h - Dynamic Glyph Atlas
+ *
+ * CPU side of the glyph texture atlas used by VulkanTextRenderer. Glyphs
+ * are keyed by (font, pixel size, glyph id) and packed on demand into
+ * fixed-size 8-bit pages with a skyline packer, so any script HarfBuzz
+ * shapes can be drawn, not just a pre-rasterized ASCII range.
+ *
+ * When every page is full, the least recently used page is cleared and
+ * reused. Glyphs looked up since the last beginFrame() are pinned: the
+ * command buffer being recorded may already sample them, so their pages
+ * are never evicted mid-frame.
+ *
+ * New glyphs are only written to the CPU pages; takeDirtyRegions() hands
+ * the changed rectangles to the renderer so it can upload them all in one
+ * submission. Not thread-safe; the renderer owns it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace opensef {
+
+struct OSFGlyphKey {
+  uint32_t font;  // Renderer-assigned font id
+  uint32_t size;  // Pixel size
+  uint32_t glyph; // Glyph index in the font (not a code point)
+  bool operator==(const OSFGlyphKey &other) const {
+    return font == other.font && size == other.size && glyph == other.glyph;
+  }
+};
+
+struct OSFGlyphEntry {
+  static constexpr uint32_t kNoPage = UINT32_MAX; // Blank glyph, e.g. space
+
+  uint32_t page = kNoPage;
+  int x = 0, y = 0;          // Bitmap origin in the page
+  int width = 0, height = 0; // Bitmap size
+  int bearingX = 0;          // Pen to left edge of the bitmap
+  int bearingY = 0;          // Baseline to top edge of the bitmap
+  float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+};
+
+class OSFGlyphAtlas {
+public:
+  static constexpr int kDefaultPageSize = 1024;
+  static constexpr size_t kDefaultMaxPages = 4;
+  static constexpr int kPadding = 1; // Blank border around every glyph
+
+  struct DirtyRegion {
+    uint32_t page;
+    int x, y, width, height;
+  };
+
+  explicit OSFGlyphAtlas(int pageSize = kDefaultPageSize,
+                         size_t maxPages = kDefaultMaxPages);
+
+  // Start a frame: unpins glyphs used by the previous one
+  void beginFrame();
+
+  // Cached glyph, pinned for this frame; null if not in the atlas.
+  // Entries stay valid until the next beginFrame() or clear().
+  const OSFGlyphEntry *find(const OSFGlyphKey &key);
+
+  // Pack an 8-bit coverage bitmap (`pitch` bytes per row) and pin it.
+  // Null if it is larger than a page or every page is pinned and full.
+  const OSFGlyphEntry *insert(const OSFGlyphKey &key, int width, int height,
+                              const uint8_t *pixels, int pitch, int bearingX,
+                              int bearingY);
+
+  // Rectangles written since the last call, for upload to the GPU
+  std::vector<DirtyRegion> takeDirtyRegions();
+
+  // Page storage
+  int pageSize() const { return pageSize_; }
+  size_t maxPages() const { return maxPages_; }
+  size_t pageCount() const { return pages_.size(); }
+  const uint8_t *pagePixels(uint32_t page) const;
+
+  // Drop every glyph and page
+  void clear();
+
+  // Statistics
+  size_t glyphCount() const { return entries_.size(); }
+  uint64_t evictions() const { return evictions_; }
+  double occupancy() const; // Packed area / page area, over all pages
+
+private:
+  struct KeyHash {
+    size_t operator()(const OSFGlyphKey &key) const {
+      return (static_cast<size_t>(key.font) * 73856093u) ^
+             (static_cast<size_t>(key.size) * 19349663u) ^
+             (static_cast<size_t>(key.glyph) * 2654435761u);
+    }
+  };
+
+  // Top edge of the packed area over [x, x + width)
+  struct SkylineNode {
+    int x, y, width;
+  };
+
+  struct Page {
+    std::vector<uint8_t> pixels;
+    std::vector<SkylineNode> skyline;
+    std::vector<OSFGlyphKey> keys;
+    std::vector<DirtyRegion> dirty;
+    bool fullyDirty = true; // New pages upload whole, clearing the GPU image
+    uint64_t lastUse = 0;
+    uint64_t lastFrame = 0;
+    int64_t usedArea = 0;
+  };
+
+  void touch(Page &page);
+  void resetPage(Page &page);
+  bool pack(Page &page, int width, int height, int &x, int &y);
+  void addPage();
+
+  int pageSize_;
+  size_t maxPages_;
+  std::vector<Page> pages_;
+  std::unordered_map<OSFGlyphKey, OSFGlyphEntry, KeyHash> entries_;
+  uint64_t frame_ = 1;
+  uint64_t useCounter_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+} // namespace opensef
@@ -0,0 +1,147 @@
+/**
+ * OSFTextLayoutCache.h - Shaped Text Layout Cache
+ *
+ * Keeps shaped PangoLayouts keyed by text and style (family, size,
+ * weight, wrap width, alignment), so widgets that redraw the same string
+ * every frame look it up instead of creating a layout, a font description
+ * and shaping again. Layouts are shaped when first requested and evicted
+ * least-recently-used.
+ *
+ * Call invalidate() after the theme's fonts or the installed fonts change;
+ * it drops every layout and the font map they were shaped with. Views
+ * recorded in display lists keep their old drawing until they are sent
+ * setNeedsDisplay().
+ *
+ * Safe to use from several rendering threads. A Pango font map is not
+ * thread-safe, so shaping and drawing layouts of one font map take turns;
+ * only the text itself is serialized, not the rest of a tile.
+ */
+
+#pragma once
+
+#include <cairo/cairo.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <opensef/OpenSEFAppKit.h>
+#include <string>
+#include <unordered_map>
+
+typedef struct _PangoContext PangoContext;
+typedef struct _PangoFontMap PangoFontMap;
+
+namespace opensef {
+
+struct OSFTextStyle {
+  std::string family = "Inter"; // AresTheme::FontFamily
+  double size = 13.0;           // Points
+  FontWeight weight = FontWeight::Normal;
+  double width = 0.0; // Wrap width in pixels; 0 for a single line
+  TextAlignment alignment = TextAlignment::Left;
+};
+
+// One shaped layout; shared by every widget showing the same text
+class OSFTextLayout {
+public:
+  ~OSFTextLayout();
+
+  OSFTextLayout(const OSFTextLayout &) = delete;
+  OSFTextLayout &operator=(const OSFTextLayout &) = delete;
+
+  // Logical size in pixels
+  int width() const { return width_; }
+  int height() const { return height_; }
+
+  // Draw with the current cairo source, top-left corner at (x, y)
+  void show(cairo_t *cr, double x, double y) const;
+
+private:
+  friend class OSFTextLayoutCache;
+  OSFTextLayout() = default;
+
+  PangoLayout *layout_ = nullptr;
+  int width_ = 0;
+  int height_ = 0;
+
+  // Held while drawing: layouts share their font map, which (like the
+  // layout itself) is not thread-safe
+  std::shared_ptr<std::mutex> fontLock_;
+};
+
+using OSFTextLayoutPtr = std::shared_ptr<const OSFTextLayout>;
+
+class OSFTextLayoutCache {
+public:
+  static OSFTextLayoutCache &shared();
+
+  OSFTextLayoutCache() = default;
+  ~OSFTextLayoutCache();
+
+  OSFTextLayoutCache(const OSFTextLayoutCache &) = delete;
+  OSFTextLayoutCache &operator=(const OSFTextLayoutCache &) = delete;
+
+  // Shaped layout of `text` in `style`; null if Pango fails
+  OSFTextLayoutPtr layout(const std::string &text, const OSFTextStyle &style);
+
+  // Fonts changed: drop every layout and reload the font map
+  void invalidate();
+
+  // Cache control
+  size_t size() const;
+  size_t capacity() const { return capacity_; }
+  void setCapacity(size_t capacity);
+  void clear();
+
+  // Statistics
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+private:
+  // Size and width in Pango units
+  struct Key {
+    std::string text;
+    std::string family;
+    int size;
+    int weight;
+    int width;
+    int alignment;
+    bool operator==(const Key &other) const {
+      return size == other.size && weight == other.weight &&
+             width == other.width && alignment == other.alignment &&
+             text == other.text && family == other.family;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      size_t h = std::hash<std::string>()(key.text);
+      h ^= std::hash<std::string>()(key.family) + 0x9e3779b9 + (h << 6) +
+           (h >> 2);
+      h ^= static_cast<size_t>(key.size) * 73856093u;
+      h ^= static_cast<size_t>(key.weight) * 19349663u;
+      h ^= static_cast<size_t>(key.width) * 2654435761u;
+      return h ^ (static_cast<size_t>(key.alignment) * 40503u);
+    }
+  };
+
+  using LruList = std::list<std::pair<Key, OSFTextLayoutPtr>>;
+
+  OSFTextLayoutPtr shape(const Key &key);
+
+  mutable std::mutex mutex_;
+  LruList lru_; // Most recently used first
+  std::unordered_map<Key, LruList::iterator, KeyHash> entries_;
+  size_t capacity_ = 512;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+  // Guards the font map and context while shaping or drawing
+  std::shared_ptr<std::mutex> fontLock_;
+  std::mutex fontMapMutex_; // Guards swapping them in invalidate()
+  PangoFontMap *fontMap_ = nullptr;
+  PangoContext *context_ = nullptr;
+};
+
+} // namespace opensef
@@ -14,6 +14,7 @@
 #include <memory>
 #include <opensef/OSFGeometry.h>
 #include <opensef/OSFResponder.h>
+#include <opensef/OSFShadowCache.h>
 #include <opensef/OSFView.h>
 #include <string>
 #include <vector>
@@ -62,7 +63,10 @@ public:
 
   // Properties
   const std::string &label() const { return label_; }
-  void setLabel(const std::string &label) { label_ = label; }
+  void setLabel(const std::string &label) {
+    label_ = label;
+    setNeedsDisplay();
+  }
   void setAction(std::function<void()> action) { action_ = action; }
 
   // State
@@ -81,6 +85,9 @@ public:
   bool mouseUp(OSFEvent &event) override;
   bool acceptsFirstResponder() const override { return true; }
 
+  // Layout: label size plus padding, measured through OSFTextLayoutCache
+  OSFRect intrinsicContentSize() const override;
+
   // Rendering
   void render(cairo_t *cr) override;
 
@@ -107,10 +114,16 @@ public:
 
   // Properties
   const std::string &text() const { return text_; }
-  void setText(const std::string &text) { text_ = text; }
+  void setText(const std::string &text) {
+    text_ = text;
+    setNeedsDisplay();
+  }
 
   OSFColor textColor() const { return textColor_; }
-  void setTextColor(const OSFColor &color) { textColor_ = color; }
+  void setTextColor(const OSFColor &color) {
+    textColor_ = color;
+    setNeedsDisplay();
+  }
 
   double fontSize() const { return fontSize_; }
   void setFontSize(double size);
@@ -121,6 +134,9 @@ public:
   TextAlignment alignment() const { return alignment_; }
   void setAlignment(TextAlignment alignment);
 
+  // Layout: unwrapped text size, measured through OSFTextLayoutCache
+  OSFRect intrinsicContentSize() const override;
+
   // Rendering
   void render(cairo_t *cr) override;
   void draw() override;
@@ -148,10 +164,14 @@ public:
 
   // Properties
   const std::string &text() const { return text_; }
-  void setText(const std::string &text) { text_ = text; }
+  void setText(const std::string &text) {
+    text_ = text;
+    setNeedsDisplay();
+  }
   const std::string &placeholder() const { return placeholder_; }
   void setPlaceholder(const std::string &placeholder) {
     placeholder_ = placeholder;
+    setNeedsDisplay();
   }
   void setSecure(bool secure);
 
@@ -168,6 +188,10 @@ public:
   void becomeFirstResponder() override;
   void resignFirstResponder() override;
 
+  // Layout: placeholder size plus padding, measured through
+  // OSFTextLayoutCache
+  OSFRect intrinsicContentSize() const override;
+
   // Rendering
   void render(cairo_t *cr) override;
 
@@ -194,18 +218,27 @@ public:
 
   // Properties
   double blurRadius() const { return blurRadius_; }
-  void setBlurRadius(double radius) { blurRadius_ = radius; }
+  void setBlurRadius(double radius) {
+    blurRadius_ = radius;
+    setNeedsDisplay();
+  }
 
   OSFColor tintColor() const { return tintColor_; }
-  void setTintColor(const OSFColor &color) { tintColor_ = color; }
+  void setTintColor(const OSFColor &color) {
+    tintColor_ = color;
+    setNeedsDisplay();
+  }
 
   void setShadowEnabled(bool enabled);
 
   // Rendering
   void render(cairo_t *cr) override;
   void draw() override;
+  OSFRect paintBounds() const override;
 
 private:
+  OSFShadowStyle shadowStyle() const;
+
   double blurRadius_ = 20.0;
   double tintAlpha_ = 0.85;
   OSFColor tintColor_{0.1, 0.1, 0.1, 0.85};
@@ -2,34 +2,39 @@
  * VulkanTextRenderer.h - Vulkan Text Rendering Engine
  *
  * Implements high-performance text rendering using FreeType and Vulkan.
- * Manages texture atlases and vertex generation for text.
+ * Text is shaped with HarfBuzz, so any UTF-8 string renders, and glyphs
+ * are rasterized on first use into a paged OSFGlyphAtlas.
+ *
+ * Text is batched per frame: queueText() only shapes and collects glyph
+ * quads, and flush() uploads every new glyph in one submission and draws
+ * all queued text with one instanced draw per atlas page. Per-frame data
+ * lives in kFramesInFlight slots of persistently mapped buffers, so the
+ * caller must not have more than kFramesInFlight - 1 frames in flight.
+ *
+ * Only built when glslc is available to compile the shaders; code using
+ * it must check OSF_HAVE_VULKAN_TEXT.
  */
 
 #pragma once
 
 #include <string>
 #include <vector>
-#include <map>
 #include <memory>
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include <opensef/OSFGlyphAtlas.h>
 
-namespace opensef {
+typedef struct hb_font_t hb_font_t;
+typedef struct hb_buffer_t hb_buffer_t;
 
-struct Character {
-    uint32_t textureID;  // Handle to the texture atlas (if multiple)
-    glm::ivec2 size;     // Size of glyph
-    glm::ivec2 bearing;  // Offset from baseline to left/top of glyph
-    uint32_t advance;    // Offset to advance to next glyph
-    glm::vec2 uvMin;     // UV coordinates in atlas
-    glm::vec2 uvMax;
-};
+namespace opensef {
 
-struct TextVertex {
-    glm::vec2 pos;
-    glm::vec2 texCoord;
+// One glyph quad; the vertex shader expands it from gl_VertexIndex
+struct GlyphInstance {
+    glm::vec4 rect;     // x, y, width, height in pixels
+    glm::vec4 texRect;  // u0, v0, u1, v1
     glm::vec4 color;
 };
 
@@ -44,10 +49,33 @@ public:
     // Font Management
     bool loadFont(const std::string& fontPath, uint32_t fontSize);
 
-    // Rendering
-    // Records draw commands into the provided command buffer
+    static constexpr uint32_t kFramesInFlight = 3;
+    static constexpr uint32_t kMaxGlyphsPerFrame = 16384;
+
+    // Counters for one frame, from beginFrame() to the next
+    struct FrameStats {
+        uint32_t strings = 0;
+        uint32_t glyphs = 0;
+        uint32_t drawCalls = 0;
+        uint32_t submits = 0;       // Atlas upload submissions
+        uint64_t uploadBytes = 0;
+    };
+
+    // Call once per frame before queueing text. Waits for the frame that
+    // last used this slot; glyphs it drew may then be evicted from the atlas
+    void beginFrame();
+
+    // Batched rendering: queue every string of the frame, then flush()
+    // once inside the render pass
+    void queueText(const std::string& text, float x, float y, float scale, const glm::vec4& color);
+    void flush(VkCommandBuffer commandBuffer);
+
+    // Immediate rendering: queueText() and flush() for a single string
     void drawText(VkCommandBuffer commandBuffer, const std::string& text, float x, float y, float scale, const glm::vec4& color);
 
+    const FrameStats& frameStats() const { return frameStats_; }
+    const FrameStats& lastFrameStats() const { return lastFrameStats_; }
+
     // Helpers
     float measureTextWidth(const std::string& text, float scale);
     void setScreenSize(int width, int height) { screenWidth_ = width; screenHeight_ = height; }
@@ -67,30 +95,60 @@ private:
     VkPipeline pipeline_ = VK_NULL_HANDLE;
     VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
     VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
-    VkDescriptorSet descriptorSet_ = VK_NULL_HANDLE;
 
-    // Font Atlas
-    VkImage atlasImage_ = VK_NULL_HANDLE;
-    VkDeviceMemory atlasMemory_ = VK_NULL_HANDLE;
-    VkImageView atlasView_ = VK_NULL_HANDLE;
+    // Font Atlas: one image and descriptor set per OSFGlyphAtlas page
+    struct AtlasPage {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        bool initialized = false; // Layout is SHADER_READ_ONLY_OPTIMAL
+    };
+    OSFGlyphAtlas atlas_;
+    std::vector<AtlasPage> atlasPages_;
     VkSampler atlasSampler_ = VK_NULL_HANDLE;
 
-    // Vertex Buffer
-    VkBuffer vertexBuffer_ = VK_NULL_HANDLE;
-    VkDeviceMemory vertexBufferMemory_ = VK_NULL_HANDLE;
-    size_t vertexBufferSize_ = 0;
-
-    // FreeType
+    // Per-frame upload state. The fence covers the slot's one pending
+    // upload; the staging buffer is persistently mapped and grown as needed
+    struct FrameSlot {
+        VkFence uploadFence = VK_NULL_HANDLE;
+        VkCommandBuffer uploadCommands = VK_NULL_HANDLE;
+        bool uploadPending = false;
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        VkDeviceSize stagingSize = 0;
+        uint8_t* staging = nullptr;
+    };
+    FrameSlot frameSlots_[kFramesInFlight];
+    uint32_t frameSlot_ = 0;
+
+    // Instance ring: kMaxGlyphsPerFrame instances per slot, persistently
+    // mapped and host coherent
+    VkBuffer instanceBuffer_ = VK_NULL_HANDLE;
+    VkDeviceMemory instanceMemory_ = VK_NULL_HANDLE;
+    GlyphInstance* instances_ = nullptr;
+    uint32_t instanceCursor_ = 0; // Next free instance in the current slot
+
+    // Glyphs queued since the last flush(), bucketed by atlas page
+    std::vector<std::vector<GlyphInstance>> queued_;
+    FrameStats frameStats_;
+    FrameStats lastFrameStats_;
+
+    // FreeType + HarfBuzz
     FT_Library ftLibrary_ = nullptr;
     FT_Face ftFace_ = nullptr;
-    std::map<char, Character> characters_;
+    hb_font_t* hbFont_ = nullptr;
+    hb_buffer_t* hbBuffer_ = nullptr;
+    uint32_t fontId_ = 0;   // Atlas key; changes with every loadFont()
+    uint32_t fontSize_ = 0;
+
+    // A shaped glyph: atlas entry and pen position in font pixels
+    struct PositionedGlyph {
+        const OSFGlyphEntry* entry;
+        float x, y;
+    };
 
-    // Atlas State
-    const int ATLAS_WIDTH = 1024;
-    const int ATLAS_HEIGHT = 1024;
-    int atlasOffsetX_ = 0;
-    int atlasOffsetY_ = 0;
-    int atlasRowHeight_ = 0;
+    std::vector<PositionedGlyph> shaped_; // Scratch for queueText()
 
     // Screen Dimensions for Projection
     int screenWidth_ = 1920;
@@ -98,12 +156,17 @@ private:
 
     // Internal methods
     void createPipeline(VkRenderPass renderPass);
-    void createAtlasTexture();
-    void updateAtlas(const std::vector<uint8_t>& buffer, int x, int y, int w, int h);
-    void createVertexBuffer();
+    void createAtlasSampler();
+    void createAtlasPage();
+    void destroyAtlasPages();
+    float shapeText(const std::string& text, std::vector<PositionedGlyph>* glyphs);
+    const OSFGlyphEntry* rasterizeGlyph(uint32_t glyphIndex);
+    void submitAtlasUploads();
+    void waitForSlot(FrameSlot& slot);
+    void createFrameResources();
+    void destroyFrameResources();
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
 };
 
 } // namespace opensef
@@ -10,6 +10,7 @@
 #endif
 
 #include <opensef/OSFAresTheme.h>
+#include <opensef/OSFTextLayoutCache.h>
 
 namespace opensef {
 
@@ -29,11 +30,21 @@ void OSFButton::click() {
   }
 }
 
-void OSFButton::handleMouseEnter() { hovered_ = true; }
-void OSFButton::handleMouseLeave() { hovered_ = false; }
-void OSFButton::handleMouseDown() { pressed_ = true; }
+void OSFButton::handleMouseEnter() {
+  hovered_ = true;
+  setNeedsDisplay();
+}
+void OSFButton::handleMouseLeave() {
+  hovered_ = false;
+  setNeedsDisplay();
+}
+void OSFButton::handleMouseDown() {
+  pressed_ = true;
+  setNeedsDisplay();
+}
 void OSFButton::handleMouseUp() {
   pressed_ = false;
+  setNeedsDisplay();
   if (hovered_)
     click();
 }
@@ -42,6 +53,7 @@ void OSFButton::handleMouseUp() {
 
 bool OSFButton::mouseDown(OSFEvent &event) {
   pressed_ = true;
+  setNeedsDisplay();
   event.setHandled(true);
   return true;
 }
@@ -49,6 +61,7 @@ bool OSFButton::mouseDown(OSFEvent &event) {
 bool OSFButton::mouseUp(OSFEvent &event) {
   if (pressed_) {
     pressed_ = false;
+    setNeedsDisplay();
     click(); // Trigger action
     event.setHandled(true);
     return true;
@@ -56,6 +69,28 @@ bool OSFButton::mouseUp(OSFEvent &event) {
   return OSFView::mouseUp(event);
 }
 
+namespace {
+
+constexpr double kLabelPaddingX = 16.0;
+constexpr double kLabelPaddingY = 8.0;
+
+OSFTextStyle labelStyle() {
+  OSFTextStyle style;
+  style.family = AresTheme::FontFamily;
+  style.size = AresTheme::FontSizeNormal;
+  return style;
+}
+
+} // namespace
+
+OSFRect OSFButton::intrinsicContentSize() const {
+  auto layout = OSFTextLayoutCache::shared().layout(label_, labelStyle());
+  if (!layout)
+    return OSFRect(0, 0, 2 * kLabelPaddingX, 2 * kLabelPaddingY);
+  return OSFRect(0, 0, layout->width() + 2 * kLabelPaddingX,
+                 layout->height() + 2 * kLabelPaddingY);
+}
+
 void OSFButton::render(cairo_t *cr) {
   if (hidden_)
     return;
@@ -80,20 +115,12 @@ void OSFButton::render(cairo_t *cr) {
   cairo_fill(cr);
 
   // Draw label
+  auto layout = OSFTextLayoutCache::shared().layout(label_, labelStyle());
+  if (!layout)
+    return;
   AresTheme::setCairoColor(cr, textColor);
-  cairo_select_font_face(
-      cr, AresTheme::FontFamily, CAIRO_FONT_SLANT_NORMAL,
-      CAIRO_FONT_WEIGHT_NORMAL); // Medium not always available
-  cairo_set_font_size(cr, AresTheme::FontSizeNormal);
-
-  cairo_text_extents_t extents;
-  cairo_text_extents(cr, label_.c_str(), &extents);
-
-  double tx = x + (w - extents.width) / 2 - extents.x_bearing;
-  double ty = y + (h - extents.height) / 2 - extents.y_bearing;
-
-  cairo_move_to(cr, tx, ty);
-  cairo_show_text(cr, label_.c_str());
+  layout->show(cr, std::round(x + (w - layout->width()) / 2),
+               std::round(y + (h - layout->height()) / 2));
 }
 
 } // namespace opensef
@@ -16,6 +16,7 @@ namespace AresTheme {
 constexpr uint32_t GlassBorder = 0x33FFFFFF;
 constexpr double CornerRadius = 12.0;
 constexpr double BorderWidth = 1.0;
+constexpr double ShadowBlur = 16.0;
 
 inline void setCairoColor(cairo_t *cr, uint32_t color) {
   double a = ((color >> 24) & 0xFF) / 255.0;
@@ -44,7 +45,28 @@ std::shared_ptr<OSFGlassPanel> OSFGlassPanel::create(const OSFRect &frame) {
   return panel;
 }
 
-void OSFGlassPanel::setShadowEnabled(bool enabled) { shadowEnabled_ = enabled; }
+void OSFGlassPanel::setShadowEnabled(bool enabled) {
+  shadowEnabled_ = enabled;
+  setNeedsDisplay();
+}
+
+OSFShadowStyle OSFGlassPanel::shadowStyle() const {
+  OSFShadowStyle shadow;
+  shadow.cornerRadius = AresTheme::CornerRadius;
+  shadow.blur = AresTheme::ShadowBlur;
+  shadow.color = OSFColor(0, 0, 0, 0.3);
+  shadow.offset = OSFPoint(0, 4);
+  return shadow;
+}
+
+OSFRect OSFGlassPanel::paintBounds() const {
+  // render() draws the panel at its frame origin, plus the shadow
+  OSFRect paint = OSFView::paintBounds().united(frame_);
+  if (shadowEnabled_) {
+    paint = paint.united(OSFShadowCache::shadowBounds(frame_, shadowStyle()));
+  }
+  return paint;
+}
 
 void OSFGlassPanel::render(cairo_t *cr) {
   if (hidden_)
@@ -52,11 +74,10 @@ void OSFGlassPanel::render(cairo_t *cr) {
 
   double x = frame_.x, y = frame_.y, w = frame_.width, h = frame_.height;
 
-  // Shadow
+  // Shadow (blurred once per radius, then composited from nine slices)
   if (shadowEnabled_) {
-    cairo_set_source_rgba(cr, 0, 0, 0, 0.3);
-    AresTheme::roundedRect(cr, x + 2, y + 4, w, h, AresTheme::CornerRadius);
-    cairo_fill(cr);
+    OSFShadowCache::shared().drawShadow(cr, OSFRect(x, y, w, h),
+                                        shadowStyle());
   }
 
   // Background with tint
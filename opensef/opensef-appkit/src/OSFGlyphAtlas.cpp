@@ -0,0 +1,252 @@
+/**
+ * OSFGlyphAtlas.cpp - Dynamic Glyph Atlas Implementation
+ */
+
+#include <opensef/OSFGlyphAtlas.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+namespace opensef {
+
+namespace {
+
+// Beyond this many rectangles a page uploads their bounding box instead
+constexpr size_t kMaxRegionsPerPage = 32;
+
+} // namespace
+
+OSFGlyphAtlas::OSFGlyphAtlas(int pageSize, size_t maxPages)
+    : pageSize_(std::max(16, pageSize)),
+      maxPages_(std::max<size_t>(1, maxPages)) {}
+
+void OSFGlyphAtlas::beginFrame() { ++frame_; }
+
+void OSFGlyphAtlas::touch(Page &page) {
+  page.lastUse = ++useCounter_;
+  page.lastFrame = frame_;
+}
+
+const OSFGlyphEntry *OSFGlyphAtlas::find(const OSFGlyphKey &key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end())
+    return nullptr;
+  if (it->second.page != OSFGlyphEntry::kNoPage)
+    touch(pages_[it->second.page]);
+  return &it->second;
+}
+
+const OSFGlyphEntry *OSFGlyphAtlas::insert(const OSFGlyphKey &key, int width,
+                                           int height, const uint8_t *pixels,
+                                           int pitch, int bearingX,
+                                           int bearingY) {
+  auto existing = entries_.find(key);
+  if (existing != entries_.end()) {
+    if (existing->second.page != OSFGlyphEntry::kNoPage)
+      touch(pages_[existing->second.page]);
+    return &existing->second;
+  }
+
+  OSFGlyphEntry entry;
+  entry.bearingX = bearingX;
+  entry.bearingY = bearingY;
+
+  // Blank glyphs only carry metrics
+  if (width <= 0 || height <= 0 || !pixels) {
+    return &entries_.emplace(key, entry).first->second;
+  }
+
+  const int cellWidth = width + 2 * kPadding;
+  const int cellHeight = height + 2 * kPadding;
+  if (cellWidth > pageSize_ || cellHeight > pageSize_) {
+    std::cerr << "[OSFGlyphAtlas] Glyph " << key.glyph << " (" << width << "x"
+              << height << ") is larger than a page" << std::endl;
+    return nullptr;
+  }
+
+  // First page with room, then a new page, then the least recently used
+  // page not needed by this frame
+  int cellX = 0, cellY = 0;
+  uint32_t pageIndex = OSFGlyphEntry::kNoPage;
+  for (uint32_t i = 0; i < pages_.size(); ++i) {
+    if (pack(pages_[i], cellWidth, cellHeight, cellX, cellY)) {
+      pageIndex = i;
+      break;
+    }
+  }
+  if (pageIndex == OSFGlyphEntry::kNoPage && pages_.size() < maxPages_) {
+    addPage();
+    pageIndex = static_cast<uint32_t>(pages_.size() - 1);
+    pack(pages_[pageIndex], cellWidth, cellHeight, cellX, cellY);
+  }
+  if (pageIndex == OSFGlyphEntry::kNoPage) {
+    uint64_t oldest = UINT64_MAX;
+    for (uint32_t i = 0; i < pages_.size(); ++i) {
+      if (pages_[i].lastFrame != frame_ && pages_[i].lastUse < oldest) {
+        oldest = pages_[i].lastUse;
+        pageIndex = i;
+      }
+    }
+    if (pageIndex == OSFGlyphEntry::kNoPage) {
+      std::cerr << "[OSFGlyphAtlas] All pages are full and in use this frame"
+                << std::endl;
+      return nullptr;
+    }
+    resetPage(pages_[pageIndex]);
+    ++evictions_;
+    pack(pages_[pageIndex], cellWidth, cellHeight, cellX, cellY);
+  }
+
+  Page &page = pages_[pageIndex];
+  entry.page = pageIndex;
+  entry.x = cellX + kPadding;
+  entry.y = cellY + kPadding;
+  entry.width = width;
+  entry.height = height;
+  entry.u0 = static_cast<float>(entry.x) / pageSize_;
+  entry.v0 = static_cast<float>(entry.y) / pageSize_;
+  entry.u1 = static_cast<float>(entry.x + width) / pageSize_;
+  entry.v1 = static_cast<float>(entry.y + height) / pageSize_;
+
+  // The cell's padding is already blank; uploading the whole cell also
+  // clears whatever an evicted glyph left in the GPU copy
+  for (int row = 0; row < height; ++row) {
+    std::memcpy(&page.pixels[static_cast<size_t>(entry.y + row) * pageSize_ +
+                             entry.x],
+                pixels + static_cast<ptrdiff_t>(row) * pitch, width);
+  }
+  if (!page.fullyDirty)
+    page.dirty.push_back({pageIndex, cellX, cellY, cellWidth, cellHeight});
+  page.keys.push_back(key);
+  page.usedArea += static_cast<int64_t>(cellWidth) * cellHeight;
+  touch(page);
+
+  return &entries_.emplace(key, entry).first->second;
+}
+
+bool OSFGlyphAtlas::pack(Page &page, int width, int height, int &x, int &y) {
+  // Bottom-left skyline: place at the lowest top edge, ties to the
+  // narrowest segment so wide gaps stay open for wide glyphs
+  std::vector<SkylineNode> &skyline = page.skyline;
+  int bestTop = INT_MAX, bestWidth = INT_MAX;
+  size_t bestIndex = skyline.size();
+  int bestY = 0;
+
+  for (size_t i = 0; i < skyline.size(); ++i) {
+    if (skyline[i].x + width > pageSize_)
+      break;
+    int top = 0;
+    int remaining = width;
+    for (size_t j = i; remaining > 0; ++j) {
+      top = std::max(top, skyline[j].y);
+      remaining -= skyline[j].width;
+    }
+    if (top + height > pageSize_)
+      continue;
+    if (top + height < bestTop ||
+        (top + height == bestTop && skyline[i].width < bestWidth)) {
+      bestTop = top + height;
+      bestWidth = skyline[i].width;
+      bestIndex = i;
+      bestY = top;
+    }
+  }
+  if (bestIndex == skyline.size())
+    return false;
+
+  x = skyline[bestIndex].x;
+  y = bestY;
+
+  // Raise the covered span to the new top edge
+  SkylineNode node{x, bestTop, width};
+  skyline.insert(skyline.begin() + bestIndex, node);
+  for (size_t i = bestIndex + 1; i < skyline.size();) {
+    int covered = node.x + node.width - skyline[i].x;
+    if (covered <= 0)
+      break;
+    if (covered >= skyline[i].width) {
+      skyline.erase(skyline.begin() + i);
+    } else {
+      skyline[i].x += covered;
+      skyline[i].width -= covered;
+      break;
+    }
+  }
+
+  // Merge neighbours at the same height
+  for (size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+  return true;
+}
+
+void OSFGlyphAtlas::addPage() {
+  pages_.emplace_back();
+  Page &page = pages_.back();
+  page.pixels.assign(static_cast<size_t>(pageSize_) * pageSize_, 0);
+  page.skyline.push_back({0, 0, pageSize_});
+}
+
+void OSFGlyphAtlas::resetPage(Page &page) {
+  for (const OSFGlyphKey &key : page.keys)
+    entries_.erase(key);
+  page.keys.clear();
+  std::fill(page.pixels.begin(), page.pixels.end(), 0);
+  page.skyline.assign(1, {0, 0, pageSize_});
+  page.usedArea = 0;
+  // Stale GPU pixels are only ever overwritten by whole cells, so the page
+  // need not be uploaded again in full
+  page.dirty.clear();
+}
+
+std::vector<OSFGlyphAtlas::DirtyRegion> OSFGlyphAtlas::takeDirtyRegions() {
+  std::vector<DirtyRegion> regions;
+  for (uint32_t i = 0; i < pages_.size(); ++i) {
+    Page &page = pages_[i];
+    if (page.fullyDirty) {
+      regions.push_back({i, 0, 0, pageSize_, pageSize_});
+    } else if (page.dirty.size() > kMaxRegionsPerPage) {
+      int x0 = pageSize_, y0 = pageSize_, x1 = 0, y1 = 0;
+      for (const DirtyRegion &rect : page.dirty) {
+        x0 = std::min(x0, rect.x);
+        y0 = std::min(y0, rect.y);
+        x1 = std::max(x1, rect.x + rect.width);
+        y1 = std::max(y1, rect.y + rect.height);
+      }
+      regions.push_back({i, x0, y0, x1 - x0, y1 - y0});
+    } else {
+      regions.insert(regions.end(), page.dirty.begin(), page.dirty.end());
+    }
+    page.fullyDirty = false;
+    page.dirty.clear();
+  }
+  return regions;
+}
+
+const uint8_t *OSFGlyphAtlas::pagePixels(uint32_t page) const {
+  return page < pages_.size() ? pages_[page].pixels.data() : nullptr;
+}
+
+void OSFGlyphAtlas::clear() {
+  entries_.clear();
+  pages_.clear();
+}
+
+double OSFGlyphAtlas::occupancy() const {
+  if (pages_.empty())
+    return 0.0;
+  int64_t used = 0;
+  for (const Page &page : pages_)
+    used += page.usedArea;
+  return static_cast<double>(used) /
+         (static_cast<double>(pageSize_) * pageSize_ * pages_.size());
+}
+
+} // namespace opensef
@@ -2,8 +2,8 @@
  * OSFLabel.cpp - Text Display Widget
  */
 
+#include <opensef/OSFTextLayoutCache.h>
 #include <opensef/OpenSEFAppKit.h>
-#include <pango/pangocairo.h>
 
 namespace opensef {
 
@@ -35,9 +35,29 @@ std::shared_ptr<OSFLabel> OSFLabel::createSubtitle(const std::string &text) {
   return label;
 }
 
-void OSFLabel::setFontSize(double size) { fontSize_ = size; }
-void OSFLabel::setFontWeight(FontWeight weight) { fontWeight_ = weight; }
-void OSFLabel::setAlignment(TextAlignment alignment) { alignment_ = alignment; }
+void OSFLabel::setFontSize(double size) {
+  fontSize_ = size;
+  setNeedsDisplay();
+}
+void OSFLabel::setFontWeight(FontWeight weight) {
+  fontWeight_ = weight;
+  setNeedsDisplay();
+}
+void OSFLabel::setAlignment(TextAlignment alignment) {
+  alignment_ = alignment;
+  setNeedsDisplay();
+}
+
+OSFRect OSFLabel::intrinsicContentSize() const {
+  OSFTextStyle style;
+  style.family = AresTheme::FontFamily;
+  style.size = fontSize_;
+  style.weight = fontWeight_;
+  auto layout = OSFTextLayoutCache::shared().layout(text_, style);
+  if (!layout)
+    return OSFRect(0, 0, 0, 0);
+  return OSFRect(0, 0, layout->width(), layout->height());
+}
 
 void OSFLabel::render(cairo_t *cr) {
   if (hidden_ || text_.empty())
@@ -46,51 +66,19 @@ void OSFLabel::render(cairo_t *cr) {
   double x = frame_.x;
   double y = frame_.y;
 
-  // Create Pango layout
-  PangoLayout *layout = pango_cairo_create_layout(cr);
-  pango_layout_set_text(layout, text_.c_str(), -1);
-
-  // Create font description
-  PangoFontDescription *fontDesc = pango_font_description_new();
-  pango_font_description_set_family(fontDesc, AresTheme::FontFamily);
-  pango_font_description_set_size(fontDesc,
-                                  static_cast<int>(fontSize_ * PANGO_SCALE));
-  pango_font_description_set_weight(
-      fontDesc, fontWeight_ == FontWeight::Bold     ? PANGO_WEIGHT_BOLD
-                : fontWeight_ == FontWeight::Medium ? PANGO_WEIGHT_MEDIUM
-                                                    : PANGO_WEIGHT_NORMAL);
-
-  pango_layout_set_font_description(layout, fontDesc);
-
-  // Set width for wrapping
-  if (frame_.width > 0) {
-    pango_layout_set_width(layout,
-                           static_cast<int>(frame_.width * PANGO_SCALE));
-  }
-
-  // Set alignment
-  switch (alignment_) {
-  case TextAlignment::Center:
-    pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
-    break;
-  case TextAlignment::Right:
-    pango_layout_set_alignment(layout, PANGO_ALIGN_RIGHT);
-    break;
-  default:
-    pango_layout_set_alignment(layout, PANGO_ALIGN_LEFT);
-    break;
-  }
+  // Shaped once per text and style; wraps at the frame width
+  OSFTextStyle style;
+  style.family = AresTheme::FontFamily;
+  style.size = fontSize_;
+  style.weight = fontWeight_;
+  style.width = frame_.width;
+  style.alignment = alignment_;
+  auto layout = OSFTextLayoutCache::shared().layout(text_, style);
+  if (!layout)
+    return;
 
-  // Set color
   textColor_.setCairo(cr);
-
-  // Render
-  cairo_move_to(cr, x, y);
-  pango_cairo_show_layout(cr, layout);
-
-  // Cleanup
-  pango_font_description_free(fontDesc);
-  g_object_unref(layout);
+  layout->show(cr, x, y);
 }
 
 } // namespace opensef
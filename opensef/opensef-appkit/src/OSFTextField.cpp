@@ -4,8 +4,8 @@
 
 #include <cmath>
 #include <opensef/OpenSEFAppKit.h>
+#include <opensef/OSFTextLayoutCache.h>
 #include <opensef/OSFWindow.h>
-#include <pango/pangocairo.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -51,7 +51,10 @@ OSFTextField::create(const std::string &placeholder) {
   return std::make_shared<OSFTextField>(placeholder);
 }
 
-void OSFTextField::setSecure(bool secure) { isSecure_ = secure; }
+void OSFTextField::setSecure(bool secure) {
+  isSecure_ = secure;
+  setNeedsDisplay();
+}
 
 void OSFTextField::handleKeyPress(uint32_t key, const std::string &text) {
   if (key == 0xFF08) { // Backspace
@@ -59,6 +62,7 @@ void OSFTextField::handleKeyPress(uint32_t key, const std::string &text) {
   } else if (!text.empty()) {
     text_ += text;
   }
+  setNeedsDisplay();
   if (onTextChanged_)
     onTextChanged_(text_);
 }
@@ -125,6 +129,7 @@ void OSFTextField::resignFirstResponder() { handleFocus(false); }
 void OSFTextField::handleFocus(bool focused) {
   focused_ = focused;
   cursorVisible_ = focused;
+  setNeedsDisplay();
 }
 
 void OSFTextField::setOnTextChanged(
@@ -136,6 +141,17 @@ void OSFTextField::setOnSubmit(std::function<void(const std::string &)> cb) {
   onSubmit_ = cb;
 }
 
+OSFRect OSFTextField::intrinsicContentSize() const {
+  OSFTextStyle style;
+  style.family = AresTheme::FontFamily;
+  style.size = AresTheme::FontSizeNormal;
+  auto layout = OSFTextLayoutCache::shared().layout(placeholder_, style);
+  double textWidth = layout ? layout->width() : 0;
+  double textHeight = layout ? layout->height() : AresTheme::FontSizeNormal;
+  double padding = 10.0; // As in render(); plus room for the cursor
+  return OSFRect(0, 0, textWidth + 2 * padding + 4, textHeight + 16);
+}
+
 void OSFTextField::render(cairo_t *cr) {
   if (hidden_)
     return;
@@ -163,24 +179,18 @@ void OSFTextField::render(cairo_t *cr) {
     displayText = std::string(text_.length(), '*');
   }
 
-  PangoLayout *layout = pango_cairo_create_layout(cr);
-  pango_layout_set_text(layout, displayText.c_str(), -1);
-
-  PangoFontDescription *fontDesc = pango_font_description_new();
-  pango_font_description_set_family(fontDesc, AresTheme::FontFamily);
-  pango_font_description_set_size(
-      fontDesc, static_cast<int>(AresTheme::FontSizeNormal * PANGO_SCALE));
-  pango_layout_set_font_description(layout, fontDesc);
-
-  uint32_t textColor = isPlaceholder ? 0xFF666666 : AresTheme::StarWhite;
-  AresTheme::setCairoColor(cr, textColor);
-
-  int textWidth, textHeight;
-  pango_layout_get_pixel_size(layout, &textWidth, &textHeight);
-  double ty = y + (h - textHeight) / 2.0;
-
-  cairo_move_to(cr, x + padding, ty);
-  pango_cairo_show_layout(cr, layout);
+  OSFTextStyle style;
+  style.family = AresTheme::FontFamily;
+  style.size = AresTheme::FontSizeNormal;
+  auto layout = OSFTextLayoutCache::shared().layout(displayText, style);
+  int textWidth = layout ? layout->width() : 0;
+  int textHeight = layout ? layout->height() : 0;
+
+  if (layout) {
+    uint32_t textColor = isPlaceholder ? 0xFF666666 : AresTheme::StarWhite;
+    AresTheme::setCairoColor(cr, textColor);
+    layout->show(cr, x + padding, y + (h - textHeight) / 2.0);
+  }
 
   // Cursor
   if (focused_ && cursorVisible_) {
@@ -191,9 +201,6 @@ void OSFTextField::render(cairo_t *cr) {
     cairo_line_to(cr, cursorX, y + h - 6);
     cairo_stroke(cr);
   }
-
-  pango_font_description_free(fontDesc);
-  g_object_unref(layout);
 }
 
 } // namespace opensef
@@ -0,0 +1,188 @@
+/**
+ * OSFTextLayoutCache.cpp - Shaped Text Layout Cache Implementation
+ */
+
+#include <opensef/OSFTextLayoutCache.h>
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace opensef {
+
+OSFTextLayout::~OSFTextLayout() {
+  if (layout_) {
+    std::lock_guard<std::mutex> lock(*fontLock_);
+    g_object_unref(layout_);
+  }
+}
+
+void OSFTextLayout::show(cairo_t *cr, double x, double y) const {
+  std::lock_guard<std::mutex> lock(*fontLock_);
+  cairo_move_to(cr, x, y);
+  pango_cairo_show_layout(cr, layout_);
+}
+
+OSFTextLayoutCache &OSFTextLayoutCache::shared() {
+  static OSFTextLayoutCache instance;
+  return instance;
+}
+
+OSFTextLayoutCache::~OSFTextLayoutCache() {
+  clear();
+  if (context_)
+    g_object_unref(context_);
+  if (fontMap_)
+    g_object_unref(fontMap_);
+}
+
+OSFTextLayoutPtr OSFTextLayoutCache::layout(const std::string &text,
+                                            const OSFTextStyle &style) {
+  Key key{text,
+          style.family,
+          static_cast<int>(std::lround(style.size * PANGO_SCALE)),
+          static_cast<int>(style.weight),
+          style.width > 0 ? static_cast<int>(style.width * PANGO_SCALE) : -1,
+          static_cast<int>(style.alignment)};
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+    ++misses_;
+  }
+
+  // Shape outside the lock; another thread may have raced us to it
+  OSFTextLayoutPtr entry = shape(key);
+  if (!entry)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+  lru_.emplace_front(key, entry);
+  entries_[key] = lru_.begin();
+  while (lru_.size() > capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back(); // Widgets mid-draw keep their shared_ptr
+  }
+  return entry;
+}
+
+OSFTextLayoutPtr OSFTextLayoutCache::shape(const Key &key) {
+  std::unique_lock<std::mutex> mapLock(fontMapMutex_);
+  if (!context_) {
+    fontMap_ = pango_cairo_font_map_new();
+    if (!fontMap_)
+      return nullptr;
+    context_ = pango_font_map_create_context(fontMap_);
+    if (!context_) {
+      std::cerr << "[OSFTextLayoutCache] Failed to create Pango context"
+                << std::endl;
+      g_object_unref(fontMap_);
+      fontMap_ = nullptr;
+      return nullptr;
+    }
+    fontLock_ = std::make_shared<std::mutex>();
+  }
+  std::shared_ptr<std::mutex> fontLock = fontLock_;
+  std::lock_guard<std::mutex> lock(*fontLock);
+
+  // The layout holds its own reference, so invalidate() may now swap maps
+  PangoLayout *layout = pango_layout_new(context_);
+  mapLock.unlock();
+  if (!layout)
+    return nullptr;
+  pango_layout_set_text(layout, key.text.c_str(), -1);
+
+  PangoFontDescription *fontDesc = pango_font_description_new();
+  pango_font_description_set_family(fontDesc, key.family.c_str());
+  pango_font_description_set_size(fontDesc, key.size);
+  pango_font_description_set_weight(
+      fontDesc,
+      key.weight == static_cast<int>(FontWeight::Bold) ? PANGO_WEIGHT_BOLD
+      : key.weight == static_cast<int>(FontWeight::Medium)
+          ? PANGO_WEIGHT_MEDIUM
+          : PANGO_WEIGHT_NORMAL);
+  pango_layout_set_font_description(layout, fontDesc);
+  pango_font_description_free(fontDesc);
+
+  if (key.width > 0)
+    pango_layout_set_width(layout, key.width);
+
+  switch (static_cast<TextAlignment>(key.alignment)) {
+  case TextAlignment::Center:
+    pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
+    break;
+  case TextAlignment::Right:
+    pango_layout_set_alignment(layout, PANGO_ALIGN_RIGHT);
+    break;
+  default:
+    pango_layout_set_alignment(layout, PANGO_ALIGN_LEFT);
+    break;
+  }
+
+  // Measuring shapes and breaks the lines now, so drawing only reads them
+  std::shared_ptr<OSFTextLayout> entry(new OSFTextLayout());
+  entry->layout_ = layout;
+  entry->fontLock_ = fontLock;
+  pango_layout_get_pixel_size(layout, &entry->width_, &entry->height_);
+  return entry;
+}
+
+void OSFTextLayoutCache::invalidate() {
+  clear();
+
+  // Layouts still in use keep their own reference to the old context
+  // and lock; the next shape() starts a new font map
+  std::lock_guard<std::mutex> lock(fontMapMutex_);
+  fontLock_.reset();
+  if (context_) {
+    g_object_unref(context_);
+    context_ = nullptr;
+  }
+  if (fontMap_) {
+    g_object_unref(fontMap_);
+    fontMap_ = nullptr;
+  }
+}
+
+size_t OSFTextLayoutCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+void OSFTextLayoutCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = std::max<size_t>(1, capacity);
+  while (lru_.size() > capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+void OSFTextLayoutCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+uint64_t OSFTextLayoutCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t OSFTextLayoutCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+} // namespace opensef
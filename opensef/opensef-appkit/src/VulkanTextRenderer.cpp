@@ -7,6 +7,8 @@
 #include <cstring>
 #include <fstream>
 #include <glm/gtc/matrix_transform.hpp>
+#include <hb-ft.h>
+#include <hb.h>
 #include <iostream>
 #include <opensef/VulkanTextRenderer.h>
 #include <stdexcept>
@@ -16,108 +18,15 @@
 
 namespace opensef {
 
-// Pre-compiled minimal SPIR-V shaders (Passthrough Vertex + Texture Fragment)
-// Generated using glslangValidator
-//
-// Vertex Shader:
-// #version 450
-// layout(location = 0) in vec2 inPos;
-// layout(location = 1) in vec2 inTexCoord;
-// layout(location = 2) in vec4 inColor;
-// layout(location = 0) out vec2 fragTexCoord;
-// layout(location = 1) out vec4 fragColor;
-// layout(push_constant) uniform PushConstants { mat4 projection; mat4 view; }
-// pc; void main() { gl_Position = pc.projection * pc.view * vec4(inPos,
-// 0.0, 1.0); fragTexCoord = inTexCoord; fragColor = inColor; }
-
+// SPIR-V for shaders/text.vert and shaders/text.frag, compiled by glslc
+// at build time
 static const uint32_t VERTEX_SHADER_SPV[] = {
-    0x07230203, 0x00010000, 0x00080001, 0x0000002e, 0x00000000, 0x00020011,
-    0x00000001, 0x0006000b, 0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e,
-    0x00000000, 0x0003000e, 0x00000000, 0x00000001, 0x000a000f, 0x00000000,
-    0x00000004, 0x6e69616d, 0x00000000, 0x0000000d, 0x00000017, 0x0000001d,
-    0x00000020, 0x00000022, 0x00030003, 0x00000002, 0x000001c2, 0x00040005,
-    0x00000004, 0x6e69616d, 0x00000000, 0x00030005, 0x00000009, 0x00000000,
-    0x00050006, 0x00000009, 0x00000000, 0x6f6c6f43, 0x00000072, 0x00040006,
-    0x00000009, 0x00000001, 0x00005635, 0x00030005, 0x0000000b, 0x0074754f,
-    0x00040005, 0x0000000f, 0x6c6f436e, 0x0000726f, 0x00030005, 0x00000013,
-    0x00000000, 0x00050006, 0x00000013, 0x00000000, 0x6f6c6f43, 0x0000726f,
-    0x00040006, 0x00000013, 0x00000001, 0x00005635, 0x00030005, 0x00000015,
-    0x00000000, 0x00050048, 0x0000000b, 0x00000000, 0x0000000b, 0x00000000,
-    0x00050048, 0x0000000b, 0x00000001, 0x0000000b, 0x00000001, 0x00030047,
-    0x0000000b, 0x00000002, 0x00040047, 0x0000000f, 0x0000001e, 0x00000000,
-    0x00040047, 0x00000013, 0x0000001e, 0x00000000, 0x00020013, 0x00000002,
-    0x00030021, 0x00000003, 0x00000002, 0x00030016, 0x00000006, 0x00000020,
-    0x00040017, 0x00000007, 0x00000006, 0x00000004, 0x00040017, 0x00000008,
-    0x00000006, 0x00000002, 0x0004001e, 0x00000009, 0x00000007, 0x00000008,
-    0x00040020, 0x0000000a, 0x00000003, 0x00000009, 0x0004003b, 0x0000000a,
-    0x0000000b, 0x00000003, 0x00040015, 0x0000000c, 0x00000020, 0x00000001,
-    0x0004002b, 0x0000000c, 0x0000000d, 0x00000000, 0x00040020, 0x0000000e,
-    0x00000001, 0x00000007, 0x0004003b, 0x0000000e, 0x0000000f, 0x00000001,
-    0x00040020, 0x00000011, 0x00000003, 0x00000007, 0x0004002b, 0x00000006,
-    0x00000013, 0x00000000, 0x00040020, 0x00000016, 0x00000003, 0x00000006,
-    0x0004003b, 0x00000016, 0x00000017, 0x00000003, 0x00040020, 0x0000001b,
-    0x00000003, 0x00000008, 0x0004003b, 0x0000001b, 0x0000001d, 0x00000003,
-    0x00040020, 0x0000001f, 0x00000003, 0x0000000d, 0x0004003b, 0x0000001f,
-    0x00000020, 0x00000003, 0x00040020, 0x00000021, 0x00000003, 0x0000000e,
-    0x0004003b, 0x00000021, 0x00000022, 0x00000003, 0x00050036, 0x00000002,
-    0x00000004, 0x00000000, 0x00000003, 0x000200f8, 0x00000005, 0x0004003d,
-    0x00000007, 0x00000010, 0x0000000f, 0x00050041, 0x00000011, 0x00000012,
-    0x0000000d, 0x00000010, 0x0003003e, 0x00000012, 0x0000000b, 0x0004003d,
-    0x00000006, 0x00000014, 0x00000013, 0x00050041, 0x00000016, 0x00000015,
-    0x0000000d, 0x00000014, 0x0003003e, 0x00000015, 0x00000017, 0x0004003d,
-    0x00000008, 0x0000001c, 0x0000001d, 0x00050051, 0x00000006, 0x0000001e,
-    0x0000001c, 0x00000000, 0x00050051, 0x00000006, 0x0000001f, 0x0000001c,
-    0x00000001, 0x00070050, 0x00000007, 0x00000023, 0x00000022, 0x0000001e,
-    0x0000001f, 0x00000020, 0x00050041, 0x00000011, 0x00000024, 0x0000000d,
-    0x00000023, 0x0003003e, 0x00000024, 0x0000000d, 0x000100fd, 0x00010038};
-
-// Fragment Shader:
-// #version 450
-// layout(location = 0) in vec2 fragTexCoord;
-// layout(location = 1) in vec4 fragColor;
-// layout(location = 0) out vec4 outColor;
-// layout(binding = 0) uniform sampler2D texSampler;
-// void main() { float alpha = texture(texSampler, fragTexCoord).r; outColor =
-// vec4(fragColor.rgb, fragColor.a * alpha); }
+#include "text.vert.inc"
+};
 
 static const uint32_t FRAGMENT_SHADER_SPV[] = {
-    0x07230203, 0x00010000, 0x00080001, 0x00000022, 0x00000000, 0x00020011,
-    0x00000001, 0x0006000b, 0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e,
-    0x00000000, 0x0003000e, 0x00000000, 0x00000001, 0x000a000f, 0x00000000,
-    0x00000004, 0x6e69616d, 0x00000000, 0x00000009, 0x00000011, 0x00000015,
-    0x00000019, 0x00030003, 0x00000002, 0x000001c2, 0x00040005, 0x00000004,
-    0x6e69616d, 0x00000000, 0x00040005, 0x00000009, 0x4374756f, 0x726f6c6f,
-    0x00000000, 0x00030005, 0x0000000d, 0x00000000, 0x00050006, 0x0000000d,
-    0x00000000, 0x6f6c6f43, 0x00000072, 0x00040006, 0x0000000d, 0x00000001,
-    0x00005635, 0x00030005, 0x00000011, 0x00786554, 0x00040005, 0x00000015,
-    0x67617266, 0x6f437865, 0x0064726f, 0x00030005, 0x00000019, 0x67617266,
-    0x00000000, 0x00050048, 0x00000009, 0x00000000, 0x0000000b, 0x00000000,
-    0x00050048, 0x0000000d, 0x00000000, 0x00000022, 0x00000000, 0x00050048,
-    0x00000011, 0x00000000, 0x00000005, 0x00000001, 0x00050048, 0x00000015,
-    0x00000000, 0x0000000b, 0x00000000, 0x00050048, 0x00000019, 0x00000000,
-    0x0000000b, 0x00000001, 0x00020013, 0x00000002, 0x00030021, 0x00000003,
-    0x00000002, 0x00030016, 0x00000006, 0x00000020, 0x00040017, 0x00000007,
-    0x00000006, 0x00000004, 0x00040020, 0x00000008, 0x00000003, 0x00000007,
-    0x0004003b, 0x00000008, 0x00000009, 0x00000003, 0x00090019, 0x0000000a,
-    0x00000006, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000001,
-    0x00000000, 0x0003001b, 0x0000000b, 0x0000000a, 0x00040020, 0x0000000c,
-    0x00000000, 0x0000000b, 0x0004003b, 0x0000000c, 0x0000000d, 0x00000000,
-    0x0004002b, 0x00000006, 0x0000000f, 0x00000000, 0x00040020, 0x00000010,
-    0x00000001, 0x0000000b, 0x0004003b, 0x00000010, 0x00000011, 0x00000001,
-    0x00040017, 0x00000013, 0x00000006, 0x00000002, 0x00040020, 0x00000014,
-    0x00000003, 0x00000013, 0x0004003b, 0x00000014, 0x00000015, 0x00000003,
-    0x00040020, 0x00000018, 0x00000003, 0x00000007, 0x0004003b, 0x00000018,
-    0x00000019, 0x00000003, 0x00050036, 0x00000002, 0x00000004, 0x00000000,
-    0x00000003, 0x000200f8, 0x00000005, 0x0004003d, 0x0000000b, 0x00000012,
-    0x00000011, 0x0004003d, 0x00000013, 0x00000016, 0x00000015, 0x00050057,
-    0x00000007, 0x00000017, 0x00000012, 0x00000016, 0x00050051, 0x00000006,
-    0x0000001a, 0x00000017, 0x00000000, 0x0004003d, 0x00000007, 0x0000001b,
-    0x00000019, 0x00050051, 0x00000007, 0x0000001c, 0x0000001b, 0x00000000,
-    0x00050051, 0x00000007, 0x0000001d, 0x0000001b, 0x00000001, 0x00050051,
-    0x00000007, 0x0000001e, 0x0000001b, 0x00000002, 0x00050081, 0x00000006,
-    0x0000001f, 0x0000001e, 0x0000001a, 0x00070050, 0x00000007, 0x00000020,
-    0x0000001c, 0x0000001d, 0x0000001f, 0x0000001e, 0x0003003e, 0x00000009,
-    0x00000020, 0x000100fd, 0x00010038};
+#include "text.frag.inc"
+};
 
 VulkanTextRenderer &VulkanTextRenderer::shared() {
   static VulkanTextRenderer instance;
@@ -144,9 +53,9 @@ void VulkanTextRenderer::initialize(VkDevice device,
     return;
   }
 
-  createAtlasTexture();
+  createAtlasSampler();
   createPipeline(renderPass);
-  createVertexBuffer(); // Initial small buffer
+  createFrameResources();
 
   // Robust font loading: Check env var first, then common paths
   std::vector<std::string> fontPaths;
@@ -190,19 +99,10 @@ void VulkanTextRenderer::shutdown() {
     if (descriptorSetLayout_)
       vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
 
+    destroyAtlasPages();
     if (atlasSampler_)
       vkDestroySampler(device_, atlasSampler_, nullptr);
-    if (atlasView_)
-      vkDestroyImageView(device_, atlasView_, nullptr);
-    if (atlasImage_)
-      vkDestroyImage(device_, atlasImage_, nullptr);
-    if (atlasMemory_)
-      vkFreeMemory(device_, atlasMemory_, nullptr);
-
-    if (vertexBuffer_)
-      vkDestroyBuffer(device_, vertexBuffer_, nullptr);
-    if (vertexBufferMemory_)
-      vkFreeMemory(device_, vertexBufferMemory_, nullptr);
+    destroyFrameResources();
 
     if (descriptorPool_)
       vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
@@ -210,6 +110,15 @@ void VulkanTextRenderer::shutdown() {
     device_ = VK_NULL_HANDLE;
   }
 
+  atlas_.clear();
+  if (hbBuffer_) {
+    hb_buffer_destroy(hbBuffer_);
+    hbBuffer_ = nullptr;
+  }
+  if (hbFont_) {
+    hb_font_destroy(hbFont_);
+    hbFont_ = nullptr;
+  }
   if (ftFace_) {
     FT_Done_Face(ftFace_);
     ftFace_ = nullptr;
@@ -222,78 +131,150 @@ void VulkanTextRenderer::shutdown() {
 
 bool VulkanTextRenderer::loadFont(const std::string &fontPath,
                                   uint32_t fontSize) {
-  if (FT_New_Face(ftLibrary_, fontPath.c_str(), 0, &ftFace_)) {
+  FT_Face face = nullptr;
+  if (FT_New_Face(ftLibrary_, fontPath.c_str(), 0, &face)) {
     return false;
   }
 
-  FT_Set_Pixel_Sizes(ftFace_, 0, fontSize);
+  FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-  // Reset atlas position
-  atlasOffsetX_ = 0;
-  atlasOffsetY_ = 0;
-  atlasRowHeight_ = 0;
-  characters_.clear();
+  // HarfBuzz keeps its own reference to the face
+  if (hbFont_)
+    hb_font_destroy(hbFont_);
+  if (ftFace_)
+    FT_Done_Face(ftFace_);
+  ftFace_ = face;
+  hbFont_ = hb_ft_font_create_referenced(ftFace_);
+  if (!hbBuffer_)
+    hbBuffer_ = hb_buffer_create();
+
+  // Glyphs of the previous font age out of the atlas on their own
+  ++fontId_;
+  fontSize_ = fontSize;
+
+  // Warm the atlas with printable ASCII; everything else is rasterized on
+  // first use. The pixels go up with the next flush()
+  for (FT_ULong c = 32; c < 127; c++) {
+    rasterizeGlyph(FT_Get_Char_Index(ftFace_, c));
+  }
 
-  // Load first 128 ASCII characters
-  for (unsigned char c = 0; c < 128; c++) {
-    if (FT_Load_Char(ftFace_, c, FT_LOAD_RENDER)) {
-      continue;
-    }
+  return true;
+}
 
-    // Add padding
-    int padding = 1;
-    int width = ftFace_->glyph->bitmap.width;
-    int height = ftFace_->glyph->bitmap.rows;
+void VulkanTextRenderer::beginFrame() {
+  lastFrameStats_ = frameStats_;
+  frameStats_ = FrameStats{};
+  if (!device_)
+    return;
 
-    // Check if we need to move to next row
-    if (atlasOffsetX_ + width + padding >= ATLAS_WIDTH) {
-      atlasOffsetX_ = 0;
-      atlasOffsetY_ += atlasRowHeight_ + padding;
-      atlasRowHeight_ = 0;
-    }
+  // The frame that last used this slot has retired (the caller keeps
+  // fewer than kFramesInFlight in flight), so its instances are free; its
+  // staging memory is free once the slot's last upload has completed
+  frameSlot_ = (frameSlot_ + 1) % kFramesInFlight;
+  waitForSlot(frameSlots_[frameSlot_]);
+  instanceCursor_ = 0;
 
-    if (atlasOffsetY_ + height >= ATLAS_HEIGHT) {
-      std::cerr << "ERROR::TEXT_RENDERER: Font atlas full" << std::endl;
-      break;
-    }
+  atlas_.beginFrame();
+  for (auto &page : queued_)
+    page.clear();
+}
 
-    // Upload glyph to atlas
-    if (width > 0 && height > 0) {
-      updateAtlas(
-          std::vector<uint8_t>(ftFace_->glyph->bitmap.buffer,
-                               ftFace_->glyph->bitmap.buffer + width * height),
-          atlasOffsetX_, atlasOffsetY_, width, height);
-    }
+void VulkanTextRenderer::waitForSlot(FrameSlot &slot) {
+  if (!slot.uploadPending)
+    return;
+  vkWaitForFences(device_, 1, &slot.uploadFence, VK_TRUE, UINT64_MAX);
+  vkResetFences(device_, 1, &slot.uploadFence);
+  vkFreeCommandBuffers(device_, commandPool_, 1, &slot.uploadCommands);
+  slot.uploadCommands = VK_NULL_HANDLE;
+  slot.uploadPending = false;
+}
 
-    // Calculate UVs
-    float uMin = (float)atlasOffsetX_ / ATLAS_WIDTH;
-    float vMin = (float)atlasOffsetY_ / ATLAS_HEIGHT;
-    float uMax = (float)(atlasOffsetX_ + width) / ATLAS_WIDTH;
-    float vMax = (float)(atlasOffsetY_ + height) / ATLAS_HEIGHT;
+const OSFGlyphEntry *VulkanTextRenderer::rasterizeGlyph(uint32_t glyphIndex) {
+  OSFGlyphKey key{fontId_, fontSize_, glyphIndex};
+  if (const OSFGlyphEntry *entry = atlas_.find(key))
+    return entry;
 
-    Character character = {
-        0,
-        glm::ivec2(width, height),
-        glm::ivec2(ftFace_->glyph->bitmap_left, ftFace_->glyph->bitmap_top),
-        static_cast<uint32_t>(ftFace_->glyph->advance.x),
-        glm::vec2(uMin, vMin),
-        glm::vec2(uMax, vMax)};
-    characters_.insert(std::pair<char, Character>(c, character));
+  if (FT_Load_Glyph(ftFace_, glyphIndex, FT_LOAD_RENDER)) {
+    return nullptr;
+  }
 
-    atlasOffsetX_ += width + padding;
-    atlasRowHeight_ = std::max(atlasRowHeight_, height);
+  FT_GlyphSlot slot = ftFace_->glyph;
+  const FT_Bitmap &bitmap = slot->bitmap;
+  if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
+    // Colour and 1-bit strikes are not supported; keep the advance only
+    return atlas_.insert(key, 0, 0, nullptr, 0, slot->bitmap_left,
+                         slot->bitmap_top);
   }
+  return atlas_.insert(key, static_cast<int>(bitmap.width),
+                       static_cast<int>(bitmap.rows), bitmap.buffer,
+                       bitmap.pitch, slot->bitmap_left, slot->bitmap_top);
+}
 
-  return true;
+float VulkanTextRenderer::shapeText(const std::string &text,
+                                    std::vector<PositionedGlyph> *glyphs) {
+  if (!hbFont_ || text.empty())
+    return 0.0f;
+
+  hb_buffer_clear_contents(hbBuffer_);
+  hb_buffer_add_utf8(hbBuffer_, text.c_str(), static_cast<int>(text.size()),
+                     0, -1);
+  hb_buffer_guess_segment_properties(hbBuffer_);
+  hb_shape(hbFont_, hbBuffer_, nullptr, 0);
+
+  unsigned int count = 0;
+  hb_glyph_info_t *infos = hb_buffer_get_glyph_infos(hbBuffer_, &count);
+  hb_glyph_position_t *positions =
+      hb_buffer_get_glyph_positions(hbBuffer_, &count);
+
+  // Positions are 26.6 fixed point at the face's pixel size
+  float penX = 0.0f;
+  float penY = 0.0f;
+  for (unsigned int i = 0; i < count; i++) {
+    if (glyphs) {
+      const OSFGlyphEntry *entry = rasterizeGlyph(infos[i].codepoint);
+      if (entry && entry->page != OSFGlyphEntry::kNoPage) {
+        glyphs->push_back({entry, penX + positions[i].x_offset / 64.0f,
+                           penY + positions[i].y_offset / 64.0f});
+      }
+    }
+    penX += positions[i].x_advance / 64.0f;
+    penY += positions[i].y_advance / 64.0f;
+  }
+  return penX;
 }
 
-void VulkanTextRenderer::createAtlasTexture() {
+void VulkanTextRenderer::createAtlasSampler() {
+  VkSamplerCreateInfo samplerInfo{};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.anisotropyEnable = VK_FALSE;
+  samplerInfo.maxAnisotropy = 1.0f;
+  samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+  samplerInfo.unnormalizedCoordinates = VK_FALSE;
+  samplerInfo.compareEnable = VK_FALSE;
+  samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+
+  if (vkCreateSampler(device_, &samplerInfo, nullptr, &atlasSampler_) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create texture sampler!");
+  }
+}
+
+void VulkanTextRenderer::createAtlasPage() {
+  AtlasPage page;
+  const uint32_t pageSize = static_cast<uint32_t>(atlas_.pageSize());
+
   // Create image
   VkImageCreateInfo imageInfo{};
   imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
   imageInfo.imageType = VK_IMAGE_TYPE_2D;
-  imageInfo.extent.width = ATLAS_WIDTH;
-  imageInfo.extent.height = ATLAS_HEIGHT;
+  imageInfo.extent.width = pageSize;
+  imageInfo.extent.height = pageSize;
   imageInfo.extent.depth = 1;
   imageInfo.mipLevels = 1;
   imageInfo.arrayLayers = 1;
@@ -305,13 +286,13 @@ void VulkanTextRenderer::createAtlasTexture() {
   imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
   imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 
-  if (vkCreateImage(device_, &imageInfo, nullptr, &atlasImage_) != VK_SUCCESS) {
+  if (vkCreateImage(device_, &imageInfo, nullptr, &page.image) != VK_SUCCESS) {
     throw std::runtime_error("failed to create atlas image!");
   }
 
   // Allocate memory
   VkMemoryRequirements memRequirements;
-  vkGetImageMemoryRequirements(device_, atlasImage_, &memRequirements);
+  vkGetImageMemoryRequirements(device_, page.image, &memRequirements);
 
   VkMemoryAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -319,17 +300,17 @@ void VulkanTextRenderer::createAtlasTexture() {
   allocInfo.memoryTypeIndex = findMemoryType(
       memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-  if (vkAllocateMemory(device_, &allocInfo, nullptr, &atlasMemory_) !=
+  if (vkAllocateMemory(device_, &allocInfo, nullptr, &page.memory) !=
       VK_SUCCESS) {
     throw std::runtime_error("failed to allocate atlas image memory!");
   }
 
-  vkBindImageMemory(device_, atlasImage_, atlasMemory_, 0);
+  vkBindImageMemory(device_, page.image, page.memory, 0);
 
   // Create View
   VkImageViewCreateInfo viewInfo{};
   viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-  viewInfo.image = atlasImage_;
+  viewInfo.image = page.image;
   viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
   viewInfo.format = VK_FORMAT_R8_UNORM;
   viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -338,49 +319,117 @@ void VulkanTextRenderer::createAtlasTexture() {
   viewInfo.subresourceRange.baseArrayLayer = 0;
   viewInfo.subresourceRange.layerCount = 1;
 
-  if (vkCreateImageView(device_, &viewInfo, nullptr, &atlasView_) !=
+  if (vkCreateImageView(device_, &viewInfo, nullptr, &page.view) !=
       VK_SUCCESS) {
     throw std::runtime_error("failed to create texture image view!");
   }
 
-  // Create Sampler
-  VkSamplerCreateInfo samplerInfo{};
-  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-  samplerInfo.magFilter = VK_FILTER_LINEAR;
-  samplerInfo.minFilter = VK_FILTER_LINEAR;
-  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-  samplerInfo.anisotropyEnable = VK_FALSE;
-  samplerInfo.maxAnisotropy = 1.0f;
-  samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-  samplerInfo.unnormalizedCoordinates = VK_FALSE;
-  samplerInfo.compareEnable = VK_FALSE;
-  samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  // One descriptor set per page; draws bind the page they sample
+  VkDescriptorSetAllocateInfo descriptorAllocInfo{};
+  descriptorAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  descriptorAllocInfo.descriptorPool = descriptorPool_;
+  descriptorAllocInfo.descriptorSetCount = 1;
+  descriptorAllocInfo.pSetLayouts = &descriptorSetLayout_;
 
-  if (vkCreateSampler(device_, &samplerInfo, nullptr, &atlasSampler_) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("failed to create texture sampler!");
+  if (vkAllocateDescriptorSets(device_, &descriptorAllocInfo,
+                               &page.descriptorSet) != VK_SUCCESS) {
+    throw std::runtime_error("failed to allocate descriptor sets!");
   }
+
+  VkDescriptorImageInfo descriptorImageInfo{};
+  descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  descriptorImageInfo.imageView = page.view;
+  descriptorImageInfo.sampler = atlasSampler_;
+
+  VkWriteDescriptorSet descriptorWrite{};
+  descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrite.dstSet = page.descriptorSet;
+  descriptorWrite.dstBinding = 0;
+  descriptorWrite.dstArrayElement = 0;
+  descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  descriptorWrite.descriptorCount = 1;
+  descriptorWrite.pImageInfo = &descriptorImageInfo;
+
+  vkUpdateDescriptorSets(device_, 1, &descriptorWrite, 0, nullptr);
+
+  atlasPages_.push_back(page);
 }
 
-void VulkanTextRenderer::updateAtlas(const std::vector<uint8_t> &buffer, int x,
-                                     int y, int w, int h) {
-  // Ideally this would use a staging buffer
-  VkDeviceSize imageSize = w * h;
+void VulkanTextRenderer::destroyAtlasPages() {
+  // Descriptor sets go with the pool
+  for (AtlasPage &page : atlasPages_) {
+    if (page.view)
+      vkDestroyImageView(device_, page.view, nullptr);
+    if (page.image)
+      vkDestroyImage(device_, page.image, nullptr);
+    if (page.memory)
+      vkFreeMemory(device_, page.memory, nullptr);
+  }
+  atlasPages_.clear();
+}
 
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingBufferMemory;
-  createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               stagingBuffer, stagingBufferMemory);
+void VulkanTextRenderer::submitAtlasUploads() {
+  std::vector<OSFGlyphAtlas::DirtyRegion> regions = atlas_.takeDirtyRegions();
+  if (regions.empty())
+    return;
 
-  void *data;
-  vkMapMemory(device_, stagingBufferMemory, 0, imageSize, 0, &data);
-  memcpy(data, buffer.data(), static_cast<size_t>(imageSize));
-  vkUnmapMemory(device_, stagingBufferMemory);
+  while (atlasPages_.size() < atlas_.pageCount()) {
+    createAtlasPage();
+  }
+
+  // A second upload in the same frame (immediate drawText() calls) first
+  // waits for the slot's previous one, which frees its staging memory
+  FrameSlot &slot = frameSlots_[frameSlot_];
+  waitForSlot(slot);
+
+  // Pack every region into the slot's staging buffer
+  VkDeviceSize totalSize = 0;
+  for (const auto &region : regions) {
+    totalSize += static_cast<VkDeviceSize>(region.width) * region.height;
+  }
+  if (totalSize > slot.stagingSize) {
+    if (slot.stagingBuffer)
+      vkDestroyBuffer(device_, slot.stagingBuffer, nullptr);
+    if (slot.stagingMemory)
+      vkFreeMemory(device_, slot.stagingMemory, nullptr);
+    // Round up so a few new glyphs a frame do not reallocate every time
+    VkDeviceSize size = std::max<VkDeviceSize>(totalSize, 64 * 1024);
+    createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 slot.stagingBuffer, slot.stagingMemory);
+    void *data;
+    vkMapMemory(device_, slot.stagingMemory, 0, VK_WHOLE_SIZE, 0, &data);
+    slot.staging = static_cast<uint8_t *>(data);
+    slot.stagingSize = size;
+  }
+
+  std::vector<VkBufferImageCopy> copies;
+  copies.reserve(regions.size());
+  VkDeviceSize offset = 0;
+  const int pageSize = atlas_.pageSize();
+  for (const auto &region : regions) {
+    const uint8_t *src = atlas_.pagePixels(region.page);
+    for (int row = 0; row < region.height; row++) {
+      memcpy(slot.staging + offset + static_cast<size_t>(row) * region.width,
+             src + static_cast<size_t>(region.y + row) * pageSize + region.x,
+             region.width);
+    }
+
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = offset;
+    copy.bufferRowLength = 0;
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = 0;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset = {region.x, region.y, 0};
+    copy.imageExtent = {(uint32_t)region.width, (uint32_t)region.height, 1};
+    copies.push_back(copy);
+
+    offset += static_cast<VkDeviceSize>(region.width) * region.height;
+  }
 
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -397,19 +446,56 @@ void VulkanTextRenderer::updateAtlas(const std::vector<uint8_t> &buffer, int x,
 
   vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
-  VkBufferImageCopy region{};
-  region.bufferOffset = 0;
-  region.bufferRowLength = 0;
-  region.bufferImageHeight = 0;
-  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  region.imageSubresource.mipLevel = 0;
-  region.imageSubresource.baseArrayLayer = 0;
-  region.imageSubresource.layerCount = 1;
-  region.imageOffset = {x, y, 0};
-  region.imageExtent = {(uint32_t)w, (uint32_t)h, 1};
-
-  vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, atlasImage_,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  // Regions come grouped by page: one transition pair and copy per page
+  for (size_t first = 0; first < regions.size();) {
+    size_t last = first;
+    while (last < regions.size() && regions[last].page == regions[first].page)
+      last++;
+    AtlasPage &page = atlasPages_[regions[first].page];
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = page.initialized
+                            ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                            : VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = page.image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = page.initialized ? VK_ACCESS_SHADER_READ_BIT : 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    // Earlier frames on this queue may still be sampling the page
+    vkCmdPipelineBarrier(commandBuffer,
+                         page.initialized
+                             ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                             : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+
+    vkCmdCopyBufferToImage(commandBuffer, slot.stagingBuffer, page.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(last - first),
+                           copies.data() + first);
+
+    // Makes the copy visible to the frame's draws, which are submitted to
+    // the same queue after this
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+
+    page.initialized = true;
+    first = last;
+  }
 
   vkEndCommandBuffer(commandBuffer);
 
@@ -418,12 +504,14 @@ void VulkanTextRenderer::updateAtlas(const std::vector<uint8_t> &buffer, int x,
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &commandBuffer;
 
-  vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(queue_);
+  // No wait: queue order and the barriers above put the copies before the
+  // frame's command buffer, which is submitted after flush() returns
+  vkQueueSubmit(queue_, 1, &submitInfo, slot.uploadFence);
+  slot.uploadCommands = commandBuffer;
+  slot.uploadPending = true;
 
-  vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer);
-  vkDestroyBuffer(device_, stagingBuffer, nullptr);
-  vkFreeMemory(device_, stagingBufferMemory, nullptr);
+  frameStats_.submits++;
+  frameStats_.uploadBytes += totalSize;
 }
 
 VkShaderModule createShaderModule(VkDevice device, const uint32_t *code,
@@ -466,27 +554,27 @@ void VulkanTextRenderer::createPipeline(VkRenderPass renderPass) {
   VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo,
                                                     fragShaderStageInfo};
 
-  // 2. Vertex Input
+  // 2. Vertex Input: one GlyphInstance per quad, no per-vertex data
   VkVertexInputBindingDescription bindingDescription{};
   bindingDescription.binding = 0;
-  bindingDescription.stride = sizeof(TextVertex);
-  bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  bindingDescription.stride = sizeof(GlyphInstance);
+  bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
   std::vector<VkVertexInputAttributeDescription> attributeDescriptions(3);
   attributeDescriptions[0].binding = 0;
   attributeDescriptions[0].location = 0;
-  attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT; // pos
-  attributeDescriptions[0].offset = offsetof(TextVertex, pos);
+  attributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT; // rect
+  attributeDescriptions[0].offset = offsetof(GlyphInstance, rect);
 
   attributeDescriptions[1].binding = 0;
   attributeDescriptions[1].location = 1;
-  attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT; // texCoord
-  attributeDescriptions[1].offset = offsetof(TextVertex, texCoord);
+  attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT; // texRect
+  attributeDescriptions[1].offset = offsetof(GlyphInstance, texRect);
 
   attributeDescriptions[2].binding = 0;
   attributeDescriptions[2].location = 2;
   attributeDescriptions[2].format = VK_FORMAT_R32G32B32A32_SFLOAT; // color
-  attributeDescriptions[2].offset = offsetof(TextVertex, color);
+  attributeDescriptions[2].offset = offsetof(GlyphInstance, color);
 
   VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
   vertexInputInfo.sType =
@@ -500,7 +588,7 @@ void VulkanTextRenderer::createPipeline(VkRenderPass renderPass) {
   VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
   inputAssembly.sType =
       VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-  inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
   inputAssembly.primitiveRestartEnable = VK_FALSE;
 
   // Viewport & Scissor (Dynamic)
@@ -590,49 +678,22 @@ void VulkanTextRenderer::createPipeline(VkRenderPass renderPass) {
     throw std::runtime_error("failed to create pipeline layout!");
   }
 
-  // Create Descriptor Pool and Set
+  // Descriptor Pool: a set per atlas page, allocated as pages appear
   VkDescriptorPoolSize poolSize{};
   poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  poolSize.descriptorCount = 1;
+  poolSize.descriptorCount = static_cast<uint32_t>(atlas_.maxPages());
 
   VkDescriptorPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
   poolInfo.poolSizeCount = 1;
   poolInfo.pPoolSizes = &poolSize;
-  poolInfo.maxSets = 1;
+  poolInfo.maxSets = static_cast<uint32_t>(atlas_.maxPages());
 
   if (vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_) !=
       VK_SUCCESS) {
     throw std::runtime_error("failed to create descriptor pool!");
   }
 
-  VkDescriptorSetAllocateInfo descriptorAllocInfo{};
-  descriptorAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-  descriptorAllocInfo.descriptorPool = descriptorPool_;
-  descriptorAllocInfo.descriptorSetCount = 1;
-  descriptorAllocInfo.pSetLayouts = &descriptorSetLayout_;
-
-  if (vkAllocateDescriptorSets(device_, &descriptorAllocInfo,
-                               &descriptorSet_) != VK_SUCCESS) {
-    throw std::runtime_error("failed to allocate descriptor sets!");
-  }
-
-  VkDescriptorImageInfo imageInfo{};
-  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  imageInfo.imageView = atlasView_;
-  imageInfo.sampler = atlasSampler_;
-
-  VkWriteDescriptorSet descriptorWrite{};
-  descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrite.dstSet = descriptorSet_;
-  descriptorWrite.dstBinding = 0;
-  descriptorWrite.dstArrayElement = 0;
-  descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  descriptorWrite.descriptorCount = 1;
-  descriptorWrite.pImageInfo = &imageInfo;
-
-  vkUpdateDescriptorSets(device_, 1, &descriptorWrite, 0, nullptr);
-
   VkGraphicsPipelineCreateInfo pipelineInfo{};
   pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
   pipelineInfo.stageCount = 2;
@@ -658,82 +719,95 @@ void VulkanTextRenderer::createPipeline(VkRenderPass renderPass) {
   vkDestroyShaderModule(device_, vertShaderModule, nullptr);
 }
 
-void VulkanTextRenderer::createVertexBuffer() {
-  // 5000 characters ring buffer
-  vertexBufferSize_ = sizeof(TextVertex) * 6 * 5000;
-  createBuffer(vertexBufferSize_, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+void VulkanTextRenderer::createFrameResources() {
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  for (FrameSlot &slot : frameSlots_) {
+    if (vkCreateFence(device_, &fenceInfo, nullptr, &slot.uploadFence) !=
+        VK_SUCCESS) {
+      throw std::runtime_error("failed to create upload fence!");
+    }
+  }
+
+  createBuffer(sizeof(GlyphInstance) * kMaxGlyphsPerFrame * kFramesInFlight,
+               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               vertexBuffer_, vertexBufferMemory_);
-}
-
-void VulkanTextRenderer::drawText(VkCommandBuffer commandBuffer,
-                                  const std::string &text, float x, float y,
-                                  float scale, const glm::vec4 &color) {
-  if (text.empty())
-    return;
+               instanceBuffer_, instanceMemory_);
+  void *data;
+  vkMapMemory(device_, instanceMemory_, 0, VK_WHOLE_SIZE, 0, &data);
+  instances_ = static_cast<GlyphInstance *>(data);
 
-  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+  queued_.resize(atlas_.maxPages());
+}
 
-  std::vector<TextVertex> vertices;
-  for (char c : text) {
-    if (characters_.find(c) == characters_.end())
-      continue;
+void VulkanTextRenderer::destroyFrameResources() {
+  for (FrameSlot &slot : frameSlots_) {
+    if (slot.uploadCommands)
+      vkFreeCommandBuffers(device_, commandPool_, 1, &slot.uploadCommands);
+    if (slot.uploadFence)
+      vkDestroyFence(device_, slot.uploadFence, nullptr);
+    if (slot.stagingBuffer)
+      vkDestroyBuffer(device_, slot.stagingBuffer, nullptr);
+    if (slot.stagingMemory)
+      vkFreeMemory(device_, slot.stagingMemory, nullptr); // Unmaps
+    slot = FrameSlot{};
+  }
 
-    Character ch = characters_[c];
+  if (instanceBuffer_)
+    vkDestroyBuffer(device_, instanceBuffer_, nullptr);
+  if (instanceMemory_)
+    vkFreeMemory(device_, instanceMemory_, nullptr);
+  instanceBuffer_ = VK_NULL_HANDLE;
+  instanceMemory_ = VK_NULL_HANDLE;
+  instances_ = nullptr;
+  instanceCursor_ = 0;
+  queued_.clear();
+}
 
-    float xpos = x + ch.bearing.x * scale;
-    float ypos = y - (ch.size.y - ch.bearing.y) * scale;
+void VulkanTextRenderer::queueText(const std::string &text, float x, float y,
+                                   float scale, const glm::vec4 &color) {
+  if (text.empty() || !hbFont_ || queued_.empty())
+    return;
 
-    float w = ch.size.x * scale;
-    float h = ch.size.y * scale;
+  shaped_.clear();
+  shapeText(text, &shaped_);
+  frameStats_.strings++;
+  frameStats_.glyphs += static_cast<uint32_t>(shaped_.size());
 
-    vertices.push_back({{xpos, ypos + h}, {ch.uvMin.x, ch.uvMax.y}, color});
-    vertices.push_back({{xpos, ypos}, {ch.uvMin.x, ch.uvMin.y}, color});
-    vertices.push_back({{xpos + w, ypos}, {ch.uvMax.x, ch.uvMin.y}, color});
+  for (const PositionedGlyph &glyph : shaped_) {
+    const OSFGlyphEntry &ch = *glyph.entry;
 
-    vertices.push_back({{xpos, ypos + h}, {ch.uvMin.x, ch.uvMax.y}, color});
-    vertices.push_back({{xpos + w, ypos}, {ch.uvMax.x, ch.uvMin.y}, color});
-    vertices.push_back({{xpos + w, ypos + h}, {ch.uvMax.x, ch.uvMax.y}, color});
+    float xpos = x + (glyph.x + ch.bearingX) * scale;
+    float ypos = y + (glyph.y - (ch.height - ch.bearingY)) * scale;
 
-    x += (ch.advance >> 6) * scale;
+    // Corner (0, 0) samples (u0, v0), matching the old quad layout
+    queued_[ch.page].push_back({{xpos, ypos, ch.width * scale,
+                                 ch.height * scale},
+                                {ch.u0, ch.v0, ch.u1, ch.v1},
+                                color});
   }
+}
 
-  if (vertices.empty())
-    return;
-
-  // Check size limit
-  VkDeviceSize dataSize = vertices.size() * sizeof(TextVertex);
-  if (dataSize > vertexBufferSize_) {
-    std::cerr << "Text too long for vertex buffer!" << std::endl;
+void VulkanTextRenderer::flush(VkCommandBuffer commandBuffer) {
+  if (!device_)
     return;
-  }
 
-  // Ring Buffer Logic: Simple implementation
-  // If it fits at current offset, write there. If not, wrap around.
-  // NOTE: In production, we need fences or multiple buffers.
-  // We add a heavy-handed waitIdle to prevent race conditions when wrapping.
-  static VkDeviceSize currentOffset = 0;
+  // Every glyph new this frame goes up in one submission
+  submitAtlasUploads();
 
-  if (currentOffset + dataSize > vertexBufferSize_) {
-    // Wait for device to be idle before resetting buffer to avoid overwriting
-    // data in use
-    vkDeviceWaitIdle(device_);
-    currentOffset = 0;
-  }
+  size_t queued = 0;
+  for (const auto &page : queued_)
+    queued += page.size();
+  if (queued == 0)
+    return;
 
-  void *data;
-  vkMapMemory(device_, vertexBufferMemory_, currentOffset, dataSize, 0, &data);
-  memcpy(data, vertices.data(), static_cast<size_t>(dataSize));
-  vkUnmapMemory(device_, vertexBufferMemory_);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
 
-  VkBuffer vertexBuffers[] = {vertexBuffer_};
-  VkDeviceSize offsets[] = {currentOffset};
+  VkBuffer vertexBuffers[] = {instanceBuffer_};
+  VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 
-  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          pipelineLayout_, 0, 1, &descriptorSet_, 0, nullptr);
-
   // Set Dynamic Viewport & Scissor to avoid undefined behavior
   VkViewport viewport{};
   viewport.x = 0.0f;
@@ -778,20 +852,45 @@ void VulkanTextRenderer::drawText(VkCommandBuffer commandBuffer,
   vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT,
                      0, sizeof(pc), &pc);
 
-  vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
+  // One instanced draw per atlas page, each a contiguous run of the slot
+  const uint32_t slotBase = frameSlot_ * kMaxGlyphsPerFrame;
+  for (uint32_t page = 0; page < queued_.size(); page++) {
+    std::vector<GlyphInstance> &glyphs = queued_[page];
+    if (glyphs.empty())
+      continue;
 
-  currentOffset += dataSize;
+    uint32_t count = static_cast<uint32_t>(glyphs.size());
+    if (instanceCursor_ + count > kMaxGlyphsPerFrame) {
+      std::cerr << "Text batch full: dropping "
+                << count - (kMaxGlyphsPerFrame - instanceCursor_)
+                << " glyphs this frame" << std::endl;
+      count = kMaxGlyphsPerFrame - instanceCursor_;
+    }
+    if (count > 0) {
+      const uint32_t firstInstance = slotBase + instanceCursor_;
+      memcpy(instances_ + firstInstance, glyphs.data(),
+             count * sizeof(GlyphInstance));
+      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipelineLayout_, 0, 1,
+                              &atlasPages_[page].descriptorSet, 0, nullptr);
+      vkCmdDraw(commandBuffer, 4, count, 0, firstInstance);
+      instanceCursor_ += count;
+      frameStats_.drawCalls++;
+    }
+    glyphs.clear();
+  }
+}
+
+void VulkanTextRenderer::drawText(VkCommandBuffer commandBuffer,
+                                  const std::string &text, float x, float y,
+                                  float scale, const glm::vec4 &color) {
+  queueText(text, x, y, scale, color);
+  flush(commandBuffer);
 }
 
 float VulkanTextRenderer::measureTextWidth(const std::string &text,
                                            float scale) {
-  float width = 0;
-  for (char c : text) {
-    if (characters_.find(c) != characters_.end()) {
-      width += (characters_[c].advance >> 6) * scale;
-    }
-  }
-  return width;
+  return shapeText(text, nullptr) * scale;
 }
 
 uint32_t VulkanTextRenderer::findMemoryType(uint32_t typeFilter,
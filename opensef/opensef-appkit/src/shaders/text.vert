@@ -1,7 +1,8 @@
 #version 450
 
-layout(location = 0) in vec2 inPos;
-layout(location = 1) in vec2 inTexCoord;
+// One instance per glyph quad, drawn as a 4-vertex triangle strip
+layout(location = 0) in vec4 inRect;     // x, y, width, height
+layout(location = 1) in vec4 inTexRect;  // u0, v0, u1, v1
 layout(location = 2) in vec4 inColor;
 
 layout(location = 0) out vec2 fragTexCoord;
@@ -14,7 +15,9 @@ layout(push_constant) uniform PushConstants {
 } pc;
 
 void main() {
-    gl_Position = pc.projection * pc.view * vec4(inPos, 0.0, 1.0);
-    fragTexCoord = inTexCoord;
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 pos = inRect.xy + corner * inRect.zw;
+    gl_Position = pc.projection * pc.view * vec4(pos, 0.0, 1.0);
+    fragTexCoord = mix(inTexRect.xy, inTexRect.zw, corner);
     fragColor = inColor;
 }
@@ -9,6 +9,8 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <opensef/OSFGeometry.h>
@@ -66,6 +68,39 @@ inline double spring(double t) {
 
 using EasingFunction = std::function<double(double)>;
 
+// Built-in curves, dispatched at compile time by the batch engine. An
+// EasingFunction holding one of the Easing:: functions maps back to its
+// curve; anything else is Custom and goes through the std::function.
+enum class EasingCurve : uint8_t {
+  Linear,
+  EaseIn,
+  EaseOut,
+  EaseInOut,
+  Spring,
+  Custom
+};
+
+constexpr std::size_t kBuiltinEasingCurveCount =
+    static_cast<std::size_t>(EasingCurve::Custom);
+
+EasingCurve easingCurveFor(const EasingFunction &easing);
+
+template <EasingCurve Curve> inline double ease(double t) {
+  if constexpr (Curve == EasingCurve::EaseIn)
+    return Easing::easeIn(t);
+  else if constexpr (Curve == EasingCurve::EaseOut)
+    return Easing::easeOut(t);
+  else if constexpr (Curve == EasingCurve::EaseInOut)
+    return Easing::easeInOut(t);
+  else if constexpr (Curve == EasingCurve::Spring)
+    return Easing::spring(t);
+  else
+    return t;
+}
+
+/** Runtime dispatch over the built-in curves (Custom is treated as Linear). */
+double ease(EasingCurve curve, double t);
+
 // =============================================================================
 // OSFAnimation - Base Animation Class
 // =============================================================================
@@ -100,6 +135,9 @@ public:
   // Called every frame by the animation manager
   virtual void tick();
 
+  // Advance to a given time; the manager samples the clock once per frame
+  void tick(Clock::time_point now);
+
   // Get current progress (0.0 to 1.0, with easing applied)
   double progress() const { return progress_; }
   double rawProgress() const { return rawProgress_; }
@@ -110,6 +148,7 @@ protected:
   double duration_ = AnimationTiming::Standard;
   double delay_ = 0.0;
   EasingFunction easing_ = Easing::easeOut;
+  EasingCurve curve_ = EasingCurve::EaseOut;
   int repeatCount_ = 0;
   bool autoReverse_ = false;
 
@@ -173,7 +212,9 @@ protected:
 
 private:
   double *target_;
-  std::vector<Keyframe> keyframes_;
+  std::vector<Keyframe> keyframes_;  // Sorted by time
+  std::vector<double> times_;        // keyframes_[i].time, for binary search
+  std::vector<EasingCurve> curves_;  // easingCurveFor(keyframes_[i].easing)
 };
 
 // =============================================================================
@@ -215,6 +256,67 @@ private:
   friend class OSFAnimationManager;
 };
 
+// =============================================================================
+// OSFAnimationBatch - Structure-of-arrays property animations
+// =============================================================================
+
+/**
+ * Holds fire-and-forget "animate this double from A to B" tracks, one lane
+ * per built-in easing curve, each lane a set of parallel arrays. evaluate()
+ * runs timing and easing for a whole lane in SSE2/AVX2/NEON kernels (the
+ * polynomial curves; Spring needs exp/cos and stays scalar), then a bulk
+ * write-back to the targets. Used for implicit OSFLayer animations, where
+ * hundreds of tracks may be in flight. Main thread only.
+ */
+class OSFAnimationBatch {
+public:
+  enum class Path { Scalar, SSE2, AVX2, NEON };
+
+  // Fastest path this CPU supports, unless forced to scalar
+  static Path path();
+  static const char *pathName(Path path);
+
+  // Use the scalar loops (for comparisons and benchmarks)
+  static void setForceScalar(bool forceScalar);
+
+  /**
+   * Animate *target from -> to. times are seconds on the caller's clock.
+   * A track already driving target is replaced (it continues from wherever
+   * the caller's `from` says).
+   */
+  void add(double *target, double from, double to, double startTime,
+           double duration, EasingCurve curve);
+
+  /** Stop animating target, leaving its current value. */
+  bool cancel(double *target);
+
+  /** Stop every track whose target lies in [begin, end) - e.g. an object. */
+  void cancelRange(const void *begin, const void *end);
+
+  /** Write values for time now and drop finished tracks. */
+  void evaluate(double now);
+
+  std::size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+private:
+  struct Lane {
+    std::vector<double *> targets;
+    std::vector<double> from;
+    std::vector<double> to;
+    std::vector<double> start;
+    std::vector<double> invDuration;
+    std::vector<double> values; // Scratch for the bulk write-back
+  };
+
+  template <EasingCurve Curve> void evaluateLane(Lane &lane, double now);
+  void removeAt(std::size_t laneIndex, std::size_t i);
+
+  Lane lanes_[kBuiltinEasingCurveCount];
+  // target -> (lane << 32 | slot), for replacement and cancellation
+  std::unordered_map<double *, uint64_t> index_;
+};
+
 // =============================================================================
 // OSFAnimationManager - Global Animation Coordinator
 // =============================================================================
@@ -229,15 +331,42 @@ public:
   // Remove completed animations
   void removeCompletedAnimations();
 
+  /**
+   * Animate a plain double without an OSFAnimation object (batch engine).
+   * Replaces any batch track already driving target.
+   */
+  void animateValue(double *target, double from, double to, double duration,
+                    EasingCurve curve = EasingCurve::EaseOut,
+                    double delay = 0.0);
+
+  // Stop batch tracks (leaving current values), e.g. before a layer dies
+  void cancelValueAnimation(double *target);
+  void cancelValueAnimations(const void *begin, const void *end);
+
   // Called every frame to update all animations
   void tick();
 
+  // Same, sampling every animation at frameTime - normally the predicted
+  // presentation time from an OSFWindow frame clock. Never earlier than the
+  // previous tick's frame time, whichever clock that came from.
+  void tick(OSFAnimation::Clock::time_point frameTime);
+
+  // Wall-clock time of the last tick (for detecting stalled frame clocks)
+  OSFAnimation::Clock::time_point lastTickTime() const { return lastTick_; }
+
   // Check if any animations are running
   bool hasActiveAnimations() const;
 
 private:
-  OSFAnimationManager() = default;
+  OSFAnimationManager() : epoch_(OSFAnimation::Clock::now()) {}
+
+  double secondsSinceEpoch(OSFAnimation::Clock::time_point time) const;
+
   std::vector<std::shared_ptr<OSFAnimation>> animations_;
+  OSFAnimationBatch batch_;
+  OSFAnimation::Clock::time_point epoch_;
+  OSFAnimation::Clock::time_point lastTick_;
+  OSFAnimation::Clock::time_point lastFrameTime_;
 };
 
 } // namespace opensef
@@ -0,0 +1,299 @@
+/**
+ * OSFCoroutine.h - C++20 coroutines on top of OSFRunLoop
+ *
+ * Lets async UI flows read as straight-line code without blocking the UI
+ * thread. Every awaitable resumes the coroutine on the owning run loop
+ * (by default the OSFApplication loop), never on a worker thread.
+ *
+ *   OSFAsync<void> unlock(std::string user, std::string password) {
+ *     bool ok = co_await offload([=] {
+ *       return OSFAuth::authenticate(user, password); // PAM, may block
+ *     });
+ *     co_await nextFrame(*window);
+ *     ok ? fadeOut() : shake();
+ *   }
+ *
+ * Coroutines start eagerly. Dropping the returned OSFAsync detaches it; the
+ * frame frees itself when the body finishes. Header-only; requires C++20.
+ * Part of opensef-base.
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "OSFCoroutine.h requires C++20 coroutines (compile with -std=c++20)"
+#endif
+
+#include <opensef/OSFTaskScheduler.h>
+#include <opensef/OSFWindow.h>
+#include <opensef/OpenSEFBase.h>
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <poll.h>
+#include <type_traits>
+#include <utility>
+
+namespace opensef {
+
+template <typename T = void> class OSFAsync;
+
+namespace detail {
+
+// Shared promise state. The frame is owned jointly by the OSFAsync handle
+// and the running body; whichever lets go last destroys it. All access is on
+// the run loop thread, so a plain counter is enough.
+struct OSFAsyncPromiseBase {
+  std::coroutine_handle<> continuation;
+  std::exception_ptr exception;
+  int refs = 2;
+
+  std::suspend_never initial_suspend() noexcept { return {}; }
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      auto &promise = handle.promise();
+      std::coroutine_handle<> next = promise.continuation
+                                         ? promise.continuation
+                                         : std::noop_coroutine();
+      if (--promise.refs == 0) {
+        // Detached: nobody will ever see the exception, so report it here
+        if (promise.exception) {
+          try {
+            std::rethrow_exception(promise.exception);
+          } catch (const std::exception &e) {
+            std::cerr << "[OSFAsync] Detached coroutine threw: " << e.what()
+                      << std::endl;
+          } catch (...) {
+            std::cerr << "[OSFAsync] Detached coroutine threw" << std::endl;
+          }
+        }
+        handle.destroy();
+      }
+      return next;
+    }
+
+    void await_resume() noexcept {}
+  };
+
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T> struct OSFAsyncPromise : OSFAsyncPromiseBase {
+  std::optional<T> value;
+
+  template <typename U> void return_value(U &&result) {
+    value.emplace(std::forward<U>(result));
+  }
+
+  T take() {
+    if (exception)
+      std::rethrow_exception(exception);
+    return std::move(*value);
+  }
+};
+
+template <> struct OSFAsyncPromise<void> : OSFAsyncPromiseBase {
+  void return_void() noexcept {}
+
+  void take() {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+};
+
+} // namespace detail
+
+// =============================================================================
+// OSFAsync - Eager, awaitable coroutine result
+// =============================================================================
+
+template <typename T> class OSFAsync {
+public:
+  struct promise_type : detail::OSFAsyncPromise<T> {
+    OSFAsync get_return_object() {
+      return OSFAsync(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+  };
+
+  OSFAsync(OSFAsync &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  OSFAsync &operator=(OSFAsync &&other) noexcept {
+    if (this != &other) {
+      release();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  OSFAsync(const OSFAsync &) = delete;
+  OSFAsync &operator=(const OSFAsync &) = delete;
+  ~OSFAsync() { release(); }
+
+  /** True once the body has returned (or thrown). */
+  bool isReady() const { return handle_ && handle_.done(); }
+
+  // Awaiting another OSFAsync chains continuations without a run loop hop.
+  bool await_ready() const noexcept { return handle_.done(); }
+  void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().continuation = awaiting;
+  }
+  T await_resume() { return handle_.promise().take(); }
+
+private:
+  explicit OSFAsync(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  void release() {
+    if (handle_ && --handle_.promise().refs == 0) {
+      handle_.destroy();
+    }
+    handle_ = nullptr;
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// =============================================================================
+// Awaitables
+// =============================================================================
+
+/**
+ * Suspend and resume on the next pass of runLoop.
+ * Also moves a coroutine onto runLoop's thread.
+ */
+inline auto resumeOn(OSFRunLoop &runLoop) {
+  struct Awaiter {
+    OSFRunLoop &loop;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      loop.postTask([handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+  };
+  return Awaiter{runLoop};
+}
+
+inline auto yieldToRunLoop() {
+  return resumeOn(OSFApplication::shared().runLoop());
+}
+
+/** Resume after delay, via OSFRunLoop::postDelayedTask. */
+inline auto sleepFor(OSFRunLoop::Clock::duration delay,
+                     OSFRunLoop &runLoop = OSFApplication::shared().runLoop()) {
+  struct Awaiter {
+    OSFRunLoop::Clock::duration delay;
+    OSFRunLoop &loop;
+    bool await_ready() const noexcept {
+      return delay <= OSFRunLoop::Clock::duration::zero();
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      loop.postDelayedTask([handle]() { handle.resume(); }, delay);
+    }
+    void await_resume() const noexcept {}
+  };
+  return Awaiter{delay, runLoop};
+}
+
+/**
+ * Resume once fd reports any of events (POLLIN, POLLOUT, ...).
+ * co_await yields the poll() revents. Uses the OSFApplication loop.
+ */
+inline auto waitForFd(int fd, short events) {
+  struct Awaiter {
+    int fd;
+    short events;
+    short revents = 0;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      OSFApplication::shared().waitForFd(fd, events,
+                                         [this, handle](short ready) {
+                                           revents = ready;
+                                           handle.resume();
+                                         });
+    }
+    short await_resume() const noexcept { return revents; }
+  };
+  return Awaiter{fd, events};
+}
+
+inline auto waitReadable(int fd) { return waitForFd(fd, POLLIN); }
+inline auto waitWritable(int fd) { return waitForFd(fd, POLLOUT); }
+
+/**
+ * Resume on window's next frame callback.
+ * co_await yields the compositor frame timestamp in milliseconds.
+ */
+inline auto nextFrame(OSFWindow &window) {
+  struct Awaiter {
+    OSFWindow &window;
+    uint32_t time = 0;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      window.requestFrame([this, handle](uint32_t frameTime) {
+        time = frameTime;
+        handle.resume();
+      });
+    }
+    uint32_t await_resume() const noexcept { return time; }
+  };
+  return Awaiter{window};
+}
+
+/**
+ * Run work() on the shared OSFTaskScheduler, then resume on runLoop with
+ * its result. Exceptions thrown by work() are rethrown at the co_await.
+ */
+template <typename Work>
+auto offload(Work work, OSFTaskPriority priority = OSFTaskPriority::Normal,
+             OSFRunLoop &runLoop = OSFApplication::shared().runLoop()) {
+  using Result = std::invoke_result_t<Work &>;
+  using Stored = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+
+  struct Awaiter {
+    Work work;
+    OSFTaskPriority priority;
+    OSFRunLoop &loop;
+    std::optional<Stored> result;
+    std::exception_ptr exception;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      // Resume is posted unconditionally: a suspended coroutine must never
+      // be stranded, so offload() deliberately takes no cancellation token.
+      OSFTaskScheduler::shared().submit(
+          [this, handle]() {
+            try {
+              if constexpr (std::is_void_v<Result>) {
+                work();
+                result.emplace(true);
+              } else {
+                result.emplace(work());
+              }
+            } catch (...) {
+              exception = std::current_exception();
+            }
+            loop.postTask([handle]() { handle.resume(); });
+          },
+          priority);
+    }
+    Result await_resume() {
+      if (exception)
+        std::rethrow_exception(exception);
+      if constexpr (!std::is_void_v<Result>)
+        return std::move(*result);
+    }
+  };
+  return Awaiter{std::move(work), priority, runLoop, std::nullopt, nullptr};
+}
+
+} // namespace opensef
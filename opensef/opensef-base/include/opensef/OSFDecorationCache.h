@@ -0,0 +1,96 @@
+/**
+ * OSFDecorationCache.h - Pre-rendered Client-Side Decorations
+ *
+ * Holds OSFWindow's title bar as a few bitmaps that don't depend on the
+ * window width: a reference strip (corners, traffic lights, fill and
+ * separator), one patch per hovered button, and the title text. A frame
+ * of any width is composed from them: left edge, one repeated middle
+ * column, right edge, the hover patch, then the title. So resizing and
+ * animating cost a handful of blits, and a hover change only touches one
+ * button's rect.
+ *
+ * Everything is rasterized lazily and kept until the title or the
+ * active/inactive palette it was drawn for changes. The title is placed
+ * on whole pixels, which is the only difference from paint().
+ */
+
+#pragma once
+
+#include <cairo/cairo.h>
+#include <cstdint>
+#include <opensef/OSFGeometry.h>
+#include <string>
+
+namespace opensef {
+
+class OSFDecorationCache {
+public:
+  static constexpr int kTitlebarHeight = 38;
+  static constexpr int kHeight = 40; // Titlebar + lower half of separator
+  static constexpr double kCornerRadius = 9.0;
+
+  // Window widths below this are painted directly
+  static constexpr int kMinWidth = 96;
+
+  OSFDecorationCache() = default;
+  ~OSFDecorationCache();
+
+  OSFDecorationCache(const OSFDecorationCache &) = delete;
+  OSFDecorationCache &operator=(const OSFDecorationCache &) = delete;
+
+  /**
+   * Rasterize whatever draw() needs for this state. After this, draw()
+   * with the same state only reads the cache and may run on several
+   * threads at once (tile rendering).
+   */
+  void prepare(bool active, int hoveredButton, const std::string &title);
+
+  /**
+   * Replace rows [0, kHeight) with the title bar. hoveredButton is 0 for
+   * none, else 1 close, 2 minimize, 3 maximize.
+   */
+  void draw(cairo_t *cr, int width, bool active, int hoveredButton,
+            const std::string &title);
+
+  // Draw the same title bar from scratch (what the cache stores)
+  static void paint(cairo_t *cr, int width, bool active, int hoveredButton,
+                    const std::string &title);
+
+  // Pixels a hover change can touch for one button (1-3)
+  static OSFRect buttonRect(int button);
+
+  // Release every bitmap
+  void clear();
+
+  // Bitmaps rasterized so far (strips, patches and titles)
+  uint64_t rasterizations() const { return rasterizations_; }
+
+private:
+  static constexpr int kLeft = 80;  // Corner and traffic lights
+  static constexpr int kRight = 12; // Corner
+  static constexpr int kReferenceWidth = kLeft + 1 + kRight;
+
+  static void paintBar(cairo_t *cr, int width, bool active, int hoveredButton);
+  static void paintTitle(cairo_t *cr, double x, double y, bool active,
+                         const std::string &title);
+
+  cairo_surface_t *strip(bool active);
+  cairo_surface_t *patch(bool active, int button);
+  void updateTitle(bool active, const std::string &title);
+
+  cairo_surface_t *strips_[2] = {};
+  cairo_surface_t *patches_[2][3] = {};
+
+  // Title sprite, with the text's advance measured once per title
+  cairo_surface_t *titleSprite_ = nullptr;
+  std::string title_;
+  bool titleActive_ = false;
+  double titleWidth_ = 0.0;
+  double titleHeight_ = 0.0;
+  int titlePad_ = 0; // Sprite x of the text origin
+  int titleSpriteWidth_ = 0;
+
+  uint64_t rasterizations_ = 0;
+};
+
+} // namespace opensef
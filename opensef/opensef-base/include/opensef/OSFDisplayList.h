@@ -0,0 +1,104 @@
+/**
+ * OSFDisplayList.h - Recorded View Drawing
+ *
+ * Records what an OSFView tree draws as a flat, paint-ordered list of
+ * items, one per view, each holding a cairo recording surface of that
+ * view's drawing and its bounds. Rebuilding the list against the previous
+ * one runs render() only for views whose displayVersion() or layer state
+ * changed; every other item reuses the old recording. Diffing the two
+ * lists gives the rects that actually changed on screen, so a window can
+ * redraw and damage just those.
+ *
+ * The item array is kept between builds and only grows, so steady-state
+ * frames allocate nothing for unchanged views.
+ *
+ * While a view is recorded its subviews are not drawn into it; each
+ * becomes an item of its own, painted after its parent. Drawing a view
+ * issues after calling OSFView::render() therefore lands below its
+ * subviews rather than above them.
+ */
+
+#pragma once
+
+#include <cairo/cairo.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <opensef/OSFGeometry.h>
+#include <unordered_map>
+#include <vector>
+
+namespace opensef {
+
+class OSFView;
+
+class OSFDisplayList {
+public:
+  // Damage beyond this many rects is merged into their bounding box
+  static constexpr std::size_t kMaxDamageRects = 8;
+
+  struct Recording;
+
+  struct Item {
+    uint64_t viewId = 0;           // view->viewId()
+    uint64_t version = 0;          // view->displayVersion() when recorded
+    std::size_t layerState = 0;    // view->layer()->stateHash()
+    std::shared_ptr<Recording> recording; // Null if the view drew nothing
+    OSFPoint origin;                      // View origin in list space
+    OSFRect bounds;                       // Drawn pixels in list space
+  };
+
+  OSFDisplayList() = default;
+  ~OSFDisplayList() = default;
+
+  OSFDisplayList(const OSFDisplayList &) = delete;
+  OSFDisplayList &operator=(const OSFDisplayList &) = delete;
+  OSFDisplayList(OSFDisplayList &&) = default;
+  OSFDisplayList &operator=(OSFDisplayList &&) = default;
+
+  /**
+   * Record `root` with its origin at `origin`, keeping only what falls
+   * inside `clip` (list space). Views unchanged since `previous` was
+   * built are not rendered again.
+   */
+  void build(OSFView &root, const OSFPoint &origin, const OSFRect &clip,
+             const OSFDisplayList *previous = nullptr);
+
+  /**
+   * Paint the recorded items, clipped to the list's clip. Items outside
+   * the cairo_t's clip are skipped. Safe to call from several threads
+   * at once (tile rendering).
+   */
+  void replay(cairo_t *cr) const;
+
+  /**
+   * Pixel-aligned rects (list space) whose contents differ between
+   * `previous` and this list: items that were added, removed, moved,
+   * re-stacked or re-recorded. Empty when nothing changed.
+   */
+  std::vector<OSFRect> damage(const OSFDisplayList &previous) const;
+
+  void clear();
+
+  const std::vector<Item> &items() const { return items_; }
+  std::size_t size() const { return items_.size(); }
+  OSFRect clip() const { return clip_; }
+
+  // Items whose view was rendered (not reused) by the last build()
+  std::size_t recordedCount() const { return recorded_; }
+
+  // True on a thread that is inside a view's render() for recording
+  static bool isRecording();
+
+private:
+  const Item *find(uint64_t viewId, std::size_t *index = nullptr) const;
+  void recordView(OSFView &view, const OSFPoint &origin,
+                  const OSFDisplayList *previous);
+
+  std::vector<Item> items_;
+  std::unordered_map<uint64_t, std::size_t> index_; // viewId -> item
+  OSFRect clip_;
+  std::size_t recorded_ = 0;
+};
+
+} // namespace opensef
@@ -0,0 +1,52 @@
+/**
+ * OSFFrameClock.h - Per-window frame timing
+ *
+ * Learns the compositor's frame cadence from wl_surface.frame callbacks
+ * and, when the compositor offers it, wp_presentation feedback. Predicts
+ * when the frame being drawn now will reach the screen, so animations are
+ * sampled at presentation time rather than whenever the loop happens to run.
+ * Part of opensef-base.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace opensef {
+
+class OSFFrameClock {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * wl_surface.frame "done": timeMs is the compositor's millisecond
+   * timestamp, received is when the event was dispatched.
+   */
+  void frameDone(uint32_t timeMs, Clock::time_point received);
+
+  /**
+   * wp_presentation_feedback "presented". refresh is the output's refresh
+   * interval, or zero when the output has none (e.g. VRR).
+   */
+  void presented(Clock::time_point when, Clock::duration refresh);
+
+  /** Predicted presentation time of a frame drawn at now. */
+  Clock::time_point nextPresentation(Clock::time_point now) const;
+
+  Clock::duration refreshInterval() const { return interval_; }
+  bool hasExactRefresh() const { return exactRefresh_; }
+
+private:
+  Clock::duration interval_ = std::chrono::microseconds(16667); // 60 Hz
+  bool exactRefresh_ = false;     // interval_ came from presentation-time
+  bool presentationAnchor_ = false;
+
+  bool haveFrame_ = false;
+  uint32_t lastFrameMs_ = 0;
+
+  bool haveAnchor_ = false;
+  Clock::time_point anchor_; // A known (or estimated) presentation time
+};
+
+} // namespace opensef
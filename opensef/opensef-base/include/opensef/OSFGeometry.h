@@ -47,6 +47,32 @@ struct OSFRect {
   bool contains(double px, double py) const {
     return px >= x && px < x + width && py >= y && py < y + height;
   }
+
+  bool isEmpty() const { return width <= 0 || height <= 0; }
+
+  // Smallest rect containing both (an empty rect contributes nothing)
+  OSFRect united(const OSFRect &other) const {
+    if (isEmpty())
+      return other;
+    if (other.isEmpty())
+      return *this;
+    double x0 = std::fmin(x, other.x);
+    double y0 = std::fmin(y, other.y);
+    double x1 = std::fmax(x + width, other.x + other.width);
+    double y1 = std::fmax(y + height, other.y + other.height);
+    return OSFRect(x0, y0, x1 - x0, y1 - y0);
+  }
+
+  // Overlap of both, or Zero() when they are disjoint
+  OSFRect intersected(const OSFRect &other) const {
+    double x0 = std::fmax(x, other.x);
+    double y0 = std::fmax(y, other.y);
+    double x1 = std::fmin(x + width, other.x + other.width);
+    double y1 = std::fmin(y + height, other.y + other.height);
+    if (x1 <= x0 || y1 <= y0)
+      return Zero();
+    return OSFRect(x0, y0, x1 - x0, y1 - y0);
+  }
 };
 
 struct OSFColor {
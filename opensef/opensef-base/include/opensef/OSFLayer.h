@@ -3,14 +3,26 @@
  *
  * Provides implicit animations for UI properties.
  * When you change a layer property, it animates automatically.
+ *
+ * A layer that caches its drawing keeps its shadow, background, draw()
+ * output and border in an offscreen backing store. Position, opacity,
+ * scale and rotation only re-composite that bitmap; the store is
+ * re-rasterized when a property it was drawn from changes or when
+ * setNeedsDisplay() is called. Plain layers from create() cache from the
+ * start; a subclass that overrides draw() opts in with
+ * setCachesDrawing(true), and until then is drawn on every render,
+ * unclipped.
  */
 
 #pragma once
 
+#include <array>
 #include <cairo/cairo.h>
 #include <memory>
+#include <mutex>
 #include <opensef/OSFAnimation.h>
 #include <opensef/OSFGeometry.h>
+#include <opensef/OSFShadowCache.h>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -29,7 +41,10 @@ using OSFLayerPtr = std::shared_ptr<OSFLayer>;
 class OSFLayer : public std::enable_shared_from_this<OSFLayer> {
 public:
   OSFLayer();
-  virtual ~OSFLayer() = default;
+  virtual ~OSFLayer();
+
+  OSFLayer(const OSFLayer &) = delete;
+  OSFLayer &operator=(const OSFLayer &) = delete;
 
   static OSFLayerPtr create();
 
@@ -100,9 +115,33 @@ public:
   // Render this layer and sublayers to Cairo context
   virtual void render(cairo_t *cr);
 
-  // Override for custom drawing
+  // Override for custom drawing. Overrides should not call
+  // OSFLayer::draw().
   virtual void draw(cairo_t *cr);
 
+  // Off by default (on for layers from create()): draw() runs on every
+  // render and may paint anywhere. When on, draw() output joins the
+  // backing store: it runs only after setNeedsDisplay*() or a
+  // drawing-affecting property change, and is clipped to the layer's
+  // bounds, border and shadow.
+  bool cachesDrawing() const { return cachesDrawing_; }
+  void setCachesDrawing(bool caches);
+
+  // Invalidate the cached contents (all of it, or one rect in layer space)
+  void setNeedsDisplay();
+  void setNeedsDisplayInRect(const OSFRect &rect);
+  bool needsDisplay() const { return needsDisplay_ || !dirtyRect_.isEmpty(); }
+
+  // Release the backing store; it is rebuilt on the next render
+  void discardBackingStore();
+  bool hasBackingStore() const { return backing_ != nullptr; }
+
+  // Changes whenever render() would draw something different: any
+  // property (including mid-animation values), setNeedsDisplay() or a
+  // sublayer change. Display lists compare it to reuse recordings. It
+  // cannot see an uncached draw() painting something new on its own.
+  std::size_t stateHash() const;
+
   // =========================================================================
   // Animation Control
   // =========================================================================
@@ -126,6 +165,17 @@ protected:
   void animatePropertyChange(double *target, double from, double to);
 
 private:
+  // Everything the backing store was rasterized from
+  using BackingKey = std::array<double, 19>;
+
+  BackingKey backingKey(double scale) const;
+  OSFShadowStyle shadowStyle() const;
+  bool hasVisibleStyle() const;
+  OSFRect contentExtent() const;
+  bool updateBackingStore(double scale);
+  void drawContents(cairo_t *cr);
+  void drawUncached(cairo_t *cr, double alpha);
+
   // Animatable properties
   OSFPoint position_;
   OSFRect bounds_;
@@ -145,6 +195,19 @@ private:
   OSFLayer *parent_ = nullptr;
   std::vector<OSFLayerPtr> sublayers_;
 
+  // Backing store
+  cairo_surface_t *backing_ = nullptr;
+  BackingKey backingKey_{};
+  OSFRect backingExtent_;
+  bool backingValid_ = false; // backing_ (possibly null) matches the key
+  bool needsDisplay_ = true;
+  OSFRect dirtyRect_;
+  uint64_t contentsVersion_ = 0; // Bumped by setNeedsDisplay*()
+  std::mutex backingMutex_;
+
+  bool cachesDrawing_ = false;
+  bool emptyDraw_ = false; // draw() is the base no-op (set by create())
+
   // Animations
   std::unordered_map<std::string, std::shared_ptr<OSFAnimation>> animations_;
 
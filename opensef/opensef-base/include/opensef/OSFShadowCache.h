@@ -0,0 +1,134 @@
+/**
+ * OSFShadowCache.h - Cached Blurred Shadows (Nine-Slice)
+ *
+ * Renders the blurred shadow of a rounded rectangle once, as a small A8
+ * nine-slice mask, and composites shadows of any size from the four
+ * corners, four stretched edges and a solid centre. Generating the mask
+ * costs a few three-pass box blurs (a close Gaussian approximation);
+ * every later shadow with the same geometry is nine cairo_mask calls.
+ *
+ * Masks are keyed by blur and the corner radius after spread, at
+ * half-pixel precision. Spread and offset only move the slices, and the
+ * colour is applied while compositing, so one mask serves every shadow
+ * size, spread and colour. Safe to use from several rendering threads.
+ */
+
+#pragma once
+
+#include <cairo/cairo.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <opensef/OSFGeometry.h>
+#include <unordered_map>
+
+namespace opensef {
+
+struct OSFShadowStyle {
+  double cornerRadius = 0.0; // Radius of the shape casting the shadow
+  double blur = 0.0;         // Blur radius (CSS box-shadow semantics)
+  double spread = 0.0;       // Grows (or shrinks) the shape before blurring
+  OSFColor color{0, 0, 0, 0.3};
+  OSFPoint offset;
+};
+
+class OSFShadowCache {
+public:
+  enum class Path { Scalar, SSE2, AVX2, NEON };
+
+  static OSFShadowCache &shared();
+
+  OSFShadowCache() = default;
+  ~OSFShadowCache();
+
+  OSFShadowCache(const OSFShadowCache &) = delete;
+  OSFShadowCache &operator=(const OSFShadowCache &) = delete;
+
+  /**
+   * Draw the shadow cast by `shape` (a rounded rect in user space).
+   * Constant time once the mask for this style's geometry is cached.
+   */
+  void drawShadow(cairo_t *cr, const OSFRect &shape,
+                  const OSFShadowStyle &style);
+
+  // Area touched by drawShadow() for this shape and style
+  static OSFRect shadowBounds(const OSFRect &shape,
+                              const OSFShadowStyle &style);
+
+  // How far the blur reaches beyond the (spread) shape edge
+  static double blurExtent(double blur);
+
+  // Blur an A8 (or any 8-bit single channel) buffer in place with three
+  // box passes per axis of the given radius
+  static void boxBlur(uint8_t *pixels, int width, int height, int stride,
+                      int radius);
+
+  // Kernels boxBlur() uses for its vertical passes on this CPU, unless
+  // forced to scalar. Every path gives identical pixels.
+  static Path blurPath();
+  static const char *pathName(Path path);
+
+  // Use the scalar kernels (for comparisons and benchmarks)
+  static void setForceScalar(bool forceScalar);
+
+  // Cache control
+  size_t size() const;
+  size_t capacity() const { return capacity_; }
+  void setCapacity(size_t capacity);
+  void clear();
+
+  // Statistics
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+private:
+  // All in half pixels. width/height are zero for nine-slice templates
+  // and set only for shapes too small to slice, which get an exact mask.
+  struct Key {
+    int radius;
+    int blur;
+    int width;
+    int height;
+    bool operator==(const Key &other) const {
+      return radius == other.radius && blur == other.blur &&
+             width == other.width && height == other.height;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      size_t h = static_cast<size_t>(key.radius) * 73856093u;
+      h ^= static_cast<size_t>(key.blur) * 19349663u;
+      h ^= static_cast<size_t>(key.width) * 2654435761u;
+      return h ^ (static_cast<size_t>(key.height) * 40503u);
+    }
+  };
+
+  // One rendered mask. For templates, corners are `slice` pixels square
+  // and the middle row/column are 1-pixel edges stretched to any size.
+  struct NineSlice {
+    cairo_surface_t *mask = nullptr;
+    cairo_surface_t *pieces[8] = {}; // Corners TL TR BL BR, edges T B L R
+    int slice = 0;
+    int pad = 0; // Mask pixels outside the shape edge
+    double centerAlpha = 1.0;
+    ~NineSlice();
+  };
+
+  using NineSlicePtr = std::shared_ptr<const NineSlice>;
+  using LruList = std::list<std::pair<Key, NineSlicePtr>>;
+
+  static NineSlicePtr render(const Key &key);
+  NineSlicePtr lookup(const Key &key);
+
+  mutable std::mutex mutex_;
+  LruList lru_; // Most recently used first
+  std::unordered_map<Key, LruList::iterator, KeyHash> entries_;
+  size_t capacity_ = 32;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+} // namespace opensef
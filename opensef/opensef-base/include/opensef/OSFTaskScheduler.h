@@ -0,0 +1,186 @@
+/**
+ * OSFTaskScheduler.h - Shared Background Work Scheduler
+ *
+ * Work-stealing thread pool for everything that must not run on the UI
+ * thread: image decoding, layout, directory scanning, search.
+ * Results are handed to an executor the caller picks: an OSFRunLoop, or a
+ * host toolkit's event loop.
+ * Packaged in opensef-core; depends on nothing but the standard library.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace opensef {
+
+// =============================================================================
+// Task Priority
+// =============================================================================
+
+enum class OSFTaskPriority {
+  High = 0,   // User is waiting on it (search-as-you-type, visible thumbnails)
+  Normal = 1, // Default background work
+  Low = 2     // Prefetching, indexing, cache warming
+};
+
+// =============================================================================
+// OSFCancellationToken - Cooperative cancellation
+// =============================================================================
+
+/**
+ * Copies share the same cancellation state.
+ * A default-constructed token can never be cancelled and costs nothing;
+ * use create() for a cancellable one.
+ */
+class OSFCancellationToken {
+public:
+  OSFCancellationToken() = default;
+
+  static OSFCancellationToken create();
+
+  void cancel();
+  bool isCancelled() const {
+    return cancelled_ && cancelled_->load(std::memory_order_acquire);
+  }
+  bool canBeCancelled() const { return cancelled_ != nullptr; }
+
+private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// =============================================================================
+// OSFTaskScheduler - Work-stealing thread pool
+// =============================================================================
+
+class OSFTaskScheduler {
+public:
+  using Task = std::function<void()>;
+
+  /** Runs a task on the thread that should see a completion. */
+  using Executor = std::function<void(Task)>;
+
+  /** Process-wide pool sized to the number of cores. */
+  static OSFTaskScheduler &shared();
+
+  /** threadCount == 0 means std::thread::hardware_concurrency(). */
+  explicit OSFTaskScheduler(std::size_t threadCount = 0);
+  ~OSFTaskScheduler();
+
+  OSFTaskScheduler(const OSFTaskScheduler &) = delete;
+  OSFTaskScheduler &operator=(const OSFTaskScheduler &) = delete;
+
+  /**
+   * Run a task on a worker thread.
+   * Tasks whose token is cancelled before they start are dropped.
+   */
+  void submit(Task task, OSFTaskPriority priority = OSFTaskPriority::Normal,
+              OSFCancellationToken token = {});
+
+  /**
+   * Run work() on a worker, then hand completion(result) to executor.
+   * The completion is skipped if the token was cancelled meanwhile, so a
+   * superseded query never delivers stale results.
+   */
+  template <typename Work, typename Completion>
+  void submit(Work work, Completion completion, Executor executor,
+              OSFTaskPriority priority = OSFTaskPriority::Normal,
+              OSFCancellationToken token = {});
+
+  /** Same as above, posting the completion to a run loop (OSFRunLoop). */
+  template <typename Work, typename Completion, typename RunLoop,
+            typename = decltype(std::declval<RunLoop &>().postTask(Task()))>
+  void submit(Work work, Completion completion, RunLoop &runLoop,
+              OSFTaskPriority priority = OSFTaskPriority::Normal,
+              OSFCancellationToken token = {}) {
+    RunLoop *loop = &runLoop;
+    submit(
+        std::move(work), std::move(completion),
+        Executor([loop](Task task) { loop->postTask(std::move(task)); }),
+        priority, token);
+  }
+
+  /** Block until every submitted task has finished. */
+  void waitIdle();
+
+  std::size_t threadCount() const { return workers_.size(); }
+
+  /** True when called from one of this scheduler's worker threads. */
+  bool isWorkerThread() const;
+
+private:
+  static constexpr int kPriorityCount = 3;
+
+  struct Entry {
+    Task task;
+    OSFCancellationToken token;
+  };
+
+  // Each worker owns one deque per priority. The owner pushes and pops at
+  // the back (LIFO, cache-warm); thieves take from the front (FIFO).
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Entry> queues[kPriorityCount];
+    std::thread thread;
+  };
+
+  void workerLoop(std::size_t index);
+  bool popLocal(std::size_t index, int priority, Entry &out);
+  bool steal(std::size_t thief, int priority, Entry &out);
+  bool findTask(std::size_t index, Entry &out);
+  void runEntry(Entry &entry);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<std::size_t> nextWorker_{0};
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<bool> stopping_{false};
+
+  std::mutex sleepMutex_;
+  std::condition_variable sleepCv_;
+
+  std::mutex idleMutex_;
+  std::condition_variable idleCv_;
+  std::size_t outstanding_ = 0;
+};
+
+// =============================================================================
+// Template Implementation
+// =============================================================================
+
+template <typename Work, typename Completion>
+void OSFTaskScheduler::submit(Work work, Completion completion,
+                              Executor executor, OSFTaskPriority priority,
+                              OSFCancellationToken token) {
+  submit(
+      [work = std::move(work), completion = std::move(completion),
+       executor = std::move(executor), token]() mutable {
+        using Result = std::invoke_result_t<Work &>;
+        if constexpr (std::is_void_v<Result>) {
+          work();
+          executor([completion = std::move(completion), token]() mutable {
+            if (!token.isCancelled())
+              completion();
+          });
+        } else {
+          auto result = std::make_shared<Result>(work());
+          executor(
+              [completion = std::move(completion), result, token]() mutable {
+                if (!token.isCancelled())
+                  completion(std::move(*result));
+              });
+        }
+      },
+      priority, token);
+}
+
+} // namespace opensef
@@ -21,6 +21,8 @@ class OSFLayer;
 using OSFLayerPtr = std::shared_ptr<OSFLayer>;
 
 class OSFView : public OSFResponder {
+  friend class OSFDisplayList;
+
 public:
   OSFView();
   virtual ~OSFView() = default;
@@ -87,6 +89,20 @@ public:
   // === Display ===
   bool needsDisplay() const { return needsDisplay_; }
 
+  /**
+   * Changes on setNeedsDisplay() and on size or alpha changes. Display
+   * lists replay a view's previous recording while this and its layer
+   * are unchanged, so widgets must call setNeedsDisplay() whenever state
+   * that render() reads changes.
+   */
+  uint64_t displayVersion() const { return displayVersion_; }
+
+  /**
+   * Never reused within the process, unlike the view's address; display
+   * lists match items between frames on it.
+   */
+  uint64_t viewId() const { return viewId_; }
+
   // === Hit Testing ===
 
   virtual OSFView *hitTest(double x, double y);
@@ -110,6 +126,13 @@ public:
   virtual void draw() {}
   virtual void render(cairo_t *cr);
 
+  /**
+   * Area this view and its subviews may draw into, in its own
+   * coordinates. render() skips subviews whose paint bounds miss the
+   * clip, so override when drawing outside bounds (shadows, glows).
+   */
+  virtual OSFRect paintBounds() const;
+
 protected:
   OSFLayerPtr layer_;
   OSFRect frame_;
@@ -117,6 +140,8 @@ protected:
   bool hidden_ = false;
   bool needsLayout_ = false;
   bool needsDisplay_ = false;
+  uint64_t viewId_ = 0;
+  uint64_t displayVersion_ = 0;
   bool acceptsFirstResponder_ = false;
 
   OSFView *superview_ = nullptr;
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <opensef/OSFResponder.h>
@@ -19,8 +21,9 @@ typedef struct _cairo cairo_t;
 
 namespace opensef {
 
-// Forward declaration
+// Forward declarations
 class OSFView;
+class OSFFrameClock;
 
 /**
  * OSFWindow - A top-level application window
@@ -34,6 +37,7 @@ public:
   using CloseCallback = std::function<void()>;
   using ResizeCallback = std::function<void(int width, int height)>;
   using DrawCallback = std::function<void(cairo_t *cr, int width, int height)>;
+  using FrameCallback = std::function<void(uint32_t timeMs)>;
 
   /**
    * Create a new window with given dimensions.
@@ -56,6 +60,9 @@ public:
   void close();
   bool isVisible() const { return visible_; }
 
+  // True while the compositor shows this window as focused
+  bool isActive() const;
+
   // === Properties ===
 
   void setTitle(const std::string &title);
@@ -111,6 +118,54 @@ public:
    */
   void setNeedsDisplay() { needsRedraw_ = true; }
 
+  /**
+   * Run callback once on the next compositor frame callback, with the frame
+   * timestamp. Requests a frame if none is pending. One-shot.
+   */
+  void requestFrame(FrameCallback callback);
+
+  // === Frame Clock ===
+
+  /**
+   * Request a frame callback for animations. Called by OSFApplication while
+   * animations are active. Returns false if the window can't produce
+   * frames (not configured or closed).
+   */
+  bool scheduleAnimationFrame();
+
+  /**
+   * If that frame callback arrived since the last call, store its predicted
+   * presentation time, mark the window dirty and return true. OSFApplication
+   * ticks OSFAnimationManager once per loop iteration from these.
+   */
+  bool takeAnimationFrame(std::chrono::steady_clock::time_point *presentation);
+
+  /** True while a frame callback is outstanding. */
+  bool isWaitingForFrame() const;
+
+  const OSFFrameClock &frameClock() const;
+
+  // === Rendering ===
+
+  /**
+   * Rasterize large frames in parallel tiles on OSFTaskScheduler workers.
+   * Output is identical to serial drawing, but view render() overrides
+   * and the draw callback are then called concurrently and must not
+   * modify shared state. Off by default.
+   */
+  void setTiledRendering(bool enabled) { tiledRendering_ = enabled; }
+  bool tiledRendering() const { return tiledRendering_; }
+
+  /**
+   * Record the content view into an OSFDisplayList and redraw only what
+   * changed since the last frame, damaging just those rects. Views are
+   * re-rendered only after setNeedsDisplay() or a size/alpha/layer change,
+   * so every view in the tree must invalidate itself when its drawing
+   * changes. Ignored while a draw callback is set. Off by default.
+   */
+  void setUsesDisplayLists(bool enabled);
+  bool usesDisplayLists() const { return displayLists_; }
+
   // === OSFResponder Overrides ===
 
   OSFResponder *nextResponder() const override;
@@ -147,6 +202,8 @@ private:
   bool visible_ = false;
   bool running_ = false;
   bool needsRedraw_ = true; // Phase 3 Performance Fix: Event-driven redraws
+  bool tiledRendering_ = false;
+  bool displayLists_ = false;
 
   // Content
   std::shared_ptr<OSFView> contentView_;
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -62,23 +64,82 @@ template <typename T> using OSFArray = std::vector<T>;
 class OSFRunLoop {
 public:
   using Task = std::function<void()>;
+  using Clock = std::chrono::steady_clock;
   friend class OSFApplication;
 
   static OSFRunLoop &main();
 
+  ~OSFRunLoop();
+
   void run();
   void stop();
   bool isRunning() const { return running_; }
 
+  /** Thread-safe: may be called from worker threads. */
   void postTask(Task task);
 
+  /** Run task once delay has elapsed. Thread-safe. */
+  void postDelayedTask(Task task, Clock::duration delay);
+
+  /**
+   * Run task once the loop has no regular task queued. Thread-safe.
+   * Idle tasks posted by idle tasks wait for the next loop iteration.
+   */
+  void postIdleTask(Task task);
+
+  /**
+   * Run every task queued so far without blocking.
+   * Used by OSFApplication::run to interleave tasks with window events.
+   * Returns the number of tasks executed.
+   */
+  std::size_t runPendingTasks();
+
+  /**
+   * Run the idle tasks queued so far, unless regular tasks are pending.
+   * Returns the number of tasks executed.
+   */
+  std::size_t runIdleTasks();
+
+  /**
+   * eventfd that becomes readable whenever a task is posted.
+   * Lets a poll()-based loop sleep until background work posts a result.
+   */
+  int wakeupFd();
+
+  /**
+   * Milliseconds until the next delayed task is due, capped at maxTimeout.
+   * Returns maxTimeout when no timer is pending (pass -1 for "forever").
+   */
+  int pollTimeout(int maxTimeout);
+
 private:
   OSFRunLoop() = default;
 
+  struct Timer {
+    Clock::time_point deadline;
+    uint64_t sequence; // FIFO among timers with the same deadline
+    Task task;
+  };
+  struct TimerLater {
+    bool operator()(const Timer &a, const Timer &b) const {
+      return a.deadline != b.deadline ? a.deadline > b.deadline
+                                      : a.sequence > b.sequence;
+    }
+  };
+
+  void clearWakeup();
+  void signalWakeup(int fd);
+  // Moves due timers onto tasks_. Caller holds mutex_.
+  void promoteDueTimers(Clock::time_point now);
+
   std::mutex mutex_;
   std::condition_variable cv_;
   std::deque<Task> tasks_;
+  std::deque<Task> idleTasks_;
+  std::vector<Timer> timers_; // Min-heap on deadline (TimerLater)
+  uint64_t nextTimerSequence_ = 0;
   bool running_ = false;
+  int wakeupFd_ = -1;
 };
 
 // ============================================================================
@@ -103,12 +164,74 @@ public:
 private:
   OSFNotificationCenter() = default;
 
+  // Copy-on-write: add/remove build a new list, so posting only takes a
+  // reference to the current snapshot instead of copying every callback.
+  using ObserverList = std::vector<std::pair<std::size_t, Callback>>;
+
   std::mutex mutex_;
-  std::unordered_map<std::string, std::vector<std::pair<std::size_t, Callback>>>
+  std::unordered_map<std::string, std::shared_ptr<const ObserverList>>
       observers_;
   std::size_t nextObserverID_ = 1;
 };
 
+// ============================================================================
+// OSFNotificationQueue - Deferred, coalescing notification posting
+// ============================================================================
+
+enum class OSFPostingStyle {
+  Now,     // Post immediately (after dropping matching queued ones)
+  ASAP,    // Post on the next run loop pass
+  WhenIdle // Post once the run loop has no other tasks queued
+};
+
+enum OSFNotificationCoalescing : unsigned {
+  OSFNotificationNoCoalescing = 0,
+  OSFNotificationCoalescingOnName = 1 << 0,
+  OSFNotificationCoalescingOnSender = 1 << 1
+};
+
+/**
+ * Collapses bursts (layout, theme changes) into one delivery per run loop
+ * iteration. A notification matching an already-queued one - by name and/or
+ * sender, per the coalescing mask - is dropped. Thread-safe.
+ */
+class OSFNotificationQueue {
+public:
+  /** Posts to the default center from the application run loop. */
+  static OSFNotificationQueue &defaultQueue();
+
+  OSFNotificationQueue(OSFNotificationCenter &center, OSFRunLoop &runLoop);
+
+  void enqueueNotification(const std::string &name, OSFPostingStyle style,
+                           unsigned coalesceMask =
+                               OSFNotificationCoalescingOnName |
+                               OSFNotificationCoalescingOnSender,
+                           const void *sender = nullptr);
+
+  /** Drop queued notifications matching name/sender under coalesceMask. */
+  void dequeueNotifications(const std::string &name, const void *sender,
+                            unsigned coalesceMask);
+
+private:
+  struct Pending {
+    std::string name;
+    const void *sender;
+  };
+
+  static bool matches(const Pending &pending, const std::string &name,
+                      const void *sender, unsigned coalesceMask);
+  void flush(OSFPostingStyle style);
+
+  OSFNotificationCenter &center_;
+  OSFRunLoop &runLoop_;
+
+  std::mutex mutex_;
+  std::vector<Pending> asap_;
+  std::vector<Pending> idle_;
+  bool asapScheduled_ = false;
+  bool idleScheduled_ = false;
+};
+
 // ============================================================================
 // OSFBundle - Resource bundle metadata
 // ============================================================================
@@ -185,6 +308,12 @@ public:
    */
   void addExternalEventSource(int fd, std::function<void()> callback);
 
+  /**
+   * One-shot wait: callback(revents) runs on the next loop pass where fd
+   * reports any of the poll() events. Main thread only.
+   */
+  void waitForFd(int fd, short events, std::function<void(short)> callback);
+
   // === First Responder (Phase 3) ===
 
   /**
@@ -215,6 +344,13 @@ private:
     std::function<void()> callback;
   };
   std::vector<ExternalSource> externalSources_;
+
+  struct FdWaiter {
+    int fd;
+    short events;
+    std::function<void(short)> callback;
+  };
+  std::vector<FdWaiter> fdWaiters_;
 };
 } // namespace opensef
 
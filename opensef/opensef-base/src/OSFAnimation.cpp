@@ -3,11 +3,62 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <opensef/OSFAnimation.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define OSF_ANIMATION_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h> // float64x2_t is AArch64 only
+#define OSF_ANIMATION_NEON 1
+#endif
+
 
 namespace opensef {
 
+// =============================================================================
+// Easing Curves
+// =============================================================================
+
+EasingCurve easingCurveFor(const EasingFunction &easing) {
+  if (!easing)
+    return EasingCurve::Linear;
+
+  using Fn = double (*)(double);
+  const Fn *fn = easing.target<Fn>();
+  if (!fn)
+    return EasingCurve::Custom;
+  if (*fn == &Easing::linear)
+    return EasingCurve::Linear;
+  if (*fn == &Easing::easeIn)
+    return EasingCurve::EaseIn;
+  if (*fn == &Easing::easeOut)
+    return EasingCurve::EaseOut;
+  if (*fn == &Easing::easeInOut)
+    return EasingCurve::EaseInOut;
+  if (*fn == &Easing::spring)
+    return EasingCurve::Spring;
+  return EasingCurve::Custom;
+}
+
+double ease(EasingCurve curve, double t) {
+  switch (curve) {
+  case EasingCurve::EaseIn:
+    return ease<EasingCurve::EaseIn>(t);
+  case EasingCurve::EaseOut:
+    return ease<EasingCurve::EaseOut>(t);
+  case EasingCurve::EaseInOut:
+    return ease<EasingCurve::EaseInOut>(t);
+  case EasingCurve::Spring:
+    return ease<EasingCurve::Spring>(t);
+  case EasingCurve::Linear:
+  case EasingCurve::Custom:
+    break;
+  }
+  return t;
+}
+
 // =============================================================================
 // OSFAnimation
 // =============================================================================
@@ -16,7 +67,10 @@ OSFAnimation::OSFAnimation() = default;
 
 void OSFAnimation::setDuration(double seconds) { duration_ = seconds; }
 
-void OSFAnimation::setEasing(EasingFunction easing) { easing_ = easing; }
+void OSFAnimation::setEasing(EasingFunction easing) {
+  easing_ = std::move(easing);
+  curve_ = easingCurveFor(easing_);
+}
 
 void OSFAnimation::setDelay(double seconds) { delay_ = seconds; }
 
@@ -55,11 +109,12 @@ void OSFAnimation::stop() {
   complete_ = true;
 }
 
-void OSFAnimation::tick() {
+void OSFAnimation::tick() { tick(Clock::now()); }
+
+void OSFAnimation::tick(Clock::time_point now) {
   if (!running_ || paused_)
     return;
 
-  auto now = Clock::now();
   auto elapsed = std::chrono::duration<double>(now - startTime_).count();
 
   // Account for delay
@@ -77,8 +132,9 @@ void OSFAnimation::tick() {
     effectiveProgress = 1.0 - rawProgress_;
   }
 
-  // Apply easing
-  progress_ = easing_(effectiveProgress);
+  // Apply easing (built-in curves skip the std::function call)
+  progress_ = curve_ == EasingCurve::Custom ? easing_(effectiveProgress)
+                                             : ease(curve_, effectiveProgress);
 
   // Apply to subclass
   applyProgress(progress_);
@@ -94,14 +150,14 @@ void OSFAnimation::tick() {
       // Start reverse
       reversing_ = true;
       rawProgress_ = 0.0;
-      startTime_ = Clock::now();
+      startTime_ = now;
     } else if (repeatCount_ != 0 &&
                (repeatCount_ < 0 || currentRepeat_ < repeatCount_)) {
       // Repeat
       currentRepeat_++;
       reversing_ = false;
       rawProgress_ = 0.0;
-      startTime_ = Clock::now();
+      startTime_ = now;
     } else {
       // Complete
       running_ = false;
@@ -140,11 +196,13 @@ OSFKeyframeAnimation::OSFKeyframeAnimation(double *target) : target_(target) {}
 
 void OSFKeyframeAnimation::addKeyframe(double time, double value,
                                        EasingFunction easing) {
-  keyframes_.push_back({time, value, easing});
-  // Sort by time
-  std::sort(
-      keyframes_.begin(), keyframes_.end(),
-      [](const Keyframe &a, const Keyframe &b) { return a.time < b.time; });
+  // Insert after any keyframes with the same time, keeping both arrays sorted
+  auto pos = std::upper_bound(times_.begin(), times_.end(), time);
+  auto index = pos - times_.begin();
+  times_.insert(pos, time);
+  curves_.insert(curves_.begin() + index, easingCurveFor(easing));
+  keyframes_.insert(keyframes_.begin() + index,
+                    {time, value, std::move(easing)});
 }
 
 std::shared_ptr<OSFKeyframeAnimation>
@@ -156,33 +214,26 @@ void OSFKeyframeAnimation::applyProgress(double progress) {
   if (!target_ || keyframes_.empty())
     return;
 
-  // Find surrounding keyframes
-  const Keyframe *prev = nullptr;
-  const Keyframe *next = nullptr;
-
-  for (size_t i = 0; i < keyframes_.size(); i++) {
-    if (keyframes_[i].time <= progress) {
-      prev = &keyframes_[i];
-    }
-    if (keyframes_[i].time >= progress && !next) {
-      next = &keyframes_[i];
-      break;
-    }
+  // First keyframe strictly after progress; its predecessor is at or before
+  auto next = std::upper_bound(times_.begin(), times_.end(), progress);
+  if (next == times_.begin()) {
+    *target_ = keyframes_.front().value;
+    return;
   }
-
-  if (!prev && next) {
-    *target_ = next->value;
-  } else if (prev && !next) {
-    *target_ = prev->value;
-  } else if (prev && next && prev != next) {
-    // Interpolate between keyframes
-    double range = next->time - prev->time;
-    double localProgress = (progress - prev->time) / range;
-    double easedProgress = next->easing(localProgress);
-    *target_ = prev->value + (next->value - prev->value) * easedProgress;
-  } else if (prev) {
-    *target_ = prev->value;
+  if (next == times_.end()) {
+    *target_ = keyframes_.back().value;
+    return;
   }
+
+  // Interpolate between keyframes
+  std::size_t i = next - times_.begin();
+  const Keyframe &a = keyframes_[i - 1];
+  const Keyframe &b = keyframes_[i];
+  double localProgress = (progress - a.time) / (b.time - a.time);
+  double easedProgress = curves_[i] == EasingCurve::Custom
+                             ? b.easing(localProgress)
+                             : ease(curves_[i], localProgress);
+  *target_ = a.value + (b.value - a.value) * easedProgress;
 }
 
 // =============================================================================
@@ -249,6 +300,343 @@ void OSFTransaction::setCompletionBlock(std::function<void()> block) {
   current().completionBlock = block;
 }
 
+// =============================================================================
+// OSFAnimationBatch
+// =============================================================================
+
+namespace {
+
+std::atomic<bool> gForceScalar{false};
+
+// Each kernel evaluates as many whole vectors as fit in count and returns
+// how many tracks it did; the scalar loop finishes the rest. Operations
+// follow the Easing:: functions in the same order.
+
+#if defined(OSF_ANIMATION_X86)
+
+bool cpuHasSSE2() {
+  static const bool hasSSE2 = __builtin_cpu_supports("sse2");
+  return hasSSE2;
+}
+
+bool cpuHasAVX2() {
+  static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+  return hasAVX2;
+}
+
+template <EasingCurve Curve>
+__attribute__((target("sse2"))) inline __m128d easeSSE2(__m128d t) {
+  const __m128d one = _mm_set1_pd(1.0);
+  if constexpr (Curve == EasingCurve::EaseIn) {
+    return _mm_mul_pd(_mm_mul_pd(t, t), t);
+  } else if constexpr (Curve == EasingCurve::EaseOut) {
+    __m128d u = _mm_sub_pd(one, t);
+    return _mm_sub_pd(one, _mm_mul_pd(_mm_mul_pd(u, u), u));
+  } else if constexpr (Curve == EasingCurve::EaseInOut) {
+    __m128d in =
+        _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(4.0), t), t), t);
+    __m128d v = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(-2.0), t), _mm_set1_pd(2.0));
+    __m128d out = _mm_sub_pd(
+        one, _mm_div_pd(_mm_mul_pd(_mm_mul_pd(v, v), v), _mm_set1_pd(2.0)));
+    __m128d first = _mm_cmplt_pd(t, _mm_set1_pd(0.5));
+    return _mm_or_pd(_mm_and_pd(first, in), _mm_andnot_pd(first, out));
+  } else {
+    return t;
+  }
+}
+
+template <EasingCurve Curve>
+__attribute__((target("sse2"))) std::size_t
+evaluateSSE2(const double *from, const double *to, const double *start,
+             const double *invDuration, double *values, std::size_t count,
+             double now) {
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd(1.0);
+  const __m128d time = _mm_set1_pd(now);
+  const std::size_t vectorCount = count & ~std::size_t(1);
+  for (std::size_t i = 0; i < vectorCount; i += 2) {
+    __m128d t = _mm_mul_pd(_mm_sub_pd(time, _mm_loadu_pd(start + i)),
+                           _mm_loadu_pd(invDuration + i));
+    t = _mm_min_pd(one, _mm_max_pd(zero, t));
+    __m128d a = _mm_loadu_pd(from + i);
+    __m128d b = _mm_loadu_pd(to + i);
+    _mm_storeu_pd(values + i,
+                  _mm_add_pd(a, _mm_mul_pd(_mm_sub_pd(b, a),
+                                           easeSSE2<Curve>(t))));
+  }
+  return vectorCount;
+}
+
+template <EasingCurve Curve>
+__attribute__((target("avx2"))) inline __m256d easeAVX2(__m256d t) {
+  const __m256d one = _mm256_set1_pd(1.0);
+  if constexpr (Curve == EasingCurve::EaseIn) {
+    return _mm256_mul_pd(_mm256_mul_pd(t, t), t);
+  } else if constexpr (Curve == EasingCurve::EaseOut) {
+    __m256d u = _mm256_sub_pd(one, t);
+    return _mm256_sub_pd(one, _mm256_mul_pd(_mm256_mul_pd(u, u), u));
+  } else if constexpr (Curve == EasingCurve::EaseInOut) {
+    __m256d in = _mm256_mul_pd(
+        _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(4.0), t), t), t);
+    __m256d v = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), t),
+                              _mm256_set1_pd(2.0));
+    __m256d out = _mm256_sub_pd(
+        one, _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(v, v), v),
+                           _mm256_set1_pd(2.0)));
+    return _mm256_blendv_pd(
+        out, in, _mm256_cmp_pd(t, _mm256_set1_pd(0.5), _CMP_LT_OQ));
+  } else {
+    return t;
+  }
+}
+
+template <EasingCurve Curve>
+__attribute__((target("avx2"))) std::size_t
+evaluateAVX2(const double *from, const double *to, const double *start,
+             const double *invDuration, double *values, std::size_t count,
+             double now) {
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d time = _mm256_set1_pd(now);
+  const std::size_t vectorCount = count & ~std::size_t(3);
+  for (std::size_t i = 0; i < vectorCount; i += 4) {
+    __m256d t =
+        _mm256_mul_pd(_mm256_sub_pd(time, _mm256_loadu_pd(start + i)),
+                      _mm256_loadu_pd(invDuration + i));
+    t = _mm256_min_pd(one, _mm256_max_pd(zero, t));
+    __m256d a = _mm256_loadu_pd(from + i);
+    __m256d b = _mm256_loadu_pd(to + i);
+    _mm256_storeu_pd(values + i,
+                     _mm256_add_pd(a, _mm256_mul_pd(_mm256_sub_pd(b, a),
+                                                    easeAVX2<Curve>(t))));
+  }
+  return vectorCount;
+}
+
+#endif // OSF_ANIMATION_X86
+
+#if defined(OSF_ANIMATION_NEON)
+
+template <EasingCurve Curve> inline float64x2_t easeNEON(float64x2_t t) {
+  const float64x2_t one = vdupq_n_f64(1.0);
+  if constexpr (Curve == EasingCurve::EaseIn) {
+    return vmulq_f64(vmulq_f64(t, t), t);
+  } else if constexpr (Curve == EasingCurve::EaseOut) {
+    float64x2_t u = vsubq_f64(one, t);
+    return vsubq_f64(one, vmulq_f64(vmulq_f64(u, u), u));
+  } else if constexpr (Curve == EasingCurve::EaseInOut) {
+    float64x2_t in = vmulq_f64(vmulq_f64(vmulq_n_f64(t, 4.0), t), t);
+    float64x2_t v = vaddq_f64(vmulq_n_f64(t, -2.0), vdupq_n_f64(2.0));
+    float64x2_t out =
+        vsubq_f64(one, vdivq_f64(vmulq_f64(vmulq_f64(v, v), v),
+                                 vdupq_n_f64(2.0)));
+    return vbslq_f64(vcltq_f64(t, vdupq_n_f64(0.5)), in, out);
+  } else {
+    return t;
+  }
+}
+
+template <EasingCurve Curve>
+std::size_t evaluateNEON(const double *from, const double *to,
+                         const double *start, const double *invDuration,
+                         double *values, std::size_t count, double now) {
+  const float64x2_t zero = vdupq_n_f64(0.0);
+  const float64x2_t one = vdupq_n_f64(1.0);
+  const float64x2_t time = vdupq_n_f64(now);
+  const std::size_t vectorCount = count & ~std::size_t(1);
+  for (std::size_t i = 0; i < vectorCount; i += 2) {
+    float64x2_t t =
+        vmulq_f64(vsubq_f64(time, vld1q_f64(start + i)),
+                  vld1q_f64(invDuration + i));
+    t = vminq_f64(one, vmaxq_f64(zero, t));
+    float64x2_t a = vld1q_f64(from + i);
+    float64x2_t b = vld1q_f64(to + i);
+    vst1q_f64(values + i,
+              vaddq_f64(a, vmulq_f64(vsubq_f64(b, a), easeNEON<Curve>(t))));
+  }
+  return vectorCount;
+}
+
+#endif // OSF_ANIMATION_NEON
+
+} // namespace
+
+OSFAnimationBatch::Path OSFAnimationBatch::path() {
+  if (gForceScalar.load(std::memory_order_relaxed))
+    return Path::Scalar;
+#if defined(OSF_ANIMATION_X86)
+  if (cpuHasAVX2())
+    return Path::AVX2;
+  return cpuHasSSE2() ? Path::SSE2 : Path::Scalar;
+#elif defined(OSF_ANIMATION_NEON)
+  return Path::NEON;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char *OSFAnimationBatch::pathName(Path path) {
+  switch (path) {
+  case Path::SSE2:
+    return "SSE2";
+  case Path::AVX2:
+    return "AVX2";
+  case Path::NEON:
+    return "NEON";
+  case Path::Scalar:
+    break;
+  }
+  return "scalar";
+}
+
+void OSFAnimationBatch::setForceScalar(bool forceScalar) {
+  gForceScalar.store(forceScalar, std::memory_order_relaxed);
+}
+
+void OSFAnimationBatch::add(double *target, double from, double to,
+                            double startTime, double duration,
+                            EasingCurve curve) {
+  if (!target)
+    return;
+
+  cancel(target);
+  if (duration <= 0.0) {
+    *target = to;
+    return;
+  }
+  if (curve == EasingCurve::Custom)
+    curve = EasingCurve::Linear; // Batch tracks only take built-in curves
+
+  std::size_t laneIndex = static_cast<std::size_t>(curve);
+  Lane &lane = lanes_[laneIndex];
+  index_[target] = (static_cast<uint64_t>(laneIndex) << 32) |
+                   static_cast<uint64_t>(lane.targets.size());
+  lane.targets.push_back(target);
+  lane.from.push_back(from);
+  lane.to.push_back(to);
+  lane.start.push_back(startTime);
+  lane.invDuration.push_back(1.0 / duration);
+}
+
+bool OSFAnimationBatch::cancel(double *target) {
+  auto it = index_.find(target);
+  if (it == index_.end())
+    return false;
+  removeAt(static_cast<std::size_t>(it->second >> 32),
+           static_cast<std::size_t>(it->second & 0xFFFFFFFFu));
+  return true;
+}
+
+void OSFAnimationBatch::cancelRange(const void *begin, const void *end) {
+  auto lo = reinterpret_cast<std::uintptr_t>(begin);
+  auto hi = reinterpret_cast<std::uintptr_t>(end);
+  for (std::size_t laneIndex = 0; laneIndex < kBuiltinEasingCurveCount;
+       ++laneIndex) {
+    Lane &lane = lanes_[laneIndex];
+    for (std::size_t i = lane.targets.size(); i-- > 0;) {
+      auto address = reinterpret_cast<std::uintptr_t>(lane.targets[i]);
+      if (address >= lo && address < hi) {
+        removeAt(laneIndex, i);
+      }
+    }
+  }
+}
+
+void OSFAnimationBatch::removeAt(std::size_t laneIndex, std::size_t i) {
+  // Swap-remove keeps every array dense; order within a lane is irrelevant
+  Lane &lane = lanes_[laneIndex];
+  std::size_t last = lane.targets.size() - 1;
+  index_.erase(lane.targets[i]);
+  if (i != last) {
+    lane.targets[i] = lane.targets[last];
+    lane.from[i] = lane.from[last];
+    lane.to[i] = lane.to[last];
+    lane.start[i] = lane.start[last];
+    lane.invDuration[i] = lane.invDuration[last];
+    index_[lane.targets[i]] =
+        (static_cast<uint64_t>(laneIndex) << 32) | static_cast<uint64_t>(i);
+  }
+  lane.targets.pop_back();
+  lane.from.pop_back();
+  lane.to.pop_back();
+  lane.start.pop_back();
+  lane.invDuration.pop_back();
+}
+
+template <EasingCurve Curve>
+void OSFAnimationBatch::evaluateLane(Lane &lane, double now) {
+  const std::size_t count = lane.targets.size();
+  if (count == 0)
+    return;
+
+  lane.values.resize(count);
+  const double *from = lane.from.data();
+  const double *to = lane.to.data();
+  const double *start = lane.start.data();
+  const double *invDuration = lane.invDuration.data();
+  double *values = lane.values.data();
+
+  // 1. Timing + easing: contiguous and branch-free, in SIMD kernels where
+  // the curve is a polynomial
+  std::size_t i = 0;
+  if constexpr (Curve != EasingCurve::Spring) {
+    switch (path()) {
+#if defined(OSF_ANIMATION_X86)
+    case Path::AVX2:
+      i = evaluateAVX2<Curve>(from, to, start, invDuration, values, count,
+                              now);
+      break;
+    case Path::SSE2:
+      i = evaluateSSE2<Curve>(from, to, start, invDuration, values, count,
+                              now);
+      break;
+#endif
+#if defined(OSF_ANIMATION_NEON)
+    case Path::NEON:
+      i = evaluateNEON<Curve>(from, to, start, invDuration, values, count,
+                              now);
+      break;
+#endif
+    default:
+      break;
+    }
+  }
+  for (; i < count; ++i) {
+    double t = std::min(1.0, std::max(0.0, (now - start[i]) * invDuration[i]));
+    values[i] = from[i] + (to[i] - from[i]) * ease<Curve>(t);
+  }
+
+  // 2. Bulk write-back
+  double *const *targets = lane.targets.data();
+  for (std::size_t i = 0; i < count; ++i) {
+    *targets[i] = values[i];
+  }
+
+  // 3. Retire finished tracks, landing exactly on their end value. Walk
+  // backwards so swap-remove only moves already-visited entries.
+  for (std::size_t i = count; i-- > 0;) {
+    if ((now - lane.start[i]) * lane.invDuration[i] >= 1.0) {
+      *lane.targets[i] = lane.to[i];
+      removeAt(static_cast<std::size_t>(Curve), i);
+    }
+  }
+}
+
+void OSFAnimationBatch::evaluate(double now) {
+  if (index_.empty())
+    return;
+  evaluateLane<EasingCurve::Linear>(
+      lanes_[static_cast<std::size_t>(EasingCurve::Linear)], now);
+  evaluateLane<EasingCurve::EaseIn>(
+      lanes_[static_cast<std::size_t>(EasingCurve::EaseIn)], now);
+  evaluateLane<EasingCurve::EaseOut>(
+      lanes_[static_cast<std::size_t>(EasingCurve::EaseOut)], now);
+  evaluateLane<EasingCurve::EaseInOut>(
+      lanes_[static_cast<std::size_t>(EasingCurve::EaseInOut)], now);
+  evaluateLane<EasingCurve::Spring>(
+      lanes_[static_cast<std::size_t>(EasingCurve::Spring)], now);
+}
+
 // =============================================================================
 // OSFAnimationManager
 // =============================================================================
@@ -270,18 +658,51 @@ void OSFAnimationManager::removeCompletedAnimations() {
       animations_.end());
 }
 
-void OSFAnimationManager::tick() {
-  if (animations_.empty())
+void OSFAnimationManager::animateValue(double *target, double from, double to,
+                                       double duration, EasingCurve curve,
+                                       double delay) {
+  batch_.add(target, from, to,
+             secondsSinceEpoch(OSFAnimation::Clock::now()) + delay, duration,
+             curve);
+}
+
+void OSFAnimationManager::cancelValueAnimation(double *target) {
+  batch_.cancel(target);
+}
+
+void OSFAnimationManager::cancelValueAnimations(const void *begin,
+                                                const void *end) {
+  batch_.cancelRange(begin, end);
+}
+
+double OSFAnimationManager::secondsSinceEpoch(
+    OSFAnimation::Clock::time_point time) const {
+  return std::chrono::duration<double>(time - epoch_).count();
+}
+
+void OSFAnimationManager::tick() { tick(OSFAnimation::Clock::now()); }
+
+void OSFAnimationManager::tick(OSFAnimation::Clock::time_point frameTime) {
+  lastTick_ = OSFAnimation::Clock::now();
+  // A predicted presentation can be ahead of a later clock tick
+  frameTime = std::max(frameTime, lastFrameTime_);
+  lastFrameTime_ = frameTime;
+  if (animations_.empty() && batch_.empty())
     return;
 
-  for (auto &anim : animations_) {
-    anim->tick();
+  // One time for everything, so all animations agree on the frame
+  batch_.evaluate(secondsSinceEpoch(frameTime));
+
+  // Index loop: callbacks may add animations (and reallocate) mid-tick
+  for (std::size_t i = 0, count = animations_.size(); i < count; ++i) {
+    animations_[i]->tick(frameTime);
   }
   removeCompletedAnimations();
 }
 
 bool OSFAnimationManager::hasActiveAnimations() const {
-  return std::any_of(animations_.begin(), animations_.end(),
+  return !batch_.empty() ||
+         std::any_of(animations_.begin(), animations_.end(),
                      [](const auto &anim) { return anim->isRunning(); });
 }
 
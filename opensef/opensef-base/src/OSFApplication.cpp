@@ -18,6 +18,13 @@
 
 namespace opensef {
 
+namespace {
+// Animation tick period when no window frame clock is available
+constexpr int kTimerFrameMs = 16;
+// Tick on the clock if frame callbacks stop arriving for this long
+constexpr int kFrameStallMs = 100;
+} // namespace
+
 OSFApplication &OSFApplication::shared() {
   static OSFApplication app;
   return app;
@@ -30,12 +37,35 @@ void OSFApplication::run() {
 
   running_ = true;
 
+  // Tasks posted from worker threads (OSFTaskScheduler continuations) wake
+  // the poll below through this eventfd.
+  const int runLoopFd = runLoop_.wakeupFd();
+
   while (running_) {
-    // If no windows/sources are registered, just wait
-    if (windows_.empty() && externalSources_.empty()) {
-      // Process any pending runloop tasks
-      runLoop_.postTask([]() {}); // Wake up runloop
-      std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    // Run-loop tasks first: results of background work land here.
+    runLoop_.runPendingTasks();
+    if (!running_)
+      break;
+
+    // Idle work (e.g. coalesced notifications) once per iteration
+    runLoop_.runIdleTasks();
+    if (!running_)
+      break;
+
+    auto &animations = OSFAnimationManager::shared();
+
+    // If no windows/sources are registered, just wait for posted tasks.
+    // There is no frame clock to follow, so animations tick on a timer.
+    if (windows_.empty() && externalSources_.empty() && fdWaiters_.empty()) {
+      bool animating = animations.hasActiveAnimations();
+      if (runLoopFd >= 0) {
+        struct pollfd pfd = {runLoopFd, POLLIN, 0};
+        poll(&pfd, 1, runLoop_.pollTimeout(animating ? kTimerFrameMs : -1));
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kTimerFrameMs));
+      }
+      if (animating)
+        animations.tick();
       continue;
     }
 
@@ -66,28 +96,61 @@ void OSFApplication::run() {
       fds.push_back(pfd);
     }
 
+    // 2b. One-shot fd waiters (OSFCoroutine awaitables)
+    size_t waiterStart = fds.size();
+    for (const auto &waiter : fdWaiters_) {
+      struct pollfd pfd;
+      pfd.fd = waiter.fd;
+      pfd.events = waiter.events;
+      pfd.revents = 0;
+      fds.push_back(pfd);
+    }
+
+    // 3. Run loop wakeup (not counted as a source to wait on by itself)
+    bool haveSources = !fds.empty();
+    if (runLoopFd >= 0) {
+      struct pollfd pfd;
+      pfd.fd = runLoopFd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      fds.push_back(pfd);
+    }
+
     // Check if we have any file descriptors to poll
-    if (fds.empty()) {
+    if (!haveSources) {
       std::this_thread::sleep_for(std::chrono::milliseconds(16));
       continue;
     }
 
+    // Animations advance on frame callbacks, sampled at the predicted
+    // presentation time (OSFWindow frame clock). Frames are only requested
+    // while something animates.
+    bool animating = animations.hasActiveAnimations();
+    bool frameDriven = false;
+    if (animating) {
+      for (OSFWindow *window : activeWindows) {
+        frameDriven |= window->scheduleAnimationFrame();
+      }
+    }
+
     // Determine poll timeout.
-    // If any window has a pending redraw OR is waiting for a frame callback,
-    // we should poll with a very short timeout (e.g., 1ms) to keep the loop
-    // tight. Otherwise, we can wait longer (e.g., 100ms) to save CPU.
-    bool busy = false;
-    bool pending = false; // Renamed from 'busy' to 'pending' for clarity
+    // A window that is dirty and not waiting on the compositor draws right
+    // after the poll, so don't block. Otherwise sleep until an event, a
+    // frame callback or a timer - indefinitely when nothing animates.
+    bool drawReady = false;
     for (OSFWindow *window : activeWindows) {
-      if (window->needsRedraw()) { // Check if any window needs a redraw
-        pending = true;
+      if (window->needsRedraw() && !window->isWaitingForFrame()) {
+        drawReady = true;
         break;
       }
     }
-    // Poll all descriptors
-    // If waiting for frame (framePending), use fail-safe timeout (e.g. 16ms)
-    // to prevent freezing if callback is lost.
-    int timeout = pending ? 16 : 100;
+    int maxTimeout = -1;
+    if (drawReady) {
+      maxTimeout = 0;
+    } else if (animating) {
+      maxTimeout = frameDriven ? kFrameStallMs : kTimerFrameMs;
+    }
+    int timeout = runLoop_.pollTimeout(maxTimeout);
 
     int result = poll(fds.data(), fds.size(), timeout);
 
@@ -117,29 +180,48 @@ void OSFApplication::run() {
           ++it; // Move to next if not ready or error
         }
       }
-    } else if (result == 0) {
-      // Timeout (100ms or 16ms)
-      // If we were waiting for a frame and timed out (16ms),
-      // Force a redraw check to keep animation moving.
-      if (pending) {
-        // Force updates if stuck?
-        // Actually, OSFWindow::update() will skip if framePending && strict.
-        // But we relaxed strictness.
+
+      // Fire ready fd waiters once; callbacks may register new waiters.
+      std::vector<FdWaiter> waiters;
+      waiters.swap(fdWaiters_);
+      for (size_t i = 0; i < waiters.size(); ++i) {
+        short revents = fds[waiterStart + i].revents;
+        if (revents != 0) {
+          waiters[i].callback(revents);
+        } else {
+          fdWaiters_.push_back(std::move(waiters[i]));
+        }
       }
     }
 
-    // ALWAYS perform update/animation tick for all windows
-    // This drives the "Game Loop"
+    // One tick per iteration, however many windows got a frame: at the
+    // earliest predicted presentation, so the soonest frame is on time
+    bool framed = false;
+    std::chrono::steady_clock::time_point frameTime;
     for (OSFWindow *window : activeWindows) {
-      // Force 'needsRedraw' if we want continuous animation (e.g. progress
-      // bars) For now, let's just call update(). If OSFWindow thinks it's done,
-      // it returns. But for Phase 3 (which might be animating), we might need
-      // to Poke it.
-      window->update();
+      std::chrono::steady_clock::time_point presentation;
+      if (window->takeAnimationFrame(&presentation) &&
+          (!framed || presentation < frameTime)) {
+        frameTime = presentation;
+        framed = true;
+      }
+    }
+    if (framed) {
+      animations.tick(frameTime);
+    } else if (animating &&
+               (!frameDriven ||
+                std::chrono::steady_clock::now() - animations.lastTickTime() >=
+                    std::chrono::milliseconds(kFrameStallMs))) {
+      // No window can produce frames (or the compositor stopped sending
+      // them, e.g. every window is hidden): keep animations moving on the
+      // clock.
+      animations.tick();
     }
 
-    // Drive animations
-    OSFAnimationManager::shared().tick();
+    // Draw dirty windows; each draw requests its own frame callback
+    for (OSFWindow *window : activeWindows) {
+      window->update();
+    }
   }
 
   if (onTerminate_) {
@@ -161,6 +243,13 @@ void OSFApplication::addExternalEventSource(int fd,
   externalSources_.push_back({fd, callback});
 }
 
+void OSFApplication::waitForFd(int fd, short events,
+                               std::function<void(short)> callback) {
+  if (fd < 0 || !callback)
+    return;
+  fdWaiters_.push_back({fd, events, std::move(callback)});
+}
+
 void OSFApplication::registerWindow(OSFWindow *window) {
   if (window &&
       std::find(windows_.begin(), windows_.end(), window) == windows_.end()) {
@@ -0,0 +1,341 @@
+/**
+ * OSFDecorationCache.cpp - Pre-rendered Client-Side Decorations
+ */
+
+#include <opensef/OSFAresTheme.h>
+#include <opensef/OSFDecorationCache.h>
+
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace opensef {
+
+namespace {
+
+// Traffic light centers
+constexpr double kButtonX[3] = {24, 46, 68};
+constexpr double kButtonY = 19;
+constexpr double kButtonRadius = 6;
+
+void setTitleFont(cairo_t *cr) {
+  cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
+                         CAIRO_FONT_WEIGHT_BOLD);
+  cairo_set_font_size(cr, 13);
+}
+
+} // namespace
+
+OSFDecorationCache::~OSFDecorationCache() { clear(); }
+
+void OSFDecorationCache::clear() {
+  for (int active = 0; active < 2; ++active) {
+    if (strips_[active]) {
+      cairo_surface_destroy(strips_[active]);
+      strips_[active] = nullptr;
+    }
+    for (auto &patch : patches_[active]) {
+      if (patch) {
+        cairo_surface_destroy(patch);
+        patch = nullptr;
+      }
+    }
+  }
+  if (titleSprite_) {
+    cairo_surface_destroy(titleSprite_);
+    titleSprite_ = nullptr;
+  }
+  title_.clear();
+  titleWidth_ = 0.0;
+  titleHeight_ = 0.0;
+}
+
+OSFRect OSFDecorationCache::buttonRect(int button) {
+  if (button < 1 || button > 3)
+    return OSFRect();
+  // Circle plus antialiasing; the hover glyph stays inside it
+  double x = kButtonX[button - 1];
+  return OSFRect(x - kButtonRadius - 2, kButtonY - kButtonRadius - 2,
+                 2 * kButtonRadius + 4, 2 * kButtonRadius + 4);
+}
+
+// =============================================================================
+// Drawing
+// =============================================================================
+
+void OSFDecorationCache::paintBar(cairo_t *cr, int width, bool active,
+                                  int hoveredButton) {
+  cairo_save(cr);
+
+  // 0. Transparent outside the rounded top corners (9px)
+  cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_rgba(cr, 0, 0, 0, 0);
+  cairo_rectangle(cr, 0, 0, width, kHeight);
+  cairo_fill(cr);
+
+  // The bottom corners lie below the strip whatever the window height
+  AresTheme::roundedRect(cr, 0, 0, width, kHeight + 2 * kCornerRadius,
+                         kCornerRadius);
+  cairo_clip(cr);
+  cairo_rectangle(cr, 0, 0, width, kHeight);
+  cairo_clip(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+  // 1. Window Background (Pure White)
+  cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+  cairo_paint(cr);
+
+  // 2. Titlebar (VitusOS Light: #F5F5F5)
+  cairo_set_source_rgb(cr, 0.96, 0.96, 0.96);
+  cairo_rectangle(cr, 0, 0, width, kTitlebarHeight);
+  cairo_fill(cr);
+
+  // 3. Traffic Lights (Ares Palette), grey while inactive
+  static const double colors[3][3] = {
+      {0.83, 0.38, 0.16}, // Close (MarsOrange: #D4622A)
+      {0.83, 0.66, 0.24}, // Minimize (MarsGold: #D4A93E)
+      {0.29, 0.62, 0.83}, // Maximize (VitusBlue: #4A9FD4)
+  };
+  for (int i = 0; i < 3; ++i) {
+    if (active) {
+      cairo_set_source_rgb(cr, colors[i][0], colors[i][1], colors[i][2]);
+    } else {
+      cairo_set_source_rgb(cr, 0.8, 0.8, 0.8);
+    }
+    cairo_arc(cr, kButtonX[i], kButtonY, kButtonRadius, 0, 2 * M_PI);
+    cairo_fill(cr);
+  }
+
+  double cx = hoveredButton >= 1 && hoveredButton <= 3
+                  ? kButtonX[hoveredButton - 1]
+                  : 0.0;
+  cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
+  cairo_set_line_width(cr, 1.2);
+  if (hoveredButton == 1) {
+    cairo_move_to(cr, cx - 3, kButtonY - 3);
+    cairo_line_to(cr, cx + 3, kButtonY + 3);
+    cairo_move_to(cr, cx + 3, kButtonY - 3);
+    cairo_line_to(cr, cx - 3, kButtonY + 3);
+    cairo_stroke(cr);
+  } else if (hoveredButton == 2) {
+    cairo_move_to(cr, cx - 3, kButtonY);
+    cairo_line_to(cr, cx + 3, kButtonY);
+    cairo_stroke(cr);
+  } else if (hoveredButton == 3) {
+    cairo_move_to(cr, cx - 3, kButtonY);
+    cairo_line_to(cr, cx + 3, kButtonY);
+    cairo_move_to(cr, cx, kButtonY - 3);
+    cairo_line_to(cr, cx, kButtonY + 3);
+    cairo_stroke(cr);
+  }
+
+  // 5. Separator
+  cairo_set_source_rgba(cr, 0, 0, 0, 0.1);
+  cairo_set_line_width(cr, 2.0);
+  cairo_move_to(cr, 0, kTitlebarHeight);
+  cairo_line_to(cr, width, kTitlebarHeight);
+  cairo_stroke(cr);
+
+  cairo_restore(cr);
+}
+
+void OSFDecorationCache::paintTitle(cairo_t *cr, double x, double y,
+                                    bool active, const std::string &title) {
+  // 4. Title Text (Dark: #1A1A1A)
+  cairo_save(cr);
+  if (active) {
+    cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+  } else {
+    cairo_set_source_rgb(cr, 0.55, 0.55, 0.55);
+  }
+  setTitleFont(cr);
+  cairo_move_to(cr, x, y);
+  cairo_show_text(cr, title.c_str());
+  cairo_restore(cr);
+}
+
+void OSFDecorationCache::paint(cairo_t *cr, int width, bool active,
+                               int hoveredButton, const std::string &title) {
+  paintBar(cr, width, active, hoveredButton);
+  if (title.empty())
+    return;
+
+  cairo_save(cr);
+  setTitleFont(cr);
+  cairo_text_extents_t ext;
+  cairo_text_extents(cr, title.c_str(), &ext);
+  cairo_restore(cr);
+  paintTitle(cr, (width - ext.width) / 2.0, kButtonY + ext.height / 2.0 - 2,
+             active, title);
+}
+
+// =============================================================================
+// Cached bitmaps
+// =============================================================================
+
+cairo_surface_t *OSFDecorationCache::strip(bool active) {
+  cairo_surface_t *&surface = strips_[active];
+  if (surface)
+    return surface;
+
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, kReferenceWidth,
+                                       kHeight);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    surface = nullptr;
+    return nullptr;
+  }
+  cairo_t *cr = cairo_create(surface);
+  paintBar(cr, kReferenceWidth, active, 0);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  ++rasterizations_;
+  return surface;
+}
+
+cairo_surface_t *OSFDecorationCache::patch(bool active, int button) {
+  cairo_surface_t *&surface = patches_[active][button - 1];
+  if (surface)
+    return surface;
+
+  // The reference strip drawn hovered, cut down to the button
+  OSFRect rect = buttonRect(button);
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                       static_cast<int>(rect.width),
+                                       static_cast<int>(rect.height));
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    surface = nullptr;
+    return nullptr;
+  }
+  cairo_surface_set_device_offset(surface, -rect.x, -rect.y);
+  cairo_t *cr = cairo_create(surface);
+  paintBar(cr, kReferenceWidth, active, button);
+  cairo_destroy(cr);
+  cairo_surface_set_device_offset(surface, 0, 0);
+  cairo_surface_flush(surface);
+  ++rasterizations_;
+  return surface;
+}
+
+void OSFDecorationCache::updateTitle(bool active, const std::string &title) {
+  if (title == title_ && active == titleActive_ &&
+      (titleSprite_ || title.empty()))
+    return;
+
+  if (titleSprite_) {
+    cairo_surface_destroy(titleSprite_);
+    titleSprite_ = nullptr;
+  }
+  titleActive_ = active;
+  if (title.empty()) {
+    title_.clear();
+    return;
+  }
+
+  // Measure once per title; a palette change reuses the extents
+  cairo_text_extents_t ext;
+  if (title != title_) {
+    cairo_surface_t *scratch =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t *cr = cairo_create(scratch);
+    setTitleFont(cr);
+    cairo_text_extents(cr, title.c_str(), &ext);
+    cairo_destroy(cr);
+    cairo_surface_destroy(scratch);
+
+    title_ = title;
+    titleWidth_ = ext.width;
+    titleHeight_ = ext.height;
+    titlePad_ = 2 + static_cast<int>(std::ceil(std::fmax(0.0, -ext.x_bearing)));
+    titleSpriteWidth_ = titlePad_ +
+                        static_cast<int>(std::ceil(std::fmax(
+                            ext.x_advance, ext.x_bearing + ext.width))) +
+                        2;
+  }
+
+  titleSprite_ = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                            titleSpriteWidth_, kHeight);
+  if (cairo_surface_status(titleSprite_) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(titleSprite_);
+    titleSprite_ = nullptr;
+    return;
+  }
+  cairo_t *cr = cairo_create(titleSprite_);
+  paintTitle(cr, titlePad_, kButtonY + titleHeight_ / 2.0 - 2, active,
+             title_);
+  cairo_destroy(cr);
+  cairo_surface_flush(titleSprite_);
+  ++rasterizations_;
+}
+
+void OSFDecorationCache::prepare(bool active, int hoveredButton,
+                                 const std::string &title) {
+  strip(active);
+  if (hoveredButton >= 1 && hoveredButton <= 3)
+    patch(active, hoveredButton);
+  updateTitle(active, title);
+}
+
+void OSFDecorationCache::draw(cairo_t *cr, int width, bool active,
+                              int hoveredButton, const std::string &title) {
+  cairo_surface_t *bar = width >= kMinWidth ? strip(active) : nullptr;
+  if (!bar) {
+    paint(cr, width, active, hoveredButton, title);
+    return;
+  }
+
+  cairo_save(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+
+  // Left corner and traffic lights
+  cairo_set_source_surface(cr, bar, 0, 0);
+  cairo_rectangle(cr, 0, 0, kLeft, kHeight);
+  cairo_fill(cr);
+
+  // Everything between the corners is one repeated column
+  cairo_surface_t *column =
+      cairo_surface_create_for_rectangle(bar, kLeft, 0, 1, kHeight);
+  cairo_pattern_t *middle = cairo_pattern_create_for_surface(column);
+  cairo_pattern_set_extend(middle, CAIRO_EXTEND_REPEAT);
+  cairo_matrix_t matrix;
+  cairo_matrix_init_translate(&matrix, -kLeft, 0);
+  cairo_pattern_set_matrix(middle, &matrix);
+  cairo_set_source(cr, middle);
+  cairo_rectangle(cr, kLeft, 0, width - kLeft - kRight, kHeight);
+  cairo_fill(cr);
+  cairo_pattern_destroy(middle);
+  cairo_surface_destroy(column);
+
+  // Right corner
+  cairo_set_source_surface(cr, bar, width - kReferenceWidth, 0);
+  cairo_rectangle(cr, width - kRight, 0, kRight, kHeight);
+  cairo_fill(cr);
+
+  // Hover glyph
+  cairo_surface_t *hover =
+      hoveredButton >= 1 && hoveredButton <= 3 ? patch(active, hoveredButton)
+                                               : nullptr;
+  if (hover) {
+    OSFRect rect = buttonRect(hoveredButton);
+    cairo_set_source_surface(cr, hover, rect.x, rect.y);
+    cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+    cairo_fill(cr);
+  }
+
+  // Title, centered on whole pixels
+  updateTitle(active, title);
+  if (titleSprite_) {
+    double x = std::round((width - titleWidth_) / 2.0) - titlePad_;
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_set_source_surface(cr, titleSprite_, x, 0);
+    cairo_rectangle(cr, x, 0, titleSpriteWidth_, kHeight);
+    cairo_fill(cr);
+  }
+
+  cairo_restore(cr);
+}
+
+} // namespace opensef
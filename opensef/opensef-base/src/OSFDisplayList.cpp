@@ -0,0 +1,226 @@
+/**
+ * OSFDisplayList.cpp - Recorded View Drawing Implementation
+ */
+
+#include <opensef/OSFDisplayList.h>
+#include <opensef/OSFLayer.h>
+#include <opensef/OSFView.h>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace opensef {
+
+// cairo may build lookup structures inside a recording surface the first
+// time it is replayed, so concurrent tiles replay one item in turn
+struct OSFDisplayList::Recording {
+  cairo_surface_t *surface = nullptr;
+  OSFRect extent; // Ink extents in view space
+  std::mutex lock;
+
+  ~Recording() {
+    if (surface)
+      cairo_surface_destroy(surface);
+  }
+};
+
+namespace {
+
+thread_local int recordingDepth = 0;
+
+// Smallest whole-pixel rect covering r
+OSFRect pixelAligned(const OSFRect &r) {
+  if (r.isEmpty())
+    return OSFRect();
+  double x0 = std::floor(r.x);
+  double y0 = std::floor(r.y);
+  return OSFRect(x0, y0, std::ceil(r.x + r.width) - x0,
+                 std::ceil(r.y + r.height) - y0);
+}
+
+bool sameRect(const OSFRect &a, const OSFRect &b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height;
+}
+
+bool touches(const OSFRect &a, const OSFRect &b) {
+  return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+         a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+} // namespace
+
+bool OSFDisplayList::isRecording() { return recordingDepth > 0; }
+
+void OSFDisplayList::clear() {
+  items_.clear();
+  index_.clear();
+  recorded_ = 0;
+}
+
+const OSFDisplayList::Item *OSFDisplayList::find(uint64_t viewId,
+                                                 std::size_t *index) const {
+  auto it = index_.find(viewId);
+  if (it == index_.end())
+    return nullptr;
+  if (index)
+    *index = it->second;
+  return &items_[it->second];
+}
+
+void OSFDisplayList::build(OSFView &root, const OSFPoint &origin,
+                           const OSFRect &clip,
+                           const OSFDisplayList *previous) {
+  // clear() keeps the item array's capacity for the next frame
+  clear();
+  clip_ = clip;
+  recordView(root, origin, previous);
+
+  index_.reserve(items_.size());
+  for (std::size_t i = 0; i < items_.size(); ++i) {
+    index_[items_[i].viewId] = i;
+  }
+}
+
+void OSFDisplayList::recordView(OSFView &view, const OSFPoint &origin,
+                                const OSFDisplayList *previous) {
+  if (view.hidden_ || view.alpha_ <= 0.0)
+    return;
+
+  Item item;
+  item.viewId = view.viewId_;
+  item.version = view.displayVersion_;
+  item.layerState = view.layer_ ? view.layer_->stateHash() : 0;
+  item.origin = origin;
+
+  const Item *old = previous ? previous->find(item.viewId) : nullptr;
+  if (old && old->version == item.version &&
+      old->layerState == item.layerState) {
+    item.recording = old->recording;
+  } else {
+    cairo_surface_t *surface =
+        cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+    cairo_t *cr = cairo_create(surface);
+    ++recordingDepth;
+    view.render(cr);
+    --recordingDepth;
+    cairo_destroy(cr);
+    view.needsDisplay_ = false;
+    ++recorded_;
+
+    double x, y, width, height;
+    cairo_recording_surface_ink_extents(surface, &x, &y, &width, &height);
+    if (width > 0 && height > 0) {
+      item.recording = std::make_shared<Recording>();
+      item.recording->surface = surface;
+      item.recording->extent = OSFRect(x, y, width, height);
+    } else {
+      cairo_surface_destroy(surface);
+    }
+  }
+
+  if (item.recording) {
+    OSFRect extent = item.recording->extent;
+    extent.x += origin.x;
+    extent.y += origin.y;
+    item.bounds = pixelAligned(extent.intersected(clip_));
+  }
+  items_.push_back(std::move(item));
+
+  // Same culling as OSFView::render
+  for (auto &subview : view.subviews_) {
+    OSFPoint subOrigin(origin.x + subview->frame_.x,
+                       origin.y + subview->frame_.y);
+    OSFRect paint = subview->paintBounds();
+    paint.x += subOrigin.x;
+    paint.y += subOrigin.y;
+    if (!paint.isEmpty() && paint.intersected(clip_).isEmpty())
+      continue;
+    recordView(*subview, subOrigin, previous);
+  }
+}
+
+void OSFDisplayList::replay(cairo_t *cr) const {
+  double x1, y1, x2, y2;
+  cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+  OSFRect visible = OSFRect(x1, y1, x2 - x1, y2 - y1).intersected(clip_);
+  if (visible.isEmpty())
+    return;
+
+  cairo_save(cr);
+  cairo_rectangle(cr, clip_.x, clip_.y, clip_.width, clip_.height);
+  cairo_clip(cr);
+  for (const Item &item : items_) {
+    if (!item.recording || item.bounds.intersected(visible).isEmpty())
+      continue;
+    std::lock_guard<std::mutex> lock(item.recording->lock);
+    cairo_set_source_surface(cr, item.recording->surface, item.origin.x,
+                             item.origin.y);
+    cairo_paint(cr);
+  }
+  cairo_restore(cr);
+}
+
+std::vector<OSFRect> OSFDisplayList::damage(
+    const OSFDisplayList &previous) const {
+  std::vector<OSFRect> rects;
+  auto add = [&rects](const OSFRect &rect) {
+    if (!rect.isEmpty())
+      rects.push_back(rect);
+  };
+
+  if (!sameRect(clip_, previous.clip_)) {
+    add(pixelAligned(clip_.united(previous.clip_)));
+  } else {
+    // Matched items must keep their relative order; one that moved
+    // backwards changed stacking against everything it jumped over
+    std::size_t lastOld = 0;
+    for (const Item &item : items_) {
+      std::size_t oldIndex = 0;
+      const Item *old = previous.find(item.viewId, &oldIndex);
+      if (!old) {
+        add(item.bounds);
+        continue;
+      }
+      bool restacked = oldIndex < lastOld;
+      lastOld = std::max(lastOld, oldIndex);
+      if (restacked || old->recording != item.recording ||
+          old->origin.x != item.origin.x || old->origin.y != item.origin.y ||
+          !sameRect(old->bounds, item.bounds)) {
+        add(old->bounds);
+        add(item.bounds);
+      }
+    }
+    for (const Item &old : previous.items_) {
+      if (!find(old.viewId))
+        add(old.bounds);
+    }
+  }
+
+  // Merge overlapping or adjacent rects until none touch
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (std::size_t i = 0; i < rects.size() && !merged; ++i) {
+      for (std::size_t j = i + 1; j < rects.size(); ++j) {
+        if (touches(rects[i], rects[j])) {
+          rects[i] = rects[i].united(rects[j]);
+          rects.erase(rects.begin() + j);
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+
+  if (rects.size() > kMaxDamageRects) {
+    OSFRect all;
+    for (const OSFRect &rect : rects)
+      all = all.united(rect);
+    rects.assign(1, all);
+  }
+  return rects;
+}
+
+} // namespace opensef
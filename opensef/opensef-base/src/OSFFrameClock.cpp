@@ -0,0 +1,52 @@
+/**
+ * OSFFrameClock.cpp - Per-window frame timing
+ */
+
+#include <opensef/OSFFrameClock.h>
+
+namespace opensef {
+
+void OSFFrameClock::frameDone(uint32_t timeMs, Clock::time_point received) {
+  if (haveFrame_ && !exactRefresh_) {
+    // Unsigned subtraction survives the 32-bit wraparound. Gaps over 100ms
+    // are idle periods, not refresh intervals.
+    uint32_t deltaMs = timeMs - lastFrameMs_;
+    if (deltaMs > 0 && deltaMs <= 100) {
+      // Smooth jitter: new = 7/8 old + 1/8 sample
+      interval_ = (interval_ * 7 + std::chrono::milliseconds(deltaMs)) / 8;
+    }
+  }
+  haveFrame_ = true;
+  lastFrameMs_ = timeMs;
+
+  // Frame callbacks fire around vblank: good enough as an anchor until
+  // presentation feedback supplies exact timestamps.
+  if (!presentationAnchor_) {
+    anchor_ = received;
+    haveAnchor_ = true;
+  }
+}
+
+void OSFFrameClock::presented(Clock::time_point when, Clock::duration refresh) {
+  if (refresh > Clock::duration::zero()) {
+    interval_ = refresh;
+    exactRefresh_ = true;
+  }
+  anchor_ = when;
+  haveAnchor_ = true;
+  presentationAnchor_ = true;
+}
+
+OSFFrameClock::Clock::time_point
+OSFFrameClock::nextPresentation(Clock::time_point now) const {
+  if (!haveAnchor_ || interval_ <= Clock::duration::zero())
+    return now + interval_;
+
+  // First vblank strictly after now, on the anchor's grid
+  if (now < anchor_)
+    return anchor_;
+  auto periods = (now - anchor_) / interval_ + 1;
+  return anchor_ + periods * interval_;
+}
+
+} // namespace opensef
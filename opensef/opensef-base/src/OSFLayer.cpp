@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iostream>
 #include <opensef/OSFLayer.h>
+#include <opensef/OSFShadowCache.h>
 
 
 #ifndef M_PI
@@ -17,43 +19,51 @@ bool OSFLayer::disableImplicitAnimations_ = false;
 
 OSFLayer::OSFLayer() = default;
 
-OSFLayerPtr OSFLayer::create() { return std::make_shared<OSFLayer>(); }
+OSFLayer::~OSFLayer() {
+  // Implicit animations write straight into our members
+  OSFAnimationManager::shared().cancelValueAnimations(this, this + 1);
+  if (backing_) {
+    cairo_surface_destroy(backing_);
+  }
+}
+
+OSFLayerPtr OSFLayer::create() {
+  auto layer = std::make_shared<OSFLayer>();
+  // A plain layer's draw() is the base no-op: all it paints is its style
+  layer->cachesDrawing_ = true;
+  layer->emptyDraw_ = true;
+  return layer;
+}
 
 // =============================================================================
 // Property Setters with Implicit Animation
 // =============================================================================
 
 void OSFLayer::animatePropertyChange(double *target, double from, double to) {
+  auto &manager = OSFAnimationManager::shared();
   if (disableImplicitAnimations_ || from == to) {
+    // Stop any in-flight animation so it can't overwrite the new value
+    manager.cancelValueAnimation(target);
     *target = to;
     return;
   }
 
-  auto anim = OSFPropertyAnimation::create(target, from, to);
-  anim->setDuration(AnimationTiming::Quick);
-  anim->setEasing(Easing::easeOut);
-  anim->start();
-  OSFAnimationManager::shared().addAnimation(anim);
+  // Batch track: no per-property OSFAnimation object; a newer change to
+  // the same property replaces the running track
+  manager.animateValue(target, from, to, AnimationTiming::Quick,
+                       EasingCurve::EaseOut);
 }
 
 void OSFLayer::setPosition(const OSFPoint &pos) {
-  if (!disableImplicitAnimations_) {
-    animatePropertyChange(&position_.x, position_.x, pos.x);
-    animatePropertyChange(&position_.y, position_.y, pos.y);
-  } else {
-    position_ = pos;
-  }
+  animatePropertyChange(&position_.x, position_.x, pos.x);
+  animatePropertyChange(&position_.y, position_.y, pos.y);
 }
 
 void OSFLayer::setBounds(const OSFRect &bounds) {
-  if (!disableImplicitAnimations_) {
-    animatePropertyChange(&bounds_.x, bounds_.x, bounds.x);
-    animatePropertyChange(&bounds_.y, bounds_.y, bounds.y);
-    animatePropertyChange(&bounds_.width, bounds_.width, bounds.width);
-    animatePropertyChange(&bounds_.height, bounds_.height, bounds.height);
-  } else {
-    bounds_ = bounds;
-  }
+  animatePropertyChange(&bounds_.x, bounds_.x, bounds.x);
+  animatePropertyChange(&bounds_.y, bounds_.y, bounds.y);
+  animatePropertyChange(&bounds_.width, bounds_.width, bounds.width);
+  animatePropertyChange(&bounds_.height, bounds_.height, bounds.height);
 }
 
 void OSFLayer::setOpacity(double opacity) {
@@ -142,12 +152,46 @@ void OSFLayer::insertSublayer(OSFLayerPtr layer, size_t index) {
 // Rendering
 // =============================================================================
 
+namespace {
+
+void roundedRectPath(cairo_t *cr, double x, double y, double w, double h,
+                     double r) {
+  cairo_new_sub_path(cr);
+  cairo_arc(cr, x + w - r, y + r, r, -M_PI / 2, 0);
+  cairo_arc(cr, x + w - r, y + h - r, r, 0, M_PI / 2);
+  cairo_arc(cr, x + r, y + h - r, r, M_PI / 2, M_PI);
+  cairo_arc(cr, x + r, y + r, r, M_PI, 3 * M_PI / 2);
+  cairo_close_path(cr);
+}
+
+// Device pixels per layer unit under the current transform, quantized so
+// float noise in parent transforms doesn't force a re-rasterization
+double rasterScale(cairo_t *cr) {
+  cairo_matrix_t m;
+  cairo_get_matrix(cr, &m);
+  double scale = std::sqrt(std::fabs(m.xx * m.yy - m.xy * m.yx));
+  double deviceX = 1.0;
+  double deviceY = 1.0;
+  cairo_surface_get_device_scale(cairo_get_target(cr), &deviceX, &deviceY);
+  scale *= deviceX;
+  if (!(scale > 0.0))
+    return 1.0;
+  return std::ceil(scale * 4.0) / 4.0;
+}
+
+} // namespace
+
 void OSFLayer::render(cairo_t *cr) {
+  if (opacity_ <= 0.0)
+    return;
+
   cairo_save(cr);
 
-  // Apply transforms
+  // Apply position; the backing store is rasterized at this scale
   cairo_translate(cr, position_.x, position_.y);
+  double scale = rasterScale(cr);
 
+  // Scale and rotation only transform the cached bitmap
   if (scaleX_ != 1.0 || scaleY_ != 1.0) {
     cairo_translate(cr, bounds_.width / 2, bounds_.height / 2);
     cairo_scale(cr, scaleX_, scaleY_);
@@ -160,25 +204,65 @@ void OSFLayer::render(cairo_t *cr) {
     cairo_translate(cr, -bounds_.width / 2, -bounds_.height / 2);
   }
 
-  // Apply opacity
-  cairo_push_group(cr);
+  // Sublayers must be faded together with us, which needs a group; a
+  // leaf layer applies its opacity while compositing the backing store.
+  bool group = opacity_ < 1.0 && !sublayers_.empty();
+  double alpha = group ? 1.0 : opacity_;
+  if (group) {
+    cairo_push_group(cr);
+  }
 
-  // Draw shadow
+  // Tiles of one frame may render this layer concurrently; the first to
+  // get here rebuilds the store, the rest find it current. A layer that
+  // hasn't opted in is drawn directly every time.
+  bool cached = false;
+  if (cachesDrawing_) {
+    std::lock_guard<std::mutex> lock(backingMutex_);
+    cached = updateBackingStore(scale);
+  }
+
+  if (cached) {
+    if (backing_) {
+      cairo_set_source_surface(cr, backing_, backingExtent_.x,
+                               backingExtent_.y);
+      if (alpha < 1.0) {
+        cairo_paint_with_alpha(cr, alpha);
+      } else {
+        cairo_paint(cr);
+      }
+    }
+  } else {
+    drawUncached(cr, alpha);
+  }
+
+  // Draw sublayers
+  for (auto &sublayer : sublayers_) {
+    sublayer->render(cr);
+  }
+
+  if (group) {
+    cairo_pop_group_to_source(cr);
+    cairo_paint_with_alpha(cr, opacity_);
+  }
+
+  cairo_restore(cr);
+}
+
+void OSFLayer::drawUncached(cairo_t *cr, double alpha) {
+  if (alpha < 1.0) {
+    cairo_push_group(cr);
+    drawContents(cr);
+    cairo_pop_group_to_source(cr);
+    cairo_paint_with_alpha(cr, alpha);
+  } else {
+    drawContents(cr);
+  }
+}
+
+void OSFLayer::drawContents(cairo_t *cr) {
+  // Draw shadow (blurred nine-slice, shared across layers)
   if (shadowOpacity_ > 0.0 && shadowRadius_ > 0.0) {
-    cairo_set_source_rgba(cr, 0, 0, 0, shadowOpacity_ * 0.5);
-    double sr = cornerRadius_;
-    double sx = bounds_.x + shadowOffset_.x;
-    double sy = bounds_.y + shadowOffset_.y;
-    double sw = bounds_.width;
-    double sh = bounds_.height;
-
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, sx + sw - sr, sy + sr, sr + shadowRadius_, -M_PI / 2, 0);
-    cairo_arc(cr, sx + sw - sr, sy + sh - sr, sr + shadowRadius_, 0, M_PI / 2);
-    cairo_arc(cr, sx + sr, sy + sh - sr, sr + shadowRadius_, M_PI / 2, M_PI);
-    cairo_arc(cr, sx + sr, sy + sr, sr + shadowRadius_, M_PI, 3 * M_PI / 2);
-    cairo_close_path(cr);
-    cairo_fill(cr);
+    OSFShadowCache::shared().drawShadow(cr, bounds_, shadowStyle());
   }
 
   // Draw background
@@ -186,16 +270,8 @@ void OSFLayer::render(cairo_t *cr) {
     backgroundColor_.setCairo(cr);
 
     if (cornerRadius_ > 0.0) {
-      double r = cornerRadius_;
-      cairo_new_sub_path(cr);
-      cairo_arc(cr, bounds_.x + bounds_.width - r, bounds_.y + r, r, -M_PI / 2,
-                0);
-      cairo_arc(cr, bounds_.x + bounds_.width - r,
-                bounds_.y + bounds_.height - r, r, 0, M_PI / 2);
-      cairo_arc(cr, bounds_.x + r, bounds_.y + bounds_.height - r, r, M_PI / 2,
-                M_PI);
-      cairo_arc(cr, bounds_.x + r, bounds_.y + r, r, M_PI, 3 * M_PI / 2);
-      cairo_close_path(cr);
+      roundedRectPath(cr, bounds_.x, bounds_.y, bounds_.width, bounds_.height,
+                      cornerRadius_);
     } else {
       cairo_rectangle(cr, bounds_.x, bounds_.y, bounds_.width, bounds_.height);
     }
@@ -203,7 +279,9 @@ void OSFLayer::render(cairo_t *cr) {
   }
 
   // Custom drawing
+  cairo_save(cr);
   draw(cr);
+  cairo_restore(cr);
 
   // Draw border
   if (borderWidth_ > 0.0 && borderColor_.a > 0.0) {
@@ -211,32 +289,189 @@ void OSFLayer::render(cairo_t *cr) {
     cairo_set_line_width(cr, borderWidth_);
 
     if (cornerRadius_ > 0.0) {
-      double r = cornerRadius_;
-      cairo_new_sub_path(cr);
-      cairo_arc(cr, bounds_.x + bounds_.width - r, bounds_.y + r, r, -M_PI / 2,
-                0);
-      cairo_arc(cr, bounds_.x + bounds_.width - r,
-                bounds_.y + bounds_.height - r, r, 0, M_PI / 2);
-      cairo_arc(cr, bounds_.x + r, bounds_.y + bounds_.height - r, r, M_PI / 2,
-                M_PI);
-      cairo_arc(cr, bounds_.x + r, bounds_.y + r, r, M_PI, 3 * M_PI / 2);
-      cairo_close_path(cr);
+      roundedRectPath(cr, bounds_.x, bounds_.y, bounds_.width, bounds_.height,
+                      cornerRadius_);
     } else {
       cairo_rectangle(cr, bounds_.x, bounds_.y, bounds_.width, bounds_.height);
     }
     cairo_stroke(cr);
   }
+}
 
-  // Draw sublayers
-  for (auto &sublayer : sublayers_) {
-    sublayer->render(cr);
+// =============================================================================
+// Backing Store
+// =============================================================================
+
+void OSFLayer::setNeedsDisplay() {
+  needsDisplay_ = true;
+  ++contentsVersion_;
+}
+
+void OSFLayer::setCachesDrawing(bool caches) {
+  if (caches == cachesDrawing_)
+    return;
+  cachesDrawing_ = caches;
+  if (!caches) {
+    discardBackingStore(); // It holds draw() output
   }
+  setNeedsDisplay();
+}
 
-  // Apply opacity
-  cairo_pop_group_to_source(cr);
-  cairo_paint_with_alpha(cr, opacity_);
+void OSFLayer::setNeedsDisplayInRect(const OSFRect &rect) {
+  dirtyRect_ = dirtyRect_.united(rect);
+  ++contentsVersion_;
+}
 
-  cairo_restore(cr);
+std::size_t OSFLayer::stateHash() const {
+  // FNV-1a over the raw property values
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+
+  BackingKey key = backingKey(1.0);
+  const double transform[] = {position_.x, position_.y, opacity_,
+                              scaleX_,     scaleY_,     rotation_};
+  mix(key.data(), sizeof(key));
+  mix(transform, sizeof(transform));
+  mix(&contentsVersion_, sizeof(contentsVersion_));
+  for (const auto &sublayer : sublayers_) {
+    std::size_t sub = sublayer->stateHash();
+    mix(&sub, sizeof(sub));
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+void OSFLayer::discardBackingStore() {
+  if (backing_) {
+    cairo_surface_destroy(backing_);
+    backing_ = nullptr;
+  }
+  backingValid_ = false;
+  needsDisplay_ = true;
+}
+
+OSFLayer::BackingKey OSFLayer::backingKey(double scale) const {
+  return {bounds_.x,          bounds_.y,          bounds_.width,
+          bounds_.height,     cornerRadius_,      backgroundColor_.r,
+          backgroundColor_.g, backgroundColor_.b, backgroundColor_.a,
+          borderWidth_,       borderColor_.r,     borderColor_.g,
+          borderColor_.b,     borderColor_.a,     shadowOpacity_,
+          shadowRadius_,      shadowOffset_.x,    shadowOffset_.y,
+          scale};
+}
+
+OSFShadowStyle OSFLayer::shadowStyle() const {
+  OSFShadowStyle style;
+  style.cornerRadius = cornerRadius_;
+  style.blur = shadowRadius_;
+  style.color = OSFColor(0, 0, 0, shadowOpacity_ * 0.5);
+  style.offset = shadowOffset_;
+  return style;
+}
+
+OSFRect OSFLayer::contentExtent() const {
+  OSFRect extent = bounds_;
+
+  // Half the border stroke lies outside the bounds
+  if (borderWidth_ > 0.0) {
+    double half = borderWidth_ / 2;
+    extent = OSFRect(extent.x - half, extent.y - half,
+                     extent.width + borderWidth_, extent.height + borderWidth_);
+  }
+
+  if (shadowOpacity_ > 0.0 && shadowRadius_ > 0.0) {
+    extent = extent.united(
+        OSFShadowCache::shadowBounds(bounds_, shadowStyle()));
+  }
+
+  // Whole layer units so the cached bitmap lands on the pixel grid
+  double x0 = std::floor(extent.x);
+  double y0 = std::floor(extent.y);
+  double x1 = std::ceil(extent.x + extent.width);
+  double y1 = std::ceil(extent.y + extent.height);
+  return OSFRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+bool OSFLayer::updateBackingStore(double scale) {
+  BackingKey key = backingKey(scale);
+  bool full = !backingValid_ || needsDisplay_ || key != backingKey_;
+  if (!full && (dirtyRect_.isEmpty() || !backing_)) {
+    dirtyRect_ = OSFRect::Zero();
+    return true; // Cached bitmap (or known-empty contents) is current
+  }
+
+  OSFRect clip = backingExtent_;
+  if (full) {
+    OSFRect extent = contentExtent();
+    int width = static_cast<int>(std::ceil(extent.width * scale));
+    int height = static_cast<int>(std::ceil(extent.height * scale));
+
+    if (width <= 0 || height <= 0 || (emptyDraw_ && !hasVisibleStyle())) {
+      // Nothing to draw; keep the key so we don't retry every frame
+      if (backing_) {
+        cairo_surface_destroy(backing_);
+        backing_ = nullptr;
+      }
+      backingValid_ = true;
+      backingKey_ = key;
+      backingExtent_ = extent;
+      needsDisplay_ = false;
+      dirtyRect_ = OSFRect::Zero();
+      return true;
+    }
+
+    if (!backing_ || cairo_image_surface_get_width(backing_) != width ||
+        cairo_image_surface_get_height(backing_) != height) {
+      if (backing_) {
+        cairo_surface_destroy(backing_);
+      }
+      backing_ = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+      if (cairo_surface_status(backing_) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "[OSFLayer] Failed to allocate " << width << "x"
+                  << height << " backing store, drawing uncached"
+                  << std::endl;
+        cairo_surface_destroy(backing_);
+        backing_ = nullptr;
+        return false;
+      }
+    }
+    cairo_surface_set_device_scale(backing_, scale, scale);
+    backingExtent_ = extent;
+    clip = extent;
+  } else {
+    clip = dirtyRect_.intersected(backingExtent_);
+  }
+
+  if (!clip.isEmpty()) {
+    cairo_t *cr = cairo_create(backing_);
+    cairo_translate(cr, -backingExtent_.x, -backingExtent_.y);
+    cairo_rectangle(cr, clip.x, clip.y, clip.width, clip.height);
+    cairo_clip(cr);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    drawContents(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(backing_);
+  }
+
+  backingValid_ = true;
+  backingKey_ = key;
+  needsDisplay_ = false;
+  dirtyRect_ = OSFRect::Zero();
+  return true;
+}
+
+bool OSFLayer::hasVisibleStyle() const {
+  return backgroundColor_.a > 0.0 ||
+         (borderWidth_ > 0.0 && borderColor_.a > 0.0) ||
+         (shadowOpacity_ > 0.0 && shadowRadius_ > 0.0);
 }
 
 void OSFLayer::draw(cairo_t *cr) { (void)cr; }
@@ -18,7 +18,11 @@ OSFNotificationCenter::addObserver(const std::string &name,
                                    Callback callback) {
   std::lock_guard<std::mutex> lock(mutex_);
   ObserverToken token{name, nextObserverID_++};
-  observers_[name].emplace_back(token.id, std::move(callback));
+  auto &slot = observers_[name];
+  auto list = slot ? std::make_shared<ObserverList>(*slot)
+                   : std::make_shared<ObserverList>();
+  list->emplace_back(token.id, std::move(callback));
+  slot = std::move(list);
   return token;
 }
 
@@ -29,33 +33,134 @@ void OSFNotificationCenter::removeObserver(const ObserverToken &token) {
     return;
   }
 
-  auto &list = it->second;
-  list.erase(std::remove_if(list.begin(), list.end(),
-                            [&token](const auto &entry) {
-                              return entry.first == token.id;
-                            }),
-             list.end());
+  auto list = std::make_shared<ObserverList>(*it->second);
+  list->erase(std::remove_if(list->begin(), list->end(),
+                             [&token](const auto &entry) {
+                               return entry.first == token.id;
+                             }),
+              list->end());
+  if (list->empty()) {
+    observers_.erase(it);
+  } else {
+    it->second = std::move(list);
+  }
 }
 
 void OSFNotificationCenter::postNotification(const std::string &name) {
-  std::vector<Callback> callbacks;
+  // Observers added or removed during delivery take effect on the next post
+  std::shared_ptr<const ObserverList> snapshot;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = observers_.find(name);
     if (it == observers_.end()) {
       return;
     }
-    callbacks.reserve(it->second.size());
-    for (const auto &entry : it->second) {
-      callbacks.push_back(entry.second);
+    snapshot = it->second;
+  }
+
+  for (const auto &entry : *snapshot) {
+    if (entry.second) {
+      entry.second();
+    }
+  }
+}
+
+// ============================================================================
+// OSFNotificationQueue
+// ============================================================================
+
+OSFNotificationQueue &OSFNotificationQueue::defaultQueue() {
+  static OSFNotificationQueue queue(OSFNotificationCenter::defaultCenter(),
+                                    OSFApplication::shared().runLoop());
+  return queue;
+}
+
+OSFNotificationQueue::OSFNotificationQueue(OSFNotificationCenter &center,
+                                           OSFRunLoop &runLoop)
+    : center_(center), runLoop_(runLoop) {}
+
+bool OSFNotificationQueue::matches(const Pending &pending,
+                                   const std::string &name,
+                                   const void *sender, unsigned coalesceMask) {
+  if (coalesceMask == OSFNotificationNoCoalescing)
+    return false;
+  return (!(coalesceMask & OSFNotificationCoalescingOnName) ||
+          pending.name == name) &&
+         (!(coalesceMask & OSFNotificationCoalescingOnSender) ||
+          pending.sender == sender);
+}
+
+void OSFNotificationQueue::enqueueNotification(const std::string &name,
+                                               OSFPostingStyle style,
+                                               unsigned coalesceMask,
+                                               const void *sender) {
+  if (style == OSFPostingStyle::Now) {
+    dequeueNotifications(name, sender, coalesceMask);
+    center_.postNotification(name);
+    return;
+  }
+
+  bool scheduleAsap = false;
+  bool scheduleIdle = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Keep the first of a burst, like NSNotificationQueue
+    auto queued = [&](const Pending &pending) {
+      return matches(pending, name, sender, coalesceMask);
+    };
+    if (std::any_of(asap_.begin(), asap_.end(), queued) ||
+        std::any_of(idle_.begin(), idle_.end(), queued)) {
+      return;
+    }
+
+    if (style == OSFPostingStyle::ASAP) {
+      asap_.push_back({name, sender});
+      scheduleAsap = !asapScheduled_;
+      asapScheduled_ = true;
+    } else {
+      idle_.push_back({name, sender});
+      scheduleIdle = !idleScheduled_;
+      idleScheduled_ = true;
     }
   }
 
-  for (const auto &callback : callbacks) {
-    if (callback) {
-      callback();
+  // One run loop task per batch, however many notifications it collects
+  if (scheduleAsap) {
+    runLoop_.postTask([this]() { flush(OSFPostingStyle::ASAP); });
+  }
+  if (scheduleIdle) {
+    runLoop_.postIdleTask([this]() { flush(OSFPostingStyle::WhenIdle); });
+  }
+}
+
+void OSFNotificationQueue::dequeueNotifications(const std::string &name,
+                                                const void *sender,
+                                                unsigned coalesceMask) {
+  auto queued = [&](const Pending &pending) {
+    return matches(pending, name, sender, coalesceMask);
+  };
+  std::lock_guard<std::mutex> lock(mutex_);
+  asap_.erase(std::remove_if(asap_.begin(), asap_.end(), queued), asap_.end());
+  idle_.erase(std::remove_if(idle_.begin(), idle_.end(), queued), idle_.end());
+}
+
+void OSFNotificationQueue::flush(OSFPostingStyle style) {
+  std::vector<Pending> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (style == OSFPostingStyle::ASAP) {
+      batch.swap(asap_);
+      asapScheduled_ = false;
+    } else {
+      batch.swap(idle_);
+      idleScheduled_ = false;
     }
   }
+
+  // Notifications enqueued by observers land in the next batch
+  for (const auto &pending : batch) {
+    center_.postNotification(pending.name);
+  }
 }
 
 } // namespace opensef
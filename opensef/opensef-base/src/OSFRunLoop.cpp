@@ -4,6 +4,10 @@
 
 #include <opensef/OpenSEFBase.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace opensef {
 
@@ -12,12 +16,36 @@ OSFRunLoop &OSFRunLoop::main() {
   return runLoop;
 }
 
+OSFRunLoop::~OSFRunLoop() {
+  if (wakeupFd_ >= 0) {
+    ::close(wakeupFd_);
+  }
+}
+
 void OSFRunLoop::run() {
   std::unique_lock<std::mutex> lock(mutex_);
   running_ = true;
   while (running_) {
+    promoteDueTimers(Clock::now());
+    if (tasks_.empty() && !idleTasks_.empty()) {
+      std::deque<Task> idle;
+      idle.swap(idleTasks_);
+      lock.unlock();
+      for (auto &task : idle) {
+        if (task) {
+          task();
+        }
+      }
+      lock.lock();
+      continue;
+    }
     if (tasks_.empty()) {
-      cv_.wait(lock, [this]() { return !running_ || !tasks_.empty(); });
+      auto ready = [this]() { return !running_ || !tasks_.empty(); };
+      if (timers_.empty()) {
+        cv_.wait(lock, ready);
+      } else {
+        cv_.wait_until(lock, timers_.front().deadline, ready);
+      }
     }
 
     while (!tasks_.empty()) {
@@ -41,11 +69,130 @@ void OSFRunLoop::stop() {
 }
 
 void OSFRunLoop::postTask(Task task) {
+  int fd = -1;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     tasks_.push_back(std::move(task));
+    fd = wakeupFd_;
+  }
+  cv_.notify_one();
+  signalWakeup(fd);
+}
+
+void OSFRunLoop::postDelayedTask(Task task, Clock::duration delay) {
+  int fd = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timers_.push_back(
+        {Clock::now() + delay, nextTimerSequence_++, std::move(task)});
+    std::push_heap(timers_.begin(), timers_.end(), TimerLater());
+    fd = wakeupFd_;
   }
+  // Wake the loop so it can shorten its poll timeout for the new deadline
   cv_.notify_one();
+  signalWakeup(fd);
+}
+
+void OSFRunLoop::postIdleTask(Task task) {
+  int fd = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idleTasks_.push_back(std::move(task));
+    fd = wakeupFd_;
+  }
+  cv_.notify_one();
+  signalWakeup(fd);
+}
+
+std::size_t OSFRunLoop::runPendingTasks() {
+  clearWakeup();
+
+  // Only run what is queued now; tasks posted by these tasks wait for the
+  // next pass so a self-reposting task cannot starve window events.
+  std::deque<Task> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    promoteDueTimers(Clock::now());
+    batch.swap(tasks_);
+  }
+
+  for (auto &task : batch) {
+    if (task) {
+      task();
+    }
+  }
+  return batch.size();
+}
+
+std::size_t OSFRunLoop::runIdleTasks() {
+  std::deque<Task> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tasks_.empty())
+      return 0; // Not idle
+    batch.swap(idleTasks_);
+  }
+
+  for (auto &task : batch) {
+    if (task) {
+      task();
+    }
+  }
+  return batch.size();
+}
+
+int OSFRunLoop::wakeupFd() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (wakeupFd_ < 0) {
+    wakeupFd_ = eventfd(tasks_.empty() ? 0 : 1, EFD_NONBLOCK | EFD_CLOEXEC);
+  }
+  return wakeupFd_;
+}
+
+int OSFRunLoop::pollTimeout(int maxTimeout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tasks_.empty())
+    return 0;
+  if (timers_.empty())
+    return maxTimeout;
+
+  auto remaining = timers_.front().deadline - Clock::now();
+  // Round up so we never wake a fraction of a millisecond early and spin
+  auto ms = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+  if (ms <= 0)
+    return 0;
+  if (maxTimeout >= 0 && ms > maxTimeout)
+    return maxTimeout;
+  return static_cast<int>(ms);
+}
+
+void OSFRunLoop::promoteDueTimers(Clock::time_point now) {
+  while (!timers_.empty() && timers_.front().deadline <= now) {
+    std::pop_heap(timers_.begin(), timers_.end(), TimerLater());
+    tasks_.push_back(std::move(timers_.back().task));
+    timers_.pop_back();
+  }
+}
+
+void OSFRunLoop::clearWakeup() {
+  int fd = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fd = wakeupFd_;
+  }
+  if (fd >= 0) {
+    uint64_t value = 0;
+    ssize_t readBytes = ::read(fd, &value, sizeof(value));
+    (void)readBytes;
+  }
+}
+
+void OSFRunLoop::signalWakeup(int fd) {
+  if (fd >= 0) {
+    uint64_t one = 1;
+    ssize_t written = ::write(fd, &one, sizeof(one));
+    (void)written; // EAGAIN means the counter is already non-zero
+  }
 }
 
 } // namespace opensef
@@ -0,0 +1,649 @@
+/**
+ * OSFShadowCache.cpp - Cached Blurred Shadows Implementation
+ */
+
+#include <opensef/OSFShadowCache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define OSF_SHADOW_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OSF_SHADOW_NEON 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace opensef {
+
+namespace {
+
+int halfPixels(double value) {
+  return static_cast<int>(std::lround(std::max(0.0, value) * 2.0));
+}
+
+// Box radius whose three passes approximate a Gaussian with
+// sigma = blur / 2 (the SVG feGaussianBlur box size formula)
+int boxRadiusFor(double blur) {
+  if (blur < 0.5)
+    return 0;
+  double sigma = blur / 2.0;
+  int box = static_cast<int>(
+      std::floor(sigma * 3.0 * std::sqrt(2.0 * M_PI) / 4.0 + 0.5));
+  return std::max(1, box / 2);
+}
+
+void roundedRectPath(cairo_t *cr, double x, double y, double w, double h,
+                     double r) {
+  if (r <= 0.0) {
+    cairo_rectangle(cr, x, y, w, h);
+    return;
+  }
+  cairo_new_sub_path(cr);
+  cairo_arc(cr, x + w - r, y + r, r, -M_PI / 2, 0);
+  cairo_arc(cr, x + w - r, y + h - r, r, 0, M_PI / 2);
+  cairo_arc(cr, x + r, y + h - r, r, M_PI / 2, M_PI);
+  cairo_arc(cr, x + r, y + r, r, M_PI, 3 * M_PI / 2);
+  cairo_close_path(cr);
+}
+
+// The shape actually blurred: grown by spread, moved by the offset and
+// snapped to whole units so the slices meet without seams
+OSFRect shadowShape(const OSFRect &shape, const OSFShadowStyle &style) {
+  return OSFRect(std::round(shape.x - style.spread + style.offset.x),
+                 std::round(shape.y - style.spread + style.offset.y),
+                 std::round(shape.width + 2 * style.spread),
+                 std::round(shape.height + 2 * style.spread));
+}
+
+void maskPiece(cairo_t *cr, cairo_surface_t *piece, double x, double y,
+               double width, double height) {
+  if (width <= 0 || height <= 0)
+    return;
+  cairo_pattern_t *pattern = cairo_pattern_create_for_surface(piece);
+  cairo_pattern_set_extend(pattern, CAIRO_EXTEND_PAD); // Stretches edges
+  cairo_matrix_t matrix;
+  cairo_matrix_init_translate(&matrix, -x, -y);
+  cairo_pattern_set_matrix(pattern, &matrix);
+
+  cairo_save(cr);
+  cairo_rectangle(cr, x, y, width, height);
+  cairo_clip(cr);
+  cairo_mask(cr, pattern);
+  cairo_restore(cr);
+  cairo_pattern_destroy(pattern);
+}
+
+// -----------------------------------------------------------------------------
+// Vertical blur kernels
+// -----------------------------------------------------------------------------
+
+std::atomic<bool> gForceScalar{false};
+
+// Divide by the box size with a 16-bit fixed-point reciprocal
+inline uint8_t boxAverage(uint32_t sum, uint32_t reciprocal) {
+  return static_cast<uint8_t>(
+      std::min<uint32_t>(255u, (sum * reciprocal + (1u << 15)) >> 16));
+}
+
+// One row of a vertical pass, for columns [begin, width): write the
+// averages of the column sums to `out`, then add the row entering the
+// window and drop the one leaving it. Any of the three may be null.
+void verticalStepScalar(uint32_t *sums, uint8_t *out, const uint8_t *add,
+                        const uint8_t *sub, int begin, int width,
+                        uint32_t reciprocal) {
+  if (out) {
+    for (int x = begin; x < width; ++x)
+      out[x] = boxAverage(sums[x], reciprocal);
+  }
+  if (add) {
+    for (int x = begin; x < width; ++x)
+      sums[x] += add[x];
+  }
+  if (sub) {
+    for (int x = begin; x < width; ++x)
+      sums[x] -= sub[x];
+  }
+}
+
+using VerticalStep = void (*)(uint32_t *sums, uint8_t *out,
+                              const uint8_t *add, const uint8_t *sub,
+                              int width, uint32_t reciprocal);
+
+void verticalStepPortable(uint32_t *sums, uint8_t *out, const uint8_t *add,
+                          const uint8_t *sub, int width,
+                          uint32_t reciprocal) {
+  verticalStepScalar(sums, out, add, sub, 0, width, reciprocal);
+}
+
+#if defined(OSF_SHADOW_X86)
+
+bool cpuHasSSE2() {
+  static const bool hasSSE2 = __builtin_cpu_supports("sse2");
+  return hasSSE2;
+}
+
+bool cpuHasAVX2() {
+  static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+  return hasAVX2;
+}
+
+// boxAverage() on four sums. SSE2 has no 32-bit mullo, so the even and odd
+// lanes are multiplied into 64 bits separately and recombined
+__attribute__((target("sse2"))) inline __m128i
+averageSSE2(__m128i sums, __m128i reciprocal, __m128i round) {
+  __m128i even = _mm_srli_epi64(
+      _mm_add_epi64(_mm_mul_epu32(sums, reciprocal), round), 16);
+  __m128i odd = _mm_srli_epi64(
+      _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(sums, 32), reciprocal),
+                    round),
+      16);
+  return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+// Sixteen columns per step; packus saturates to 255 like boxAverage()
+__attribute__((target("sse2"))) void
+verticalStepSSE2(uint32_t *sums, uint8_t *out, const uint8_t *add,
+                 const uint8_t *sub, int width, uint32_t reciprocal) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rec = _mm_set1_epi32(static_cast<int>(reciprocal));
+  const __m128i round = _mm_set1_epi64x(1 << 15);
+  const int vectorWidth = width & ~15;
+  for (int x = 0; x < vectorWidth; x += 16) {
+    __m128i *s = reinterpret_cast<__m128i *>(sums + x);
+    __m128i s0 = _mm_loadu_si128(s), s1 = _mm_loadu_si128(s + 1);
+    __m128i s2 = _mm_loadu_si128(s + 2), s3 = _mm_loadu_si128(s + 3);
+    if (out) {
+      __m128i lo = _mm_packs_epi32(averageSSE2(s0, rec, round),
+                                   averageSSE2(s1, rec, round));
+      __m128i hi = _mm_packs_epi32(averageSSE2(s2, rec, round),
+                                   averageSSE2(s3, rec, round));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                       _mm_packus_epi16(lo, hi));
+    }
+    if (add) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(add + x));
+      __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+      s0 = _mm_add_epi32(s0, _mm_unpacklo_epi16(lo, zero));
+      s1 = _mm_add_epi32(s1, _mm_unpackhi_epi16(lo, zero));
+      s2 = _mm_add_epi32(s2, _mm_unpacklo_epi16(hi, zero));
+      s3 = _mm_add_epi32(s3, _mm_unpackhi_epi16(hi, zero));
+    }
+    if (sub) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sub + x));
+      __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+      s0 = _mm_sub_epi32(s0, _mm_unpacklo_epi16(lo, zero));
+      s1 = _mm_sub_epi32(s1, _mm_unpackhi_epi16(lo, zero));
+      s2 = _mm_sub_epi32(s2, _mm_unpacklo_epi16(hi, zero));
+      s3 = _mm_sub_epi32(s3, _mm_unpackhi_epi16(hi, zero));
+    }
+    _mm_storeu_si128(s, s0);
+    _mm_storeu_si128(s + 1, s1);
+    _mm_storeu_si128(s + 2, s2);
+    _mm_storeu_si128(s + 3, s3);
+  }
+  verticalStepScalar(sums, out, add, sub, vectorWidth, width, reciprocal);
+}
+
+__attribute__((target("avx2"))) inline __m256i
+averageAVX2(__m256i sums, __m256i reciprocal, __m256i round) {
+  return _mm256_srli_epi32(
+      _mm256_add_epi32(_mm256_mullo_epi32(sums, reciprocal), round), 16);
+}
+
+__attribute__((target("avx2"))) inline __m256i
+widenAVX2(const uint8_t *bytes) {
+  return _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(bytes)));
+}
+
+// Thirty-two columns per step. Packing works within 128-bit lanes, so a
+// final dword permute puts the columns back in order
+__attribute__((target("avx2"))) void
+verticalStepAVX2(uint32_t *sums, uint8_t *out, const uint8_t *add,
+                 const uint8_t *sub, int width, uint32_t reciprocal) {
+  const __m256i rec = _mm256_set1_epi32(static_cast<int>(reciprocal));
+  const __m256i round = _mm256_set1_epi32(1 << 15);
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  const int vectorWidth = width & ~31;
+  for (int x = 0; x < vectorWidth; x += 32) {
+    __m256i *s = reinterpret_cast<__m256i *>(sums + x);
+    __m256i s0 = _mm256_loadu_si256(s), s1 = _mm256_loadu_si256(s + 1);
+    __m256i s2 = _mm256_loadu_si256(s + 2), s3 = _mm256_loadu_si256(s + 3);
+    if (out) {
+      __m256i lo = _mm256_packs_epi32(averageAVX2(s0, rec, round),
+                                      averageAVX2(s1, rec, round));
+      __m256i hi = _mm256_packs_epi32(averageAVX2(s2, rec, round),
+                                      averageAVX2(s3, rec, round));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i *>(out + x),
+          _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order));
+    }
+    if (add) {
+      s0 = _mm256_add_epi32(s0, widenAVX2(add + x));
+      s1 = _mm256_add_epi32(s1, widenAVX2(add + x + 8));
+      s2 = _mm256_add_epi32(s2, widenAVX2(add + x + 16));
+      s3 = _mm256_add_epi32(s3, widenAVX2(add + x + 24));
+    }
+    if (sub) {
+      s0 = _mm256_sub_epi32(s0, widenAVX2(sub + x));
+      s1 = _mm256_sub_epi32(s1, widenAVX2(sub + x + 8));
+      s2 = _mm256_sub_epi32(s2, widenAVX2(sub + x + 16));
+      s3 = _mm256_sub_epi32(s3, widenAVX2(sub + x + 24));
+    }
+    _mm256_storeu_si256(s, s0);
+    _mm256_storeu_si256(s + 1, s1);
+    _mm256_storeu_si256(s + 2, s2);
+    _mm256_storeu_si256(s + 3, s3);
+  }
+  verticalStepScalar(sums, out, add, sub, vectorWidth, width, reciprocal);
+}
+
+#endif // OSF_SHADOW_X86
+
+#if defined(OSF_SHADOW_NEON)
+
+inline uint16x4_t averageNEON(uint32x4_t sums, uint32x4_t reciprocal,
+                              uint32x4_t round) {
+  return vmovn_u32(vshrq_n_u32(vmlaq_u32(round, sums, reciprocal), 16));
+}
+
+// Sixteen columns per step; vqmovn saturates to 255 like boxAverage()
+void verticalStepNEON(uint32_t *sums, uint8_t *out, const uint8_t *add,
+                      const uint8_t *sub, int width, uint32_t reciprocal) {
+  const uint32x4_t rec = vdupq_n_u32(reciprocal);
+  const uint32x4_t round = vdupq_n_u32(1u << 15);
+  const int vectorWidth = width & ~15;
+  for (int x = 0; x < vectorWidth; x += 16) {
+    uint32x4_t s0 = vld1q_u32(sums + x), s1 = vld1q_u32(sums + x + 4);
+    uint32x4_t s2 = vld1q_u32(sums + x + 8), s3 = vld1q_u32(sums + x + 12);
+    if (out) {
+      uint16x8_t lo = vcombine_u16(averageNEON(s0, rec, round),
+                                   averageNEON(s1, rec, round));
+      uint16x8_t hi = vcombine_u16(averageNEON(s2, rec, round),
+                                   averageNEON(s3, rec, round));
+      vst1q_u8(out + x, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+    }
+    if (add) {
+      uint8x16_t v = vld1q_u8(add + x);
+      uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+      uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+      s0 = vaddw_u16(s0, vget_low_u16(lo));
+      s1 = vaddw_u16(s1, vget_high_u16(lo));
+      s2 = vaddw_u16(s2, vget_low_u16(hi));
+      s3 = vaddw_u16(s3, vget_high_u16(hi));
+    }
+    if (sub) {
+      uint8x16_t v = vld1q_u8(sub + x);
+      uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+      uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+      s0 = vsubw_u16(s0, vget_low_u16(lo));
+      s1 = vsubw_u16(s1, vget_high_u16(lo));
+      s2 = vsubw_u16(s2, vget_low_u16(hi));
+      s3 = vsubw_u16(s3, vget_high_u16(hi));
+    }
+    vst1q_u32(sums + x, s0);
+    vst1q_u32(sums + x + 4, s1);
+    vst1q_u32(sums + x + 8, s2);
+    vst1q_u32(sums + x + 12, s3);
+  }
+  verticalStepScalar(sums, out, add, sub, vectorWidth, width, reciprocal);
+}
+
+#endif // OSF_SHADOW_NEON
+
+} // namespace
+
+OSFShadowCache &OSFShadowCache::shared() {
+  static OSFShadowCache instance;
+  return instance;
+}
+
+OSFShadowCache::~OSFShadowCache() = default;
+
+OSFShadowCache::NineSlice::~NineSlice() {
+  for (cairo_surface_t *piece : pieces) {
+    if (piece)
+      cairo_surface_destroy(piece);
+  }
+  if (mask)
+    cairo_surface_destroy(mask);
+}
+
+// =============================================================================
+// Blur
+// =============================================================================
+
+void OSFShadowCache::boxBlur(uint8_t *pixels, int width, int height,
+                             int stride, int radius) {
+  if (!pixels || radius <= 0 || width <= 0 || height <= 0)
+    return;
+
+  const uint32_t box = 2 * static_cast<uint32_t>(radius) + 1;
+  const uint32_t reciprocal = ((1u << 16) + box / 2) / box;
+
+  // Horizontal: running sum along each row. Each sum depends on the one
+  // before it, so this stays scalar
+  std::vector<uint8_t> line(width + 4 * radius + 2, 0);
+  for (int pass = 0; pass < 3; ++pass) {
+    for (int y = 0; y < height; ++y) {
+      uint8_t *row = pixels + static_cast<size_t>(y) * stride;
+      // Pad the line with zeros so the window slides without bounds checks
+      std::fill(line.begin(), line.begin() + radius + 1, 0);
+      std::copy(row, row + width, line.begin() + radius + 1);
+      uint32_t sum = 0;
+      for (int i = 1; i <= 2 * radius + 1; ++i)
+        sum += line[i];
+      for (int x = 0; x < width; ++x) {
+        row[x] = boxAverage(sum, reciprocal);
+        sum += line[x + 2 * radius + 2];
+        sum -= line[x + 1];
+      }
+    }
+  }
+
+  // Vertical: one running sum per column, advanced a whole row at a time,
+  // so the columns of a row are independent and go through SIMD kernels
+  VerticalStep step = verticalStepPortable;
+  switch (blurPath()) {
+#if defined(OSF_SHADOW_X86)
+  case Path::AVX2:
+    step = verticalStepAVX2;
+    break;
+  case Path::SSE2:
+    step = verticalStepSSE2;
+    break;
+#endif
+#if defined(OSF_SHADOW_NEON)
+  case Path::NEON:
+    step = verticalStepNEON;
+    break;
+#endif
+  default:
+    break;
+  }
+
+  std::vector<uint8_t> source(static_cast<size_t>(width) * height);
+  std::vector<uint32_t> sums(width);
+  for (int pass = 0; pass < 3; ++pass) {
+    for (int y = 0; y < height; ++y) {
+      std::copy(pixels + static_cast<size_t>(y) * stride,
+                pixels + static_cast<size_t>(y) * stride + width,
+                source.begin() + static_cast<size_t>(y) * width);
+    }
+    std::fill(sums.begin(), sums.end(), 0u);
+    for (int y = 0; y <= std::min(radius, height - 1); ++y) {
+      step(sums.data(), nullptr,
+           source.data() + static_cast<size_t>(y) * width, nullptr, width,
+           reciprocal);
+    }
+    for (int y = 0; y < height; ++y) {
+      const uint8_t *add =
+          y + radius + 1 < height
+              ? source.data() + static_cast<size_t>(y + radius + 1) * width
+              : nullptr;
+      const uint8_t *sub =
+          y - radius >= 0
+              ? source.data() + static_cast<size_t>(y - radius) * width
+              : nullptr;
+      step(sums.data(), pixels + static_cast<size_t>(y) * stride, add, sub,
+           width, reciprocal);
+    }
+  }
+}
+
+OSFShadowCache::Path OSFShadowCache::blurPath() {
+  if (gForceScalar.load(std::memory_order_relaxed))
+    return Path::Scalar;
+#if defined(OSF_SHADOW_X86)
+  if (cpuHasAVX2())
+    return Path::AVX2;
+  return cpuHasSSE2() ? Path::SSE2 : Path::Scalar;
+#elif defined(OSF_SHADOW_NEON)
+  return Path::NEON;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char *OSFShadowCache::pathName(Path path) {
+  switch (path) {
+  case Path::SSE2:
+    return "SSE2";
+  case Path::AVX2:
+    return "AVX2";
+  case Path::NEON:
+    return "NEON";
+  case Path::Scalar:
+    break;
+  }
+  return "scalar";
+}
+
+void OSFShadowCache::setForceScalar(bool forceScalar) {
+  gForceScalar.store(forceScalar, std::memory_order_relaxed);
+}
+
+double OSFShadowCache::blurExtent(double blur) {
+  int radius = boxRadiusFor(blur);
+  return radius > 0 ? 3 * radius + 1 : 0;
+}
+
+// =============================================================================
+// Mask Generation
+// =============================================================================
+
+OSFShadowCache::NineSlicePtr OSFShadowCache::render(const Key &key) {
+  double radius = key.radius / 2.0;
+  double blur = key.blur / 2.0;
+  int pad = static_cast<int>(blurExtent(blur));
+
+  auto entry = std::make_shared<NineSlice>();
+  entry->pad = pad;
+
+  int width, height;
+  if (key.width > 0) {
+    // Exact mask for a shape too small to slice
+    width = static_cast<int>(std::ceil(key.width / 2.0)) + 2 * pad;
+    height = static_cast<int>(std::ceil(key.height / 2.0)) + 2 * pad;
+  } else {
+    entry->slice = 2 * pad + static_cast<int>(std::ceil(radius));
+    width = height = 2 * entry->slice + 1;
+  }
+
+  cairo_surface_t *mask =
+      cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+  if (cairo_surface_status(mask) != CAIRO_STATUS_SUCCESS) {
+    std::cerr << "[OSFShadowCache] Failed to allocate " << width << "x"
+              << height << " shadow mask" << std::endl;
+    cairo_surface_destroy(mask);
+    return nullptr;
+  }
+
+  cairo_t *cr = cairo_create(mask);
+  cairo_set_source_rgba(cr, 0, 0, 0, 1);
+  roundedRectPath(cr, pad, pad, width - 2 * pad, height - 2 * pad, radius);
+  cairo_fill(cr);
+  cairo_destroy(cr);
+
+  cairo_surface_flush(mask);
+  uint8_t *data = cairo_image_surface_get_data(mask);
+  int stride = cairo_image_surface_get_stride(mask);
+  boxBlur(data, width, height, stride, boxRadiusFor(blur));
+  cairo_surface_mark_dirty(mask);
+  entry->mask = mask;
+
+  if (entry->slice > 0) {
+    const int s = entry->slice;
+    entry->centerAlpha = data[static_cast<size_t>(s) * stride + s] / 255.0;
+    const int rects[8][4] = {
+        {0, 0, s, s},     {s + 1, 0, s, s}, // TL TR
+        {0, s + 1, s, s}, {s + 1, s + 1, s, s}, // BL BR
+        {s, 0, 1, s},     {s, s + 1, 1, s}, // T B
+        {0, s, s, 1},     {s + 1, s, s, 1}, // L R
+    };
+    for (int i = 0; i < 8; ++i) {
+      entry->pieces[i] = cairo_surface_create_for_rectangle(
+          mask, rects[i][0], rects[i][1], rects[i][2], rects[i][3]);
+    }
+  }
+  return entry;
+}
+
+OSFShadowCache::NineSlicePtr OSFShadowCache::lookup(const Key &key) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+    ++misses_;
+  }
+
+  // Blur outside the lock; another thread may have raced us to it
+  NineSlicePtr entry = render(key);
+  if (!entry)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+  lru_.emplace_front(key, entry);
+  entries_[key] = lru_.begin();
+  while (lru_.size() > capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back(); // In-flight draws keep their shared_ptr
+  }
+  return entry;
+}
+
+// =============================================================================
+// Drawing
+// =============================================================================
+
+OSFRect OSFShadowCache::shadowBounds(const OSFRect &shape,
+                                     const OSFShadowStyle &style) {
+  OSFRect rect = shadowShape(shape, style);
+  double pad = blurExtent(style.blur);
+  return OSFRect(rect.x - pad, rect.y - pad, rect.width + 2 * pad,
+                 rect.height + 2 * pad);
+}
+
+void OSFShadowCache::drawShadow(cairo_t *cr, const OSFRect &shape,
+                                const OSFShadowStyle &style) {
+  if (style.color.a <= 0.0)
+    return;
+
+  OSFRect rect = shadowShape(shape, style);
+  if (rect.width <= 0 || rect.height <= 0)
+    return;
+  double radius = std::max(0.0, style.cornerRadius + style.spread);
+  radius = std::min(radius, std::min(rect.width, rect.height) / 2);
+
+  cairo_save(cr);
+  style.color.setCairo(cr);
+
+  if (boxRadiusFor(style.blur) == 0) {
+    // Hard shadow: nothing to cache
+    roundedRectPath(cr, rect.x, rect.y, rect.width, rect.height, radius);
+    cairo_fill(cr);
+    cairo_restore(cr);
+    return;
+  }
+
+  Key key{halfPixels(radius), halfPixels(style.blur), 0, 0};
+  double pad = blurExtent(style.blur);
+  double minSide = 2 * (pad + std::ceil(key.radius / 2.0)) + 1;
+  if (rect.width < minSide || rect.height < minSide) {
+    key.width = halfPixels(rect.width);
+    key.height = halfPixels(rect.height);
+  }
+
+  NineSlicePtr entry = lookup(key);
+  if (!entry) {
+    cairo_restore(cr);
+    return;
+  }
+
+  double x = rect.x - pad;
+  double y = rect.y - pad;
+  if (entry->slice == 0) {
+    cairo_mask_surface(cr, entry->mask, x, y);
+    cairo_restore(cr);
+    return;
+  }
+
+  const double s = entry->slice;
+  const double w = rect.width + 2 * pad;
+  const double h = rect.height + 2 * pad;
+  const double right = x + w - s;
+  const double bottom = y + h - s;
+
+  maskPiece(cr, entry->pieces[0], x, y, s, s);
+  maskPiece(cr, entry->pieces[1], right, y, s, s);
+  maskPiece(cr, entry->pieces[2], x, bottom, s, s);
+  maskPiece(cr, entry->pieces[3], right, bottom, s, s);
+  maskPiece(cr, entry->pieces[4], x + s, y, w - 2 * s, s);
+  maskPiece(cr, entry->pieces[5], x + s, bottom, w - 2 * s, s);
+  maskPiece(cr, entry->pieces[6], x, y + s, s, h - 2 * s);
+  maskPiece(cr, entry->pieces[7], right, y + s, s, h - 2 * s);
+
+  // Centre: the blurred interior is uniform
+  if (w > 2 * s && h > 2 * s) {
+    cairo_set_source_rgba(cr, style.color.r, style.color.g, style.color.b,
+                          style.color.a * entry->centerAlpha);
+    cairo_rectangle(cr, x + s, y + s, w - 2 * s, h - 2 * s);
+    cairo_fill(cr);
+  }
+
+  cairo_restore(cr);
+}
+
+// =============================================================================
+// Cache Control
+// =============================================================================
+
+size_t OSFShadowCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+void OSFShadowCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = std::max<size_t>(1, capacity);
+  while (lru_.size() > capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+void OSFShadowCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+uint64_t OSFShadowCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t OSFShadowCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+} // namespace opensef
@@ -0,0 +1,217 @@
+/**
+ * OSFTaskScheduler.cpp - Work-stealing thread pool
+ */
+
+#include <opensef/OSFTaskScheduler.h>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace opensef {
+
+namespace {
+// Identifies the scheduler and worker slot of the current thread so that
+// nested submissions land on the submitting worker's own deque.
+thread_local const OSFTaskScheduler *tlsScheduler = nullptr;
+thread_local std::size_t tlsWorkerIndex = 0;
+} // namespace
+
+// =============================================================================
+// OSFCancellationToken
+// =============================================================================
+
+OSFCancellationToken OSFCancellationToken::create() {
+  OSFCancellationToken token;
+  token.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+  return token;
+}
+
+void OSFCancellationToken::cancel() {
+  if (cancelled_) {
+    cancelled_->store(true, std::memory_order_release);
+  }
+}
+
+// =============================================================================
+// OSFTaskScheduler - Lifecycle
+// =============================================================================
+
+OSFTaskScheduler &OSFTaskScheduler::shared() {
+  static OSFTaskScheduler scheduler;
+  return scheduler;
+}
+
+OSFTaskScheduler::OSFTaskScheduler(std::size_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  workers_.reserve(threadCount);
+  for (std::size_t i = 0; i < threadCount; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Start threads only after every Worker exists: thieves index workers_.
+  for (std::size_t i = 0; i < threadCount; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+  }
+}
+
+OSFTaskScheduler::~OSFTaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_ = true;
+  }
+  sleepCv_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+bool OSFTaskScheduler::isWorkerThread() const { return tlsScheduler == this; }
+
+// =============================================================================
+// OSFTaskScheduler - Submission
+// =============================================================================
+
+void OSFTaskScheduler::submit(Task task, OSFTaskPriority priority,
+                              OSFCancellationToken token) {
+  if (!task || token.isCancelled())
+    return;
+
+  // Workers push onto their own deque; other threads spread round-robin.
+  std::size_t index = isWorkerThread()
+                          ? tlsWorkerIndex
+                          : nextWorker_.fetch_add(1, std::memory_order_relaxed) %
+                                workers_.size();
+
+  {
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    outstanding_++;
+  }
+  {
+    // Count before publishing so queued_ never underflows. Taking
+    // sleepMutex_ orders the increment against a worker that has just
+    // checked queued_ and is about to wait, so no wakeup is lost.
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    queued_.fetch_add(1, std::memory_order_release);
+  }
+  {
+    Worker &worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.queues[static_cast<int>(priority)].push_back(
+        {std::move(task), std::move(token)});
+  }
+  sleepCv_.notify_one();
+}
+
+void OSFTaskScheduler::waitIdle() {
+  std::unique_lock<std::mutex> lock(idleMutex_);
+  idleCv_.wait(lock, [this]() { return outstanding_ == 0; });
+}
+
+// =============================================================================
+// OSFTaskScheduler - Workers
+// =============================================================================
+
+bool OSFTaskScheduler::popLocal(std::size_t index, int priority, Entry &out) {
+  Worker &worker = *workers_[index];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  auto &queue = worker.queues[priority];
+  if (queue.empty())
+    return false;
+  out = std::move(queue.back());
+  queue.pop_back();
+  return true;
+}
+
+bool OSFTaskScheduler::steal(std::size_t thief, int priority, Entry &out) {
+  const std::size_t count = workers_.size();
+  for (std::size_t offset = 1; offset < count; ++offset) {
+    Worker &victim = *workers_[(thief + offset) % count];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+      continue; // Busy victim - try the next one rather than contend
+    auto &queue = victim.queues[priority];
+    if (queue.empty())
+      continue;
+    out = std::move(queue.front());
+    queue.pop_front();
+    return true;
+  }
+  return false;
+}
+
+bool OSFTaskScheduler::findTask(std::size_t index, Entry &out) {
+  // Priority is global: a worker holding only Low tasks locally still
+  // steals someone else's High task first.
+  for (int priority = 0; priority < kPriorityCount; ++priority) {
+    if (popLocal(index, priority, out) || steal(index, priority, out)) {
+      queued_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+  return false;
+}
+
+void OSFTaskScheduler::runEntry(Entry &entry) {
+  if (!entry.token.isCancelled()) {
+    try {
+      entry.task();
+    } catch (const std::exception &e) {
+      std::cerr << "[OSFTaskScheduler] Task threw: " << e.what() << std::endl;
+    } catch (...) {
+      std::cerr << "[OSFTaskScheduler] Task threw unknown exception"
+                << std::endl;
+    }
+  }
+  entry.task = nullptr; // Release captures before reporting idle
+
+  bool idle = false;
+  {
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    idle = (--outstanding_ == 0);
+  }
+  if (idle) {
+    idleCv_.notify_all();
+  }
+}
+
+void OSFTaskScheduler::workerLoop(std::size_t index) {
+  tlsScheduler = this;
+  tlsWorkerIndex = index;
+
+  while (true) {
+    Entry entry;
+    if (findTask(index, entry)) {
+      runEntry(entry);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    if (stopping_)
+      break;
+    // A try_to_lock steal can miss work held under a busy victim's lock, and
+    // a counted task may not be published yet, so never sleep while anything
+    // is queued; just yield and rescan.
+    if (queued_.load(std::memory_order_acquire) > 0) {
+      lock.unlock();
+      std::this_thread::yield();
+      continue;
+    }
+    sleepCv_.wait(lock, [this]() {
+      return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+    });
+  }
+
+  // Drain on shutdown so nothing waiting in waitIdle() hangs forever.
+  Entry entry;
+  while (findTask(index, entry)) {
+    runEntry(entry);
+  }
+}
+
+} // namespace opensef
@@ -0,0 +1,165 @@
+/**
+ * OSFTileRenderer.cpp - Tile-Parallel Rasterization Implementation
+ */
+
+#include <opensef/OSFTaskScheduler.h>
+#include <opensef/OSFTileRenderer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace opensef {
+
+namespace {
+
+struct Tile {
+  int x, y, width, height;
+};
+
+// One render() call. Helper tasks may start after render() has returned,
+// so they hold this state and only touch the caller's pixels and draw
+// function once they are counted in `active`
+struct TileJob {
+  std::vector<Tile> tiles;
+  std::atomic<std::size_t> next{0};
+  unsigned char *data = nullptr;
+  int stride = 0;
+  cairo_format_t format = CAIRO_FORMAT_ARGB32;
+  double scaleX = 1.0;
+  double scaleY = 1.0;
+  const OSFTileRenderer::DrawFunction *draw = nullptr;
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::size_t active = 0; // Helpers between claiming and finishing tiles
+};
+
+void drawTiles(TileJob &job) {
+  for (std::size_t i = job.next.fetch_add(1); i < job.tiles.size();
+       i = job.next.fetch_add(1)) {
+    const Tile &tile = job.tiles[i];
+    // Aliases the target's pixels; tiles never overlap
+    cairo_surface_t *surface = cairo_image_surface_create_for_data(
+        job.data + static_cast<std::size_t>(tile.y) * job.stride + tile.x * 4,
+        job.format, tile.width, tile.height, job.stride);
+    cairo_surface_set_device_scale(surface, job.scaleX, job.scaleY);
+    cairo_surface_set_device_offset(surface, -tile.x, -tile.y);
+
+    cairo_t *cr = cairo_create(surface);
+    (*job.draw)(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+}
+
+} // namespace
+
+OSFTileRenderer::OSFTileRenderer(int tileSize)
+    : tileSize_(std::max(16, tileSize)) {}
+
+void OSFTileRenderer::setTileSize(int size) { tileSize_ = std::max(16, size); }
+
+void OSFTileRenderer::renderSerial(cairo_surface_t *target,
+                                   const OSFRect &area,
+                                   const DrawFunction &draw) {
+  double scaleX = 1.0;
+  double scaleY = 1.0;
+  cairo_surface_get_device_scale(target, &scaleX, &scaleY);
+
+  cairo_t *cr = cairo_create(target);
+  cairo_rectangle(cr, area.x / scaleX, area.y / scaleY, area.width / scaleX,
+                  area.height / scaleY);
+  cairo_clip(cr);
+  draw(cr);
+  cairo_destroy(cr);
+  lastTileCount_ = 1;
+}
+
+void OSFTileRenderer::render(cairo_surface_t *target, const OSFRect &area,
+                             const DrawFunction &draw) {
+  lastTileCount_ = 0;
+  if (!target || !draw)
+    return;
+
+  // Whole pixels inside the surface
+  const int surfaceWidth = cairo_image_surface_get_width(target);
+  const int surfaceHeight = cairo_image_surface_get_height(target);
+  const int x0 = std::max(0, static_cast<int>(std::floor(area.x)));
+  const int y0 = std::max(0, static_cast<int>(std::floor(area.y)));
+  const int x1 = std::min(surfaceWidth,
+                          static_cast<int>(std::ceil(area.x + area.width)));
+  const int y1 = std::min(surfaceHeight,
+                          static_cast<int>(std::ceil(area.y + area.height)));
+  if (x1 <= x0 || y1 <= y0)
+    return;
+  const OSFRect pixels(x0, y0, x1 - x0, y1 - y0);
+
+  OSFTaskScheduler &scheduler =
+      scheduler_ ? *scheduler_ : OSFTaskScheduler::shared();
+  const cairo_format_t format = cairo_image_surface_get_format(target);
+  const bool fourBytes =
+      format == CAIRO_FORMAT_ARGB32 || format == CAIRO_FORMAT_RGB24;
+  if (!fourBytes || pixels.width * pixels.height < kMinParallelArea ||
+      scheduler.threadCount() == 0 || scheduler.isWorkerThread()) {
+    renderSerial(target, pixels, draw);
+    return;
+  }
+
+  // Fixed, row-major grid anchored at the area origin
+  auto job = std::make_shared<TileJob>();
+  for (int y = y0; y < y1; y += tileSize_) {
+    for (int x = x0; x < x1; x += tileSize_) {
+      job->tiles.push_back(
+          {x, y, std::min(tileSize_, x1 - x), std::min(tileSize_, y1 - y)});
+    }
+  }
+  if (job->tiles.size() < 2) {
+    renderSerial(target, pixels, draw);
+    return;
+  }
+
+  cairo_surface_flush(target);
+  job->data = cairo_image_surface_get_data(target);
+  job->stride = cairo_image_surface_get_stride(target);
+  job->format = format;
+  job->draw = &draw;
+  cairo_surface_get_device_scale(target, &job->scaleX, &job->scaleY);
+
+  // Fork-join: helpers pull tiles from the shared counter, and so does
+  // this thread. It takes whatever the pool hasn't started on, and then
+  // only waits for helpers that are drawing a tile, never for queued ones
+  const std::size_t helpers =
+      std::min(scheduler.threadCount(), job->tiles.size() - 1);
+  for (std::size_t i = 0; i < helpers; ++i) {
+    scheduler.submit(
+        [job]() {
+          {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (job->next.load() >= job->tiles.size())
+              return; // Started too late, nothing left
+            ++job->active;
+          }
+          drawTiles(*job);
+          std::lock_guard<std::mutex> lock(job->mutex);
+          --job->active;
+          job->done.notify_one();
+        },
+        OSFTaskPriority::High);
+  }
+  drawTiles(*job);
+  {
+    // Every tile is claimed now; a helper admitted later finds none
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done.wait(lock, [&job]() { return job->active == 0; });
+  }
+
+  cairo_surface_mark_dirty_rectangle(target, x0, y0, x1 - x0, y1 - y0);
+  lastTileCount_ = job->tiles.size();
+}
+
+} // namespace opensef
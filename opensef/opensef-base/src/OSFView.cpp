@@ -6,18 +6,39 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <opensef/OSFDisplayList.h>
 #include <opensef/OSFLayer.h>
 #include <opensef/OSFView.h>
 #include <opensef/OSFWindow.h>
 
 namespace opensef {
 
-OSFView::OSFView() {
+namespace {
+
+// Unique across views, so a new view at a freed view's address never
+// matches its old display list item
+uint64_t nextDisplayVersion() {
+  static std::atomic<uint64_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint64_t nextViewId() {
+  static std::atomic<uint64_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace
+
+OSFView::OSFView()
+    : viewId_(nextViewId()), displayVersion_(nextDisplayVersion()) {
   layer_ = OSFLayer::create();
   layer_->setBackgroundColor(OSFColor(0, 0, 0, 0)); // Transparent by default
 }
 
 void OSFView::setFrame(const OSFRect &frame) {
+  if (frame.width != frame_.width || frame.height != frame_.height)
+    displayVersion_ = nextDisplayVersion();
   frame_ = frame;
   if (layer_) {
     layer_->setPosition(frame.x, frame.y);
@@ -27,6 +48,8 @@ void OSFView::setFrame(const OSFRect &frame) {
 }
 
 void OSFView::setAlpha(double alpha) {
+  if (alpha != alpha_)
+    displayVersion_ = nextDisplayVersion();
   alpha_ = alpha;
   if (layer_) {
     layer_->setOpacity(alpha);
@@ -172,6 +195,7 @@ bool OSFView::keyDown(OSFEvent &event) { return OSFResponder::keyDown(event); }
 
 void OSFView::setNeedsDisplay() {
   needsDisplay_ = true;
+  displayVersion_ = nextDisplayVersion();
   if (window_) {
     window_->setNeedsDisplay();
   }
@@ -186,10 +210,25 @@ void OSFView::render(cairo_t *cr) {
     layer_->render(cr);
   }
 
+  // A display list records each subview as an item of its own
+  if (OSFDisplayList::isRecording())
+    return;
+
+  // Only subviews that reach the clip (damage or render tile) draw
+  double x1, y1, x2, y2;
+  cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+  OSFRect visible(x1, y1, x2 - x1, y2 - y1);
+
   // Render subviews (Note: In a fully layer-backed system,
   // subview rendering would be handled by layer hierarchy.
   // For now we keep the dual system for compatibility).
   for (auto &subview : subviews_) {
+    OSFRect paint = subview->paintBounds();
+    paint.x += subview->frame_.x;
+    paint.y += subview->frame_.y;
+    if (!paint.isEmpty() && paint.intersected(visible).isEmpty())
+      continue; // Empty paint bounds: extent unknown, always draw
+
     cairo_save(cr);
     cairo_translate(cr, subview->frame_.x, subview->frame_.y);
     subview->render(cr);
@@ -197,4 +236,17 @@ void OSFView::render(cairo_t *cr) {
   }
 }
 
+OSFRect OSFView::paintBounds() const {
+  OSFRect paint = bounds();
+  for (auto &subview : subviews_) {
+    if (subview->hidden_)
+      continue;
+    OSFRect child = subview->paintBounds();
+    child.x += subview->frame_.x;
+    child.y += subview->frame_.y;
+    paint = paint.united(child);
+  }
+  return paint;
+}
+
 } // namespace opensef
@@ -13,6 +13,10 @@
 #include <opensef/OpenSEFBase.h>
 // Needed for OSFView hitTest
 #include <opensef/OSFAresTheme.h>
+#include <opensef/OSFDecorationCache.h>
+#include <opensef/OSFDisplayList.h>
+#include <opensef/OSFFrameClock.h>
+#include <opensef/OSFTileRenderer.h>
 #include <opensef/OSFView.h>
 
 #ifndef M_PI
@@ -21,12 +25,14 @@
 
 #include <cairo/cairo.h>
 #include <cstring>
+#include <ctime>
 #include <fcntl.h>
 #include <iostream>
 #include <linux/input-event-codes.h>
 #include <poll.h>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <vector>
 #include <wayland-client.h>
 #include <xkbcommon/xkbcommon.h>
 
@@ -36,6 +42,12 @@ extern "C" {
 #include "../build/xdg-shell-protocol.c"
 }
 
+// Presentation time protocol (generated by CMake)
+#include "presentation-time-client-protocol.h"
+extern "C" {
+#include "../build/presentation-time-protocol.c"
+}
+
 namespace opensef {
 
 // ============================================================================
@@ -54,6 +66,8 @@ struct WindowImpl {
   wl_keyboard *keyboard = nullptr; // Keyboard
 
   xdg_wm_base *xdgWmBase = nullptr;
+  wp_presentation *presentation = nullptr; // Optional
+  uint32_t presentationClock = CLOCK_MONOTONIC;
   xdg_surface *xdgSurface = nullptr;
   xdg_toplevel *xdgToplevel = nullptr;
 
@@ -77,8 +91,24 @@ struct WindowImpl {
   // State
   bool configured = false;
   bool closed = false;
+  bool activated = true; // xdg_toplevel "activated" state
   wl_callback *frameCallback = nullptr; // Phase 3: v-sync (144Hz support)
   bool framePending = false;            // Waiting for compositor callback
+  std::vector<OSFWindow::FrameCallback> frameWaiters; // requestFrame()
+  bool animationFrame = false; // Animations want the next frame
+  bool animationFrameReady = false; // ... it arrived, not yet taken
+  OSFFrameClock::Clock::time_point animationFrameTime; // Its presentation
+  OSFFrameClock frameClock;
+  OSFTileRenderer tileRenderer; // setTiledRendering(true)
+  OSFDecorationCache decorations;
+
+  // setUsesDisplayLists(true): the list on screen and the one being built
+  OSFDisplayList displayList;
+  OSFDisplayList nextDisplayList;
+  bool bufferFresh = true; // Buffer holds no previous frame to keep
+  int paintedHover = -1;
+  bool paintedActive = true;
+  std::string paintedTitle;
 
   // Parent reference
   OSFWindow *window = nullptr;
@@ -418,6 +448,43 @@ static const wl_seat_listener seatListener = {
 // Wayland Protocol Listeners
 // ============================================================================
 
+// --- Presentation Time ---
+
+static void presentationClockId(void *data, wp_presentation *,
+                                uint32_t clockId) {
+  static_cast<WindowImpl *>(data)->presentationClock = clockId;
+}
+
+static const wp_presentation_listener presentationListener = {
+    presentationClockId};
+
+static void feedbackSyncOutput(void *, wp_presentation_feedback *,
+                               wl_output *) {}
+
+static void feedbackPresented(void *data, wp_presentation_feedback *feedback,
+                              uint32_t tvSecHi, uint32_t tvSecLo,
+                              uint32_t tvNsec, uint32_t refresh, uint32_t,
+                              uint32_t, uint32_t) {
+  auto *impl = static_cast<WindowImpl *>(data);
+  wp_presentation_feedback_destroy(feedback);
+
+  // steady_clock is CLOCK_MONOTONIC on Linux; other clocks can't be mapped
+  if (impl->presentationClock != CLOCK_MONOTONIC)
+    return;
+  uint64_t seconds = (static_cast<uint64_t>(tvSecHi) << 32) | tvSecLo;
+  OSFFrameClock::Clock::time_point when(std::chrono::duration_cast<
+                                        OSFFrameClock::Clock::duration>(
+      std::chrono::seconds(seconds) + std::chrono::nanoseconds(tvNsec)));
+  impl->frameClock.presented(when, std::chrono::nanoseconds(refresh));
+}
+
+static void feedbackDiscarded(void *, wp_presentation_feedback *feedback) {
+  wp_presentation_feedback_destroy(feedback);
+}
+
+static const wp_presentation_feedback_listener feedbackListener = {
+    feedbackSyncOutput, feedbackPresented, feedbackDiscarded};
+
 static void registryGlobal(void *data, wl_registry *registry, uint32_t name,
                            const char *interface, uint32_t /*version*/) {
   auto *impl = static_cast<WindowImpl *>(data);
@@ -435,6 +502,11 @@ static void registryGlobal(void *data, wl_registry *registry, uint32_t name,
     impl->seat = static_cast<wl_seat *>(
         wl_registry_bind(registry, name, &wl_seat_interface, 7));
     wl_seat_add_listener(impl->seat, &seatListener, impl);
+  } else if (strcmp(interface, wp_presentation_interface.name) == 0) {
+    impl->presentation = static_cast<wp_presentation *>(
+        wl_registry_bind(registry, name, &wp_presentation_interface, 1));
+    wp_presentation_add_listener(impl->presentation, &presentationListener,
+                                 impl);
   }
 }
 
@@ -456,8 +528,23 @@ static void xdgSurfaceConfigure(void *data, xdg_surface *surface,
 }
 static const xdg_surface_listener xdgSurfaceListener = {xdgSurfaceConfigure};
 static void xdgToplevelConfigure(void *data, xdg_toplevel *, int32_t width,
-                                 int32_t height, wl_array *) {
+                                 int32_t height, wl_array *states) {
   auto *impl = static_cast<WindowImpl *>(data);
+
+  bool activated = false;
+  if (states) {
+    const auto *state = static_cast<const uint32_t *>(states->data);
+    for (size_t i = 0; i < states->size / sizeof(uint32_t); ++i) {
+      if (state[i] == XDG_TOPLEVEL_STATE_ACTIVATED)
+        activated = true;
+    }
+  }
+  if (activated != impl->activated) {
+    impl->activated = activated;
+    if (impl->window)
+      impl->window->setNeedsDisplay(); // Decorations change palette
+  }
+
   if (width > 0 && height > 0 && impl->window) {
     // DEBUG:
     std::cerr << "[OSFWindow] Configure request: " << width << "x" << height
@@ -492,18 +579,45 @@ static const xdg_toplevel_listener xdgToplevelListener = {
 // --- Frame Callback ---
 
 static void frame_callback_handler(void *data, wl_callback *callback,
-                                   uint32_t /*callback_data*/) {
+                                   uint32_t time) {
   auto *impl = static_cast<WindowImpl *>(data);
   wl_callback_destroy(callback);
   impl->frameCallback = nullptr;
   impl->framePending = false;
-  if (impl->window)
-    impl->window->setNeedsDisplay(); // Ready for next frame
+
+  auto now = OSFFrameClock::Clock::now();
+  impl->frameClock.frameDone(time, now);
+
+  // No unconditional redraw: the window only draws again when something
+  // marks it dirty, so an idle window stops producing frames. Animations
+  // are ticked by OSFApplication, once per loop iteration for all windows,
+  // at when this frame will actually be on screen.
+  if (impl->animationFrame) {
+    impl->animationFrame = false;
+    impl->animationFrameReady = true;
+    impl->animationFrameTime = impl->frameClock.nextPresentation(now);
+  }
+
+  // Waiters may request the next frame again, so swap them out first
+  std::vector<OSFWindow::FrameCallback> waiters;
+  waiters.swap(impl->frameWaiters);
+  for (auto &waiter : waiters) {
+    waiter(time);
+  }
 }
 
 static const wl_callback_listener frameCallbackListener = {
     frame_callback_handler};
 
+// Ask for a frame callback on the next commit. Caller commits.
+static void requestFrameCallback(WindowImpl *impl) {
+  if (impl->frameCallback)
+    wl_callback_destroy(impl->frameCallback);
+  impl->frameCallback = wl_surface_frame(impl->surface);
+  wl_callback_add_listener(impl->frameCallback, &frameCallbackListener, impl);
+  impl->framePending = true;
+}
+
 // ============================================================================
 // Buffer Creation (Unchanged)
 // ============================================================================
@@ -565,6 +679,7 @@ static bool createBuffer(WindowImpl *impl, int width, int height) {
   impl->cairoSurface = cairo_image_surface_create_for_data(
       static_cast<unsigned char *>(impl->shmData), CAIRO_FORMAT_ARGB32, width,
       height, stride);
+  impl->bufferFresh = true;
   return true;
 }
 
@@ -662,6 +777,15 @@ void OSFWindow::disconnect() {
     wl_surface_destroy(impl_->surface);
     impl_->surface = nullptr;
   }
+  if (impl_->frameCallback) {
+    wl_callback_destroy(impl_->frameCallback);
+    impl_->frameCallback = nullptr;
+    impl_->framePending = false;
+  }
+  if (impl_->presentation) {
+    wp_presentation_destroy(impl_->presentation);
+    impl_->presentation = nullptr;
+  }
   if (impl_->xdgWmBase) {
     xdg_wm_base_destroy(impl_->xdgWmBase);
     impl_->xdgWmBase = nullptr;
@@ -773,92 +897,30 @@ void OSFWindow::runEventLoop() {
 
       // === VitusOS CSD (Client Side Decorations) ===
 
-      // 0. Transparent Background and Rounding
+      // 0. Transparent Background
       cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
       cairo_set_source_rgba(cr, 0, 0, 0, 0); // Clear to transparency
       cairo_paint(cr);
 
-      // Clip to rounded rectangle (9px)
+      // 1-4. Titlebar, traffic lights, title and separator (cached)
+      impl_->decorations.draw(cr, width_, impl_->activated,
+                              impl_->hoveredButton, title_);
+
+      // Window body (Pure White), clipped to rounded rectangle (9px)
       AresTheme::roundedRect(cr, 0, 0, width_, height_, 9.0);
       cairo_clip(cr);
-
       cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
-
-      // 1. Window Background (Pure White)
       cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-      cairo_paint(cr);
-
-      // 2. Titlebar (VitusOS Light: #F5F5F5)
-      cairo_set_source_rgb(cr, 0.96, 0.96, 0.96); // #F5F5F5
-      cairo_rectangle(cr, 0, 0, width_, 38);
+      cairo_rectangle(cr, 0, OSFDecorationCache::kHeight, width_,
+                      height_ - OSFDecorationCache::kHeight);
       cairo_fill(cr);
 
-      // 3. Traffic Lights (Mars themed)
-      // Close (Orange-Red: #D4622A)
-      cairo_set_source_rgb(cr, 0.83, 0.38, 0.16);
-      cairo_arc(cr, 24, 19, 6, 0, 2 * M_PI);
-      cairo_fill(cr);
-      if (impl_->hoveredButton == 1) {
-        cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-        cairo_set_line_width(cr, 1.2);
-        cairo_move_to(cr, 21, 16);
-        cairo_line_to(cr, 27, 22);
-        cairo_move_to(cr, 27, 16);
-        cairo_line_to(cr, 21, 22);
-        cairo_stroke(cr);
-      }
-
-      // Minimize (Gold: #D4A93E)
-      cairo_set_source_rgb(cr, 0.83, 0.66, 0.24);
-      cairo_arc(cr, 46, 19, 6, 0, 2 * M_PI);
-      cairo_fill(cr);
-      if (impl_->hoveredButton == 2) {
-        cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-        cairo_set_line_width(cr, 1.2);
-        cairo_move_to(cr, 43, 19);
-        cairo_line_to(cr, 49, 19);
-        cairo_stroke(cr);
-      }
-
-      // Maximize (Blue: #4A9FD4)
-      cairo_set_source_rgb(cr, 0.29, 0.62, 0.83);
-      cairo_arc(cr, 68, 19, 6, 0, 2 * M_PI);
-      cairo_fill(cr);
-      if (impl_->hoveredButton == 3) {
-        cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-        cairo_set_line_width(cr, 1.2);
-        cairo_move_to(cr, 65, 19);
-        cairo_line_to(cr, 71, 19);
-        cairo_move_to(cr, 68, 16);
-        cairo_line_to(cr, 68, 22);
-        cairo_stroke(cr);
-      }
-
-      // 4. Title Text (Dark: #1A1A1A)
-      if (!title_.empty()) {
-        cairo_set_source_rgb(cr, 0.1, 0.1, 0.1); // #1A1A1A
-        cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
-                               CAIRO_FONT_WEIGHT_BOLD);
-        cairo_set_font_size(cr, 13);
-        cairo_text_extents_t ext;
-        cairo_text_extents(cr, title_.c_str(), &ext);
-        cairo_move_to(cr, (width_ - ext.width) / 2.0,
-                      19 + ext.height / 2.0 - 2);
-        cairo_show_text(cr, title_.c_str());
-      }
-
       // 5. App Content
       cairo_save(cr);
       if (drawCallback_)
         drawCallback_(cr, width_, height_);
       cairo_restore(cr);
 
-      // 6. Separator
-      cairo_set_source_rgba(cr, 0, 0, 0, 0.1);
-      cairo_move_to(cr, 0, 38);
-      cairo_line_to(cr, width_, 38);
-      cairo_stroke(cr);
-
       if (drawCallback_)
         drawCallback_(cr, width_, height_);
       cairo_destroy(cr);
@@ -929,6 +991,63 @@ bool OSFWindow::processEvents() {
   return !impl_->closed;
 }
 
+void OSFWindow::requestFrame(FrameCallback callback) {
+  if (!callback)
+    return;
+
+  if (impl_->closed || !impl_->surface) {
+    // No frames will ever arrive; don't strand the caller
+    OSFApplication::shared().runLoop().postTask(
+        [callback = std::move(callback)]() { callback(0); });
+    return;
+  }
+
+  impl_->frameWaiters.push_back(std::move(callback));
+  if (impl_->framePending)
+    return; // The in-flight callback will fire it
+
+  if (!impl_->configured) {
+    setNeedsDisplay(); // update() requests the frame after configure
+    return;
+  }
+
+  requestFrameCallback(impl_.get());
+  wl_surface_commit(impl_->surface);
+  wl_display_flush(impl_->display);
+}
+
+bool OSFWindow::scheduleAnimationFrame() {
+  if (!impl_->configured || impl_->closed || !impl_->surface)
+    return false;
+
+  impl_->animationFrame = true;
+  if (impl_->framePending)
+    return true; // The in-flight callback will tick
+
+  requestFrameCallback(impl_.get());
+  wl_surface_commit(impl_->surface);
+  wl_display_flush(impl_->display);
+  return true;
+}
+
+bool OSFWindow::takeAnimationFrame(
+    std::chrono::steady_clock::time_point *presentation) {
+  if (!impl_->animationFrameReady)
+    return false;
+  impl_->animationFrameReady = false;
+  *presentation = impl_->animationFrameTime;
+  setNeedsDisplay();
+  return true;
+}
+
+bool OSFWindow::isWaitingForFrame() const { return impl_->framePending; }
+
+bool OSFWindow::isActive() const { return impl_->activated; }
+
+const OSFFrameClock &OSFWindow::frameClock() const {
+  return impl_->frameClock;
+}
+
 void OSFWindow::update() {
   if (!impl_->configured || impl_->closed)
     return;
@@ -940,124 +1059,136 @@ void OSFWindow::update() {
   // 1. Create Buffer
   if (createBuffer(impl_.get(), width_, height_)) {
     needsRedraw_ = false;
-    impl_->framePending = true; // Mark as waiting for next frame callback
 
-    // Soft V-Sync: Request callback, but don't block
-    if (impl_->frameCallback)
-      wl_callback_destroy(impl_->frameCallback);
-    impl_->frameCallback = wl_surface_frame(impl_->surface);
-    wl_callback_add_listener(impl_->frameCallback, &frameCallbackListener,
-                             impl_.get());
-
-    cairo_t *cr = cairo_create(impl_->cairoSurface);
-    if (!cr)
-      return;
+    // Work out what changed; without display lists, everything did
+    const OSFRect fullFrame(0, 0, width_, height_);
+    std::vector<OSFRect> damage;
+    const bool useList = displayLists_ && contentView_ && !drawCallback_;
+    if (useList) {
+      OSFRect content(0, 38, width_, height_ - 38);
+      impl_->nextDisplayList.build(*contentView_, OSFPoint(0, 38), content,
+                                   &impl_->displayList);
+      std::swap(impl_->displayList, impl_->nextDisplayList);
+
+      if (impl_->bufferFresh) {
+        damage.push_back(fullFrame);
+      } else {
+        damage = impl_->displayList.damage(impl_->nextDisplayList);
+        if (impl_->paintedActive != impl_->activated ||
+            impl_->paintedTitle != title_) {
+          damage.push_back(
+              OSFRect(0, 0, width_, OSFDecorationCache::kHeight));
+        } else if (impl_->paintedHover != impl_->hoveredButton) {
+          // Just the buttons that gained or lost their glyph
+          for (int button : {impl_->paintedHover, impl_->hoveredButton}) {
+            OSFRect rect = OSFDecorationCache::buttonRect(button);
+            if (!rect.isEmpty())
+              damage.push_back(rect);
+          }
+        }
+      }
+      impl_->bufferFresh = false;
+      impl_->paintedHover = impl_->hoveredButton;
+      impl_->paintedActive = impl_->activated;
+      impl_->paintedTitle = title_;
 
-    // === VitusOS CSD (Client Side Decorations) ===
-
-    // 0. Transparent Background and Rounding
-    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-    cairo_set_source_rgba(cr, 0, 0, 0, 0); // Clear to transparency
-    cairo_paint(cr);
-
-    // Clip to rounded rectangle (9px)
-    AresTheme::roundedRect(cr, 0, 0, width_, height_, 9.0);
-    cairo_clip(cr);
-
-    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
-
-    // 1. Window Background (Pure White)
-    cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-    cairo_paint(cr);
-
-    // 2. Titlebar (VitusOS Light: #F5F5F5)
-    cairo_set_source_rgb(cr, 0.96, 0.96, 0.96); // #F5F5F5
-    cairo_rectangle(cr, 0, 0, width_, 38);
-    cairo_fill(cr);
-
-    // 3. Traffic Lights (Ares Palette)
-    // Close (MarsOrange: #D4622A)
-    cairo_set_source_rgb(cr, 0.83, 0.38, 0.16);
-    cairo_arc(cr, 24, 19, 6, 0, 2 * M_PI);
-    cairo_fill(cr);
-    if (impl_->hoveredButton == 1) {
-      cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-      cairo_set_line_width(cr, 1.2);
-      cairo_move_to(cr, 21, 16);
-      cairo_line_to(cr, 27, 22);
-      cairo_move_to(cr, 27, 16);
-      cairo_line_to(cr, 21, 22);
-      cairo_stroke(cr);
+      if (damage.empty())
+        return; // Nothing on screen changed; skip the frame entirely
+    } else {
+      damage.push_back(fullFrame);
     }
 
-    // Minimize (MarsGold: #D4A93E)
-    cairo_set_source_rgb(cr, 0.83, 0.66, 0.24);
-    cairo_arc(cr, 46, 19, 6, 0, 2 * M_PI);
-    cairo_fill(cr);
-    if (impl_->hoveredButton == 2) {
-      cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-      cairo_set_line_width(cr, 1.2);
-      cairo_move_to(cr, 43, 19);
-      cairo_line_to(cr, 49, 19);
-      cairo_stroke(cr);
+    // Soft V-Sync: Request callback, but don't block
+    requestFrameCallback(impl_.get());
+    if (impl_->presentation) {
+      wp_presentation_feedback *feedback =
+          wp_presentation_feedback(impl_->presentation, impl_->surface);
+      wp_presentation_feedback_add_listener(feedback, &feedbackListener,
+                                            impl_.get());
     }
 
-    // Maximize (VitusBlue: #4A9FD4)
-    cairo_set_source_rgb(cr, 0.29, 0.62, 0.83);
-    cairo_arc(cr, 68, 19, 6, 0, 2 * M_PI);
-    cairo_fill(cr);
-    if (impl_->hoveredButton == 3) {
-      cairo_set_source_rgba(cr, 0, 0, 0, 0.5);
-      cairo_set_line_width(cr, 1.2);
-      cairo_move_to(cr, 65, 19);
-      cairo_line_to(cr, 71, 19);
-      cairo_move_to(cr, 68, 16);
-      cairo_line_to(cr, 68, 22);
-      cairo_stroke(cr);
-    }
+    // Runs once per tile when tiled rendering is on
+    auto paint = [this, useList](cairo_t *cr) {
+      // === VitusOS CSD (Client Side Decorations) ===
 
-    // 4. Title Text (Dark: #1A1A1A)
-    if (!title_.empty()) {
-      cairo_set_source_rgb(cr, 0.1, 0.1, 0.1); // #1A1A1A
-      cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
-                             CAIRO_FONT_WEIGHT_BOLD);
-      cairo_set_font_size(cr, 13);
-      cairo_text_extents_t ext;
-      cairo_text_extents(cr, title_.c_str(), &ext);
-      cairo_move_to(cr, (width_ - ext.width) / 2.0, 19 + ext.height / 2.0 - 2);
-      cairo_show_text(cr, title_.c_str());
-    }
+      // 0. Transparent Background
+      cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+      cairo_set_source_rgba(cr, 0, 0, 0, 0); // Clear to transparency
+      cairo_paint(cr);
 
-    // 5. Separator
-    cairo_set_source_rgba(cr, 0, 0, 0, 0.1);
-    cairo_move_to(cr, 0, 38);
-    cairo_line_to(cr, width_, 38);
-    cairo_stroke(cr);
+      // 1-5. Titlebar, traffic lights, title and separator, blitted from
+      // the decoration cache
+      impl_->decorations.draw(cr, width_, impl_->activated,
+                              impl_->hoveredButton, title_);
 
-    // 6. App Content (Clipped to area below title bar)
-    cairo_save(cr);
-    cairo_rectangle(cr, 0, 38, width_, height_ - 38);
-    cairo_clip(cr);
-    cairo_translate(cr, 0, 38);
+      // Window body (Pure White), clipped to rounded rectangle (9px)
+      AresTheme::roundedRect(cr, 0, 0, width_, height_, 9.0);
+      cairo_clip(cr);
+      cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+      cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+      cairo_rectangle(cr, 0, OSFDecorationCache::kHeight, width_,
+                      height_ - OSFDecorationCache::kHeight);
+      cairo_fill(cr);
 
-    if (contentView_) {
-      contentView_->render(cr);
-    }
-    if (drawCallback_) {
-      drawCallback_(cr, width_, height_ - 38);
-    }
-    cairo_restore(cr);
+      // 6. App Content (Clipped to area below title bar)
+      if (useList) {
+        impl_->displayList.replay(cr); // Clips itself
+        return;
+      }
+      cairo_save(cr);
+      cairo_rectangle(cr, 0, 38, width_, height_ - 38);
+      cairo_clip(cr);
+      cairo_translate(cr, 0, 38);
 
-    cairo_destroy(cr);
+      if (contentView_) {
+        contentView_->render(cr);
+      }
+      if (drawCallback_) {
+        drawCallback_(cr, width_, height_ - 38);
+      }
+      cairo_restore(cr);
+    };
+
+    // Painting is clipped to each damaged rect; the buffer keeps the
+    // previous frame everywhere else
+    impl_->decorations.prepare(impl_->activated, impl_->hoveredButton,
+                               title_);
+    for (const OSFRect &rect : damage) {
+      if (tiledRendering_) {
+        impl_->tileRenderer.render(impl_->cairoSurface, rect, paint);
+      } else {
+        cairo_t *cr = cairo_create(impl_->cairoSurface);
+        cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+        cairo_clip(cr);
+        paint(cr);
+        cairo_destroy(cr);
+      }
+    }
 
     // Commit
     wl_surface_attach(impl_->surface, impl_->buffer, 0, 0);
-    wl_surface_damage_buffer(impl_->surface, 0, 0, width_, height_);
+    for (const OSFRect &rect : damage) {
+      wl_surface_damage_buffer(impl_->surface, static_cast<int32_t>(rect.x),
+                               static_cast<int32_t>(rect.y),
+                               static_cast<int32_t>(rect.width),
+                               static_cast<int32_t>(rect.height));
+    }
     wl_surface_commit(impl_->surface);
     wl_display_flush(impl_->display);
   }
 }
 
+void OSFWindow::setUsesDisplayLists(bool enabled) {
+  if (displayLists_ == enabled)
+    return;
+  displayLists_ = enabled;
+  // Start from a full frame either way
+  impl_->displayList.clear();
+  impl_->nextDisplayList.clear();
+  impl_->bufferFresh = true;
+  setNeedsDisplay();
+}
+
 std::shared_ptr<OSFWindow> OSFWindow::create(int width, int height,
                                              const std::string &title) {
   return std::make_shared<OSFWindow>(width, height, title);
@@ -0,0 +1,44 @@
+/**
+ * OSFImageScaler.h - ARGB8888 Pixel Kernels
+ *
+ * Byte swizzling and high-quality resampling for the wallpaper pipeline.
+ * Resampling is a separable Lanczos-3 filter in 14-bit fixed point: a
+ * horizontal pass into an 8-bit intermediate, then a vertical pass. When
+ * minifying, the filter widens with the scale factor so every source
+ * pixel contributes (no aliasing, unlike nearest or bilinear sampling).
+ *
+ * Each kernel has a scalar version and an AVX2 (x86, chosen at runtime)
+ * or NEON (ARM) version; all produce bit-identical results.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opensef {
+
+class OSFImageScaler {
+public:
+  enum class Path { Scalar, AVX2, NEON };
+
+  // Fastest path this CPU supports, unless forced to scalar
+  static Path path();
+  static const char *pathName(Path path);
+
+  // Use the scalar kernels (for comparisons and benchmarks)
+  static void setForceScalar(bool forceScalar);
+
+  // RGBA bytes (stb_image order) to ARGB8888 words. src and dst may alias
+  static void swizzleRGBA(const uint8_t *src, uint32_t *dst, size_t count);
+
+  // Resample the source rectangle (cropX, cropY, cropWidth, cropHeight),
+  // in source pixels and possibly fractional, onto dstWidth x dstHeight.
+  // Strides are in pixels. Edges are clamped, not wrapped
+  static void resample(const uint32_t *src, int srcWidth, int srcHeight,
+                       int srcStride, float cropX, float cropY,
+                       float cropWidth, float cropHeight, uint32_t *dst,
+                       int dstWidth, int dstHeight, int dstStride);
+};
+
+} // namespace opensef
@@ -4,19 +4,23 @@
  * Renders wallpaper as a wlr_scene_rect (solid color) or
  * wlr_scene_buffer (image) in the background layer.
  *
- * Now supports actual image loading with stb_image!
+ * Images are decoded and scaled to the output size by OSFWallpaper on a
+ * worker thread; the solid color shows until the first one is ready.
  */
 
 #pragma once
 
 extern "C" {
+#include <wayland-server-core.h>
 #include <wlr/types/wlr_buffer.h>
 #include <wlr/types/wlr_scene.h>
 }
 
+#include "OSFWallpaper.h"
+
 #include <cstdint>
+#include <memory>
 #include <string>
-#include <vector>
 
 namespace opensef {
 
@@ -35,7 +39,7 @@ public:
   // Set solid color wallpaper
   void setColor(uint32_t color);
 
-  // Load image wallpaper
+  // Load image wallpaper (asynchronously)
   bool loadImage(const std::string &path);
 
   // Load default Mars wallpaper
@@ -45,6 +49,7 @@ public:
   void resize(int width, int height);
 
 private:
+  static int handleImageReady(int fd, uint32_t mask, void *data);
   void applyImageToScene();
 
   OSFCompositor *compositor_;
@@ -53,17 +58,17 @@ private:
   // Scene nodes
   wlr_scene_rect *colorRect_ = nullptr;
   wlr_scene_buffer *imageNode_ = nullptr;
-  wlr_buffer *imageBuffer_ = nullptr;
 
   // Screen size
   int width_ = 0;
   int height_ = 0;
   uint32_t color_ = 0xB5651D; // Default: Mars desert sand
 
-  // Image data
-  std::vector<uint8_t> imagePixels_;
-  int imageWidth_ = 0;
-  int imageHeight_ = 0;
+  // Image pipeline; readyFd_ wakes the event loop when it has new images
+  std::unique_ptr<OSFWallpaper> wallpaper_;
+  std::shared_ptr<const OSFWallpaperImage> image_; // Shown by imageNode_
+  int readyFd_ = -1;
+  wl_event_source *readySource_ = nullptr;
 };
 
 } // namespace opensef
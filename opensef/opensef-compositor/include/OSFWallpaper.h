@@ -1,16 +1,27 @@
 /**
  * OSFWallpaper.h - Desktop Wallpaper
  *
- * Loads and renders the desktop wallpaper behind windows.
- * Supports JPG, PNG via stb_image.
+ * Decodes and scales the desktop wallpaper off the compositor thread.
+ * Supports JPG, PNG via stb_image; JPEGs go through libjpeg instead when
+ * built with OSF_HAVE_LIBJPEG, decoding at 1/2, 1/4 or 1/8 scale when the
+ * outputs are small enough.
+ *
+ * Each requested output size gets one immutable ARGB8888 image, shared by
+ * every output of that size and handed to the background layer as is.
+ * The decoded source is dropped once the images are scaled.
  */
 
 #pragma once
 
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
-
+#include <utility>
+#include <vector>
 
 namespace opensef {
 
@@ -26,50 +37,92 @@ enum class WallpaperScaleMode {
   Tile     // Tile the image
 };
 
+// The wallpaper for one output size; never modified once published
+struct OSFWallpaperImage {
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels; // ARGB8888, stride width * 4
+};
+
 /**
  * OSFWallpaper - Desktop wallpaper manager
  */
 class OSFWallpaper {
 public:
+  // Called on a worker thread whenever new images are ready
+  using ReadyHandler = std::function<void()>;
+
+  struct Stats {
+    uint64_t decodes = 0;
+    int lastDecodeWidth = 0; // After reduced-scale decoding
+    int lastDecodeHeight = 0;
+    double lastDecodeMs = 0.0;
+    double lastScaleMs = 0.0; // All sizes of the last job
+  };
+
   OSFWallpaper(OSFCompositor *compositor);
   ~OSFWallpaper();
 
-  // Load wallpaper from file
+  // Set the wallpaper file; only its header is read here
   bool load(const std::string &path);
 
-  // Render wallpaper to buffer
-  void render(uint32_t *buffer, int screenW, int screenH);
+  // The image for an output of this size, or null until the first one is
+  // ready. After load() or a mode change the previous image is returned
+  // until its replacement is done.
+  std::shared_ptr<const OSFWallpaperImage> image(int width, int height);
+
+  void setReadyHandler(ReadyHandler handler);
 
   // Settings
-  void setScaleMode(WallpaperScaleMode mode) { scaleMode_ = mode; }
-  WallpaperScaleMode scaleMode() const { return scaleMode_; }
+  void setScaleMode(WallpaperScaleMode mode);
+  WallpaperScaleMode scaleMode() const;
+
+  // Is a wallpaper file set?
+  bool isLoaded() const;
 
-  // Is wallpaper loaded?
-  bool isLoaded() const { return pixels_ != nullptr; }
+  // Source image dimensions
+  int width() const;
+  int height() const;
 
-  // Image dimensions
-  int width() const { return width_; }
-  int height() const { return height_; }
+  // Block until queued decoding and scaling has finished
+  void waitIdle();
+
+  Stats stats() const;
 
 private:
+  using Size = std::pair<int, int>;
+
+  struct Entry {
+    std::shared_ptr<const OSFWallpaperImage> image;
+    uint64_t generation = 0;
+  };
+
+  void invalidateLocked();
+  void scheduleLocked();
+  void runJobs();
+
   OSFCompositor *compositor_;
 
-  // Image data
-  uint32_t *pixels_ = nullptr;
+  mutable std::mutex mutex_;
+  std::condition_variable idle_;
+
+  // Source
+  std::string path_;
   int width_ = 0;
   int height_ = 0;
 
-  // Scaled cache
-  uint32_t *scaledPixels_ = nullptr;
-  int scaledWidth_ = 0;
-  int scaledHeight_ = 0;
-
   WallpaperScaleMode scaleMode_ = WallpaperScaleMode::Fill;
 
-  // Helpers
-  void freePixels();
-  void createScaledCache(int targetW, int targetH);
-  uint32_t sampleBilinear(float x, float y);
+  // Scaled images by output size; generation_ changes with the source or
+  // mode, making older entries stale
+  std::map<Size, Entry> images_;
+  std::vector<Size> pending_;
+  uint64_t generation_ = 1;
+  bool working_ = false;
+  bool stopping_ = false;
+
+  ReadyHandler readyHandler_;
+  Stats stats_;
 };
 
 } // namespace opensef
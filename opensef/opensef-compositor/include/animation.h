@@ -0,0 +1,72 @@
+/**
+ * animation.h - Compositor-side Window Animations
+ *
+ * Animations run on the output frame clock and only touch scene nodes:
+ * the view tree's position, and the opacity and destination size of its
+ * buffers. Clients are never asked to redraw, so a busy client animates
+ * as smoothly as an idle one.
+ *
+ * - Map: fade and grow in
+ * - Unmap: the last buffers fade and shrink out (a "ghost" copy, since the
+ *   surface is gone)
+ * - Minimize/restore: shrink toward the dock and back
+ * - Tiling, overview and maximize: every layout transaction morphs views
+ *   from the box they were shown in to their new one
+ *
+ * Set VITUS_ANIMATIONS=0 to disable them.
+ */
+
+#ifndef OSF_ANIMATION_H
+#define OSF_ANIMATION_H
+
+#include "server.h"
+#include <stdbool.h>
+
+/* Durations, following the Ares design spec (OSFAnimations.h) */
+#define OSF_ANIM_MAP_MS 200
+#define OSF_ANIM_UNMAP_MS 200
+#define OSF_ANIM_MINIMIZE_MS 300
+#define OSF_ANIM_GEOMETRY_MS 200
+#define OSF_ANIM_OVERVIEW_MS 300
+
+void osf_animation_init(struct osf_server *server);
+void osf_animation_finish(struct osf_server *server);
+
+/* Advance every animation to `now_ms` (CLOCK_MONOTONIC); called before
+ * each output frame is rendered */
+void osf_animation_tick(struct osf_server *server, double now_ms);
+
+/* Where the view is currently shown, animated or not */
+struct wlr_box osf_animation_view_box(struct osf_view *view);
+
+/* Scene position the layout gave the view, ignoring any animation */
+void osf_animation_view_position(struct osf_view *view, int *x, int *y);
+
+void osf_animation_view_map(struct osf_view *view);
+void osf_animation_view_unmap(struct osf_view *view);
+void osf_animation_view_minimize(struct osf_view *view, bool minimized);
+
+/* The view was moved/resized by a layout transaction and is now at its
+ * new place; morph it there from `from` */
+void osf_animation_view_moved(struct osf_view *view, struct wlr_box from);
+
+/* Jump to the end state, e.g. before an interactive move */
+void osf_animation_view_finish(struct osf_view *view);
+
+/* Show the view at `scale` of its size while at rest, shrunk toward its
+ * tree position; 1 is its own size. The overview fits windows into its
+ * grid slots this way. Morphs there when animations are on */
+void osf_animation_view_set_scale(struct osf_view *view, float scale);
+
+/* After a commit: keep the new buffers at the view's rest scale */
+void osf_animation_view_commit(struct osf_view *view);
+
+/* Dim the desktop in or out behind the overview */
+void osf_animation_overview(struct osf_server *server, bool active);
+
+/* Copy the buffers below `node` into `into`, at their offsets from the
+ * node's parent: the node's own position is included */
+void osf_animation_copy_buffers(struct wlr_scene_node *node,
+                                struct wlr_scene_tree *into);
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * capture.h - Screen Capture (screencopy / image-copy-capture)
+ *
+ * Exposes the outputs to capture clients (grim, wayvnc, visual tests):
+ *
+ * - wlr-screencopy-unstable-v1 (our own, capture.c), including
+ *   copy_with_damage: a frame only completes once the output has rendered
+ *   new damage, the client gets the damaged rectangles, and only what
+ *   changed since its buffer was last filled is read back into it
+ * - ext-image-copy-capture-v1 with output sources (wlroots 0.19): damage
+ *   is tracked per client buffer, and copies into dmabufs only blit the
+ *   damaged region
+ * - wlr-export-dmabuf-unstable-v1: the output's own buffer, no copy at all
+ * - xdg-output, so clients can map outputs to the layout
+ *
+ * Every capture rides on the output's normal commit, so it is paced by the
+ * output and costs nothing while the screen is idle.
+ */
+
+#ifndef OSF_CAPTURE_H
+#define OSF_CAPTURE_H
+
+struct osf_server;
+
+void osf_capture_init(struct osf_server *server);
+void osf_capture_finish(struct osf_server *server);
+
+#endif
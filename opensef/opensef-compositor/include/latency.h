@@ -0,0 +1,74 @@
+/**
+ * latency.h - Input-to-Commit Latency Tracing
+ *
+ * With VITUS_LATENCY_TRACE=1 every pointer and keyboard event is followed
+ * from its device timestamp to the first output commit that shows new
+ * damage after it. The stages are timed from the event's arrival in the
+ * compositor, except delivery and total:
+ *
+ *   delivery   device timestamp to the compositor's handler
+ *   dispatch   delivered to the client, or its keybinding done
+ *   focus      focus change done (only events that changed focus)
+ *   framework  osf_window_focus(): EventBus publication and subscribers
+ *   commit     first output commit with damage
+ *   total      device timestamp to that commit
+ *
+ * Framework events published while an event is handled carry its
+ * timestamp (OSFEventBus::INPUT_TIME_KEY). Percentiles per event kind and
+ * stage are logged and written to $XDG_RUNTIME_DIR/vitus-latency-<socket>.json
+ * every VITUS_LATENCY_REPORT_MS.
+ *
+ * Motion is coalesced per pointer frame, and per output frame while it
+ * stays on one surface (input.c), so a "motion" event is one batch, timed
+ * from its oldest device timestamp.
+ *
+ * Disabled, each hook is a function call and a NULL check.
+ */
+
+#ifndef OSF_LATENCY_H
+#define OSF_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define OSF_LATENCY_REPORT_MS 5000
+
+struct osf_server;
+
+enum osf_latency_kind {
+  OSF_LATENCY_MOTION,
+  OSF_LATENCY_BUTTON,
+  OSF_LATENCY_AXIS,
+  OSF_LATENCY_KEY,
+  OSF_LATENCY_KIND_COUNT,
+};
+
+enum osf_latency_stage {
+  OSF_LATENCY_DELIVERY,
+  OSF_LATENCY_DISPATCH,
+  OSF_LATENCY_FOCUS,
+  OSF_LATENCY_FRAMEWORK,
+  OSF_LATENCY_COMMIT,
+  OSF_LATENCY_TOTAL,
+  OSF_LATENCY_STAGE_COUNT,
+};
+
+void osf_latency_init(struct osf_server *server);
+void osf_latency_finish(struct osf_server *server);
+
+/* Bracket an input handler; time_msec is the event's device timestamp */
+void osf_latency_event_begin(struct osf_server *server,
+                             enum osf_latency_kind kind, uint32_t time_msec);
+void osf_latency_event_end(struct osf_server *server);
+
+/* The event being handled reached a stage; no-op outside a handler */
+void osf_latency_mark(struct osf_server *server, enum osf_latency_stage stage);
+
+/* Around framework calls made on behalf of the event being handled */
+void osf_latency_framework_begin(struct osf_server *server);
+void osf_latency_framework_end(struct osf_server *server);
+
+/* After an output commit; damaged: it put something new on screen */
+void osf_latency_output_commit(struct osf_server *server, bool damaged);
+
+#endif
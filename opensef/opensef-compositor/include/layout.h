@@ -0,0 +1,110 @@
+/**
+ * layout.h - Tiling Layout Trees
+ *
+ * Pure layout math for the tiling engine, with no wlroots dependency: a
+ * tree of split containers whose leaves are windows (opaque pointers).
+ * Inserting or removing a window re-arranges only the subtree whose
+ * children changed, and every operation reports just the windows whose
+ * tile actually moved or resized.
+ */
+
+#ifndef OSF_LAYOUT_H
+#define OSF_LAYOUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum osf_layout_kind {
+  OSF_LAYOUT_MASTER_STACK, /* Master column on the left, stack on the right */
+  OSF_LAYOUT_DWINDLE,      /* Each window splits the focused one (BSP) */
+  OSF_LAYOUT_COLUMNS,      /* Equal-width columns */
+  OSF_LAYOUT_KIND_COUNT,
+};
+
+enum osf_layout_split {
+  OSF_SPLIT_HORIZONTAL, /* Children side by side */
+  OSF_SPLIT_VERTICAL,   /* Children stacked */
+};
+
+struct osf_layout_rect {
+  int x, y, width, height;
+};
+
+struct osf_layout_config {
+  int inner_gap;
+  int outer_gap;
+  float master_ratio; /* Master column's share of the width */
+  int master_count;   /* Windows in the master column */
+};
+
+struct osf_layout_node {
+  struct osf_layout_node *parent;
+  struct osf_layout_node **children;
+  size_t child_count;
+  size_t child_capacity;
+  enum osf_layout_split split;
+  float ratio;                 /* First child's share of two; 0 = equal */
+  void *window;                /* Leaves only */
+  struct osf_layout_rect rect; /* Last arranged box */
+  bool placed;                 /* Leaf rect has been reported */
+};
+
+struct osf_layout_delta {
+  void *window;
+  struct osf_layout_rect rect;
+};
+
+struct osf_layout {
+  enum osf_layout_kind kind;
+  struct osf_layout_config config;
+  struct osf_layout_rect area; /* Output box, before outer gaps */
+  struct osf_layout_node *root;
+  struct osf_layout_node *focused; /* Leaf new windows are placed after */
+  size_t window_count;
+
+  /* Windows whose tile changed in the last operation */
+  struct osf_layout_delta *deltas;
+  size_t delta_count;
+  size_t delta_capacity;
+
+  uint64_t nodes_arranged; /* Running total, for benchmarks */
+};
+
+struct osf_layout *osf_layout_create(enum osf_layout_kind kind,
+                                     const struct osf_layout_config *config,
+                                     struct osf_layout_rect area);
+void osf_layout_destroy(struct osf_layout *layout);
+
+/* Each operation below replaces layout->deltas */
+
+/* Returns the window's leaf, its handle for the calls below */
+struct osf_layout_node *osf_layout_insert(struct osf_layout *layout,
+                                          void *window);
+void osf_layout_remove(struct osf_layout *layout,
+                       struct osf_layout_node *leaf);
+
+/* Focus decides where the next window goes; nothing moves */
+void osf_layout_focus(struct osf_layout *layout, struct osf_layout_node *leaf);
+
+void osf_layout_set_area(struct osf_layout *layout,
+                         struct osf_layout_rect area);
+void osf_layout_set_config(struct osf_layout *layout,
+                           const struct osf_layout_config *config);
+void osf_layout_set_kind(struct osf_layout *layout,
+                         enum osf_layout_kind kind);
+
+/* Recompute the whole tree; reports nothing if it is up to date */
+void osf_layout_arrange(struct osf_layout *layout);
+
+const char *osf_layout_kind_name(enum osf_layout_kind kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,8 @@
 #define OSF_SERVER_H
 
 #include "multitask.h"
+#include "transaction.h"
+#include <pixman.h>
 #include <wayland-server-core.h>
 #include <wlr/backend.h>
 #include <wlr/render/allocator.h>
@@ -38,18 +40,44 @@ struct osf_output;
 struct osf_view;
 struct osf_layer_surface;
 struct osf_titlebar;
+struct osf_layout;
+struct osf_layout_node;
+struct osf_workspace;
+struct osf_animator;
+struct osf_thumbnail;
+struct osf_latency;
+struct osf_capture;
 
 /* ============================================================================
  * Server State
  * ============================================================================
  */
 
+#define OSF_WORKSPACE_COUNT 9
+
 enum osf_cursor_mode {
   OSF_CURSOR_PASSTHROUGH,
   OSF_CURSOR_MOVE,
   OSF_CURSOR_RESIZE,
 };
 
+/* Last pointer hit test (input.c). While the cursor stays inside region
+ * and nothing was mapped, moved, resized or restacked over it, the surface
+ * under it is known without walking the scene. */
+struct osf_pointer_hit {
+  bool valid;
+  struct wlr_surface *surface;
+  struct osf_view *view;     /* NULL: layer or unmanaged surface */
+  double origin_x, origin_y; /* Surface origin in layout coordinates */
+  pixman_region32_t region;  /* Shown part of surface, nothing above it */
+  struct wl_listener surface_destroy;
+  /* The surface's root; its commits place the surface and subsurfaces */
+  struct wlr_surface *root;
+  int root_width, root_height;
+  struct wl_listener root_commit;
+  struct wl_listener root_destroy;
+};
+
 struct osf_server {
   struct wl_display *wl_display;
   struct wl_event_loop *wl_event_loop;
@@ -67,7 +95,7 @@ struct osf_server {
   /* Desktop layers (bottom to top) */
   struct wlr_scene_tree *layer_background;
   struct wlr_scene_tree *layer_bottom;
-  struct wlr_scene_tree *layer_views;   /* Normal windows */
+  struct wlr_scene_tree *layer_views;   /* Workspace trees */
   struct wlr_scene_tree *layer_top;     /* Dock, panel */
   struct wlr_scene_tree *layer_overlay; /* Notifications, OSD */
 
@@ -90,6 +118,8 @@ struct osf_server {
   /* Input */
   struct wlr_seat *seat;
   struct wl_listener new_input;
+  struct wl_listener new_virtual_keyboard; /* VITUS_VIRTUAL_INPUT=1 only */
+  struct wl_listener new_virtual_pointer;
   struct wl_listener request_cursor;
   struct wl_listener request_set_selection;
   struct wl_list keyboards;
@@ -103,6 +133,16 @@ struct osf_server {
   struct wl_listener cursor_axis;
   struct wl_listener cursor_frame;
 
+  /* Motion is coalesced until the pointer frame (or the loop goes idle),
+   * and while it stays on the hit-cached surface, until the output frame */
+  bool motion_pending;
+  uint32_t motion_time;       /* Newest coalesced event */
+  uint32_t motion_first_time; /* Oldest, for latency tracing */
+  struct wl_event_source *motion_idle;
+  bool motion_frame_pending; /* Cache hit: deliver on the next output frame */
+  struct osf_pointer_hit pointer_hit;
+  bool default_cursor; /* Compositor's image shown, not a client's */
+
   /* Cursor mode (move/resize) */
   enum osf_cursor_mode cursor_mode;
   struct osf_view *grabbed_view;
@@ -123,6 +163,34 @@ struct osf_server {
 
   /* Multitask / Overview */
   struct osf_multitask *multitask;
+
+  /* Workspaces; only the active one's tree is enabled */
+  struct osf_workspace *workspaces[OSF_WORKSPACE_COUNT];
+  struct osf_workspace *active_workspace;
+
+  /* Frame callback throttling for views nobody can see (visibility.h) */
+  bool visibility_dirty;
+  int throttled_frame_ms; /* 0: no callbacks at all while hidden */
+  struct wl_event_source *throttle_timer;
+
+  /* Window animations (animation.h) */
+  struct osf_animator *animator;
+
+  /* Live window thumbnails for the shell (thumbnail.h) */
+  int thumbnail_ms; /* Minimum interval per window; 0: disabled */
+  struct wl_event_source *thumbnail_timer;
+  struct wl_global *thumbnail_global; /* zvitus_thumbnail_manager_v1 */
+  struct wl_list thumbnail_resources; /* Bound managers */
+
+  /* Input-to-commit latency tracing (latency.h); NULL unless enabled */
+  struct osf_latency *latency;
+
+  /* Screen capture clients and their damage (capture.h) */
+  struct osf_capture *capture;
+
+  /* Layout transaction waiting for clients (at most one) */
+  struct osf_transaction *pending_transaction;
+  struct osf_transaction_stats transaction_stats;
 };
 
 /* ============================================================================
@@ -139,6 +207,32 @@ struct osf_output {
   struct wl_listener frame;
   struct wl_listener request_state;
   struct wl_listener destroy;
+
+  /* Tiling: one layout per workspace, `layout` is the active one's */
+  struct osf_layout *layouts[OSF_WORKSPACE_COUNT];
+  struct osf_layout *layout;
+  bool layout_dirty[OSF_WORKSPACE_COUNT]; /* Changed while hidden */
+  bool tiling;
+};
+
+/* ============================================================================
+ * Workspace
+ * ============================================================================
+ */
+
+enum osf_view_visibility {
+  OSF_VIEW_VISIBLE,
+  OSF_VIEW_OCCLUDED,  /* Covered by opaque views above it */
+  OSF_VIEW_OFFSCREEN, /* Outside every output */
+  OSF_VIEW_MINIMIZED,
+  OSF_VIEW_HIDDEN, /* On a hidden workspace */
+};
+
+struct osf_workspace {
+  struct osf_server *server;
+  int index;
+  struct wlr_scene_tree *tree; /* Parent of its views' trees */
+  int view_count;
 };
 
 /* ============================================================================
@@ -146,11 +240,20 @@ struct osf_output {
  * ============================================================================
  */
 
+enum osf_anim_kind {
+  OSF_ANIM_NONE,
+  OSF_ANIM_MAP,
+  OSF_ANIM_MINIMIZE,
+  OSF_ANIM_RESTORE,
+  OSF_ANIM_GEOMETRY,
+};
+
 struct osf_view {
   struct wl_list link;
   struct osf_server *server;
   struct wlr_xdg_toplevel *xdg_toplevel;
   struct wlr_scene_tree *scene_tree;   /* Container tree */
+  struct osf_workspace *workspace;     /* Owns scene_tree */
   struct wlr_scene_tree *content_tree; /* XDG surface tree */
 
   /* Listeners */
@@ -166,9 +269,50 @@ struct osf_view {
 
   /* State */
   bool mapped;
+  bool minimized;
   bool is_tiled;
+  struct osf_layout_node *tile;    /* Leaf in tile_layout */
+  struct osf_layout *tile_layout;
+  struct osf_output *tile_output;
   float saved_x, saved_y;
   float saved_w, saved_h;
+  struct wlr_box unmaximized; /* Tree position and size to restore */
+
+  /* Interactive resize: at most one configure in flight. Pointer motion
+   * only updates the desired box; the next configure goes out once the
+   * client has acked and committed the previous one, or after
+   * OSF_RESIZE_TIMEOUT_MS if it never does. */
+  struct {
+    uint32_t serial;        /* Outstanding configure, 0 if none */
+    struct wl_event_source *timer; /* Deadline for serial */
+    struct wlr_box sent;    /* Layout box of the outstanding configure */
+    struct wlr_box desired; /* Latest box from the pointer */
+    bool has_desired;       /* desired is newer than sent */
+    uint32_t edges;         /* Grabbed edges; the opposite ones stay put */
+  } resize;
+
+  /* Frame callbacks: full rate only while visible on frame_output */
+  enum osf_view_visibility visibility;
+  struct osf_output *frame_output; /* Output showing most of the view */
+  int committed_width, committed_height;
+  uint64_t frames_sent;
+  uint64_t frames_suppressed; /* Frames of any output that skipped it */
+
+  /* Compositor-side animation (animation.h) */
+  struct {
+    enum osf_anim_kind kind;
+    double start_ms;
+    int duration_ms;
+    struct wlr_box from, to; /* Shown boxes; empty `to`: the view's own */
+    float from_alpha, to_alpha;
+    struct wlr_box box; /* Shown at the last tick */
+    float alpha;
+    int real_x, real_y;       /* Tree position set by the layout */
+    int applied_x, applied_y; /* Tree position set by the last tick */
+    float scale;              /* At rest; below 1 in the overview */
+  } anim;
+
+  struct osf_thumbnail *thumbnail; /* Shared snapshot, NULL if none */
 
   /* Borders */
   struct wlr_scene_rect *border_top;
@@ -232,8 +376,31 @@ struct osf_view *osf_view_at(struct osf_server *server, double lx, double ly,
                              struct wlr_surface **surface, double *sx,
                              double *sy);
 void osf_focus_view(struct osf_view *view, struct wlr_surface *surface);
+/* A client that doesn't ack a resize configure within this is sent the
+ * next size anyway */
+#define OSF_RESIZE_TIMEOUT_MS 200
+void osf_view_resize(struct osf_view *view, struct wlr_box box,
+                     uint32_t edges);
+void osf_view_set_minimized(struct osf_view *view, bool minimized);
+
+/* Outputs */
+struct osf_output *osf_output_at_cursor(struct osf_server *server);
 
 /* Cursor */
 void osf_reset_cursor_mode(struct osf_server *server);
+void osf_cursor_hit_init(struct osf_server *server);
+void osf_cursor_hit_finish(struct osf_server *server);
+/* The scene changed under the cursor; next motion hit-tests again */
+void osf_cursor_invalidate_hit(struct osf_server *server);
+/* Something moved within box (layout coordinates); drops the hit cache
+ * only if it reaches the cached region */
+void osf_cursor_scene_changed(struct osf_server *server,
+                              const struct wlr_box *box);
+/* Before rendering: the one delivery per frame for motion on the cached
+ * surface */
+void osf_cursor_output_frame(struct osf_server *server);
+
+/* Input */
+void osf_virtual_input_init(struct osf_server *server);
 
 #endif /* OSF_SERVER_H */
@@ -0,0 +1,31 @@
+/**
+ * thumbnail.h - Live Window Thumbnails
+ *
+ * Every mapped window gets a downscaled snapshot in a sealed memfd the
+ * shell receives over zvitus_thumbnail_manager_v1 and maps read-only
+ * (layout in <opensef/OSFThumbnail.h>). The snapshot is rendered
+ * on the GPU from the surface textures and read back at thumbnail size, so
+ * its cost scales with the thumbnail, not the window. It is only redone
+ * after the window commits damage, and at most once per
+ * server->thumbnail_ms (VITUS_THUMBNAIL_MS, default 200; 0 disables
+ * thumbnails).
+ */
+
+#ifndef OSF_THUMBNAIL_H
+#define OSF_THUMBNAIL_H
+
+#include "server.h"
+
+#define OSF_THUMBNAIL_INTERVAL_MS 200
+#define OSF_THUMBNAIL_MANAGER_VERSION 1
+
+void osf_thumbnail_init(struct osf_server *server);
+void osf_thumbnail_finish(struct osf_server *server);
+
+void osf_thumbnail_view_map(struct osf_view *view);
+void osf_thumbnail_view_unmap(struct osf_view *view);
+
+/* Schedules a new snapshot if the commit carried damage */
+void osf_thumbnail_view_commit(struct osf_view *view);
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef OSF_TILING_H
 #define OSF_TILING_H
 
+#include "layout.h"
 #include "server.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -19,7 +20,26 @@ struct osf_tiling_config {
 
 void osf_tiling_init(struct osf_server *server);
 void osf_tiling_update(struct osf_server *server);
+
+/* Each output keeps a layout tree per workspace (see layout.h) */
+void osf_tiling_output_init(struct osf_output *output);
+void osf_tiling_output_destroy(struct osf_output *output);
+void osf_tiling_toggle(struct osf_server *server, struct osf_output *output);
+void osf_tiling_cycle_layout(struct osf_server *server,
+                             struct osf_output *output);
+
+/* Re-fit the layouts to the output's current size */
 void osf_tiling_arrange(struct osf_server *server, struct osf_output *output);
+
+/* Outputs show the active workspace's layouts */
+void osf_tiling_workspace_activated(struct osf_server *server);
+
+/* View lifecycle; only windows on a tiling output are affected */
+void osf_tiling_view_map(struct osf_view *view);
+void osf_tiling_view_unmap(struct osf_view *view);
+void osf_tiling_view_focus(struct osf_view *view);
+void osf_tiling_view_workspace_changed(struct osf_view *view);
+
 void osf_view_update_borders(struct osf_view *view, bool active);
 
 #endif
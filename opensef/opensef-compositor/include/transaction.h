@@ -0,0 +1,56 @@
+/**
+ * transaction.h - Atomic Layout Transactions
+ *
+ * A layout change (tiling, overview) records the target geometry of every
+ * view it touches and sends the new sizes. Until each client has committed
+ * a buffer for its new size, or the deadline passes, views keep showing
+ * their old buffers at their old positions; then every scene change is
+ * applied at once, so a single output frame shows the whole new layout.
+ */
+
+#ifndef OSF_TRANSACTION_H
+#define OSF_TRANSACTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct osf_server;
+struct osf_view;
+struct osf_transaction;
+
+/* Clients slower than this are shown at their new position anyway */
+#define OSF_TRANSACTION_TIMEOUT_MS 200
+
+struct osf_transaction_stats {
+  uint64_t committed;  /* Transactions started */
+  uint64_t applied;    /* Transactions shown */
+  uint64_t timed_out;  /* ... of which hit the deadline */
+  uint64_t superseded; /* Merged into a newer one before being shown */
+  uint32_t last_views;
+  uint32_t last_configures;
+  double last_wait_ms; /* Commit to apply */
+  double max_wait_ms;
+};
+
+struct osf_transaction *osf_transaction_begin(struct osf_server *server);
+
+/* Target layout box of the view's scene tree. A width or height <= 0
+ * keeps the current size and only moves the view (no configure). The
+ * content offset places the client surface inside that box. */
+void osf_transaction_set_geometry(struct osf_transaction *txn,
+                                  struct osf_view *view, int x, int y,
+                                  int width, int height, int content_x,
+                                  int content_y);
+
+/* Send configures and start waiting; a transaction still waiting is
+ * merged into this one */
+void osf_transaction_commit(struct osf_transaction *txn);
+
+/* Hooks from the view lifecycle */
+void osf_transaction_view_commit(struct osf_view *view);
+void osf_transaction_view_unmap(struct osf_view *view);
+
+/* Whether a waiting transaction will place the view */
+bool osf_transaction_has_view(struct osf_view *view);
+
+#endif
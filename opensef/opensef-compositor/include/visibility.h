@@ -0,0 +1,41 @@
+/**
+ * visibility.h - Occlusion-aware Frame Callbacks
+ *
+ * Before each output frame the views are walked front to back, subtracting
+ * the opaque regions of the views above, to tell which ones can actually
+ * be seen. Only visible views get a frame callback with every frame of the
+ * output showing most of them. Covered, off-screen, minimized and hidden
+ * workspace views are marked suspended and get one callback per
+ * server->throttled_frame_ms instead (none if 0), until the frame in which
+ * they become visible again.
+ *
+ * The rate can be set with VITUS_THROTTLED_FRAME_MS.
+ */
+
+#ifndef OSF_VISIBILITY_H
+#define OSF_VISIBILITY_H
+
+#include "server.h"
+#include <time.h>
+
+#define OSF_VISIBILITY_THROTTLED_FRAME_MS 1000
+
+void osf_visibility_init(struct osf_server *server);
+void osf_visibility_finish(struct osf_server *server);
+
+/* Stacking, geometry, opaque regions or outputs changed */
+void osf_visibility_mark_dirty(struct osf_server *server);
+
+/* Recompute visibility if anything changed since the last frame */
+void osf_visibility_update(struct osf_server *server);
+
+/* Replaces wlr_scene_output_send_frame_done() */
+void osf_visibility_send_frame_done(struct osf_output *output,
+                                    const struct timespec *now);
+
+/* Views shown on an output that is going away */
+void osf_visibility_output_destroy(struct osf_output *output);
+
+const char *osf_visibility_name(enum osf_view_visibility visibility);
+
+#endif
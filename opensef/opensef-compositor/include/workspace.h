@@ -0,0 +1,30 @@
+/**
+ * workspace.h - Virtual Workspaces
+ *
+ * Every workspace owns a scene tree under layer_views holding its views'
+ * trees. Only the active workspace's tree is enabled, so hidden views are
+ * neither rendered nor hit-tested; their frame callbacks are throttled
+ * like any other view nobody can see (see visibility.h).
+ */
+
+#ifndef OSF_WORKSPACE_H
+#define OSF_WORKSPACE_H
+
+struct osf_server;
+struct osf_view;
+
+/* Must run before outputs appear, they create per-workspace layouts */
+void osf_workspace_init(struct osf_server *server);
+void osf_workspace_finish(struct osf_server *server);
+
+/* Show workspace `index` (0-based) and hide the current one */
+void osf_workspace_switch(struct osf_server *server, int index);
+
+/* Send the view to workspace `index`; it stays focused only if that is
+ * the active one */
+void osf_workspace_move_view(struct osf_view *view, int index);
+
+/* Focus whatever was on top of the active workspace, or nothing */
+void osf_workspace_focus_top(struct osf_server *server);
+
+#endif
@@ -0,0 +1,475 @@
+/**
+ * OSFImageScaler.cpp - ARGB8888 Pixel Kernels Implementation
+ */
+
+#include "OSFImageScaler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define OSF_SCALER_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OSF_SCALER_NEON 1
+#endif
+
+namespace opensef {
+
+namespace {
+
+constexpr int kPrecision = 14; // Weights sum to 1 << kPrecision
+constexpr int kRound = 1 << (kPrecision - 1);
+
+std::atomic<bool> gForceScalar{false};
+
+// Filter taps for one axis: output i reads `taps` consecutive source pixels
+// starting at first[i], weighted by weights[i * taps ...]
+struct Coefficients {
+  int taps = 0;
+  std::vector<int> first;
+  std::vector<int16_t> weights;
+};
+
+double lanczos3(double x) {
+  x = std::fabs(x);
+  if (x < 1e-9)
+    return 1.0;
+  if (x >= 3.0)
+    return 0.0;
+  const double px = M_PI * x;
+  return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+}
+
+// The tap count is padded to a multiple of `align` and every window is
+// shifted to stay inside the source, so SIMD loops need no tail handling
+Coefficients computeCoefficients(int srcSize, double start, double length,
+                                 int dstSize, int align) {
+  Coefficients c;
+  const double scale = length / dstSize;
+  const double filterScale = std::max(scale, 1.0);
+  const double support = 3.0 * filterScale;
+  int taps = 2 * static_cast<int>(std::ceil(support)) + 1;
+  taps = (taps + align - 1) / align * align;
+  c.taps = std::min(taps, srcSize);
+  c.first.resize(dstSize);
+  c.weights.assign(static_cast<size_t>(dstSize) * c.taps, 0);
+
+  std::vector<double> window(c.taps);
+  for (int i = 0; i < dstSize; ++i) {
+    const double center = start + (i + 0.5) * scale;
+    int lo = std::max(0, static_cast<int>(std::floor(center - support)));
+    int hi = std::min(srcSize, static_cast<int>(std::ceil(center + support)));
+    hi = std::min(hi, lo + c.taps);
+    if (hi <= lo) { // Crop entirely outside the image: clamp to the edge
+      lo = std::min(std::max(0, static_cast<int>(center)), srcSize - 1);
+      hi = lo + 1;
+    }
+
+    double sum = 0.0;
+    for (int j = lo; j < hi; ++j) {
+      window[j - lo] = lanczos3((j + 0.5 - center) / filterScale);
+      sum += window[j - lo];
+    }
+    if (sum == 0.0) {
+      window[0] = 1.0;
+      sum = 1.0;
+      hi = lo + 1;
+    }
+
+    const int first = std::min(lo, srcSize - c.taps);
+    c.first[i] = first;
+    int16_t *weights = &c.weights[static_cast<size_t>(i) * c.taps];
+    int total = 0, largest = lo - first;
+    for (int j = lo; j < hi; ++j) {
+      int16_t w = static_cast<int16_t>(
+          std::lround(window[j - lo] / sum * (1 << kPrecision)));
+      weights[j - first] = w;
+      total += w;
+      if (w > weights[largest])
+        largest = j - first;
+    }
+    // Rounding residue goes to the centre tap so flat areas stay exact
+    weights[largest] =
+        static_cast<int16_t>(weights[largest] + (1 << kPrecision) - total);
+  }
+  return c;
+}
+
+inline uint32_t clampChannel(int value) {
+  value >>= kPrecision;
+  return static_cast<uint32_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// -----------------------------------------------------------------------------
+// Scalar kernels
+// -----------------------------------------------------------------------------
+
+void swizzleScalar(const uint8_t *src, uint32_t *dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t *p = src + i * 4;
+    dst[i] = (uint32_t(p[3]) << 24) | (uint32_t(p[0]) << 16) |
+             (uint32_t(p[1]) << 8) | p[2];
+  }
+}
+
+void horizontalScalar(const uint32_t *src, int srcStride, int rowBegin,
+                      int rowEnd, const Coefficients &c, uint32_t *out,
+                      int dstWidth) {
+  for (int row = rowBegin; row < rowEnd; ++row) {
+    const uint32_t *in = src + static_cast<ptrdiff_t>(row) * srcStride;
+    uint32_t *line = out + static_cast<ptrdiff_t>(row - rowBegin) * dstWidth;
+    for (int x = 0; x < dstWidth; ++x) {
+      const int16_t *w = &c.weights[static_cast<size_t>(x) * c.taps];
+      const uint32_t *p = in + c.first[x];
+      int ch0 = kRound, ch1 = kRound, ch2 = kRound, ch3 = kRound;
+      for (int k = 0; k < c.taps; ++k) {
+        const uint32_t px = p[k];
+        ch0 += int(px & 0xFF) * w[k];
+        ch1 += int((px >> 8) & 0xFF) * w[k];
+        ch2 += int((px >> 16) & 0xFF) * w[k];
+        ch3 += int(px >> 24) * w[k];
+      }
+      line[x] = clampChannel(ch0) | (clampChannel(ch1) << 8) |
+                (clampChannel(ch2) << 16) | (clampChannel(ch3) << 24);
+    }
+  }
+}
+
+void verticalScalar(const uint32_t *tmp, int rowBegin, const Coefficients &c,
+                    uint32_t *dst, int dstWidth, int dstHeight, int dstStride,
+                    int xBegin = 0) {
+  for (int y = 0; y < dstHeight; ++y) {
+    const int16_t *w = &c.weights[static_cast<size_t>(y) * c.taps];
+    const uint32_t *base =
+        tmp + static_cast<ptrdiff_t>(c.first[y] - rowBegin) * dstWidth;
+    uint32_t *line = dst + static_cast<ptrdiff_t>(y) * dstStride;
+    for (int x = xBegin; x < dstWidth; ++x) {
+      int ch0 = kRound, ch1 = kRound, ch2 = kRound, ch3 = kRound;
+      for (int k = 0; k < c.taps; ++k) {
+        const uint32_t px = base[static_cast<ptrdiff_t>(k) * dstWidth + x];
+        ch0 += int(px & 0xFF) * w[k];
+        ch1 += int((px >> 8) & 0xFF) * w[k];
+        ch2 += int((px >> 16) & 0xFF) * w[k];
+        ch3 += int(px >> 24) * w[k];
+      }
+      line[x] = clampChannel(ch0) | (clampChannel(ch1) << 8) |
+                (clampChannel(ch2) << 16) | (clampChannel(ch3) << 24);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// AVX2 kernels
+// -----------------------------------------------------------------------------
+
+#if defined(OSF_SCALER_X86)
+
+bool cpuHasAVX2() {
+  static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+  return hasAVX2;
+}
+
+__attribute__((target("avx2"))) void swizzleAVX2(const uint8_t *src,
+                                                 uint32_t *dst, size_t count) {
+  // R G B A -> B G R A bytes, i.e. 0xAARRGGBB little-endian words
+  const __m256i mask = _mm256_setr_epi8(
+      2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5,
+      4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_shuffle_epi8(v, mask));
+  }
+  swizzleScalar(src + i * 4, dst + i, count - i);
+}
+
+// Four taps per step: pixel pairs are interleaved per channel so that
+// _mm256_madd_epi16 multiplies and sums two taps at once
+__attribute__((target("avx2"))) void
+horizontalAVX2(const uint32_t *src, int srcStride, int rowBegin, int rowEnd,
+               const Coefficients &c, uint32_t *out, int dstWidth) {
+  const __m128i interleave =
+      _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+  for (int row = rowBegin; row < rowEnd; ++row) {
+    const uint32_t *in = src + static_cast<ptrdiff_t>(row) * srcStride;
+    uint32_t *line = out + static_cast<ptrdiff_t>(row - rowBegin) * dstWidth;
+    for (int x = 0; x < dstWidth; ++x) {
+      const int16_t *w = &c.weights[static_cast<size_t>(x) * c.taps];
+      const uint32_t *p = in + c.first[x];
+      __m256i acc = _mm256_setzero_si256();
+      for (int k = 0; k < c.taps; k += 4) {
+        __m128i pixels = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + k)),
+            interleave);
+        __m128i w4 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(w + k));
+        __m256i weights = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_shuffle_epi32(w4, 0x00)),
+            _mm_shuffle_epi32(w4, 0x55), 1);
+        acc = _mm256_add_epi32(
+            acc, _mm256_madd_epi16(_mm256_cvtepu8_epi16(pixels), weights));
+      }
+      __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                  _mm256_extracti128_si256(acc, 1));
+      sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(kRound)),
+                           kPrecision);
+      sum = _mm_packs_epi32(sum, sum);
+      line[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum)));
+    }
+  }
+}
+
+// Eight pixels per step, two source rows per madd; unpacking and packing
+// both work within 128-bit lanes, so the pixel order comes back intact
+__attribute__((target("avx2"))) void
+verticalAVX2(const uint32_t *tmp, int rowBegin, const Coefficients &c,
+             uint32_t *dst, int dstWidth, int dstHeight, int dstStride) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i round = _mm256_set1_epi32(kRound);
+  const int vectorWidth = dstWidth & ~7;
+  for (int y = 0; y < dstHeight; ++y) {
+    const int16_t *w = &c.weights[static_cast<size_t>(y) * c.taps];
+    const uint32_t *base =
+        tmp + static_cast<ptrdiff_t>(c.first[y] - rowBegin) * dstWidth;
+    uint32_t *line = dst + static_cast<ptrdiff_t>(y) * dstStride;
+    for (int x = 0; x < vectorWidth; x += 8) {
+      __m256i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+      for (int k = 0; k < c.taps; k += 2) {
+        const uint32_t *row0 = base + static_cast<ptrdiff_t>(k) * dstWidth + x;
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row0));
+        __m256i b = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(row0 + dstWidth));
+        __m256i weights = _mm256_set1_epi32(
+            static_cast<int>((uint32_t(uint16_t(w[k + 1])) << 16) |
+                             uint16_t(w[k])));
+        __m256i lo = _mm256_unpacklo_epi8(a, b);
+        __m256i hi = _mm256_unpackhi_epi8(a, b);
+        acc0 = _mm256_add_epi32(
+            acc0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), weights));
+        acc1 = _mm256_add_epi32(
+            acc1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), weights));
+        acc2 = _mm256_add_epi32(
+            acc2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), weights));
+        acc3 = _mm256_add_epi32(
+            acc3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), weights));
+      }
+      __m256i packedLo = _mm256_packs_epi32(_mm256_srai_epi32(acc0, kPrecision),
+                                            _mm256_srai_epi32(acc1, kPrecision));
+      __m256i packedHi = _mm256_packs_epi32(_mm256_srai_epi32(acc2, kPrecision),
+                                            _mm256_srai_epi32(acc3, kPrecision));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(line + x),
+                          _mm256_packus_epi16(packedLo, packedHi));
+    }
+  }
+  if (vectorWidth < dstWidth)
+    verticalScalar(tmp, rowBegin, c, dst, dstWidth, dstHeight, dstStride,
+                   vectorWidth);
+}
+
+#endif // OSF_SCALER_X86
+
+// -----------------------------------------------------------------------------
+// NEON kernels
+// -----------------------------------------------------------------------------
+
+#if defined(OSF_SCALER_NEON)
+
+void swizzleNEON(const uint8_t *src, uint32_t *dst, size_t count) {
+  size_t i = 0;
+  uint8_t *out = reinterpret_cast<uint8_t *>(dst);
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t v = vld4q_u8(src + i * 4);
+    uint8x16_t r = v.val[0];
+    v.val[0] = v.val[2];
+    v.val[2] = r;
+    vst4q_u8(out + i * 4, v);
+  }
+  swizzleScalar(src + i * 4, dst + i, count - i);
+}
+
+inline uint32_t narrowPixel(int32x4_t acc) {
+  int16x4_t narrow = vqmovn_s32(vshrq_n_s32(acc, kPrecision));
+  uint8x8_t bytes = vqmovun_s16(vcombine_s16(narrow, narrow));
+  return vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+}
+
+void horizontalNEON(const uint32_t *src, int srcStride, int rowBegin,
+                    int rowEnd, const Coefficients &c, uint32_t *out,
+                    int dstWidth) {
+  for (int row = rowBegin; row < rowEnd; ++row) {
+    const uint32_t *in = src + static_cast<ptrdiff_t>(row) * srcStride;
+    uint32_t *line = out + static_cast<ptrdiff_t>(row - rowBegin) * dstWidth;
+    for (int x = 0; x < dstWidth; ++x) {
+      const int16_t *w = &c.weights[static_cast<size_t>(x) * c.taps];
+      const uint8_t *p = reinterpret_cast<const uint8_t *>(in + c.first[x]);
+      int32x4_t acc = vdupq_n_s32(kRound);
+      for (int k = 0; k < c.taps; k += 2) {
+        int16x8_t pair = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p + k * 4)));
+        acc = vmlal_n_s16(acc, vget_low_s16(pair), w[k]);
+        acc = vmlal_n_s16(acc, vget_high_s16(pair), w[k + 1]);
+      }
+      line[x] = narrowPixel(acc);
+    }
+  }
+}
+
+void verticalNEON(const uint32_t *tmp, int rowBegin, const Coefficients &c,
+                  uint32_t *dst, int dstWidth, int dstHeight, int dstStride) {
+  const int vectorWidth = dstWidth & ~3;
+  for (int y = 0; y < dstHeight; ++y) {
+    const int16_t *w = &c.weights[static_cast<size_t>(y) * c.taps];
+    const uint32_t *base =
+        tmp + static_cast<ptrdiff_t>(c.first[y] - rowBegin) * dstWidth;
+    uint8_t *line = reinterpret_cast<uint8_t *>(
+        dst + static_cast<ptrdiff_t>(y) * dstStride);
+    for (int x = 0; x < vectorWidth; x += 4) {
+      int32x4_t acc0 = vdupq_n_s32(kRound), acc1 = acc0, acc2 = acc0,
+                acc3 = acc0;
+      for (int k = 0; k < c.taps; ++k) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(
+            base + static_cast<ptrdiff_t>(k) * dstWidth + x));
+        int16x8_t lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(v)));
+        int16x8_t hi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(v)));
+        acc0 = vmlal_n_s16(acc0, vget_low_s16(lo), w[k]);
+        acc1 = vmlal_n_s16(acc1, vget_high_s16(lo), w[k]);
+        acc2 = vmlal_n_s16(acc2, vget_low_s16(hi), w[k]);
+        acc3 = vmlal_n_s16(acc3, vget_high_s16(hi), w[k]);
+      }
+      int16x8_t lo = vcombine_s16(vqmovn_s32(vshrq_n_s32(acc0, kPrecision)),
+                                  vqmovn_s32(vshrq_n_s32(acc1, kPrecision)));
+      int16x8_t hi = vcombine_s16(vqmovn_s32(vshrq_n_s32(acc2, kPrecision)),
+                                  vqmovn_s32(vshrq_n_s32(acc3, kPrecision)));
+      vst1q_u8(line + x * 4, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+    }
+  }
+  if (vectorWidth < dstWidth)
+    verticalScalar(tmp, rowBegin, c, dst, dstWidth, dstHeight, dstStride,
+                   vectorWidth);
+}
+
+#endif // OSF_SCALER_NEON
+
+} // namespace
+
+// =============================================================================
+// OSFImageScaler
+// =============================================================================
+
+OSFImageScaler::Path OSFImageScaler::path() {
+  if (gForceScalar.load(std::memory_order_relaxed))
+    return Path::Scalar;
+#if defined(OSF_SCALER_X86)
+  return cpuHasAVX2() ? Path::AVX2 : Path::Scalar;
+#elif defined(OSF_SCALER_NEON)
+  return Path::NEON;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char *OSFImageScaler::pathName(Path path) {
+  switch (path) {
+  case Path::AVX2:
+    return "AVX2";
+  case Path::NEON:
+    return "NEON";
+  case Path::Scalar:
+    break;
+  }
+  return "scalar";
+}
+
+void OSFImageScaler::setForceScalar(bool forceScalar) {
+  gForceScalar.store(forceScalar, std::memory_order_relaxed);
+}
+
+void OSFImageScaler::swizzleRGBA(const uint8_t *src, uint32_t *dst,
+                                 size_t count) {
+  switch (path()) {
+#if defined(OSF_SCALER_X86)
+  case Path::AVX2:
+    swizzleAVX2(src, dst, count);
+    return;
+#endif
+#if defined(OSF_SCALER_NEON)
+  case Path::NEON:
+    swizzleNEON(src, dst, count);
+    return;
+#endif
+  default:
+    swizzleScalar(src, dst, count);
+  }
+}
+
+void OSFImageScaler::resample(const uint32_t *src, int srcWidth, int srcHeight,
+                              int srcStride, float cropX, float cropY,
+                              float cropWidth, float cropHeight, uint32_t *dst,
+                              int dstWidth, int dstHeight, int dstStride) {
+  if (!src || !dst || srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 ||
+      dstHeight <= 0 || cropWidth <= 0.0f || cropHeight <= 0.0f)
+    return;
+
+  const Path simd = path();
+  // AVX2 reads four horizontal taps and two vertical rows per step
+  const int hAlign = simd == Path::Scalar ? 1 : (simd == Path::NEON ? 2 : 4);
+  const int vAlign = simd == Path::AVX2 ? 2 : 1;
+  Coefficients horizontal =
+      computeCoefficients(srcWidth, cropX, cropWidth, dstWidth, hAlign);
+  Coefficients vertical =
+      computeCoefficients(srcHeight, cropY, cropHeight, dstHeight, vAlign);
+
+  // Only the rows the vertical filter reads go through the first pass
+  const int rowBegin = vertical.first.front();
+  const int rowEnd = vertical.first.back() + vertical.taps;
+  std::vector<uint32_t> tmp(static_cast<size_t>(dstWidth) *
+                            (rowEnd - rowBegin));
+
+  // Tiny sources can leave fewer taps than a SIMD step
+  const bool hSimd = horizontal.taps % hAlign == 0;
+  const bool vSimd = vertical.taps % vAlign == 0;
+
+  switch (simd) {
+#if defined(OSF_SCALER_X86)
+  case Path::AVX2:
+    if (hSimd)
+      horizontalAVX2(src, srcStride, rowBegin, rowEnd, horizontal, tmp.data(),
+                     dstWidth);
+    else
+      horizontalScalar(src, srcStride, rowBegin, rowEnd, horizontal,
+                       tmp.data(), dstWidth);
+    if (vSimd)
+      verticalAVX2(tmp.data(), rowBegin, vertical, dst, dstWidth, dstHeight,
+                   dstStride);
+    else
+      verticalScalar(tmp.data(), rowBegin, vertical, dst, dstWidth, dstHeight,
+                     dstStride);
+    return;
+#endif
+#if defined(OSF_SCALER_NEON)
+  case Path::NEON:
+    if (hSimd)
+      horizontalNEON(src, srcStride, rowBegin, rowEnd, horizontal, tmp.data(),
+                     dstWidth);
+    else
+      horizontalScalar(src, srcStride, rowBegin, rowEnd, horizontal,
+                       tmp.data(), dstWidth);
+    verticalNEON(tmp.data(), rowBegin, vertical, dst, dstWidth, dstHeight,
+                 dstStride);
+    return;
+#endif
+  default:
+    (void)hSimd;
+    (void)vSimd;
+    horizontalScalar(src, srcStride, rowBegin, rowEnd, horizontal, tmp.data(),
+                     dstWidth);
+    verticalScalar(tmp.data(), rowBegin, vertical, dst, dstWidth, dstHeight,
+                   dstStride);
+  }
+}
+
+} // namespace opensef
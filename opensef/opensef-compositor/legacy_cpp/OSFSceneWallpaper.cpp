@@ -1,24 +1,88 @@
 /**
  * OSFSceneWallpaper.cpp - Scene-based Wallpaper Implementation
  *
- * Now with actual image loading using stb_image!
+ * Shows OSFWallpaper's scaled images through a wlr_buffer that wraps the
+ * shared pixels, so nothing is copied on the compositor thread.
  */
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
 #include "OSFAresTheme.h"
 #include "OSFCompositor.h"
 #include "OSFDesktopLayers.h"
 #include "OSFSceneWallpaper.h"
 
-
 #include <cstring>
 #include <iostream>
-#include <vector>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Try to include drm_fourcc.h, fallback if missing
+#if __has_include(<drm_fourcc.h>)
+#include <drm_fourcc.h>
+#elif __has_include(<libdrm/drm_fourcc.h>)
+#include <libdrm/drm_fourcc.h>
+#else
+// Fallback definition for ARGB8888 (Little Endian -> B G R A in memory)
+#ifndef DRM_FORMAT_ARGB8888
+#define DRM_FORMAT_ARGB8888 0x34325241
+#endif
+#endif
 
 namespace opensef {
 
+namespace {
+
+// ----------------------------------------------------------------------------
+// OSFImageBuffer: read-only wlr_buffer over an OSFWallpaperImage
+// ----------------------------------------------------------------------------
+
+struct OSFImageBuffer {
+  struct wlr_buffer base;
+  std::shared_ptr<const OSFWallpaperImage> image;
+};
+
+static void image_buffer_destroy(struct wlr_buffer *wlr_buf) {
+  delete (OSFImageBuffer *)wlr_buf;
+}
+
+static bool image_buffer_begin_data_ptr_access(struct wlr_buffer *wlr_buf,
+                                               uint32_t flags, void **data,
+                                               uint32_t *format,
+                                               size_t *stride) {
+  if (flags & WLR_BUFFER_DATA_PTR_ACCESS_WRITE) {
+    return false; // Shared between outputs; never written
+  }
+  OSFImageBuffer *buffer = (OSFImageBuffer *)wlr_buf;
+  if (data) *data = (void *)buffer->image->pixels.data();
+  if (format) *format = DRM_FORMAT_ARGB8888;
+  if (stride) *stride = buffer->image->width * 4;
+  return true;
+}
+
+static void image_buffer_end_data_ptr_access(struct wlr_buffer *wlr_buf) {
+  (void)wlr_buf;
+  // No-op
+}
+
+static const struct wlr_buffer_impl image_buffer_impl = {
+    .destroy = image_buffer_destroy,
+    .get_dmabuf = nullptr,
+    .get_shm = nullptr,
+    .begin_data_ptr_access = image_buffer_begin_data_ptr_access,
+    .end_data_ptr_access = image_buffer_end_data_ptr_access,
+};
+
+static struct wlr_buffer *
+create_image_buffer(std::shared_ptr<const OSFWallpaperImage> image) {
+  OSFImageBuffer *buffer = new OSFImageBuffer();
+  wlr_buffer_init(&buffer->base, &image_buffer_impl, image->width,
+                  image->height);
+  buffer->image = std::move(image);
+  return &buffer->base;
+}
+
+} // namespace
+
 // Default wallpaper path
 static const char *kDefaultWallpaperPaths[] = {
     "../resources/wallpapers/mars_default.jpg",
@@ -28,14 +92,47 @@ static const char *kDefaultWallpaperPaths[] = {
 
 OSFSceneWallpaper::OSFSceneWallpaper(OSFCompositor *compositor,
                                      OSFDesktopLayers *layers)
-    : compositor_(compositor), layers_(layers) {}
+    : compositor_(compositor), layers_(layers),
+      wallpaper_(std::make_unique<OSFWallpaper>(compositor)) {
+  // Images finish on a worker; bounce back to the event loop to show them
+  readyFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (readyFd_ >= 0) {
+    readySource_ = wl_event_loop_add_fd(
+        wl_display_get_event_loop(compositor_->display()), readyFd_,
+        WL_EVENT_READABLE, handleImageReady, this);
+  }
+  int fd = readyFd_;
+  wallpaper_->setReadyHandler([fd] {
+    uint64_t one = 1;
+    if (fd >= 0 && write(fd, &one, sizeof(one)) < 0) {
+      // Counter saturated; a wakeup is already pending
+    }
+  });
+}
 
 OSFSceneWallpaper::~OSFSceneWallpaper() {
-  // Scene nodes are owned by the scene tree, will be cleaned up automatically
-  if (imageBuffer_) {
-    wlr_buffer_drop(imageBuffer_);
-    imageBuffer_ = nullptr;
+  // Stop the worker before the fd it signals goes away
+  wallpaper_.reset();
+  if (readySource_) {
+    wl_event_source_remove(readySource_);
+    readySource_ = nullptr;
   }
+  if (readyFd_ >= 0) {
+    close(readyFd_);
+    readyFd_ = -1;
+  }
+  // Scene nodes are owned by the scene tree, will be cleaned up
+  // automatically; they hold the last references to our buffers
+}
+
+int OSFSceneWallpaper::handleImageReady(int fd, uint32_t mask, void *data) {
+  (void)mask;
+  uint64_t count;
+  if (read(fd, &count, sizeof(count)) < 0) {
+    // Spurious wakeup
+  }
+  static_cast<OSFSceneWallpaper *>(data)->applyImageToScene();
+  return 0;
 }
 
 void OSFSceneWallpaper::setColor(uint32_t color) {
@@ -83,56 +180,13 @@ bool OSFSceneWallpaper::loadImage(const std::string &path) {
     return false;
   }
 
-  // Load image with stb_image
-  int imgWidth, imgHeight, channels;
-  stbi_uc *pixels = stbi_load(actualPath.c_str(), &imgWidth, &imgHeight,
-                              &channels, 4); // Force RGBA
-
-  if (!pixels) {
-    std::cerr << "[openSEF] Failed to load wallpaper: " << actualPath
-              << std::endl;
-    std::cerr << "[openSEF] Reason: " << stbi_failure_reason() << std::endl;
+  // Only the header is read here; decoding happens on a worker
+  if (!wallpaper_->load(actualPath)) {
     setColor(0x8B4513); // Fallback
     return false;
   }
 
-  std::cout << "[openSEF] Loaded wallpaper: " << actualPath << " (" << imgWidth
-            << "x" << imgHeight << ")" << std::endl;
-
-  // Store image dimensions
-  imageWidth_ = imgWidth;
-  imageHeight_ = imgHeight;
-
-  // Convert RGBA to ARGB (Wayland format is ARGB)
-  for (int i = 0; i < imgWidth * imgHeight; i++) {
-    uint8_t r = pixels[i * 4 + 0];
-    uint8_t g = pixels[i * 4 + 1];
-    uint8_t b = pixels[i * 4 + 2];
-    uint8_t a = pixels[i * 4 + 3];
-
-    // Reorder to ARGB (or BGRA for little-endian)
-    pixels[i * 4 + 0] = b;
-    pixels[i * 4 + 1] = g;
-    pixels[i * 4 + 2] = r;
-    pixels[i * 4 + 3] = a;
-  }
-
-  // Create wlr_buffer from pixels
-  // Note: This requires proper buffer implementation with wlr_buffer_impl
-  // For now, we'll use wlr_scene_buffer_create with a data buffer
-
-  // Create scene buffer node
-  if (imageNode_) {
-    wlr_scene_node_destroy(&imageNode_->node);
-    imageNode_ = nullptr;
-  }
-
-  // Store pixels for later use (scene buffer creation happens in resize)
-  imagePixels_.assign(pixels, pixels + (imgWidth * imgHeight * 4));
-
-  stbi_image_free(pixels);
-
-  // Apply to current screen size if already set
+  // Request the image for the current screen size if already set
   if (width_ > 0 && height_ > 0) {
     applyImageToScene();
   }
@@ -141,37 +195,42 @@ bool OSFSceneWallpaper::loadImage(const std::string &path) {
 }
 
 void OSFSceneWallpaper::applyImageToScene() {
-  if (imagePixels_.empty() || width_ <= 0 || height_ <= 0) {
+  if (width_ <= 0 || height_ <= 0) {
+    return;
+  }
+
+  // Kicks off scaling if this size isn't ready yet
+  std::shared_ptr<const OSFWallpaperImage> image =
+      wallpaper_->image(width_, height_);
+  if (!image || image == image_) {
     return;
   }
+  image_ = image;
 
-  // For wlroots scene API, we need to create a proper buffer
-  // This is a simplified version - real implementation needs wlr_buffer_impl
+  struct wlr_buffer *buffer = create_image_buffer(image);
+  if (imageNode_) {
+    wlr_scene_buffer_set_buffer(imageNode_, buffer);
+  } else {
+    imageNode_ = wlr_scene_buffer_create(
+        layers_->layer(DesktopLayer::Background), buffer);
+  }
+  // The scene node holds its own lock on the buffer
+  wlr_buffer_drop(buffer);
 
-  // For now, hide the color rect and show a message
-  // The proper implementation requires creating a wlr_buffer with the image
-  // data
+  if (imageNode_) {
+    wlr_scene_node_set_position(&imageNode_->node, 0, 0);
+    // Stale images from a previous size are stretched until replaced
+    wlr_scene_buffer_set_dest_size(imageNode_, width_, height_);
+  }
 
-  // Hide color fallback if image loaded
+  // Hide color fallback once an image is shown
   if (colorRect_) {
     wlr_scene_node_set_enabled(&colorRect_->node, false);
   }
 
-  // Create a simple indicator that image loaded
-  // Real implementation: wlr_scene_buffer_create() with proper buffer
-  std::cout << "[openSEF] Wallpaper image ready (" << imageWidth_ << "x"
-            << imageHeight_ << " -> " << width_ << "x" << height_ << ")"
+  std::cout << "[openSEF] Wallpaper image shown (" << image->width << "x"
+            << image->height << " on " << width_ << "x" << height_ << ")"
             << std::endl;
-
-  // For actual rendering with wlroots, you would need:
-  // 1. Create a wlr_buffer_impl for raw pixel data
-  // 2. Create wlr_buffer with those pixels
-  // 3. Create wlr_scene_buffer from the wlr_buffer
-  // This requires deeper wlroots integration
-
-  // Temporary: just show the color that matches the wallpaper tone
-  // until proper buffer implementation
-  setColor(0xB5651D); // Desert sand color matching Mars wallpaper
 }
 
 void OSFSceneWallpaper::resize(int width, int height) {
@@ -182,14 +241,16 @@ void OSFSceneWallpaper::resize(int width, int height) {
   width_ = width;
   height_ = height;
 
-  if (!imagePixels_.empty()) {
-    applyImageToScene();
-  } else if (colorRect_) {
+  if (colorRect_) {
     wlr_scene_rect_set_size(colorRect_, width, height);
   } else {
     // Create rect with current color
     setColor(color_);
   }
+
+  if (wallpaper_->isLoaded()) {
+    applyImageToScene();
+  }
 }
 
 void OSFSceneWallpaper::loadDefault() {
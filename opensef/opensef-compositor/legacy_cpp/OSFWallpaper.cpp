@@ -3,12 +3,21 @@
  */
 
 #include "OSFWallpaper.h"
-#include "OSFCompositor.h"
+#include "OSFImageScaler.h"
 
+#include <opensef/OSFTaskScheduler.h>
+
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <csetjmp>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 
+#ifdef OSF_HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
 
 // Define STB_IMAGE_IMPLEMENTATION in exactly one source file
 #define STB_IMAGE_IMPLEMENTATION
@@ -16,223 +25,415 @@
 
 namespace opensef {
 
-OSFWallpaper::OSFWallpaper(OSFCompositor *compositor)
-    : compositor_(compositor) {}
+namespace {
 
-OSFWallpaper::~OSFWallpaper() { freePixels(); }
+constexpr uint32_t kBackgroundColor = 0xFF1A1A2E; // Space Charcoal
 
-bool OSFWallpaper::load(const std::string &path) {
-  freePixels();
+struct DecodedImage {
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels; // ARGB8888
+};
 
-  // Load image using stb_image
-  int channels;
-  stbi_uc *data = stbi_load(path.c_str(), &width_, &height_, &channels, 4);
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
 
-  if (!data) {
-    std::cerr << "[openSEF] Failed to load wallpaper: " << path << std::endl;
-    std::cerr << "[openSEF] Reason: " << stbi_failure_reason() << std::endl;
+// Largest power-of-two decode reduction (up to 1/8) that still leaves at
+// least one source pixel per output pixel in the visible area
+int maxReduction(int srcW, int srcH, int outW, int outH,
+                 WallpaperScaleMode mode) {
+  double limit;
+  switch (mode) {
+  case WallpaperScaleMode::Fill:
+  case WallpaperScaleMode::Stretch:
+    limit = std::min(static_cast<double>(srcW) / outW,
+                     static_cast<double>(srcH) / outH);
+    break;
+  case WallpaperScaleMode::Fit:
+    limit = std::max(static_cast<double>(srcW) / outW,
+                     static_cast<double>(srcH) / outH);
+    break;
+  default:
+    return 1; // Center and Tile show source pixels 1:1
+  }
+  int reduction = 1;
+  while (reduction < 8 && reduction * 2 <= limit)
+    reduction *= 2;
+  return reduction;
+}
+
+#ifdef OSF_HAVE_LIBJPEG
+
+struct JpegError {
+  jpeg_error_mgr manager;
+  jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr info) {
+  longjmp(reinterpret_cast<JpegError *>(info->err)->jump, 1);
+}
+
+// Decodes straight into ARGB8888 rows, letting the IDCT do the reduction
+bool decodeJpeg(const std::string &path, int reduction, DecodedImage &out) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+
+  jpeg_decompress_struct info;
+  JpegError error;
+  info.err = jpeg_std_error(&error.manager);
+  error.manager.error_exit = jpegErrorExit;
+  if (setjmp(error.jump)) {
+    jpeg_destroy_decompress(&info);
+    fclose(file);
     return false;
   }
 
-  // Convert RGBA to ARGB (stb gives us RGBA, we need ARGB for compositor)
-  pixels_ = new uint32_t[width_ * height_];
-  for (int i = 0; i < width_ * height_; i++) {
-    uint8_t r = data[i * 4 + 0];
-    uint8_t g = data[i * 4 + 1];
-    uint8_t b = data[i * 4 + 2];
-    uint8_t a = data[i * 4 + 3];
-    pixels_[i] = (a << 24) | (r << 16) | (g << 8) | b;
+  jpeg_create_decompress(&info);
+  jpeg_stdio_src(&info, file);
+  jpeg_read_header(&info, TRUE);
+  info.scale_num = 1;
+  info.scale_denom = reduction;
+#ifdef JCS_EXTENSIONS
+  info.out_color_space = JCS_EXT_BGRA; // 0xAARRGGBB words, alpha 0xFF
+#else
+  info.out_color_space = JCS_RGB;
+#endif
+  jpeg_start_decompress(&info);
+
+  out.width = static_cast<int>(info.output_width);
+  out.height = static_cast<int>(info.output_height);
+  out.pixels.resize(static_cast<size_t>(out.width) * out.height);
+  while (info.output_scanline < info.output_height) {
+    uint32_t *line =
+        out.pixels.data() + static_cast<size_t>(info.output_scanline) *
+                                out.width;
+#ifdef JCS_EXTENSIONS
+    JSAMPROW row = reinterpret_cast<JSAMPROW>(line);
+    jpeg_read_scanlines(&info, &row, 1);
+#else
+    // RGB goes in the last three quarters of the row and is widened in
+    // place; each pixel is read before its slot is overwritten
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(line);
+    JSAMPROW row = bytes + out.width;
+    jpeg_read_scanlines(&info, &row, 1);
+    for (int x = 0; x < out.width; ++x) {
+      const uint8_t *rgb = row + x * 3;
+      line[x] = 0xFF000000u | (uint32_t(rgb[0]) << 16) |
+                (uint32_t(rgb[1]) << 8) | rgb[2];
+    }
+#endif
   }
 
-  stbi_image_free(data);
+  jpeg_finish_decompress(&info);
+  jpeg_destroy_decompress(&info);
+  fclose(file);
+  return true;
+}
 
-  std::cout << "[openSEF] Loaded wallpaper: " << path << " (" << width_ << "x"
-            << height_ << ")" << std::endl;
+bool isJpeg(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+  unsigned char magic[2] = {0, 0};
+  size_t read = fread(magic, 1, 2, file);
+  fclose(file);
+  return read == 2 && magic[0] == 0xFF && magic[1] == 0xD8;
+}
 
+#endif // OSF_HAVE_LIBJPEG
+
+bool decodeWallpaper(const std::string &path, int reduction,
+                     DecodedImage &out) {
+#ifdef OSF_HAVE_LIBJPEG
+  if (isJpeg(path))
+    return decodeJpeg(path, reduction, out);
+#else
+  (void)reduction;
+#endif
+
+  int channels;
+  stbi_uc *data = stbi_load(path.c_str(), &out.width, &out.height, &channels,
+                            4); // Force RGBA
+  if (!data) {
+    std::cerr << "[openSEF] Reason: " << stbi_failure_reason() << std::endl;
+    return false;
+  }
+  out.pixels.resize(static_cast<size_t>(out.width) * out.height);
+  OSFImageScaler::swizzleRGBA(data, out.pixels.data(), out.pixels.size());
+  stbi_image_free(data);
   return true;
 }
 
-void OSFWallpaper::render(uint32_t *buffer, int screenW, int screenH) {
-  if (!pixels_) {
-    // No wallpaper loaded - fill with dark background
-    uint32_t bgColor = 0xFF1A1A2E; // Space Charcoal
-    for (int i = 0; i < screenW * screenH; i++) {
-      buffer[i] = bgColor;
-    }
-    return;
+void fill(OSFWallpaperImage &out, uint32_t color) {
+  std::fill(out.pixels.begin(), out.pixels.end(), color);
+}
+
+// Lay the decoded source out for one output size
+void compose(const DecodedImage &src, WallpaperScaleMode mode,
+             OSFWallpaperImage &out) {
+  const int w = out.width;
+  const int h = out.height;
+  out.pixels.resize(static_cast<size_t>(w) * h);
+
+  switch (mode) {
+  case WallpaperScaleMode::Fill: {
+    // Crop the source to the output's aspect ratio
+    const float scale = std::max(static_cast<float>(w) / src.width,
+                                 static_cast<float>(h) / src.height);
+    const float cropW = w / scale;
+    const float cropH = h / scale;
+    OSFImageScaler::resample(src.pixels.data(), src.width, src.height,
+                             src.width, (src.width - cropW) / 2,
+                             (src.height - cropH) / 2, cropW, cropH,
+                             out.pixels.data(), w, h, w);
+    break;
   }
 
-  // Check if we need to recreate scaled cache
-  if (scaleMode_ == WallpaperScaleMode::Fill ||
-      scaleMode_ == WallpaperScaleMode::Fit ||
-      scaleMode_ == WallpaperScaleMode::Stretch) {
-    if (scaledWidth_ != screenW || scaledHeight_ != screenH) {
-      createScaledCache(screenW, screenH);
-    }
+  case WallpaperScaleMode::Fit: {
+    // Letterbox
+    fill(out, kBackgroundColor);
+    const float scale = std::min(static_cast<float>(w) / src.width,
+                                 static_cast<float>(h) / src.height);
+    const int fitW = std::max(1, static_cast<int>(std::lround(src.width * scale)));
+    const int fitH =
+        std::max(1, static_cast<int>(std::lround(src.height * scale)));
+    uint32_t *origin = out.pixels.data() +
+                       static_cast<size_t>((h - fitH) / 2) * w + (w - fitW) / 2;
+    OSFImageScaler::resample(src.pixels.data(), src.width, src.height,
+                             src.width, 0.0f, 0.0f, src.width, src.height,
+                             origin, fitW, fitH, w);
+    break;
   }
 
-  switch (scaleMode_) {
-  case WallpaperScaleMode::Fill:
-  case WallpaperScaleMode::Fit:
   case WallpaperScaleMode::Stretch:
-    // Use scaled cache
-    if (scaledPixels_) {
-      std::memcpy(buffer, scaledPixels_, screenW * screenH * sizeof(uint32_t));
-    }
+    OSFImageScaler::resample(src.pixels.data(), src.width, src.height,
+                             src.width, 0.0f, 0.0f, src.width, src.height,
+                             out.pixels.data(), w, h, w);
     break;
 
   case WallpaperScaleMode::Center: {
-    // Center the wallpaper
-    int offsetX = (screenW - width_) / 2;
-    int offsetY = (screenH - height_) / 2;
-
-    // Fill background first
-    uint32_t bgColor = 0xFF1A1A2E;
-    for (int i = 0; i < screenW * screenH; i++) {
-      buffer[i] = bgColor;
-    }
-
-    // Copy image to center
-    for (int y = 0; y < height_ && y + offsetY < screenH; y++) {
-      if (y + offsetY < 0)
-        continue;
-      for (int x = 0; x < width_ && x + offsetX < screenW; x++) {
-        if (x + offsetX < 0)
-          continue;
-        buffer[(y + offsetY) * screenW + (x + offsetX)] =
-            pixels_[y * width_ + x];
-      }
+    fill(out, kBackgroundColor);
+    // Overlap of the centred source with the output, in both spaces
+    const int offsetX = (w - src.width) / 2;
+    const int offsetY = (h - src.height) / 2;
+    const int dstX = std::max(0, offsetX), srcX = std::max(0, -offsetX);
+    const int dstY = std::max(0, offsetY), srcY = std::max(0, -offsetY);
+    const int copyW = std::min(w - dstX, src.width - srcX);
+    const int copyH = std::min(h - dstY, src.height - srcY);
+    for (int y = 0; y < copyH; ++y) {
+      std::memcpy(&out.pixels[static_cast<size_t>(dstY + y) * w + dstX],
+                  &src.pixels[static_cast<size_t>(srcY + y) * src.width + srcX],
+                  copyW * sizeof(uint32_t));
     }
     break;
   }
 
   case WallpaperScaleMode::Tile:
-    // Tile the image
-    for (int y = 0; y < screenH; y++) {
-      for (int x = 0; x < screenW; x++) {
-        int srcX = x % width_;
-        int srcY = y % height_;
-        buffer[y * screenW + x] = pixels_[srcY * width_ + srcX];
+    for (int y = 0; y < h; ++y) {
+      const uint32_t *srcRow =
+          &src.pixels[static_cast<size_t>(y % src.height) * src.width];
+      uint32_t *dstRow = &out.pixels[static_cast<size_t>(y) * w];
+      for (int x = 0; x < w; x += src.width) {
+        std::memcpy(dstRow + x, srcRow,
+                    std::min(src.width, w - x) * sizeof(uint32_t));
       }
     }
     break;
   }
 }
 
-void OSFWallpaper::freePixels() {
-  if (pixels_) {
-    delete[] pixels_;
-    pixels_ = nullptr;
-  }
-  if (scaledPixels_) {
-    delete[] scaledPixels_;
-    scaledPixels_ = nullptr;
-  }
-  width_ = 0;
-  height_ = 0;
-  scaledWidth_ = 0;
-  scaledHeight_ = 0;
+} // namespace
+
+OSFWallpaper::OSFWallpaper(OSFCompositor *compositor)
+    : compositor_(compositor) {}
+
+OSFWallpaper::~OSFWallpaper() {
+  // The job references this object; let it finish its current step
+  std::unique_lock<std::mutex> lock(mutex_);
+  stopping_ = true;
+  pending_.clear();
+  idle_.wait(lock, [this] { return !working_; });
 }
 
-void OSFWallpaper::createScaledCache(int targetW, int targetH) {
-  if (scaledPixels_) {
-    delete[] scaledPixels_;
+bool OSFWallpaper::load(const std::string &path) {
+  int width, height, channels;
+  if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+    std::cerr << "[openSEF] Failed to load wallpaper: " << path << std::endl;
+    std::cerr << "[openSEF] Reason: " << stbi_failure_reason() << std::endl;
+    return false;
   }
 
-  scaledWidth_ = targetW;
-  scaledHeight_ = targetH;
-  scaledPixels_ = new uint32_t[targetW * targetH];
-
-  float scaleX, scaleY;
-  int offsetX = 0, offsetY = 0;
-
-  if (scaleMode_ == WallpaperScaleMode::Fill) {
-    // Scale to fill (crop if needed)
-    float aspectSrc = static_cast<float>(width_) / height_;
-    float aspectDst = static_cast<float>(targetW) / targetH;
-
-    if (aspectSrc > aspectDst) {
-      // Image is wider - scale by height, crop width
-      scaleY = static_cast<float>(height_) / targetH;
-      scaleX = scaleY;
-      offsetX = static_cast<int>((width_ - targetW * scaleX) / 2);
-    } else {
-      // Image is taller - scale by width, crop height
-      scaleX = static_cast<float>(width_) / targetW;
-      scaleY = scaleX;
-      offsetY = static_cast<int>((height_ - targetH * scaleY) / 2);
-    }
-  } else if (scaleMode_ == WallpaperScaleMode::Fit) {
-    // Scale to fit (letterbox if needed)
-    float aspectSrc = static_cast<float>(width_) / height_;
-    float aspectDst = static_cast<float>(targetW) / targetH;
-
-    // Fill with background first
-    uint32_t bgColor = 0xFF1A1A2E;
-    for (int i = 0; i < targetW * targetH; i++) {
-      scaledPixels_[i] = bgColor;
-    }
+  std::lock_guard<std::mutex> lock(mutex_);
+  path_ = path;
+  width_ = width;
+  height_ = height;
+  invalidateLocked();
 
-    if (aspectSrc > aspectDst) {
-      scaleX = static_cast<float>(width_) / targetW;
-      scaleY = scaleX;
-    } else {
-      scaleY = static_cast<float>(height_) / targetH;
-      scaleX = scaleY;
-    }
-  } else {
-    // Stretch
-    scaleX = static_cast<float>(width_) / targetW;
-    scaleY = static_cast<float>(height_) / targetH;
+  std::cout << "[openSEF] Loaded wallpaper: " << path << " (" << width << "x"
+            << height << ")" << std::endl;
+  return true;
+}
+
+std::shared_ptr<const OSFWallpaperImage> OSFWallpaper::image(int width,
+                                                             int height) {
+  if (width <= 0 || height <= 0)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (path_.empty())
+    return nullptr;
+
+  const Size size{width, height};
+  auto it = images_.find(size);
+  if (it != images_.end() && it->second.generation == generation_)
+    return it->second.image;
+
+  if (std::find(pending_.begin(), pending_.end(), size) == pending_.end()) {
+    pending_.push_back(size);
+    scheduleLocked();
   }
+  return it != images_.end() ? it->second.image : nullptr;
+}
+
+void OSFWallpaper::setReadyHandler(ReadyHandler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readyHandler_ = std::move(handler);
+}
+
+void OSFWallpaper::setScaleMode(WallpaperScaleMode mode) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (scaleMode_ == mode)
+    return;
+  scaleMode_ = mode;
+  invalidateLocked();
+}
+
+WallpaperScaleMode OSFWallpaper::scaleMode() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return scaleMode_;
+}
 
-  // Perform scaling with bilinear interpolation
-  for (int y = 0; y < targetH; y++) {
-    for (int x = 0; x < targetW; x++) {
-      float srcX = x * scaleX + offsetX;
-      float srcY = y * scaleY + offsetY;
+bool OSFWallpaper::isLoaded() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !path_.empty();
+}
 
-      if (srcX >= 0 && srcX < width_ - 1 && srcY >= 0 && srcY < height_ - 1) {
-        scaledPixels_[y * targetW + x] = sampleBilinear(srcX, srcY);
+int OSFWallpaper::width() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return width_;
+}
+
+int OSFWallpaper::height() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return height_;
+}
+
+void OSFWallpaper::waitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return !working_; });
+}
+
+OSFWallpaper::Stats OSFWallpaper::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void OSFWallpaper::invalidateLocked() {
+  // Sizes already shown are rebuilt right away; their old images stay
+  // visible until then
+  ++generation_;
+  pending_.clear();
+  for (const auto &entry : images_)
+    pending_.push_back(entry.first);
+  if (!pending_.empty())
+    scheduleLocked();
+}
+
+void OSFWallpaper::scheduleLocked() {
+  if (working_ || stopping_)
+    return;
+  working_ = true;
+  OSFTaskScheduler::shared().submit([this] { runJobs(); });
+}
+
+void OSFWallpaper::runJobs() {
+  for (;;) {
+    std::vector<Size> sizes;
+    std::string path;
+    WallpaperScaleMode mode;
+    uint64_t generation;
+    int srcW, srcH;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_ || pending_.empty()) {
+        working_ = false;
+        idle_.notify_all();
+        return;
       }
+      sizes.swap(pending_);
+      path = path_;
+      mode = scaleMode_;
+      generation = generation_;
+      srcW = width_;
+      srcH = height_;
     }
-  }
-}
 
-uint32_t OSFWallpaper::sampleBilinear(float x, float y) {
-  int x0 = static_cast<int>(x);
-  int y0 = static_cast<int>(y);
-  int x1 = x0 + 1;
-  int y1 = y0 + 1;
-
-  float fx = x - x0;
-  float fy = y - y0;
-
-  // Clamp to image bounds
-  x1 = std::min(x1, width_ - 1);
-  y1 = std::min(y1, height_ - 1);
-
-  // Get four corner pixels
-  uint32_t p00 = pixels_[y0 * width_ + x0];
-  uint32_t p10 = pixels_[y0 * width_ + x1];
-  uint32_t p01 = pixels_[y1 * width_ + x0];
-  uint32_t p11 = pixels_[y1 * width_ + x1];
-
-  // Interpolate each channel
-  auto lerp = [](uint8_t a, uint8_t b, float t) -> uint8_t {
-    return static_cast<uint8_t>(a * (1 - t) + b * t);
-  };
-
-  auto lerpPixel = [&](uint32_t a, uint32_t b, float t) -> uint32_t {
-    uint8_t rA = lerp((a >> 16) & 0xFF, (b >> 16) & 0xFF, t);
-    uint8_t rG = lerp((a >> 8) & 0xFF, (b >> 8) & 0xFF, t);
-    uint8_t rB = lerp(a & 0xFF, b & 0xFF, t);
-    return 0xFF000000 | (rA << 16) | (rG << 8) | rB;
-  };
-
-  uint32_t top = lerpPixel(p00, p10, fx);
-  uint32_t bot = lerpPixel(p01, p11, fx);
-  return lerpPixel(top, bot, fy);
+    // One decode serves every size, at the reduction the largest allows
+    int reduction = 8;
+    for (const Size &size : sizes)
+      reduction = std::min(
+          reduction, maxReduction(srcW, srcH, size.first, size.second, mode));
+
+    auto start = std::chrono::steady_clock::now();
+    DecodedImage source;
+    if (!decodeWallpaper(path, reduction, source)) {
+      std::cerr << "[openSEF] Failed to decode wallpaper: " << path
+                << std::endl;
+      continue;
+    }
+    const double decodeMs = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::pair<Size, std::shared_ptr<OSFWallpaperImage>>> images;
+    for (const Size &size : sizes) {
+      auto image = std::make_shared<OSFWallpaperImage>();
+      image->width = size.first;
+      image->height = size.second;
+      compose(source, mode, *image);
+      images.emplace_back(size, std::move(image));
+    }
+    const double scaleMs = millisecondsSince(start);
+
+    ReadyHandler handler;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.decodes++;
+      stats_.lastDecodeWidth = source.width;
+      stats_.lastDecodeHeight = source.height;
+      stats_.lastDecodeMs = decodeMs;
+      stats_.lastScaleMs = scaleMs;
+      // Results for a superseded file or mode are dropped; the sizes were
+      // queued again by invalidateLocked()
+      if (generation != generation_)
+        continue;
+      for (auto &result : images)
+        images_[result.first] = {std::move(result.second), generation};
+      handler = readyHandler_;
+    }
+
+    std::cout << "[openSEF] Wallpaper scaled from " << source.width << "x"
+              << source.height << " (1/" << reduction << " decode, "
+              << decodeMs << " ms) to " << sizes.size() << " size(s) in "
+              << scaleMs << " ms using "
+              << OSFImageScaler::pathName(OSFImageScaler::path()) << std::endl;
+
+    if (handler)
+      handler();
+  } // The source is released here, before the next job
 }
 
 } // namespace opensef
@@ -0,0 +1,674 @@
+/**
+ * animation.c - Compositor-side Window Animations
+ *
+ * A view's animation interpolates the box it is shown in and its opacity.
+ * The box is applied by offsetting the view tree and scaling the
+ * destination size of its surface buffers; subsurface offsets are not
+ * scaled, which only shows mid-animation and in the overview. Whatever the
+ * layout sets meanwhile (a new tree position, a new size, a new rest
+ * scale) becomes the target of the running animation instead of being
+ * overwritten.
+ */
+
+#include "animation.h"
+#include "visibility.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/util/log.h>
+
+/* Size of a minimized window where it meets the dock */
+#define OSF_ANIM_DOCK_SIZE 96
+
+/* Overview backdrop opacity when fully shown */
+#define OSF_ANIM_OVERVIEW_DIM 0.45f
+
+struct osf_ghost_buffer {
+  struct wlr_scene_buffer *buffer;
+  int x, y, width, height; /* Unscaled, relative to the ghost tree */
+};
+
+/* The last frame of an unmapped view, fading out on its own */
+struct osf_ghost {
+  struct wl_list link;
+  struct wlr_scene_tree *tree;
+  double start_ms;
+  float cx, cy; /* Scale origin in tree coordinates */
+  struct osf_ghost_buffer *buffers;
+  size_t count, capacity;
+};
+
+struct osf_animator {
+  struct osf_server *server;
+  bool enabled;
+  bool running; /* Frames are being scheduled */
+  struct wl_list ghosts; /* osf_ghost::link */
+
+  /* Overview backdrop, drives multitask->anim_progress */
+  bool overview_running;
+  double overview_start_ms;
+  float overview_from, overview_to;
+};
+
+/* ============================================================================
+ * Timing
+ * ============================================================================
+ */
+
+static double now_ms(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+static float progress(double start_ms, int duration_ms, double now) {
+  if (duration_ms <= 0) {
+    return 1.0f;
+  }
+  float t = (float)((now - start_ms) / duration_ms);
+  return t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+}
+
+static float ease_out(float t) {
+  return 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);
+}
+
+static float ease_in(float t) { return t * t * t; }
+
+static float ease_in_out(float t) {
+  return t < 0.5f ? 4.0f * t * t * t
+                  : 1.0f - (-2.0f * t + 2.0f) * (-2.0f * t + 2.0f) *
+                               (-2.0f * t + 2.0f) / 2.0f;
+}
+
+static float lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+static struct wlr_box lerp_box(struct wlr_box a, struct wlr_box b, float t) {
+  return (struct wlr_box){
+      (int)lroundf(lerp(a.x, b.x, t)),
+      (int)lroundf(lerp(a.y, b.y, t)),
+      (int)lroundf(lerp(a.width, b.width, t)),
+      (int)lroundf(lerp(a.height, b.height, t)),
+  };
+}
+
+static void schedule_frames(struct osf_server *server) {
+  server->animator->running = true;
+  struct osf_output *output;
+  wl_list_for_each(output, &server->outputs, link) {
+    wlr_output_schedule_frame(output->wlr_output);
+  }
+}
+
+/* ============================================================================
+ * Applying a shown box to a view
+ * ============================================================================
+ */
+
+static struct wlr_box view_geometry(struct osf_view *view) {
+  struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+  if (geo.width <= 0 || geo.height <= 0) {
+    struct wlr_surface *surface = view->xdg_toplevel->base->surface;
+    geo = (struct wlr_box){0, 0, surface->current.width,
+                           surface->current.height};
+  }
+  return geo;
+}
+
+static float rest_scale(struct osf_view *view) {
+  return view->anim.scale > 0.0f ? view->anim.scale : 1.0f;
+}
+
+/* Where the view shows at rest with its tree at (x, y), scaled about the
+ * content origin */
+static struct wlr_box box_at(struct osf_view *view, int x, int y) {
+  struct wlr_box geo = view_geometry(view);
+  float scale = rest_scale(view);
+  return (struct wlr_box){
+      x + view->content_tree->node.x + (int)lroundf(geo.x * scale),
+      y + view->content_tree->node.y + (int)lroundf(geo.y * scale),
+      (int)lroundf(geo.width * scale), (int)lroundf(geo.height * scale)};
+}
+
+struct scale_iter {
+  float sx, sy, alpha;
+};
+
+static void scale_buffer_iterator(struct wlr_scene_buffer *buffer, int x,
+                                  int y, void *data) {
+  struct scale_iter *iter = data;
+  (void)x;
+  (void)y;
+
+  wlr_scene_buffer_set_opacity(buffer, iter->alpha);
+  /* Saved transaction buffers keep their size, only surfaces scale */
+  struct wlr_scene_surface *scene_surface =
+      wlr_scene_surface_try_from_buffer(buffer);
+  if (scene_surface) {
+    struct wlr_surface *surface = scene_surface->surface;
+    wlr_scene_buffer_set_dest_size(
+        buffer, (int)lroundf(surface->current.width * iter->sx),
+        (int)lroundf(surface->current.height * iter->sy));
+  }
+}
+
+static void apply_view(struct osf_view *view, struct wlr_box box,
+                       float alpha) {
+  struct wlr_box geo = view_geometry(view);
+  struct scale_iter iter = {
+      .sx = geo.width > 0 ? (float)box.width / geo.width : 1.0f,
+      .sy = geo.height > 0 ? (float)box.height / geo.height : 1.0f,
+      .alpha = alpha,
+  };
+
+  view->anim.applied_x =
+      box.x - view->content_tree->node.x - (int)lroundf(geo.x * iter.sx);
+  view->anim.applied_y =
+      box.y - view->content_tree->node.y - (int)lroundf(geo.y * iter.sy);
+  wlr_scene_node_set_position(&view->scene_tree->node, view->anim.applied_x,
+                              view->anim.applied_y);
+  wlr_scene_node_for_each_buffer(&view->scene_tree->node,
+                                 scale_buffer_iterator, &iter);
+  view->anim.box = box;
+  view->anim.alpha = alpha;
+}
+
+/* Someone else positioned the tree since the last tick: that is where the
+ * layout wants the view now */
+static void adopt_position(struct osf_view *view) {
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  if (node->x != view->anim.applied_x || node->y != view->anim.applied_y) {
+    view->anim.real_x = node->x;
+    view->anim.real_y = node->y;
+  }
+}
+
+static struct wlr_box box_union(struct wlr_box a, struct wlr_box b) {
+  if (wlr_box_empty(&a)) {
+    return b;
+  }
+  if (wlr_box_empty(&b)) {
+    return a;
+  }
+  int x1 = a.x < b.x ? a.x : b.x;
+  int y1 = a.y < b.y ? a.y : b.y;
+  int x2 = a.x + a.width > b.x + b.width ? a.x + a.width : b.x + b.width;
+  int y2 = a.y + a.height > b.y + b.height ? a.y + a.height : b.y + b.height;
+  return (struct wlr_box){x1, y1, x2 - x1, y2 - y1};
+}
+
+static void extents_buffer_iterator(struct wlr_scene_buffer *buffer, int x,
+                                    int y, void *data) {
+  struct wlr_box *extents = data;
+  int width = buffer->dst_width;
+  int height = buffer->dst_height;
+  if (width == 0 && buffer->buffer) {
+    width = buffer->buffer->width;
+    height = buffer->buffer->height;
+  }
+  *extents = box_union(*extents, (struct wlr_box){x, y, width, height});
+}
+
+/* Layout box of everything the view draws: buffers and border rects */
+static struct wlr_box view_extents(struct osf_view *view) {
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  struct wlr_box extents = {0};
+  int lx, ly;
+  if (!node->enabled || !wlr_scene_node_coords(node, &lx, &ly)) {
+    return extents;
+  }
+  wlr_scene_node_for_each_buffer(node, extents_buffer_iterator, &extents);
+  /* The iterator counts from the tree's parent */
+  extents.x += lx - node->x;
+  extents.y += ly - node->y;
+
+  struct wlr_scene_node *child;
+  wl_list_for_each(child, &view->scene_tree->children, link) {
+    if (child->enabled && child->type == WLR_SCENE_NODE_RECT) {
+      struct wlr_scene_rect *rect = wlr_scene_rect_from_node(child);
+      extents = box_union(extents, (struct wlr_box){lx + child->x,
+                                                    ly + child->y, rect->width,
+                                                    rect->height});
+    }
+  }
+  return extents;
+}
+
+static void end_view(struct osf_view *view) {
+  enum osf_anim_kind kind = view->anim.kind;
+  view->anim.kind = OSF_ANIM_NONE;
+  adopt_position(view);
+
+  apply_view(view, box_at(view, view->anim.real_x, view->anim.real_y),
+             1.0f);
+  if (kind == OSF_ANIM_MINIMIZE) {
+    wlr_scene_node_set_enabled(&view->scene_tree->node, false);
+  }
+  osf_visibility_mark_dirty(view->server);
+  osf_cursor_invalidate_hit(view->server);
+}
+
+static void start_view(struct osf_view *view, enum osf_anim_kind kind,
+                       struct wlr_box from, struct wlr_box to,
+                       float from_alpha, float to_alpha, int duration_ms) {
+  if (view->anim.kind == OSF_ANIM_NONE) {
+    view->anim.real_x = view->scene_tree->node.x;
+    view->anim.real_y = view->scene_tree->node.y;
+  } else {
+    adopt_position(view);
+  }
+  view->anim.kind = kind;
+  view->anim.start_ms = now_ms();
+  view->anim.duration_ms = duration_ms;
+  view->anim.from = from;
+  view->anim.to = to;
+  view->anim.from_alpha = from_alpha;
+  view->anim.to_alpha = to_alpha;
+  apply_view(view, from, from_alpha);
+  schedule_frames(view->server);
+}
+
+static void step_view(struct osf_view *view, double now) {
+  adopt_position(view);
+  float t = progress(view->anim.start_ms, view->anim.duration_ms, now);
+  if (t >= 1.0f) {
+    end_view(view);
+    return;
+  }
+
+  float e;
+  switch (view->anim.kind) {
+  case OSF_ANIM_MINIMIZE:
+  case OSF_ANIM_RESTORE:
+    e = ease_in_out(t);
+    break;
+  default:
+    e = ease_out(t);
+    break;
+  }
+  struct wlr_box to = view->anim.to.width > 0
+                          ? view->anim.to
+                          : box_at(view, view->anim.real_x, view->anim.real_y);
+  apply_view(view, lerp_box(view->anim.from, to, e),
+             lerp(view->anim.from_alpha, view->anim.to_alpha, e));
+}
+
+/* Only what can be seen is worth animating */
+static bool should_animate(struct osf_view *view) {
+  struct osf_server *server = view->server;
+  return server->animator && server->animator->enabled && view->mapped &&
+         view->workspace == server->active_workspace &&
+         !wl_list_empty(&server->outputs);
+}
+
+/* ============================================================================
+ * Ghosts
+ * ============================================================================
+ */
+
+static void copy_buffer_iterator(struct wlr_scene_buffer *buffer, int sx,
+                                 int sy, void *data) {
+  struct wlr_scene_tree *into = data;
+  if (!buffer->buffer) {
+    return;
+  }
+
+  struct wlr_scene_buffer *copy = wlr_scene_buffer_create(into, buffer->buffer);
+  if (!copy) {
+    return;
+  }
+  wlr_scene_buffer_set_dest_size(copy, buffer->dst_width, buffer->dst_height);
+  wlr_scene_buffer_set_source_box(copy, &buffer->src_box);
+  wlr_scene_buffer_set_transform(copy, buffer->transform);
+  wlr_scene_buffer_set_opaque_region(copy, &buffer->opaque_region);
+  wlr_scene_buffer_set_opacity(copy, buffer->opacity);
+  wlr_scene_node_set_position(&copy->node, sx, sy);
+}
+
+void osf_animation_copy_buffers(struct wlr_scene_node *node,
+                                struct wlr_scene_tree *into) {
+  wlr_scene_node_for_each_buffer(node, copy_buffer_iterator, into);
+}
+
+static void record_ghost_buffer(struct wlr_scene_buffer *buffer, int sx,
+                                int sy, void *data) {
+  struct osf_ghost *ghost = data;
+  if (ghost->count == ghost->capacity) {
+    size_t capacity = ghost->capacity ? ghost->capacity * 2 : 4;
+    struct osf_ghost_buffer *grown =
+        realloc(ghost->buffers, capacity * sizeof(*grown));
+    if (!grown) {
+      return;
+    }
+    ghost->buffers = grown;
+    ghost->capacity = capacity;
+  }
+  int width = buffer->dst_width > 0 ? buffer->dst_width : buffer->buffer->width;
+  int height =
+      buffer->dst_height > 0 ? buffer->dst_height : buffer->buffer->height;
+  /* The iterator adds the ghost tree's own position */
+  ghost->buffers[ghost->count++] = (struct osf_ghost_buffer){
+      buffer, sx - ghost->tree->node.x, sy - ghost->tree->node.y, width,
+      height};
+}
+
+static void ghost_destroy(struct osf_ghost *ghost) {
+  wl_list_remove(&ghost->link);
+  wlr_scene_node_destroy(&ghost->tree->node);
+  free(ghost->buffers);
+  free(ghost);
+}
+
+/* Returns false once the ghost is gone */
+static bool step_ghost(struct osf_ghost *ghost, double now) {
+  float t = progress(ghost->start_ms, OSF_ANIM_UNMAP_MS, now);
+  if (t >= 1.0f) {
+    ghost_destroy(ghost);
+    return false;
+  }
+
+  float e = ease_in(t);
+  float scale = lerp(1.0f, 0.9f, e);
+  for (size_t i = 0; i < ghost->count; i++) {
+    struct osf_ghost_buffer *b = &ghost->buffers[i];
+    wlr_scene_node_set_position(
+        &b->buffer->node, (int)lroundf(ghost->cx + (b->x - ghost->cx) * scale),
+        (int)lroundf(ghost->cy + (b->y - ghost->cy) * scale));
+    wlr_scene_buffer_set_dest_size(b->buffer, (int)lroundf(b->width * scale),
+                                   (int)lroundf(b->height * scale));
+    wlr_scene_buffer_set_opacity(b->buffer, 1.0f - e);
+  }
+  return true;
+}
+
+/* ============================================================================
+ * Overview backdrop
+ * ============================================================================
+ */
+
+static void step_overview(struct osf_server *server, double now) {
+  struct osf_animator *animator = server->animator;
+  struct osf_multitask *mt = server->multitask;
+  float t = progress(animator->overview_start_ms, OSF_ANIM_OVERVIEW_MS, now);
+  mt->anim_progress =
+      lerp(animator->overview_from, animator->overview_to, ease_out(t));
+
+  float color[4] = {0.0f, 0.0f, 0.0f, OSF_ANIM_OVERVIEW_DIM * mt->anim_progress};
+  wlr_scene_rect_set_color(mt->overlay, color);
+  if (t >= 1.0f) {
+    animator->overview_running = false;
+    wlr_scene_node_set_enabled(&mt->overlay->node, mt->anim_progress > 0.0f);
+  }
+}
+
+void osf_animation_overview(struct osf_server *server, bool active) {
+  struct osf_animator *animator = server->animator;
+  struct osf_multitask *mt = server->multitask;
+  if (!mt->overlay) {
+    return;
+  }
+
+  struct wlr_box extents;
+  wlr_output_layout_get_box(server->output_layout, NULL, &extents);
+  wlr_scene_node_set_position(&mt->overlay->node, extents.x, extents.y);
+  wlr_scene_rect_set_size(mt->overlay, extents.width, extents.height);
+  wlr_scene_node_set_enabled(&mt->overlay->node, true);
+
+  animator->overview_from = mt->anim_progress;
+  animator->overview_to = active ? 1.0f : 0.0f;
+  animator->overview_start_ms = now_ms();
+  animator->overview_running = true;
+  if (!animator->enabled) {
+    step_overview(server, animator->overview_start_ms + OSF_ANIM_OVERVIEW_MS);
+    return;
+  }
+  schedule_frames(server);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+void osf_animation_init(struct osf_server *server) {
+  struct osf_animator *animator = calloc(1, sizeof(*animator));
+  if (!animator) {
+    wlr_log(WLR_ERROR, "Failed to allocate animator");
+    return;
+  }
+  animator->server = server;
+  const char *env = getenv("VITUS_ANIMATIONS");
+  animator->enabled = !(env && strcmp(env, "0") == 0);
+  wl_list_init(&animator->ghosts);
+  server->animator = animator;
+
+  wlr_log(WLR_INFO, "Window animations %s",
+          animator->enabled ? "enabled" : "disabled");
+}
+
+void osf_animation_finish(struct osf_server *server) {
+  struct osf_animator *animator = server->animator;
+  if (!animator) {
+    return;
+  }
+  struct osf_ghost *ghost, *tmp;
+  wl_list_for_each_safe(ghost, tmp, &animator->ghosts, link) {
+    ghost_destroy(ghost);
+  }
+  free(animator);
+  server->animator = NULL;
+}
+
+void osf_animation_tick(struct osf_server *server, double now) {
+  struct osf_animator *animator = server->animator;
+  if (!animator || !animator->running) {
+    return;
+  }
+
+  bool running = false;
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    if (view->anim.kind != OSF_ANIM_NONE) {
+      struct wlr_box before = view_extents(view);
+      step_view(view, now);
+      if (view->anim.kind != OSF_ANIM_NONE) {
+        /* Only a step that sweeps over the cached hit drops it */
+        struct wlr_box swept = box_union(before, view_extents(view));
+        osf_cursor_scene_changed(server, &swept);
+        running = true;
+      }
+    }
+  }
+  if (running) {
+    /* What covers what changes with every step */
+    osf_visibility_mark_dirty(server);
+  }
+
+  struct osf_ghost *ghost, *tmp;
+  wl_list_for_each_safe(ghost, tmp, &animator->ghosts, link) {
+    running |= step_ghost(ghost, now);
+  }
+
+  if (animator->overview_running) {
+    step_overview(server, now);
+    running |= animator->overview_running;
+  }
+
+  animator->running = running;
+  if (running) {
+    schedule_frames(server);
+  }
+}
+
+struct wlr_box osf_animation_view_box(struct osf_view *view) {
+  if (view->anim.kind != OSF_ANIM_NONE) {
+    return view->anim.box;
+  }
+  return box_at(view, view->scene_tree->node.x, view->scene_tree->node.y);
+}
+
+void osf_animation_view_position(struct osf_view *view, int *x, int *y) {
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  if (view->anim.kind != OSF_ANIM_NONE && node->x == view->anim.applied_x &&
+      node->y == view->anim.applied_y) {
+    *x = view->anim.real_x;
+    *y = view->anim.real_y;
+    return;
+  }
+  *x = node->x;
+  *y = node->y;
+}
+
+void osf_animation_view_finish(struct osf_view *view) {
+  if (view->anim.kind != OSF_ANIM_NONE) {
+    end_view(view);
+  }
+}
+
+void osf_animation_view_map(struct osf_view *view) {
+  if (!should_animate(view)) {
+    return;
+  }
+  struct wlr_box to = box_at(view, view->scene_tree->node.x,
+                             view->scene_tree->node.y);
+  struct wlr_box from = {
+      to.x + to.width / 20,
+      to.y + to.height / 20,
+      to.width - to.width / 10,
+      to.height - to.height / 10,
+  };
+  start_view(view, OSF_ANIM_MAP, from, (struct wlr_box){0}, 0.0f, 1.0f,
+             OSF_ANIM_MAP_MS);
+}
+
+void osf_animation_view_unmap(struct osf_view *view) {
+  struct osf_server *server = view->server;
+  osf_animation_view_finish(view);
+  /* Mapped again, it starts out at its own size */
+  view->anim.scale = 1.0f;
+  if (!server->animator || !server->animator->enabled || view->minimized ||
+      view->workspace != server->active_workspace) {
+    return;
+  }
+
+  struct osf_ghost *ghost = calloc(1, sizeof(*ghost));
+  if (!ghost) {
+    return;
+  }
+  ghost->tree = wlr_scene_tree_create(view->workspace->tree);
+  if (!ghost->tree) {
+    free(ghost);
+    return;
+  }
+  wlr_scene_node_place_above(&ghost->tree->node, &view->scene_tree->node);
+  wlr_scene_node_set_position(&ghost->tree->node, view->scene_tree->node.x,
+                              view->scene_tree->node.y);
+  /* Per child, so the offsets stay relative to the view tree */
+  struct wlr_scene_node *child;
+  wl_list_for_each(child, &view->scene_tree->children, link) {
+    osf_animation_copy_buffers(child, ghost->tree);
+  }
+  wlr_scene_node_for_each_buffer(&ghost->tree->node, record_ghost_buffer,
+                                 ghost);
+
+  struct wlr_box geo = view_geometry(view);
+  ghost->cx = view->content_tree->node.x + geo.x + geo.width / 2.0f;
+  ghost->cy = view->content_tree->node.y + geo.y + geo.height / 2.0f;
+  ghost->start_ms = now_ms();
+  wl_list_insert(&server->animator->ghosts, &ghost->link);
+  schedule_frames(server);
+}
+
+/* The spot on the dock a minimized view shrinks into: bottom center of
+ * the output showing it */
+static struct wlr_box dock_box(struct osf_view *view, struct wlr_box shown) {
+  struct osf_server *server = view->server;
+  struct osf_output *output =
+      view->frame_output ? view->frame_output : osf_output_at_cursor(server);
+  struct wlr_box area = {0};
+  if (output) {
+    wlr_output_layout_get_box(server->output_layout, output->wlr_output,
+                              &area);
+  }
+  int width = OSF_ANIM_DOCK_SIZE;
+  int height = shown.width > 0 ? OSF_ANIM_DOCK_SIZE * shown.height / shown.width
+                               : OSF_ANIM_DOCK_SIZE;
+  return (struct wlr_box){area.x + (area.width - width) / 2,
+                          area.y + area.height - height, width, height};
+}
+
+void osf_animation_view_minimize(struct osf_view *view, bool minimized) {
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  if (!should_animate(view)) {
+    osf_animation_view_finish(view);
+    wlr_scene_node_set_enabled(node, !minimized);
+    return;
+  }
+
+  if (minimized) {
+    struct wlr_box from = osf_animation_view_box(view);
+    start_view(view, OSF_ANIM_MINIMIZE, from, dock_box(view, from),
+               view->anim.kind != OSF_ANIM_NONE ? view->anim.alpha : 1.0f,
+               0.0f, OSF_ANIM_MINIMIZE_MS);
+    return;
+  }
+
+  /* Still shrinking: turn around from where it is */
+  bool shrinking = view->anim.kind == OSF_ANIM_MINIMIZE;
+  int x, y;
+  osf_animation_view_position(view, &x, &y);
+  struct wlr_box to = box_at(view, x, y);
+  struct wlr_box from = shrinking ? view->anim.box : dock_box(view, to);
+  float alpha = shrinking ? view->anim.alpha : 0.0f;
+  wlr_scene_node_set_enabled(node, true);
+  start_view(view, OSF_ANIM_RESTORE, from, (struct wlr_box){0}, alpha, 1.0f,
+             OSF_ANIM_MINIMIZE_MS);
+}
+
+void osf_animation_view_moved(struct osf_view *view, struct wlr_box from) {
+  if (!should_animate(view) || view->minimized) {
+    return;
+  }
+  struct wlr_box to = box_at(view, view->scene_tree->node.x,
+                             view->scene_tree->node.y);
+  if (from.width <= 0 || from.height <= 0 ||
+      (from.x == to.x && from.y == to.y && from.width == to.width &&
+       from.height == to.height)) {
+    return;
+  }
+  float alpha = view->anim.kind != OSF_ANIM_NONE ? view->anim.alpha : 1.0f;
+  start_view(view, OSF_ANIM_GEOMETRY, from, (struct wlr_box){0}, alpha, 1.0f,
+             OSF_ANIM_GEOMETRY_MS);
+}
+
+void osf_animation_view_set_scale(struct osf_view *view, float scale) {
+  if (scale <= 0.0f || scale == rest_scale(view)) {
+    return;
+  }
+  struct wlr_box from = osf_animation_view_box(view);
+  view->anim.scale = scale;
+  if (view->anim.kind != OSF_ANIM_NONE) {
+    return; /* Its next step heads for the new box */
+  }
+
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  apply_view(view, box_at(view, node->x, node->y), 1.0f);
+  osf_visibility_mark_dirty(view->server);
+  osf_cursor_invalidate_hit(view->server);
+  osf_animation_view_moved(view, from);
+}
+
+void osf_animation_view_commit(struct osf_view *view) {
+  /* Committed buffers come back at the surface size; an animation step
+   * rescales them anyway */
+  if (view->anim.kind != OSF_ANIM_NONE || rest_scale(view) == 1.0f) {
+    return;
+  }
+  struct wlr_scene_node *node = &view->scene_tree->node;
+  apply_view(view, box_at(view, node->x, node->y), 1.0f);
+}
@@ -0,0 +1,755 @@
+/**
+ * capture.c - Screen Capture (screencopy / image-copy-capture)
+ *
+ * wlr-screencopy is implemented here rather than by wlroots, whose shm path
+ * reads the whole frame back for every copy. A frame waits for the next
+ * output commit and reads from the buffer that commit shows.
+ *
+ * Damage is kept twice per client: what it has not been told about yet
+ * (osf_capture_damage, reported by the next copy_with_damage), and what
+ * changed since each of its buffers was last filled (osf_capture_buffer).
+ * A copy_with_damage into a buffer the client used before only reads the
+ * latter; the rest of the buffer still holds the earlier copy. Plain copies
+ * always read the whole box.
+ *
+ * The other protocols come from wlroots; the compositor only creates their
+ * globals.
+ */
+
+#include "capture.h"
+#include "server.h"
+
+#include "wlr-screencopy-unstable-v1-protocol.h"
+
+#include <drm_fourcc.h>
+#include <stdlib.h>
+#include <time.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_export_dmabuf_v1.h>
+#include <wlr/types/wlr_xdg_output_v1.h>
+#include <wlr/util/box.h>
+#include <wlr/util/log.h>
+#include <wlr/version.h>
+
+/* ext-image-copy-capture arrived with wlroots 0.19 */
+#if WLR_VERSION_NUM >= ((0 << 16) | (19 << 8) | 0)
+#define OSF_HAVE_IMAGE_COPY_CAPTURE 1
+#include <wlr/types/wlr_ext_image_capture_source_v1.h>
+#include <wlr/types/wlr_ext_image_copy_capture_v1.h>
+#endif
+
+#define OSF_SCREENCOPY_VERSION 3
+#define OSF_CAPTURE_MAX_RECTS 32 /* More damage events: send their extents */
+
+struct osf_capture {
+  struct osf_server *server;
+  struct wl_global *screencopy;
+  struct wl_list clients; /* osf_capture_client::link */
+  struct wl_list outputs; /* osf_capture_output::link */
+  struct wl_listener new_output;
+
+  /* Pixels read back, against whole frames for the same copies */
+  uint64_t copied_pixels;
+  uint64_t frame_pixels;
+};
+
+struct osf_capture_output {
+  struct wl_list link;
+  struct osf_capture *capture;
+  struct wlr_output *output;
+  struct wl_list frames; /* osf_capture_frame::link, until finished */
+  struct wl_listener commit;
+  struct wl_listener destroy;
+};
+
+/* One bound manager. Frames stay valid after the manager is destroyed, so
+ * it is freed once neither is left. */
+struct osf_capture_client {
+  struct wl_list link;
+  struct osf_capture *capture;
+  struct wl_resource *resource; /* NULL once destroyed */
+  int frames;
+  struct wl_list damage;  /* osf_capture_damage::link */
+  struct wl_list buffers; /* osf_capture_buffer::link */
+};
+
+/* Damage on an output the client has not been told about */
+struct osf_capture_damage {
+  struct wl_list link;
+  struct wlr_output *output;
+  pixman_region32_t region;
+};
+
+/* A buffer the client copied into, and what changed on screen since */
+struct osf_capture_buffer {
+  struct wl_list link;
+  struct wl_resource *resource;
+  struct wlr_output *output;
+  struct wlr_box box;
+  pixman_region32_t stale;
+  struct wl_listener destroy;
+};
+
+struct osf_capture_frame {
+  struct wl_resource *resource;
+  struct osf_capture_client *client;
+  struct osf_capture_output *output; /* NULL: finished or failed */
+  struct wl_list link;               /* osf_capture_output::frames */
+  struct wlr_box box;                /* Output buffer coordinates */
+  int stride;
+  bool used;
+  bool with_damage;
+  struct wl_resource *buffer; /* Set by copy, until finished */
+  struct wl_listener buffer_destroy;
+};
+
+static const struct zwlr_screencopy_frame_v1_interface frame_impl;
+static const struct zwlr_screencopy_manager_v1_interface manager_impl;
+
+/* ============================================================================
+ * Clients
+ * ============================================================================
+ */
+
+static void region_subtract_box(pixman_region32_t *region,
+                                const struct wlr_box *box) {
+  pixman_region32_t rect;
+  pixman_region32_init_rect(&rect, box->x, box->y, box->width, box->height);
+  pixman_region32_subtract(region, region, &rect);
+  pixman_region32_fini(&rect);
+}
+
+static void buffer_forget(struct osf_capture_buffer *buffer) {
+  wl_list_remove(&buffer->link);
+  wl_list_remove(&buffer->destroy.link);
+  pixman_region32_fini(&buffer->stale);
+  free(buffer);
+}
+
+static void damage_forget(struct osf_capture_damage *damage) {
+  wl_list_remove(&damage->link);
+  pixman_region32_fini(&damage->region);
+  free(damage);
+}
+
+static void client_unref(struct osf_capture_client *client) {
+  if (client->resource || client->frames > 0) {
+    return;
+  }
+  struct osf_capture_damage *damage, *damage_tmp;
+  wl_list_for_each_safe(damage, damage_tmp, &client->damage, link) {
+    damage_forget(damage);
+  }
+  struct osf_capture_buffer *buffer, *buffer_tmp;
+  wl_list_for_each_safe(buffer, buffer_tmp, &client->buffers, link) {
+    buffer_forget(buffer);
+  }
+  wl_list_remove(&client->link);
+  free(client);
+}
+
+/* Damage the client was not told about; a new output starts fully damaged */
+static struct osf_capture_damage *
+client_damage(struct osf_capture_client *client, struct wlr_output *output) {
+  struct osf_capture_damage *damage;
+  wl_list_for_each(damage, &client->damage, link) {
+    if (damage->output == output) {
+      return damage;
+    }
+  }
+  damage = calloc(1, sizeof(*damage));
+  if (!damage) {
+    return NULL;
+  }
+  damage->output = output;
+  pixman_region32_init_rect(&damage->region, 0, 0, output->width,
+                            output->height);
+  wl_list_insert(&client->damage, &damage->link);
+  return damage;
+}
+
+static void handle_buffer_destroy(struct wl_listener *listener, void *data) {
+  struct osf_capture_buffer *buffer =
+      wl_container_of(listener, buffer, destroy);
+  (void)data;
+  buffer_forget(buffer);
+}
+
+/* The client's record of `resource`; a new or resized one is all stale */
+static struct osf_capture_buffer *
+client_buffer(struct osf_capture_client *client, struct wl_resource *resource,
+              struct wlr_output *output, const struct wlr_box *box) {
+  struct osf_capture_buffer *buffer;
+  wl_list_for_each(buffer, &client->buffers, link) {
+    if (buffer->resource == resource) {
+      if (buffer->output != output ||
+          !wlr_box_equal(&buffer->box, box)) {
+        buffer->output = output;
+        buffer->box = *box;
+        pixman_region32_union_rect(&buffer->stale, &buffer->stale, box->x,
+                                   box->y, box->width, box->height);
+      }
+      return buffer;
+    }
+  }
+  buffer = calloc(1, sizeof(*buffer));
+  if (!buffer) {
+    return NULL;
+  }
+  buffer->resource = resource;
+  buffer->output = output;
+  buffer->box = *box;
+  pixman_region32_init_rect(&buffer->stale, box->x, box->y, box->width,
+                            box->height);
+  buffer->destroy.notify = handle_buffer_destroy;
+  wl_resource_add_destroy_listener(resource, &buffer->destroy);
+  wl_list_insert(&client->buffers, &buffer->link);
+  return buffer;
+}
+
+/* ============================================================================
+ * Frames
+ * ============================================================================
+ */
+
+/* Stops waiting for a commit; the resource lives until the client drops it */
+static void frame_finish(struct osf_capture_frame *frame) {
+  if (frame->output) {
+    wl_list_remove(&frame->link);
+    frame->output = NULL;
+  }
+  if (frame->buffer) {
+    wl_list_remove(&frame->buffer_destroy.link);
+    frame->buffer = NULL;
+  }
+}
+
+static void frame_fail(struct osf_capture_frame *frame) {
+  frame_finish(frame);
+  zwlr_screencopy_frame_v1_send_failed(frame->resource);
+}
+
+static void handle_frame_buffer_destroy(struct wl_listener *listener,
+                                        void *data) {
+  struct osf_capture_frame *frame =
+      wl_container_of(listener, frame, buffer_destroy);
+  (void)data;
+  frame_fail(frame);
+}
+
+static void handle_frame_resource_destroy(struct wl_resource *resource) {
+  struct osf_capture_frame *frame = wl_resource_get_user_data(resource);
+  frame_finish(frame);
+  frame->client->frames--;
+  client_unref(frame->client);
+  free(frame);
+}
+
+static void send_damage(struct osf_capture_frame *frame,
+                        pixman_region32_t *damage) {
+  int count = 0;
+  const pixman_box32_t *rects = pixman_region32_rectangles(damage, &count);
+  if (count > OSF_CAPTURE_MAX_RECTS) {
+    rects = pixman_region32_extents(damage);
+    count = 1;
+  }
+  for (int i = 0; i < count; i++) {
+    zwlr_screencopy_frame_v1_send_damage(
+        frame->resource, rects[i].x1 - frame->box.x, rects[i].y1 - frame->box.y,
+        rects[i].x2 - rects[i].x1, rects[i].y2 - rects[i].y1);
+  }
+}
+
+/* Reads `region` (output buffer coordinates) of the committed buffer into
+ * the frame's shm buffer */
+static bool read_region(struct osf_capture_frame *frame,
+                        struct wlr_texture *texture,
+                        pixman_region32_t *region) {
+  struct wl_shm_buffer *shm = wl_shm_buffer_get(frame->buffer);
+  wl_shm_buffer_begin_access(shm);
+  void *data = wl_shm_buffer_get_data(shm);
+
+  bool ok = true;
+  int count = 0;
+  const pixman_box32_t *rects = pixman_region32_rectangles(region, &count);
+  for (int i = 0; i < count && ok; i++) {
+    ok = wlr_texture_read_pixels(
+        texture, &(struct wlr_texture_read_pixels_options){
+                     .data = data,
+                     .format = DRM_FORMAT_XRGB8888,
+                     .stride = frame->stride,
+                     .dst_x = rects[i].x1 - frame->box.x,
+                     .dst_y = rects[i].y1 - frame->box.y,
+                     .src_box =
+                         {
+                             .x = rects[i].x1,
+                             .y = rects[i].y1,
+                             .width = rects[i].x2 - rects[i].x1,
+                             .height = rects[i].y2 - rects[i].y1,
+                         },
+                 });
+  }
+  wl_shm_buffer_end_access(shm);
+  return ok;
+}
+
+/* Completes the frame from `texture`; false: keep waiting for damage */
+static bool frame_copy(struct osf_capture_frame *frame,
+                       struct wlr_texture *texture) {
+  struct osf_capture_client *client = frame->client;
+  struct osf_capture *capture = client->capture;
+  struct wlr_output *output = frame->output->output;
+  const struct wlr_box *box = &frame->box;
+
+  struct osf_capture_damage *damage = client_damage(client, output);
+  struct osf_capture_buffer *buffer =
+      client_buffer(client, frame->buffer, output, box);
+  if (!damage || !buffer) {
+    frame_fail(frame);
+    return true;
+  }
+
+  pixman_region32_t reported;
+  pixman_region32_init(&reported);
+  pixman_region32_intersect_rect(&reported, &damage->region, box->x, box->y,
+                                 box->width, box->height);
+  if (frame->with_damage && !pixman_region32_not_empty(&reported)) {
+    pixman_region32_fini(&reported);
+    return false;
+  }
+
+  pixman_region32_t copy;
+  if (frame->with_damage) {
+    pixman_region32_init(&copy);
+    pixman_region32_intersect_rect(&copy, &buffer->stale, box->x, box->y,
+                                   box->width, box->height);
+  } else {
+    pixman_region32_init_rect(&copy, box->x, box->y, box->width, box->height);
+  }
+
+  bool ok = read_region(frame, texture, &copy);
+  if (ok) {
+    const pixman_box32_t *extents = pixman_region32_extents(&copy);
+    int count = 0;
+    const pixman_box32_t *rects = pixman_region32_rectangles(&copy, &count);
+    uint64_t pixels = 0;
+    for (int i = 0; i < count; i++) {
+      pixels += (uint64_t)(rects[i].x2 - rects[i].x1) *
+                (rects[i].y2 - rects[i].y1);
+    }
+    capture->copied_pixels += pixels;
+    capture->frame_pixels += (uint64_t)box->width * box->height;
+    wlr_log(WLR_DEBUG,
+            "Screencopy: copied %llu of %d pixels (%d,%d %dx%d), total "
+            "%llu of %llu",
+            (unsigned long long)pixels, box->width * box->height, extents->x1,
+            extents->y1, extents->x2 - extents->x1, extents->y2 - extents->y1,
+            (unsigned long long)capture->copied_pixels,
+            (unsigned long long)capture->frame_pixels);
+
+    pixman_region32_subtract(&buffer->stale, &buffer->stale, &copy);
+    if (frame->with_damage) {
+      send_damage(frame, &reported);
+      region_subtract_box(&damage->region, box);
+    }
+  }
+  pixman_region32_fini(&copy);
+  pixman_region32_fini(&reported);
+
+  if (!ok) {
+    wlr_log(WLR_ERROR, "Screencopy: failed to read the output buffer");
+    /* Whatever was read into it is unknown now */
+    pixman_region32_union_rect(&buffer->stale, &buffer->stale, box->x, box->y,
+                               box->width, box->height);
+    frame_fail(frame);
+    return true;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  frame_finish(frame);
+  zwlr_screencopy_frame_v1_send_flags(frame->resource, 0);
+  zwlr_screencopy_frame_v1_send_ready(frame->resource,
+                                      (uint32_t)((uint64_t)now.tv_sec >> 32),
+                                      (uint32_t)now.tv_sec,
+                                      (uint32_t)now.tv_nsec);
+  return true;
+}
+
+static void frame_request_copy(struct wl_client *wl_client,
+                               struct wl_resource *resource,
+                               struct wl_resource *buffer_resource,
+                               bool with_damage) {
+  struct osf_capture_frame *frame = wl_resource_get_user_data(resource);
+  (void)wl_client;
+  if (frame->used) {
+    wl_resource_post_error(resource, ZWLR_SCREENCOPY_FRAME_V1_ERROR_ALREADY_USED,
+                           "frame already used");
+    return;
+  }
+  frame->used = true;
+  if (!frame->output) {
+    /* Failed already, or its output went away */
+    zwlr_screencopy_frame_v1_send_failed(resource);
+    return;
+  }
+
+  struct wl_shm_buffer *shm = wl_shm_buffer_get(buffer_resource);
+  if (!shm || wl_shm_buffer_get_format(shm) != WL_SHM_FORMAT_XRGB8888 ||
+      wl_shm_buffer_get_width(shm) != frame->box.width ||
+      wl_shm_buffer_get_height(shm) != frame->box.height ||
+      wl_shm_buffer_get_stride(shm) != frame->stride) {
+    wl_resource_post_error(resource,
+                           ZWLR_SCREENCOPY_FRAME_V1_ERROR_INVALID_BUFFER,
+                           "invalid buffer attributes");
+    return;
+  }
+
+  frame->buffer = buffer_resource;
+  frame->with_damage = with_damage;
+  frame->buffer_destroy.notify = handle_frame_buffer_destroy;
+  wl_resource_add_destroy_listener(buffer_resource, &frame->buffer_destroy);
+
+  /* A plain copy wants a frame even if nothing changed; so does damage the
+   * client was not told about yet */
+  struct wlr_output *output = frame->output->output;
+  struct osf_capture_damage *damage = client_damage(frame->client, output);
+  if (!with_damage || (damage && pixman_region32_not_empty(&damage->region))) {
+    wlr_output_update_needs_frame(output);
+  }
+}
+
+static void frame_handle_copy(struct wl_client *wl_client,
+                              struct wl_resource *resource,
+                              struct wl_resource *buffer) {
+  frame_request_copy(wl_client, resource, buffer, false);
+}
+
+static void frame_handle_copy_with_damage(struct wl_client *wl_client,
+                                          struct wl_resource *resource,
+                                          struct wl_resource *buffer) {
+  frame_request_copy(wl_client, resource, buffer, true);
+}
+
+static void frame_handle_destroy(struct wl_client *wl_client,
+                                 struct wl_resource *resource) {
+  (void)wl_client;
+  wl_resource_destroy(resource);
+}
+
+static const struct zwlr_screencopy_frame_v1_interface frame_impl = {
+    .copy = frame_handle_copy,
+    .destroy = frame_handle_destroy,
+    .copy_with_damage = frame_handle_copy_with_damage,
+};
+
+/* ============================================================================
+ * Outputs
+ * ============================================================================
+ */
+
+static void output_handle_commit(struct wl_listener *listener, void *data) {
+  struct osf_capture_output *capture_output =
+      wl_container_of(listener, capture_output, commit);
+  const struct wlr_output_event_commit *event = data;
+  const struct wlr_output_state *state = event->state;
+  struct wlr_output *output = capture_output->output;
+  struct osf_capture *capture = capture_output->capture;
+
+  if (!(state->committed & WLR_OUTPUT_STATE_BUFFER) || !state->buffer) {
+    return;
+  }
+
+  pixman_region32_t damage;
+  if (state->committed & WLR_OUTPUT_STATE_DAMAGE) {
+    pixman_region32_init(&damage);
+    pixman_region32_copy(&damage, &state->damage);
+  } else {
+    pixman_region32_init_rect(&damage, 0, 0, output->width, output->height);
+  }
+
+  struct osf_capture_client *client;
+  wl_list_for_each(client, &capture->clients, link) {
+    struct osf_capture_damage *pending;
+    wl_list_for_each(pending, &client->damage, link) {
+      if (pending->output == output) {
+        pixman_region32_union(&pending->region, &pending->region, &damage);
+      }
+    }
+    struct osf_capture_buffer *buffer;
+    wl_list_for_each(buffer, &client->buffers, link) {
+      if (buffer->output == output) {
+        pixman_region32_union(&buffer->stale, &buffer->stale, &damage);
+      }
+    }
+  }
+  pixman_region32_fini(&damage);
+
+  bool requested = false;
+  struct osf_capture_frame *frame, *tmp;
+  wl_list_for_each(frame, &capture_output->frames, link) {
+    requested |= frame->buffer != NULL;
+  }
+  if (!requested) {
+    return;
+  }
+  struct wlr_texture *texture =
+      wlr_texture_from_buffer(capture->server->renderer, state->buffer);
+  wl_list_for_each_safe(frame, tmp, &capture_output->frames, link) {
+    if (!frame->buffer) {
+      continue; /* No copy requested yet */
+    }
+    if (!texture) {
+      frame_fail(frame);
+    } else {
+      frame_copy(frame, texture);
+    }
+  }
+  if (texture) {
+    wlr_texture_destroy(texture);
+  }
+}
+
+static void output_handle_destroy(struct wl_listener *listener, void *data) {
+  struct osf_capture_output *capture_output =
+      wl_container_of(listener, capture_output, destroy);
+  struct wlr_output *output = capture_output->output;
+  (void)data;
+
+  struct osf_capture_frame *frame, *frame_tmp;
+  wl_list_for_each_safe(frame, frame_tmp, &capture_output->frames, link) {
+    frame_fail(frame);
+  }
+
+  struct osf_capture_client *client;
+  wl_list_for_each(client, &capture_output->capture->clients, link) {
+    struct osf_capture_damage *damage, *damage_tmp;
+    wl_list_for_each_safe(damage, damage_tmp, &client->damage, link) {
+      if (damage->output == output) {
+        damage_forget(damage);
+      }
+    }
+    struct osf_capture_buffer *buffer, *buffer_tmp;
+    wl_list_for_each_safe(buffer, buffer_tmp, &client->buffers, link) {
+      if (buffer->output == output) {
+        buffer_forget(buffer);
+      }
+    }
+  }
+
+  wl_list_remove(&capture_output->commit.link);
+  wl_list_remove(&capture_output->destroy.link);
+  wl_list_remove(&capture_output->link);
+  free(capture_output);
+}
+
+static void handle_new_output(struct wl_listener *listener, void *data) {
+  struct osf_capture *capture = wl_container_of(listener, capture, new_output);
+  struct wlr_output *output = data;
+
+  struct osf_capture_output *capture_output =
+      calloc(1, sizeof(*capture_output));
+  if (!capture_output) {
+    return;
+  }
+  capture_output->capture = capture;
+  capture_output->output = output;
+  wl_list_init(&capture_output->frames);
+  capture_output->commit.notify = output_handle_commit;
+  wl_signal_add(&output->events.commit, &capture_output->commit);
+  capture_output->destroy.notify = output_handle_destroy;
+  wl_signal_add(&output->events.destroy, &capture_output->destroy);
+  wl_list_insert(&capture->outputs, &capture_output->link);
+}
+
+static struct osf_capture_output *
+capture_output_get(struct osf_capture *capture, struct wlr_output *output) {
+  struct osf_capture_output *capture_output;
+  wl_list_for_each(capture_output, &capture->outputs, link) {
+    if (capture_output->output == output) {
+      return capture_output;
+    }
+  }
+  return NULL;
+}
+
+/* ============================================================================
+ * Manager
+ * ============================================================================
+ */
+
+static void capture_output(struct wl_resource *manager_resource, uint32_t id,
+                           struct wl_resource *output_resource,
+                           const struct wlr_box *region) {
+  struct osf_capture_client *client =
+      wl_resource_get_user_data(manager_resource);
+  struct wl_client *wl_client = wl_resource_get_client(manager_resource);
+
+  struct osf_capture_frame *frame = calloc(1, sizeof(*frame));
+  if (!frame) {
+    wl_resource_post_no_memory(manager_resource);
+    return;
+  }
+  frame->resource =
+      wl_resource_create(wl_client, &zwlr_screencopy_frame_v1_interface,
+                         wl_resource_get_version(manager_resource), id);
+  if (!frame->resource) {
+    free(frame);
+    wl_resource_post_no_memory(manager_resource);
+    return;
+  }
+  wl_resource_set_implementation(frame->resource, &frame_impl, frame,
+                                 handle_frame_resource_destroy);
+  frame->client = client;
+  client->frames++;
+
+  struct wlr_output *output = wlr_output_from_resource(output_resource);
+  struct osf_capture_output *capture_output =
+      output && output->enabled ? capture_output_get(client->capture, output)
+                                : NULL;
+  if (!capture_output) {
+    zwlr_screencopy_frame_v1_send_failed(frame->resource);
+    return;
+  }
+
+  /* Buffer coordinates of the output, the region's are logical */
+  int width, height;
+  wlr_output_transformed_resolution(output, &width, &height);
+  struct wlr_box box = {0, 0, width, height};
+  if (region) {
+    struct wlr_box scaled = {
+        (int)(region->x * output->scale),
+        (int)(region->y * output->scale),
+        (int)(region->width * output->scale),
+        (int)(region->height * output->scale),
+    };
+    if (!wlr_box_intersection(&box, &box, &scaled)) {
+      zwlr_screencopy_frame_v1_send_failed(frame->resource);
+      return;
+    }
+  }
+  wlr_box_transform(&frame->box, &box,
+                    wlr_output_transform_invert(output->transform), width,
+                    height);
+  frame->stride = frame->box.width * 4;
+  frame->output = capture_output;
+  wl_list_insert(capture_output->frames.prev, &frame->link);
+
+  zwlr_screencopy_frame_v1_send_buffer(frame->resource,
+                                       WL_SHM_FORMAT_XRGB8888,
+                                       frame->box.width, frame->box.height,
+                                       frame->stride);
+  if (wl_resource_get_version(frame->resource) >= 3) {
+    zwlr_screencopy_frame_v1_send_buffer_done(frame->resource);
+  }
+}
+
+/* The cursor is part of the scene's frame either way */
+static void manager_handle_capture_output(struct wl_client *wl_client,
+                                          struct wl_resource *resource,
+                                          uint32_t id, int32_t overlay_cursor,
+                                          struct wl_resource *output) {
+  (void)wl_client;
+  (void)overlay_cursor;
+  capture_output(resource, id, output, NULL);
+}
+
+static void manager_handle_capture_output_region(
+    struct wl_client *wl_client, struct wl_resource *resource, uint32_t id,
+    int32_t overlay_cursor, struct wl_resource *output, int32_t x, int32_t y,
+    int32_t width, int32_t height) {
+  (void)wl_client;
+  (void)overlay_cursor;
+  struct wlr_box region = {x, y, width, height};
+  capture_output(resource, id, output, &region);
+}
+
+static void manager_handle_destroy(struct wl_client *wl_client,
+                                   struct wl_resource *resource) {
+  (void)wl_client;
+  wl_resource_destroy(resource);
+}
+
+static const struct zwlr_screencopy_manager_v1_interface manager_impl = {
+    .capture_output = manager_handle_capture_output,
+    .capture_output_region = manager_handle_capture_output_region,
+    .destroy = manager_handle_destroy,
+};
+
+static void handle_manager_resource_destroy(struct wl_resource *resource) {
+  struct osf_capture_client *client = wl_resource_get_user_data(resource);
+  client->resource = NULL;
+  client_unref(client);
+}
+
+static void screencopy_bind(struct wl_client *wl_client, void *data,
+                            uint32_t version, uint32_t id) {
+  struct osf_capture *capture = data;
+
+  struct osf_capture_client *client = calloc(1, sizeof(*client));
+  if (!client) {
+    wl_client_post_no_memory(wl_client);
+    return;
+  }
+  client->resource = wl_resource_create(
+      wl_client, &zwlr_screencopy_manager_v1_interface, version, id);
+  if (!client->resource) {
+    free(client);
+    wl_client_post_no_memory(wl_client);
+    return;
+  }
+  client->capture = capture;
+  wl_list_init(&client->damage);
+  wl_list_init(&client->buffers);
+  wl_list_insert(&capture->clients, &client->link);
+  wl_resource_set_implementation(client->resource, &manager_impl, client,
+                                 handle_manager_resource_destroy);
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================
+ */
+
+void osf_capture_init(struct osf_server *server) {
+  wlr_xdg_output_manager_v1_create(server->wl_display, server->output_layout);
+  wlr_export_dmabuf_manager_v1_create(server->wl_display);
+
+  struct osf_capture *capture = calloc(1, sizeof(*capture));
+  if (capture) {
+    capture->server = server;
+    wl_list_init(&capture->clients);
+    wl_list_init(&capture->outputs);
+    capture->screencopy = wl_global_create(
+        server->wl_display, &zwlr_screencopy_manager_v1_interface,
+        OSF_SCREENCOPY_VERSION, capture, screencopy_bind);
+    capture->new_output.notify = handle_new_output;
+    wl_signal_add(&server->backend->events.new_output, &capture->new_output);
+    server->capture = capture;
+  }
+
+#ifdef OSF_HAVE_IMAGE_COPY_CAPTURE
+  wlr_ext_output_image_capture_source_manager_v1_create(server->wl_display, 1);
+  wlr_ext_image_copy_capture_manager_v1_create(server->wl_display, 1);
+  wlr_log(WLR_INFO, "Screen capture: screencopy, image-copy-capture, "
+                    "export-dmabuf");
+#else
+  wlr_log(WLR_INFO, "Screen capture: screencopy, export-dmabuf");
+#endif
+}
+
+void osf_capture_finish(struct osf_server *server) {
+  struct osf_capture *capture = server->capture;
+  if (!capture) {
+    return;
+  }
+  /* Clients are gone, and with them every frame and manager */
+  struct osf_capture_output *output, *tmp;
+  wl_list_for_each_safe(output, tmp, &capture->outputs, link) {
+    output_handle_destroy(&output->destroy, NULL);
+  }
+  wl_list_remove(&capture->new_output.link);
+  wl_global_destroy(capture->screencopy);
+  free(capture);
+  server->capture = NULL;
+}
@@ -7,13 +7,22 @@
 #include "server.h"
 
 #include <opensef/OSFFrameworkC.h>
+#include "latency.h"
 #include "multitask.h"
 #include "tiling.h"
+#include "visibility.h"
+#include "workspace.h"
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_cursor.h>
 #include <wlr/types/wlr_keyboard.h>
 #include <wlr/types/wlr_pointer.h>
+#include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_seat.h>
+#include <wlr/types/wlr_virtual_keyboard_v1.h>
+#include <wlr/types/wlr_virtual_pointer_v1.h>
 #include <wlr/types/wlr_xcursor_manager.h>
 #include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/util/log.h>
@@ -51,9 +60,12 @@ static bool handle_compositor_keybinding(struct osf_server *server,
     /* Alt+F1: Cycle focus */
     if (wlr_keyboard_get_modifiers(wlr_seat_get_keyboard(server->seat)) &
         WLR_MODIFIER_ALT) {
-      if (!wl_list_empty(&server->views)) {
-        struct osf_view *next = wl_container_of(server->views.prev, next, link);
-        osf_focus_view(next, next->xdg_toplevel->base->surface);
+      struct osf_view *next;
+      wl_list_for_each_reverse(next, &server->views, link) {
+        if (next->workspace == server->active_workspace) {
+          osf_focus_view(next, next->xdg_toplevel->base->surface);
+          break;
+        }
       }
       return true;
     }
@@ -72,13 +84,62 @@ static bool handle_compositor_keybinding(struct osf_server *server,
     /* Super+T: Toggle Tiling */
     if (wlr_keyboard_get_modifiers(wlr_seat_get_keyboard(server->seat)) &
         WLR_MODIFIER_LOGO) {
-      // Toggle tiling on the primary output
-      struct osf_output *output =
-          wl_container_of(server->outputs.next, output, link);
-      osf_tiling_arrange(server, output);
+      struct osf_output *output = osf_output_at_cursor(server);
+      if (output) {
+        osf_tiling_toggle(server, output);
+      }
       return true;
     }
     break;
+
+  case XKB_KEY_space:
+    /* Super+Space: Next tiling layout */
+    if (wlr_keyboard_get_modifiers(wlr_seat_get_keyboard(server->seat)) &
+        WLR_MODIFIER_LOGO) {
+      struct osf_output *output = osf_output_at_cursor(server);
+      if (output && output->tiling) {
+        osf_tiling_cycle_layout(server, output);
+      }
+      return true;
+    }
+    break;
+  }
+  return false;
+}
+
+/* Super+N shows workspace N, Super+Shift+N sends the focused window there.
+ * Matched on the unshifted keysym so Shift+1 is still "1", not "!" */
+static bool handle_workspace_keybinding(struct osf_keyboard *keyboard,
+                                        uint32_t keycode) {
+  struct osf_server *server = keyboard->server;
+  struct wlr_keyboard *wlr_keyboard = keyboard->wlr_keyboard;
+  uint32_t modifiers = wlr_keyboard_get_modifiers(wlr_keyboard);
+  if (!(modifiers & WLR_MODIFIER_LOGO)) {
+    return false;
+  }
+
+  xkb_layout_index_t layout =
+      xkb_state_key_get_layout(wlr_keyboard->xkb_state, keycode);
+  const xkb_keysym_t *syms;
+  int num_syms = xkb_keymap_key_get_syms_by_level(
+      wlr_keyboard->keymap, keycode, layout, 0, &syms);
+
+  for (int i = 0; i < num_syms; i++) {
+    if (syms[i] < XKB_KEY_1 || syms[i] > XKB_KEY_9) {
+      continue;
+    }
+    int index = syms[i] - XKB_KEY_1;
+    if (!(modifiers & WLR_MODIFIER_SHIFT)) {
+      osf_workspace_switch(server, index);
+      return true;
+    }
+    struct wlr_surface *focused = server->seat->keyboard_state.focused_surface;
+    struct wlr_xdg_toplevel *toplevel =
+        focused ? wlr_xdg_toplevel_try_from_wlr_surface(focused) : NULL;
+    if (toplevel && toplevel->base->data) {
+      osf_workspace_move_view(toplevel->base->data, index);
+    }
+    return true;
   }
   return false;
 }
@@ -97,8 +158,10 @@ static void keyboard_key(struct wl_listener *listener, void *data) {
 
   bool handled = false;
 
+  osf_latency_event_begin(server, OSF_LATENCY_KEY, event->time_msec);
   if (event->state == WL_KEYBOARD_KEY_STATE_PRESSED) {
-    for (int i = 0; i < num_syms; i++) {
+    handled = handle_workspace_keybinding(keyboard, keycode);
+    for (int i = 0; !handled && i < num_syms; i++) {
       handled = handle_compositor_keybinding(server, syms[i]);
       if (handled)
         break;
@@ -111,6 +174,8 @@ static void keyboard_key(struct wl_listener *listener, void *data) {
     wlr_seat_keyboard_notify_key(seat, event->time_msec, event->keycode,
                                  event->state);
   }
+  osf_latency_mark(server, OSF_LATENCY_DISPATCH);
+  osf_latency_event_end(server);
 }
 
 static void keyboard_destroy(struct wl_listener *listener, void *data) {
@@ -171,6 +236,14 @@ static void new_pointer(struct osf_server *server,
   wlr_log(WLR_INFO, "Pointer added");
 }
 
+static void update_capabilities(struct osf_server *server) {
+  uint32_t caps = WL_SEAT_CAPABILITY_POINTER;
+  if (!wl_list_empty(&server->keyboards)) {
+    caps |= WL_SEAT_CAPABILITY_KEYBOARD;
+  }
+  wlr_seat_set_capabilities(server->seat, caps);
+}
+
 void osf_new_input(struct wl_listener *listener, void *data) {
   struct osf_server *server = wl_container_of(listener, server, new_input);
   struct wlr_input_device *device = data;
@@ -187,12 +260,53 @@ void osf_new_input(struct wl_listener *listener, void *data) {
     break;
   }
 
-  /* Update seat capabilities */
-  uint32_t caps = WL_SEAT_CAPABILITY_POINTER;
-  if (!wl_list_empty(&server->keyboards)) {
-    caps |= WL_SEAT_CAPABILITY_KEYBOARD;
+  update_capabilities(server);
+}
+
+/* ============================================================================
+ * Virtual input (benchmarks and automated tests)
+ * ============================================================================
+ */
+
+static void new_virtual_keyboard(struct wl_listener *listener, void *data) {
+  struct osf_server *server =
+      wl_container_of(listener, server, new_virtual_keyboard);
+  struct wlr_virtual_keyboard_v1 *keyboard = data;
+
+  new_keyboard(server, &keyboard->keyboard.base);
+  update_capabilities(server);
+}
+
+static void new_virtual_pointer(struct wl_listener *listener, void *data) {
+  struct osf_server *server =
+      wl_container_of(listener, server, new_virtual_pointer);
+  struct wlr_virtual_pointer_v1_new_pointer_event *event = data;
+
+  new_pointer(server, &event->new_pointer->pointer.base);
+  update_capabilities(server);
+}
+
+/* Any client could drive the seat through these, so they are only offered
+ * when asked for (VITUS_VIRTUAL_INPUT=1), e.g. by compositor-benchmark */
+void osf_virtual_input_init(struct osf_server *server) {
+  const char *env = getenv("VITUS_VIRTUAL_INPUT");
+  if (!env || strcmp(env, "1") != 0) {
+    return;
   }
-  wlr_seat_set_capabilities(server->seat, caps);
+
+  struct wlr_virtual_keyboard_manager_v1 *keyboards =
+      wlr_virtual_keyboard_manager_v1_create(server->wl_display);
+  server->new_virtual_keyboard.notify = new_virtual_keyboard;
+  wl_signal_add(&keyboards->events.new_virtual_keyboard,
+                &server->new_virtual_keyboard);
+
+  struct wlr_virtual_pointer_manager_v1 *pointers =
+      wlr_virtual_pointer_manager_v1_create(server->wl_display);
+  server->new_virtual_pointer.notify = new_virtual_pointer;
+  wl_signal_add(&pointers->events.new_virtual_pointer,
+                &server->new_virtual_pointer);
+
+  wlr_log(WLR_INFO, "Virtual keyboard and pointer enabled");
 }
 
 /* ============================================================================
@@ -213,6 +327,8 @@ static void process_cursor_move(struct osf_server *server, uint32_t time) {
 
   wlr_scene_node_set_position(&view->scene_tree->node,
                               server->cursor->x - server->grab_x, next_y);
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
 
   /* Report to framework */
   char window_id[64];
@@ -263,22 +379,220 @@ static void process_cursor_resize(struct osf_server *server, uint32_t time) {
     }
   }
 
-  struct wlr_box geo;
-  // wlr_xdg_surface_get_geometry(view->xdg_toplevel->base, &geo);
-  geo = view->xdg_toplevel->base->current.geometry;
-  wlr_scene_node_set_position(&view->scene_tree->node, new_left - geo.x,
-                              new_top - geo.y);
+  /* Throttled to the client's acks; the view moves and reports its
+   * geometry when the matching size is committed */
+  struct wlr_box box = {
+      .x = new_left,
+      .y = new_top,
+      .width = new_right - new_left,
+      .height = new_bottom - new_top,
+  };
+  osf_view_resize(view, box, server->resize_edges);
+}
 
-  int new_width = new_right - new_left;
-  int new_height = new_bottom - new_top;
-  wlr_xdg_toplevel_set_size(view->xdg_toplevel, new_width, new_height);
+/* ============================================================================
+ * Pointer hit cache
+ * ============================================================================
+ */
 
-  /* Report to framework */
-  char window_id[64];
-  snprintf(window_id, sizeof(window_id), "window-%p", (void *)view);
-  osf_window_set_geometry(window_id, new_left, new_top, new_width, new_height);
+struct hit_walk {
+  struct wlr_surface *surface;
+  bool found;                /* Nodes after the surface's are above it */
+  struct wlr_box box;        /* The surface's buffer node, layout coords */
+  pixman_region32_t *covered; /* Union of everything above */
+};
+
+static void walk_scene(struct wlr_scene_node *node, int lx, int ly,
+                       struct hit_walk *walk) {
+  if (!node->enabled) {
+    return;
+  }
+  lx += node->x;
+  ly += node->y;
+
+  int width = 0, height = 0;
+  switch (node->type) {
+  case WLR_SCENE_NODE_TREE: {
+    struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+    struct wlr_scene_node *child;
+    wl_list_for_each(child, &tree->children, link) {
+      walk_scene(child, lx, ly, walk);
+    }
+    return;
+  }
+  case WLR_SCENE_NODE_RECT: {
+    struct wlr_scene_rect *rect = wlr_scene_rect_from_node(node);
+    width = rect->width;
+    height = rect->height;
+    break;
+  }
+  case WLR_SCENE_NODE_BUFFER: {
+    struct wlr_scene_buffer *buffer = wlr_scene_buffer_from_node(node);
+    width = buffer->dst_width;
+    height = buffer->dst_height;
+    if (width == 0 && buffer->buffer) {
+      width = buffer->buffer->width;
+      height = buffer->buffer->height;
+      if (buffer->transform & WL_OUTPUT_TRANSFORM_90) {
+        width = buffer->buffer->height;
+        height = buffer->buffer->width;
+      }
+    }
+    if (!walk->found) {
+      struct wlr_scene_surface *scene_surface =
+          wlr_scene_surface_try_from_buffer(buffer);
+      if (scene_surface && scene_surface->surface == walk->surface) {
+        walk->found = true;
+        walk->box = (struct wlr_box){lx, ly, width, height};
+      }
+      return;
+    }
+    break;
+  }
+  }
+
+  if (walk->found && width > 0 && height > 0) {
+    pixman_region32_union_rect(walk->covered, walk->covered, lx, ly, width,
+                               height);
+  }
+}
+
+static void pointer_hit_surface_destroy(struct wl_listener *listener,
+                                        void *data) {
+  struct osf_server *server =
+      wl_container_of(listener, server, pointer_hit.surface_destroy);
+  (void)data;
+  osf_cursor_invalidate_hit(server);
+}
+
+static void pointer_hit_root_destroy(struct wl_listener *listener,
+                                     void *data) {
+  struct osf_server *server =
+      wl_container_of(listener, server, pointer_hit.root_destroy);
+  (void)data;
+  osf_cursor_invalidate_hit(server);
+}
+
+void osf_cursor_invalidate_hit(struct osf_server *server) {
+  struct osf_pointer_hit *hit = &server->pointer_hit;
+  if (hit->valid) {
+    wl_list_remove(&hit->surface_destroy.link);
+    wl_list_remove(&hit->root_commit.link);
+    wl_list_remove(&hit->root_destroy.link);
+    hit->valid = false;
+  }
+}
+
+void osf_cursor_scene_changed(struct osf_server *server,
+                              const struct wlr_box *box) {
+  struct osf_pointer_hit *hit = &server->pointer_hit;
+  if (!hit->valid) {
+    return;
+  }
+  const pixman_box32_t *extents = pixman_region32_extents(&hit->region);
+  if (!box || (box->x < extents->x2 && box->x + box->width > extents->x1 &&
+               box->y < extents->y2 && box->y + box->height > extents->y1)) {
+    osf_cursor_invalidate_hit(server);
+  }
+}
+
+/* Frames that keep the size leave the cache alone; the root also applies
+ * its subsurfaces' positions and stacking, which we can't see */
+static void pointer_hit_root_commit(struct wl_listener *listener,
+                                    void *data) {
+  struct osf_server *server =
+      wl_container_of(listener, server, pointer_hit.root_commit);
+  struct osf_pointer_hit *hit = &server->pointer_hit;
+  struct wlr_surface *root = hit->root;
+  (void)data;
+
+  if (root->current.width != hit->root_width ||
+      root->current.height != hit->root_height ||
+      (root->current.committed &
+       (WLR_SURFACE_STATE_OFFSET | WLR_SURFACE_STATE_SCALE |
+        WLR_SURFACE_STATE_TRANSFORM | WLR_SURFACE_STATE_VIEWPORT)) ||
+      !wl_list_empty(&root->current.subsurfaces_above) ||
+      !wl_list_empty(&root->current.subsurfaces_below)) {
+    osf_cursor_invalidate_hit(server);
+  }
+}
+
+/* One walk over the scene, on a miss; anything drawn above the surface,
+ * whether or not it takes input, is left out of the region */
+static void pointer_hit_store(struct osf_server *server,
+                              struct wlr_surface *surface,
+                              struct osf_view *view, double sx, double sy) {
+  struct osf_pointer_hit *hit = &server->pointer_hit;
+  osf_cursor_invalidate_hit(server);
+
+  pixman_region32_t covered;
+  pixman_region32_init(&covered);
+  struct hit_walk walk = {.surface = surface, .covered = &covered};
+  walk_scene(&server->scene->tree.node, 0, 0, &walk);
+  if (walk.found) {
+    pixman_region32_fini(&hit->region);
+    pixman_region32_init_rect(&hit->region, walk.box.x, walk.box.y,
+                              walk.box.width, walk.box.height);
+    pixman_region32_subtract(&hit->region, &hit->region, &covered);
+
+    hit->valid = true;
+    hit->surface = surface;
+    hit->view = view;
+    hit->origin_x = server->cursor->x - sx;
+    hit->origin_y = server->cursor->y - sy;
+    wl_signal_add(&surface->events.destroy, &hit->surface_destroy);
+    hit->root = wlr_surface_get_root_surface(surface);
+    hit->root_width = hit->root->current.width;
+    hit->root_height = hit->root->current.height;
+    wl_signal_add(&hit->root->events.commit, &hit->root_commit);
+    wl_signal_add(&hit->root->events.destroy, &hit->root_destroy);
+  }
+  pixman_region32_fini(&covered);
+}
+
+static bool pointer_hit_lookup(struct osf_server *server,
+                               struct wlr_surface **surface,
+                               struct osf_view **view, double *sx,
+                               double *sy) {
+  struct osf_pointer_hit *hit = &server->pointer_hit;
+  double lx = server->cursor->x, ly = server->cursor->y;
+  if (!hit->valid ||
+      !pixman_region32_contains_point(&hit->region, (int)floor(lx),
+                                      (int)floor(ly), NULL)) {
+    return false;
+  }
+  /* Input regions can exclude parts (client-side shadows) */
+  *sx = lx - hit->origin_x;
+  *sy = ly - hit->origin_y;
+  if (!wlr_surface_point_accepts_input(hit->surface, *sx, *sy)) {
+    return false;
+  }
+  *surface = hit->surface;
+  *view = hit->view;
+  return true;
 }
 
+void osf_cursor_hit_init(struct osf_server *server) {
+  pixman_region32_init(&server->pointer_hit.region);
+  server->pointer_hit.surface_destroy.notify = pointer_hit_surface_destroy;
+  server->pointer_hit.root_commit.notify = pointer_hit_root_commit;
+  server->pointer_hit.root_destroy.notify = pointer_hit_root_destroy;
+}
+
+void osf_cursor_hit_finish(struct osf_server *server) {
+  osf_cursor_invalidate_hit(server);
+  pixman_region32_fini(&server->pointer_hit.region);
+  if (server->motion_idle) {
+    wl_event_source_remove(server->motion_idle);
+    server->motion_idle = NULL;
+  }
+}
+
+/* ============================================================================
+ * Cursor events
+ * ============================================================================
+ */
+
 static void process_cursor_motion(struct osf_server *server, uint32_t time) {
   if (server->cursor_mode == OSF_CURSOR_MOVE) {
     process_cursor_move(server, time);
@@ -288,21 +602,110 @@ static void process_cursor_motion(struct osf_server *server, uint32_t time) {
     return;
   }
 
-  /* Find view under cursor */
+  /* Find view under cursor, walking the scene only on a cache miss */
   double sx, sy;
   struct wlr_surface *surface = NULL;
-  struct osf_view *view = osf_view_at(server, server->cursor->x,
-                                      server->cursor->y, &surface, &sx, &sy);
+  struct osf_view *view = NULL;
+  if (!pointer_hit_lookup(server, &surface, &view, &sx, &sy)) {
+    view = osf_view_at(server, server->cursor->x, server->cursor->y, &surface,
+                       &sx, &sy);
+    if (surface) {
+      pointer_hit_store(server, surface, view, sx, sy);
+    } else {
+      osf_cursor_invalidate_hit(server);
+    }
+  }
+
+  /* Enter only on an actual focus change */
+  struct wlr_seat *seat = server->seat;
+  if (surface != seat->pointer_state.focused_surface) {
+    if (surface) {
+      wlr_seat_pointer_notify_enter(seat, surface, sx, sy);
+    } else {
+      wlr_seat_pointer_clear_focus(seat);
+    }
+    server->default_cursor = false; /* The new client sets its own */
+  }
 
-  if (!view) {
+  if (!view && !server->default_cursor) {
     wlr_cursor_set_xcursor(server->cursor, server->cursor_mgr, "default");
+    server->default_cursor = true;
   }
 
   if (surface) {
-    wlr_seat_pointer_notify_enter(server->seat, surface, sx, sy);
-    wlr_seat_pointer_notify_motion(server->seat, time, sx, sy);
-  } else {
-    wlr_seat_pointer_clear_focus(server->seat);
+    wlr_seat_pointer_notify_motion(seat, time, sx, sy);
+  }
+}
+
+/* Deliver coalesced motion: on the pointer frame, before a button or axis
+ * event, or once the event loop has drained whatever else was queued.
+ *
+ * A cache miss walks the scene and delivers right away, so entering a
+ * surface is never late. Motion that stays on the cached surface waits
+ * for the next output frame unless `now` (buttons and axis events need it
+ * delivered first), so a fast mouse sends a client one motion per frame,
+ * not one per pointer frame. Returns false while it waits. */
+static bool flush_cursor_motion(struct osf_server *server, bool now) {
+  if (server->motion_idle) {
+    wl_event_source_remove(server->motion_idle);
+    server->motion_idle = NULL;
+  }
+  if (!server->motion_pending) {
+    return true;
+  }
+
+  double sx, sy;
+  struct wlr_surface *surface;
+  struct osf_view *view;
+  struct osf_output *output = osf_output_at_cursor(server);
+  if (!now && output && server->cursor_mode == OSF_CURSOR_PASSTHROUGH &&
+      pointer_hit_lookup(server, &surface, &view, &sx, &sy)) {
+    if (!server->motion_frame_pending) {
+      server->motion_frame_pending = true;
+      wlr_output_schedule_frame(output->wlr_output);
+    }
+    return false;
+  }
+  server->motion_pending = false;
+  server->motion_frame_pending = false;
+
+  osf_latency_event_begin(server, OSF_LATENCY_MOTION,
+                          server->motion_first_time);
+  process_cursor_motion(server, server->motion_time);
+  osf_latency_mark(server, OSF_LATENCY_DISPATCH);
+  osf_latency_event_end(server);
+  return true;
+}
+
+static void motion_idle_callback(void *data) {
+  struct osf_server *server = data;
+  server->motion_idle = NULL; /* Idle sources remove themselves */
+  if (server->motion_pending && flush_cursor_motion(server, false)) {
+    wlr_seat_pointer_notify_frame(server->seat);
+  }
+}
+
+void osf_cursor_output_frame(struct osf_server *server) {
+  if (server->motion_frame_pending && server->motion_pending) {
+    flush_cursor_motion(server, true);
+    wlr_seat_pointer_notify_frame(server->seat);
+  }
+  server->motion_frame_pending = false;
+}
+
+/* The cursor image moves right away; the rest waits for the frame */
+static void queue_cursor_motion(struct osf_server *server, uint32_t time) {
+  if (!server->motion_pending) {
+    server->motion_pending = true;
+    server->motion_first_time = time;
+  }
+  server->motion_time = time;
+
+  /* For pointers that never send a frame */
+  if (!server->motion_idle) {
+    struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+    server->motion_idle =
+        wl_event_loop_add_idle(loop, motion_idle_callback, server);
   }
 }
 
@@ -312,7 +715,7 @@ void osf_cursor_motion(struct wl_listener *listener, void *data) {
 
   wlr_cursor_move(server->cursor, &event->pointer->base, event->delta_x,
                   event->delta_y);
-  process_cursor_motion(server, event->time_msec);
+  queue_cursor_motion(server, event->time_msec);
 }
 
 void osf_cursor_motion_absolute(struct wl_listener *listener, void *data) {
@@ -322,15 +725,19 @@ void osf_cursor_motion_absolute(struct wl_listener *listener, void *data) {
 
   wlr_cursor_warp_absolute(server->cursor, &event->pointer->base, event->x,
                            event->y);
-  process_cursor_motion(server, event->time_msec);
+  queue_cursor_motion(server, event->time_msec);
 }
 
 void osf_cursor_button(struct wl_listener *listener, void *data) {
   struct osf_server *server = wl_container_of(listener, server, cursor_button);
   struct wlr_pointer_button_event *event = data;
 
+  flush_cursor_motion(server, true);
+
+  osf_latency_event_begin(server, OSF_LATENCY_BUTTON, event->time_msec);
   wlr_seat_pointer_notify_button(server->seat, event->time_msec, event->button,
                                  event->state);
+  osf_latency_mark(server, OSF_LATENCY_DISPATCH);
 
   if (event->state == WL_POINTER_BUTTON_STATE_RELEASED) {
     osf_reset_cursor_mode(server);
@@ -344,21 +751,30 @@ void osf_cursor_button(struct wl_listener *listener, void *data) {
       osf_focus_view(view, surface);
     }
   }
+  osf_latency_event_end(server);
 }
 
 void osf_cursor_axis(struct wl_listener *listener, void *data) {
   struct osf_server *server = wl_container_of(listener, server, cursor_axis);
   struct wlr_pointer_axis_event *event = data;
 
+  flush_cursor_motion(server, true);
+
+  osf_latency_event_begin(server, OSF_LATENCY_AXIS, event->time_msec);
   wlr_seat_pointer_notify_axis(
       server->seat, event->time_msec, event->orientation, event->delta,
       event->delta_discrete, event->source, event->relative_direction);
+  osf_latency_mark(server, OSF_LATENCY_DISPATCH);
+  osf_latency_event_end(server);
 }
 
 void osf_cursor_frame(struct wl_listener *listener, void *data) {
   struct osf_server *server = wl_container_of(listener, server, cursor_frame);
   (void)data;
-  wlr_seat_pointer_notify_frame(server->seat);
+  /* Held for the output frame: that one ends it */
+  if (flush_cursor_motion(server, false)) {
+    wlr_seat_pointer_notify_frame(server->seat);
+  }
 }
 
 void osf_seat_request_cursor(struct wl_listener *listener, void *data) {
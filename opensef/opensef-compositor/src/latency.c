@@ -0,0 +1,325 @@
+/**
+ * latency.c - Input-to-Commit Latency Tracing
+ *
+ * Handled events wait in a small queue until an output commit shows new
+ * damage; that commit is taken as the one reflecting them. Events whose
+ * handling changed nothing on screen expire after a second without a
+ * commit sample. Each kind/stage pair keeps its newest samples in a ring,
+ * sorted only when a report is written.
+ */
+
+#include "latency.h"
+#include "server.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wlr/util/log.h>
+
+#include <opensef/OSFFrameworkC.h>
+
+#define OSF_LATENCY_SAMPLES 1024      /* Per kind and stage */
+#define OSF_LATENCY_PENDING 64        /* Events waiting for their commit */
+#define OSF_LATENCY_EXPIRE_US 1000000 /* No damage within: no commit sample */
+#define OSF_LATENCY_MAX_AGE_MS 10000  /* Older device timestamps: other clock */
+
+static const char *kind_names[OSF_LATENCY_KIND_COUNT] = {
+    "motion",
+    "button",
+    "axis",
+    "key",
+};
+
+static const char *stage_names[OSF_LATENCY_STAGE_COUNT] = {
+    "delivery", "dispatch", "focus", "framework", "commit", "total",
+};
+
+struct osf_latency_ring {
+  double ms[OSF_LATENCY_SAMPLES];
+  uint32_t next;
+  uint32_t count;
+};
+
+struct osf_latency_event {
+  enum osf_latency_kind kind;
+  uint64_t device_us; /* 0: device clock is not CLOCK_MONOTONIC */
+  uint64_t arrival_us;
+};
+
+struct osf_latency {
+  struct osf_latency_ring rings[OSF_LATENCY_KIND_COUNT]
+                               [OSF_LATENCY_STAGE_COUNT];
+  uint64_t events[OSF_LATENCY_KIND_COUNT];
+  uint64_t expired; /* Never followed by a damaged commit */
+  uint64_t dropped; /* Queue full */
+
+  /* Event being handled; handlers can nest (keybinding → focus) */
+  int depth;
+  struct osf_latency_event current;
+  uint32_t marked; /* Stages already sampled for it */
+  uint64_t framework_start_us;
+
+  /* Handled, waiting for their commit */
+  struct osf_latency_event pending[OSF_LATENCY_PENDING];
+  int pending_count;
+
+  int report_ms;
+  char report_path[256];
+  struct wl_event_source *report_timer;
+};
+
+static uint64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void record(struct osf_latency *latency, enum osf_latency_kind kind,
+                   enum osf_latency_stage stage, uint64_t from_us,
+                   uint64_t to_us) {
+  struct osf_latency_ring *ring = &latency->rings[kind][stage];
+  ring->ms[ring->next] = to_us > from_us ? (to_us - from_us) / 1000.0 : 0.0;
+  ring->next = (ring->next + 1) % OSF_LATENCY_SAMPLES;
+  if (ring->count < OSF_LATENCY_SAMPLES) {
+    ring->count++;
+  }
+}
+
+/* ============================================================================
+ * Hooks
+ * ============================================================================
+ */
+
+void osf_latency_event_begin(struct osf_server *server,
+                             enum osf_latency_kind kind, uint32_t time_msec) {
+  struct osf_latency *latency = server->latency;
+  if (!latency || latency->depth++ > 0) {
+    return;
+  }
+
+  uint64_t now = now_us();
+  latency->current.kind = kind;
+  latency->current.arrival_us = now;
+  latency->current.device_us = 0;
+  latency->marked = 0;
+  latency->events[kind]++;
+
+  /* libinput stamps events with CLOCK_MONOTONIC milliseconds; other
+   * sources (nested backends, virtual devices) may use their own base */
+  uint32_t age_ms = (uint32_t)(now / 1000) - time_msec;
+  if (age_ms < OSF_LATENCY_MAX_AGE_MS) {
+    latency->current.device_us = now - (uint64_t)age_ms * 1000;
+    record(latency, kind, OSF_LATENCY_DELIVERY, latency->current.device_us,
+           now);
+  }
+
+  osf_input_trace_begin(latency->current.device_us
+                            ? latency->current.device_us
+                            : latency->current.arrival_us);
+}
+
+void osf_latency_event_end(struct osf_server *server) {
+  struct osf_latency *latency = server->latency;
+  if (!latency || latency->depth == 0 || --latency->depth > 0) {
+    return;
+  }
+  osf_input_trace_end();
+
+  if (latency->pending_count == OSF_LATENCY_PENDING) {
+    memmove(&latency->pending[0], &latency->pending[1],
+            sizeof(latency->pending[0]) * (OSF_LATENCY_PENDING - 1));
+    latency->pending_count--;
+    latency->dropped++;
+  }
+  latency->pending[latency->pending_count++] = latency->current;
+}
+
+void osf_latency_mark(struct osf_server *server,
+                      enum osf_latency_stage stage) {
+  struct osf_latency *latency = server->latency;
+  if (!latency || latency->depth == 0 || (latency->marked & (1u << stage))) {
+    return;
+  }
+  latency->marked |= 1u << stage;
+  record(latency, latency->current.kind, stage, latency->current.arrival_us,
+         now_us());
+}
+
+void osf_latency_framework_begin(struct osf_server *server) {
+  struct osf_latency *latency = server->latency;
+  if (latency && latency->depth > 0) {
+    latency->framework_start_us = now_us();
+  }
+}
+
+void osf_latency_framework_end(struct osf_server *server) {
+  struct osf_latency *latency = server->latency;
+  if (latency && latency->depth > 0 && latency->framework_start_us) {
+    record(latency, latency->current.kind, OSF_LATENCY_FRAMEWORK,
+           latency->framework_start_us, now_us());
+    latency->framework_start_us = 0;
+  }
+}
+
+void osf_latency_output_commit(struct osf_server *server, bool damaged) {
+  struct osf_latency *latency = server->latency;
+  if (!latency || latency->pending_count == 0) {
+    return;
+  }
+
+  uint64_t now = now_us();
+  int kept = 0;
+  for (int i = 0; i < latency->pending_count; i++) {
+    struct osf_latency_event *event = &latency->pending[i];
+    if (damaged) {
+      record(latency, event->kind, OSF_LATENCY_COMMIT, event->arrival_us, now);
+      record(latency, event->kind, OSF_LATENCY_TOTAL,
+             event->device_us ? event->device_us : event->arrival_us, now);
+    } else if (now - event->arrival_us > OSF_LATENCY_EXPIRE_US) {
+      latency->expired++;
+    } else {
+      latency->pending[kept++] = *event;
+    }
+  }
+  latency->pending_count = kept;
+}
+
+/* ============================================================================
+ * Reports
+ * ============================================================================
+ */
+
+static int compare_ms(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, uint32_t count, double p) {
+  uint32_t i = (uint32_t)(p * (count - 1) + 0.5);
+  return sorted[i < count ? i : count - 1];
+}
+
+static void write_stage(FILE *f, const struct osf_latency_ring *ring) {
+  static double sorted[OSF_LATENCY_SAMPLES];
+  memcpy(sorted, ring->ms, sizeof(double) * ring->count);
+  qsort(sorted, ring->count, sizeof(double), compare_ms);
+  fprintf(f,
+          "{\"count\": %u, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, "
+          "\"max\": %.3f}",
+          ring->count, percentile(sorted, ring->count, 0.50),
+          percentile(sorted, ring->count, 0.95),
+          percentile(sorted, ring->count, 0.99), sorted[ring->count - 1]);
+}
+
+static void write_report(struct osf_latency *latency) {
+  char tmp[sizeof(latency->report_path) + 4];
+  snprintf(tmp, sizeof(tmp), "%s.tmp", latency->report_path);
+  FILE *f = fopen(tmp, "w");
+  if (!f) {
+    wlr_log(WLR_ERROR, "Latency report %s: %s", tmp, strerror(errno));
+    return;
+  }
+
+  fprintf(f, "{\"expired\": %llu, \"dropped\": %llu, \"kinds\": {",
+          (unsigned long long)latency->expired,
+          (unsigned long long)latency->dropped);
+  for (int k = 0; k < OSF_LATENCY_KIND_COUNT; k++) {
+    fprintf(f, "%s\"%s\": {\"events\": %llu", k ? ", " : "", kind_names[k],
+            (unsigned long long)latency->events[k]);
+    for (int s = 0; s < OSF_LATENCY_STAGE_COUNT; s++) {
+      if (latency->rings[k][s].count > 0) {
+        fprintf(f, ", \"%s\": ", stage_names[s]);
+        write_stage(f, &latency->rings[k][s]);
+      }
+    }
+    fprintf(f, "}");
+  }
+  fprintf(f, "}}\n");
+  fclose(f);
+
+  if (rename(tmp, latency->report_path) < 0) {
+    wlr_log(WLR_ERROR, "Latency report %s: %s", latency->report_path,
+            strerror(errno));
+  }
+}
+
+static void log_report(struct osf_latency *latency) {
+  static double sorted[OSF_LATENCY_SAMPLES];
+  for (int k = 0; k < OSF_LATENCY_KIND_COUNT; k++) {
+    const struct osf_latency_ring *ring =
+        &latency->rings[k][OSF_LATENCY_TOTAL];
+    if (ring->count == 0) {
+      continue;
+    }
+    memcpy(sorted, ring->ms, sizeof(double) * ring->count);
+    qsort(sorted, ring->count, sizeof(double), compare_ms);
+    wlr_log(WLR_INFO,
+            "Input latency %s: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms "
+            "(%u samples)",
+            kind_names[k], percentile(sorted, ring->count, 0.50),
+            percentile(sorted, ring->count, 0.95),
+            percentile(sorted, ring->count, 0.99), ring->count);
+  }
+}
+
+static int report_timer_callback(void *data) {
+  struct osf_server *server = data;
+  struct osf_latency *latency = server->latency;
+
+  log_report(latency);
+  write_report(latency);
+  wl_event_source_timer_update(latency->report_timer, latency->report_ms);
+  return 0;
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================
+ */
+
+void osf_latency_init(struct osf_server *server) {
+  const char *env = getenv("VITUS_LATENCY_TRACE");
+  if (!env || strcmp(env, "1") != 0) {
+    return;
+  }
+  const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (!runtime_dir || !server->socket) {
+    wlr_log(WLR_ERROR, "Latency tracing: XDG_RUNTIME_DIR is not set");
+    return;
+  }
+
+  struct osf_latency *latency = calloc(1, sizeof(*latency));
+  if (!latency) {
+    return;
+  }
+  latency->report_ms = OSF_LATENCY_REPORT_MS;
+  env = getenv("VITUS_LATENCY_REPORT_MS");
+  if (env && atoi(env) > 0) {
+    latency->report_ms = atoi(env);
+  }
+  snprintf(latency->report_path, sizeof(latency->report_path),
+           "%s/vitus-latency-%s.json", runtime_dir, server->socket);
+
+  struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+  latency->report_timer =
+      wl_event_loop_add_timer(loop, report_timer_callback, server);
+  wl_event_source_timer_update(latency->report_timer, latency->report_ms);
+  server->latency = latency;
+
+  wlr_log(WLR_INFO, "Input latency tracing, reports every %d ms in %s",
+          latency->report_ms, latency->report_path);
+}
+
+void osf_latency_finish(struct osf_server *server) {
+  struct osf_latency *latency = server->latency;
+  if (!latency) {
+    return;
+  }
+  log_report(latency);
+  write_report(latency);
+  wl_event_source_remove(latency->report_timer);
+  free(latency);
+  server->latency = NULL;
+}
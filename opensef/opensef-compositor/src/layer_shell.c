@@ -59,6 +59,8 @@ static void arrange_layers(struct osf_server *server) {
                                            &full_area, &usable_area);
     }
   }
+  /* Mapped, unmapped or moved: all come through here */
+  osf_cursor_invalidate_hit(server);
 }
 
 static void layer_surface_map(struct wl_listener *listener, void *data) {
@@ -0,0 +1,583 @@
+/**
+ * layout.c - Tiling Layout Trees
+ *
+ * Every layout is built from the same containers; the kinds only differ
+ * in where a window is inserted and how the tree is repaired after a
+ * removal. Each of those returns the lowest node whose children changed,
+ * and only that node is arranged again.
+ */
+
+#include "layout.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Nodes
+ * ============================================================================
+ */
+
+static struct osf_layout_node *node_create(void *window,
+                                           enum osf_layout_split split) {
+  struct osf_layout_node *node = calloc(1, sizeof(*node));
+  if (node) {
+    node->window = window;
+    node->split = split;
+  }
+  return node;
+}
+
+/* Frees the node only, not its children */
+static void node_free(struct osf_layout_node *node) {
+  free(node->children);
+  free(node);
+}
+
+static void node_destroy_tree(struct osf_layout_node *node) {
+  for (size_t i = 0; i < node->child_count; i++) {
+    node_destroy_tree(node->children[i]);
+  }
+  node_free(node);
+}
+
+static size_t node_index(const struct osf_layout_node *parent,
+                         const struct osf_layout_node *child) {
+  for (size_t i = 0; i < parent->child_count; i++) {
+    if (parent->children[i] == child) {
+      return i;
+    }
+  }
+  return parent->child_count;
+}
+
+static bool node_insert_child(struct osf_layout_node *parent, size_t index,
+                              struct osf_layout_node *child) {
+  if (parent->child_count == parent->child_capacity) {
+    size_t capacity = parent->child_capacity ? parent->child_capacity * 2 : 4;
+    struct osf_layout_node **grown =
+        realloc(parent->children, capacity * sizeof(*grown));
+    if (!grown) {
+      return false;
+    }
+    parent->children = grown;
+    parent->child_capacity = capacity;
+  }
+  memmove(&parent->children[index + 1], &parent->children[index],
+          (parent->child_count - index) * sizeof(*parent->children));
+  parent->children[index] = child;
+  parent->child_count++;
+  child->parent = parent;
+  return true;
+}
+
+static bool node_append_child(struct osf_layout_node *parent,
+                              struct osf_layout_node *child) {
+  return node_insert_child(parent, parent->child_count, child);
+}
+
+static void node_remove_child(struct osf_layout_node *parent,
+                              struct osf_layout_node *child) {
+  size_t index = node_index(parent, child);
+  if (index == parent->child_count) {
+    return;
+  }
+  memmove(&parent->children[index], &parent->children[index + 1],
+          (parent->child_count - index - 1) * sizeof(*parent->children));
+  parent->child_count--;
+  child->parent = NULL;
+}
+
+/* Put `replacement` where `node` is in the tree */
+static void node_replace(struct osf_layout *layout,
+                         struct osf_layout_node *node,
+                         struct osf_layout_node *replacement) {
+  struct osf_layout_node *parent = node->parent;
+  if (parent) {
+    parent->children[node_index(parent, node)] = replacement;
+  } else {
+    layout->root = replacement;
+  }
+  replacement->parent = parent;
+  node->parent = NULL;
+}
+
+static struct osf_layout_node *last_leaf(struct osf_layout_node *node) {
+  while (node && !node->window) {
+    node = node->child_count ? node->children[node->child_count - 1] : NULL;
+  }
+  return node;
+}
+
+/* Position after the focused window when it is in this container */
+static size_t insert_index(const struct osf_layout *layout,
+                           const struct osf_layout_node *container) {
+  const struct osf_layout_node *focused = layout->focused;
+  if (focused && focused->parent == container) {
+    return node_index(container, focused) + 1;
+  }
+  return container->child_count;
+}
+
+/* ============================================================================
+ * Arranging
+ * ============================================================================
+ */
+
+static bool rect_equal(struct osf_layout_rect a, struct osf_layout_rect b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height;
+}
+
+static struct osf_layout_rect usable_area(const struct osf_layout *layout) {
+  int og = layout->config.outer_gap;
+  struct osf_layout_rect rect = {
+      layout->area.x + og,
+      layout->area.y + og,
+      layout->area.width - og * 2,
+      layout->area.height - og * 2,
+  };
+  if (rect.width < 0) {
+    rect.width = 0;
+  }
+  if (rect.height < 0) {
+    rect.height = 0;
+  }
+  return rect;
+}
+
+static void push_delta(struct osf_layout *layout, void *window,
+                       struct osf_layout_rect rect) {
+  if (layout->delta_count == layout->delta_capacity) {
+    size_t capacity = layout->delta_capacity ? layout->delta_capacity * 2 : 16;
+    struct osf_layout_delta *grown =
+        realloc(layout->deltas, capacity * sizeof(*grown));
+    if (!grown) {
+      return;
+    }
+    layout->deltas = grown;
+    layout->delta_capacity = capacity;
+  }
+  layout->deltas[layout->delta_count++] =
+      (struct osf_layout_delta){window, rect};
+}
+
+static void arrange_node(struct osf_layout *layout,
+                         struct osf_layout_node *node,
+                         struct osf_layout_rect rect) {
+  layout->nodes_arranged++;
+
+  if (node->window) {
+    if (!node->placed || !rect_equal(node->rect, rect)) {
+      node->rect = rect;
+      node->placed = true;
+      push_delta(layout, node->window, rect);
+    }
+    return;
+  }
+
+  node->rect = rect;
+  size_t n = node->child_count;
+  if (n == 0) {
+    return;
+  }
+
+  bool horizontal = node->split == OSF_SPLIT_HORIZONTAL;
+  int gap = layout->config.inner_gap;
+  int length = horizontal ? rect.width : rect.height;
+  int total = length - gap * (int)(n - 1);
+  if (total < (int)n) {
+    /* Too crowded for gaps; keep every tile inside the container */
+    gap = 0;
+    total = length > 0 ? length : 0;
+  }
+
+  int offset = 0;
+  for (size_t i = 0; i < n; i++) {
+    int size;
+    if (n == 2 && node->ratio > 0.0f) {
+      int first = (int)(total * node->ratio + 0.5f);
+      size = i == 0 ? first : total - first;
+    } else {
+      size = total / (int)n + ((int)i < total % (int)n ? 1 : 0);
+    }
+
+    struct osf_layout_rect child = rect;
+    if (horizontal) {
+      child.x += offset;
+      child.width = size;
+    } else {
+      child.y += offset;
+      child.height = size;
+    }
+    arrange_node(layout, node->children[i], child);
+    offset += size + gap;
+  }
+}
+
+static void arrange_root(struct osf_layout *layout) {
+  if (layout->root) {
+    arrange_node(layout, layout->root, usable_area(layout));
+  }
+}
+
+/* ============================================================================
+ * Layout kinds
+ *
+ * insert and remove return the node to arrange again and its box, or NULL
+ * when the whole tree needs it.
+ * ============================================================================
+ */
+
+/* Master/stack: root splits horizontally into a master container and, once
+ * the master is full, a stack container */
+static struct osf_layout_node *
+master_stack_insert(struct osf_layout *layout, struct osf_layout_node *leaf) {
+  if (!layout->root) {
+    struct osf_layout_node *root = node_create(NULL, OSF_SPLIT_HORIZONTAL);
+    struct osf_layout_node *master = node_create(NULL, OSF_SPLIT_VERTICAL);
+    root->ratio = layout->config.master_ratio;
+    node_append_child(root, master);
+    node_append_child(master, leaf);
+    layout->root = root;
+    return NULL;
+  }
+
+  struct osf_layout_node *root = layout->root;
+  struct osf_layout_node *master = root->children[0];
+  int master_count =
+      layout->config.master_count > 0 ? layout->config.master_count : 1;
+  if ((int)master->child_count < master_count) {
+    node_insert_child(master, insert_index(layout, master), leaf);
+    return master;
+  }
+
+  if (root->child_count < 2) {
+    struct osf_layout_node *stack = node_create(NULL, OSF_SPLIT_VERTICAL);
+    node_append_child(root, stack);
+    node_append_child(stack, leaf);
+    return root;
+  }
+
+  struct osf_layout_node *stack = root->children[1];
+  node_insert_child(stack, insert_index(layout, stack), leaf);
+  return stack;
+}
+
+static struct osf_layout_node *
+master_stack_remove(struct osf_layout *layout, struct osf_layout_node *leaf) {
+  struct osf_layout_node *root = layout->root;
+  struct osf_layout_node *master = root->children[0];
+  struct osf_layout_node *stack =
+      root->child_count > 1 ? root->children[1] : NULL;
+  struct osf_layout_node *container = leaf->parent;
+  struct osf_layout_node *dirty = container;
+
+  node_remove_child(container, leaf);
+
+  /* The first stacked window fills the master's place */
+  if (container == master && stack) {
+    struct osf_layout_node *promoted = stack->children[0];
+    node_remove_child(stack, promoted);
+    node_append_child(master, promoted);
+    dirty = root;
+  }
+
+  if (stack && stack->child_count == 0) {
+    node_remove_child(root, stack);
+    node_free(stack);
+    dirty = root;
+  }
+
+  if (master->child_count == 0) {
+    node_destroy_tree(root);
+    layout->root = NULL;
+    return NULL;
+  }
+  return dirty;
+}
+
+/* Columns: one horizontal container */
+static struct osf_layout_node *columns_insert(struct osf_layout *layout,
+                                              struct osf_layout_node *leaf) {
+  if (!layout->root) {
+    layout->root = node_create(NULL, OSF_SPLIT_HORIZONTAL);
+    node_append_child(layout->root, leaf);
+    return NULL;
+  }
+  node_insert_child(layout->root, insert_index(layout, layout->root), leaf);
+  return layout->root;
+}
+
+static struct osf_layout_node *columns_remove(struct osf_layout *layout,
+                                              struct osf_layout_node *leaf) {
+  node_remove_child(layout->root, leaf);
+  if (layout->root->child_count == 0) {
+    node_destroy_tree(layout->root);
+    layout->root = NULL;
+    return NULL;
+  }
+  return layout->root;
+}
+
+/* Dwindle: a binary tree; a new window halves the focused one along its
+ * longer side */
+static struct osf_layout_node *dwindle_insert(struct osf_layout *layout,
+                                              struct osf_layout_node *leaf) {
+  if (!layout->root) {
+    layout->root = leaf;
+    return NULL;
+  }
+
+  struct osf_layout_node *target =
+      layout->focused ? layout->focused : last_leaf(layout->root);
+  struct osf_layout_node *split = node_create(
+      NULL, target->rect.width >= target->rect.height ? OSF_SPLIT_HORIZONTAL
+                                                      : OSF_SPLIT_VERTICAL);
+  split->rect = target->rect;
+  node_replace(layout, target, split);
+  node_append_child(split, target);
+  node_append_child(split, leaf);
+  return split;
+}
+
+static struct osf_layout_node *
+dwindle_remove(struct osf_layout *layout, struct osf_layout_node *leaf,
+               struct osf_layout_rect *rect) {
+  struct osf_layout_node *parent = leaf->parent;
+  if (!parent) {
+    layout->root = NULL;
+    return NULL;
+  }
+
+  /* The sibling takes over the parent's box */
+  node_remove_child(parent, leaf);
+  struct osf_layout_node *sibling = parent->children[0];
+  *rect = parent->rect;
+  node_replace(layout, parent, sibling);
+  node_free(parent);
+  return sibling;
+}
+
+static struct osf_layout_node *insert_leaf(struct osf_layout *layout,
+                                           struct osf_layout_node *leaf) {
+  switch (layout->kind) {
+  case OSF_LAYOUT_DWINDLE:
+    return dwindle_insert(layout, leaf);
+  case OSF_LAYOUT_COLUMNS:
+    return columns_insert(layout, leaf);
+  case OSF_LAYOUT_MASTER_STACK:
+  default:
+    return master_stack_insert(layout, leaf);
+  }
+}
+
+/* Arrange `dirty` within its (possibly new) box, or everything */
+static void arrange_dirty(struct osf_layout *layout,
+                          struct osf_layout_node *dirty,
+                          struct osf_layout_rect rect) {
+  if (dirty) {
+    arrange_node(layout, dirty, rect);
+  } else {
+    arrange_root(layout);
+  }
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+struct osf_layout *osf_layout_create(enum osf_layout_kind kind,
+                                     const struct osf_layout_config *config,
+                                     struct osf_layout_rect area) {
+  struct osf_layout *layout = calloc(1, sizeof(*layout));
+  if (!layout) {
+    return NULL;
+  }
+  layout->kind = kind;
+  layout->config = *config;
+  layout->area = area;
+  return layout;
+}
+
+void osf_layout_destroy(struct osf_layout *layout) {
+  if (!layout) {
+    return;
+  }
+  if (layout->root) {
+    node_destroy_tree(layout->root);
+  }
+  free(layout->deltas);
+  free(layout);
+}
+
+struct osf_layout_node *osf_layout_insert(struct osf_layout *layout,
+                                          void *window) {
+  layout->delta_count = 0;
+  struct osf_layout_node *leaf = node_create(window, OSF_SPLIT_HORIZONTAL);
+  if (!leaf) {
+    return NULL;
+  }
+
+  struct osf_layout_node *dirty = insert_leaf(layout, leaf);
+  arrange_dirty(layout, dirty, dirty ? dirty->rect : usable_area(layout));
+  layout->window_count++;
+  return leaf;
+}
+
+void osf_layout_remove(struct osf_layout *layout,
+                       struct osf_layout_node *leaf) {
+  layout->delta_count = 0;
+  if (layout->focused == leaf) {
+    layout->focused = NULL;
+  }
+
+  struct osf_layout_node *dirty;
+  struct osf_layout_rect rect = {0, 0, 0, 0};
+  switch (layout->kind) {
+  case OSF_LAYOUT_DWINDLE:
+    dirty = dwindle_remove(layout, leaf, &rect);
+    break;
+  case OSF_LAYOUT_COLUMNS:
+    dirty = columns_remove(layout, leaf);
+    break;
+  case OSF_LAYOUT_MASTER_STACK:
+  default:
+    dirty = master_stack_remove(layout, leaf);
+    break;
+  }
+  if (dirty && layout->kind != OSF_LAYOUT_DWINDLE) {
+    rect = dirty->rect;
+  }
+  if (dirty) {
+    arrange_node(layout, dirty, rect);
+  }
+
+  layout->window_count--;
+  node_free(leaf);
+}
+
+void osf_layout_focus(struct osf_layout *layout,
+                      struct osf_layout_node *leaf) {
+  layout->delta_count = 0;
+  layout->focused = leaf;
+}
+
+void osf_layout_set_area(struct osf_layout *layout,
+                         struct osf_layout_rect area) {
+  layout->delta_count = 0;
+  layout->area = area;
+  arrange_root(layout);
+}
+
+static void collect_leaves(struct osf_layout_node *node,
+                           struct osf_layout_node **leaves, size_t *count) {
+  if (node->window) {
+    leaves[(*count)++] = node;
+    return;
+  }
+  for (size_t i = 0; i < node->child_count; i++) {
+    collect_leaves(node->children[i], leaves, count);
+  }
+}
+
+/* Frees the containers, leaving the leaves detached */
+static void free_containers(struct osf_layout_node *node) {
+  if (node->window) {
+    node->parent = NULL;
+    return;
+  }
+  for (size_t i = 0; i < node->child_count; i++) {
+    free_containers(node->children[i]);
+  }
+  node_free(node);
+}
+
+static void rebuild(struct osf_layout *layout) {
+  layout->delta_count = 0;
+  if (!layout->root) {
+    return;
+  }
+
+  /* Rebuild from the same leaves in order; their old boxes are kept aside
+   * so only real changes are reported */
+  size_t count = 0;
+  struct osf_layout_node **leaves =
+      malloc(layout->window_count * sizeof(*leaves));
+  struct osf_layout_rect *before =
+      malloc(layout->window_count * sizeof(*before));
+  if (!leaves || !before) {
+    free(leaves);
+    free(before);
+    return;
+  }
+  collect_leaves(layout->root, leaves, &count);
+  for (size_t i = 0; i < count; i++) {
+    before[i] = leaves[i]->rect;
+  }
+  free_containers(layout->root);
+  layout->root = NULL;
+
+  struct osf_layout_node *focused = layout->focused;
+  for (size_t i = 0; i < count; i++) {
+    /* Each window splits the previous one, as if opened in order */
+    layout->focused = i ? leaves[i - 1] : NULL;
+    struct osf_layout_node *dirty = insert_leaf(layout, leaves[i]);
+    arrange_dirty(layout, dirty, dirty ? dirty->rect : usable_area(layout));
+  }
+  layout->focused = focused;
+
+  layout->delta_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!rect_equal(before[i], leaves[i]->rect)) {
+      push_delta(layout, leaves[i]->window, leaves[i]->rect);
+    }
+  }
+  free(leaves);
+  free(before);
+}
+
+void osf_layout_set_config(struct osf_layout *layout,
+                           const struct osf_layout_config *config) {
+  bool restructure = layout->kind == OSF_LAYOUT_MASTER_STACK &&
+                     config->master_count != layout->config.master_count;
+  layout->config = *config;
+  if (restructure) {
+    rebuild(layout);
+    return;
+  }
+
+  layout->delta_count = 0;
+  if (layout->kind == OSF_LAYOUT_MASTER_STACK && layout->root) {
+    layout->root->ratio = config->master_ratio;
+  }
+  arrange_root(layout);
+}
+
+void osf_layout_set_kind(struct osf_layout *layout,
+                         enum osf_layout_kind kind) {
+  if (layout->kind == kind) {
+    layout->delta_count = 0;
+    return;
+  }
+  layout->kind = kind;
+  rebuild(layout);
+}
+
+void osf_layout_arrange(struct osf_layout *layout) {
+  layout->delta_count = 0;
+  arrange_root(layout);
+}
+
+const char *osf_layout_kind_name(enum osf_layout_kind kind) {
+  switch (kind) {
+  case OSF_LAYOUT_MASTER_STACK:
+    return "master/stack";
+  case OSF_LAYOUT_DWINDLE:
+    return "dwindle";
+  case OSF_LAYOUT_COLUMNS:
+    return "columns";
+  default:
+    return "unknown";
+  }
+}
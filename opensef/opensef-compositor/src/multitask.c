@@ -3,9 +3,13 @@
  */
 
 #include "server.h"
+#include "animation.h"
+#include "visibility.h"
+#include <math.h>
 #include <stdlib.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/util/log.h>
 
 void osf_multitask_init(struct osf_server *server) {
@@ -13,21 +17,32 @@ void osf_multitask_init(struct osf_server *server) {
   server->multitask->server = server;
   server->multitask->scene_tree = wlr_scene_tree_create(&server->scene->tree);
   wlr_scene_node_set_enabled(&server->multitask->scene_tree->node, false);
+
+  /* Backdrop dimming the desktop behind the windows, faded by anim_progress */
+  float clear[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  server->multitask->overlay =
+      wlr_scene_rect_create(server->layer_bottom, 0, 0, clear);
+  wlr_scene_node_set_enabled(&server->multitask->overlay->node, false);
 }
 
 void osf_multitask_toggle(struct osf_server *server) {
   struct osf_multitask *mt = server->multitask;
   mt->active = !mt->active;
   wlr_scene_node_set_enabled(&mt->scene_tree->node, mt->active);
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
+  osf_animation_overview(server, mt->active);
 
   if (mt->active) {
     wlr_log(WLR_INFO, "Multitask View activated");
     // Save current states and move to grid
     struct osf_view *view;
     wl_list_for_each(view, &server->views, link) {
-      if (view->mapped) {
-        view->saved_x = view->scene_tree->node.x;
-        view->saved_y = view->scene_tree->node.y;
+      if (view->mapped && view->workspace == server->active_workspace) {
+        int x, y;
+        osf_animation_view_position(view, &x, &y);
+        view->saved_x = x;
+        view->saved_y = y;
         view->saved_w = view->xdg_toplevel->current.width;
         view->saved_h = view->xdg_toplevel->current.height;
       }
@@ -36,13 +51,17 @@ void osf_multitask_toggle(struct osf_server *server) {
   } else {
     wlr_log(WLR_INFO, "Multitask View deactivated");
     // Restore windows
+    struct osf_transaction *txn = osf_transaction_begin(server);
     struct osf_view *view;
     wl_list_for_each(view, &server->views, link) {
-      if (view->mapped) {
-        wlr_scene_node_set_position(&view->scene_tree->node, view->saved_x,
-                                    view->saved_y);
+      if (view->mapped && view->workspace == server->active_workspace) {
+        osf_animation_view_set_scale(view, 1.0f);
+        osf_transaction_set_geometry(txn, view, view->saved_x, view->saved_y,
+                                     0, 0, view->content_tree->node.x,
+                                     view->content_tree->node.y);
       }
     }
+    osf_transaction_commit(txn);
   }
 }
 
@@ -55,7 +74,7 @@ void osf_multitask_update(struct osf_server *server) {
   int count = 0;
   struct osf_view *view;
   wl_list_for_each(view, &server->views, link) {
-    if (view->mapped)
+    if (view->mapped && view->workspace == server->active_workspace)
       count++;
   }
   if (count == 0)
@@ -75,8 +94,9 @@ void osf_multitask_update(struct osf_server *server) {
   int slot_w = (box.width - padding * (cols + 1)) / cols;
   int slot_h = (box.height - padding * (rows + 1)) / rows;
 
+  struct osf_transaction *txn = osf_transaction_begin(server);
   wl_list_for_each(view, &server->views, link) {
-    if (!view->mapped)
+    if (!view->mapped || view->workspace != server->active_workspace)
       continue;
 
     int r = i / cols;
@@ -84,8 +104,25 @@ void osf_multitask_update(struct osf_server *server) {
     int x = box.x + padding + c * (slot_w + padding);
     int y = box.y + padding + r * (slot_h + padding);
 
-    wlr_scene_node_set_position(&view->scene_tree->node, x, y);
-    // TODO: Apply scene node scaling once verified
+    // Shrink the window to fit its slot and center it there
+    struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+    float scale = 1.0f;
+    if (geo.width > 0 && geo.height > 0 && slot_w > 0 && slot_h > 0) {
+      scale = fminf(1.0f, fminf((float)slot_w / geo.width,
+                                (float)slot_h / geo.height));
+    }
+    int shown_w = (int)lroundf(geo.width * scale);
+    int shown_h = (int)lroundf(geo.height * scale);
+    x += (slot_w - shown_w) / 2 - (int)lroundf(geo.x * scale) -
+         view->content_tree->node.x;
+    y += (slot_h - shown_h) / 2 - (int)lroundf(geo.y * scale) -
+         view->content_tree->node.y;
+
+    osf_animation_view_set_scale(view, scale);
+    osf_transaction_set_geometry(txn, view, x, y, 0, 0,
+                                 view->content_tree->node.x,
+                                 view->content_tree->node.y);
     i++;
   }
+  osf_transaction_commit(txn);
 }
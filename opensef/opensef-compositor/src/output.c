@@ -5,6 +5,10 @@
  */
 
 #include "server.h"
+#include "animation.h"
+#include "latency.h"
+#include "tiling.h"
+#include "visibility.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -13,8 +17,20 @@
 #include <wlr/backend/wayland.h>
 #include <wlr/backend/x11.h>
 #include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
+#include <wlr/version.h>
+
+/* Whether a commit will show new damage, for latency tracing */
+static bool scene_output_damaged(struct wlr_scene_output *scene_output) {
+#if WLR_VERSION_NUM >= ((0 << 16) | (18 << 8) | 0)
+  return wlr_scene_output_needs_frame(scene_output);
+#else
+  (void)scene_output;
+  return true;
+#endif
+}
 
 static void output_frame(struct wl_listener *listener, void *data) {
   struct osf_output *output = wl_container_of(listener, output, frame);
@@ -22,14 +38,30 @@ static void output_frame(struct wl_listener *listener, void *data) {
 
   (void)data;
 
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  /* Animations step on the output's clock, never waiting for clients */
+  osf_animation_tick(output->server,
+                     now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0);
+
+  /* Before rendering, so views uncovered by this frame get its callback */
+  osf_visibility_update(output->server);
+
+  /* Motion held on the hit-cached surface, against the scene about to be
+   * shown */
+  osf_cursor_output_frame(output->server);
+
   /* Render the scene */
+  bool damaged = scene_output_damaged(scene_output);
   if (!wlr_scene_output_commit(scene_output, NULL)) {
     wlr_log(WLR_ERROR, "Failed to commit scene output frame");
+    damaged = false;
   }
+  osf_latency_output_commit(output->server, damaged);
 
-  struct timespec now;
   clock_gettime(CLOCK_MONOTONIC, &now);
-  wlr_scene_output_send_frame_done(scene_output, &now);
+  osf_visibility_send_frame_done(output, &now);
 }
 
 static void output_request_state(struct wl_listener *listener, void *data) {
@@ -37,6 +69,9 @@ static void output_request_state(struct wl_listener *listener, void *data) {
   const struct wlr_output_event_request_state *event = data;
 
   wlr_output_commit_state(output->wlr_output, event->state);
+  osf_tiling_arrange(output->server, output);
+  osf_visibility_mark_dirty(output->server);
+  osf_cursor_invalidate_hit(output->server);
 }
 
 static void output_destroy(struct wl_listener *listener, void *data) {
@@ -46,6 +81,9 @@ static void output_destroy(struct wl_listener *listener, void *data) {
 
   wlr_log(WLR_INFO, "Output '%s' disconnected", output->wlr_output->name);
 
+  osf_tiling_output_destroy(output);
+  osf_visibility_output_destroy(output);
+
   wl_list_remove(&output->frame.link);
   wl_list_remove(&output->request_state.link);
   wl_list_remove(&output->destroy.link);
@@ -53,6 +91,21 @@ static void output_destroy(struct wl_listener *listener, void *data) {
   free(output);
 }
 
+struct osf_output *osf_output_at_cursor(struct osf_server *server) {
+  struct wlr_output *wlr_output = wlr_output_layout_output_at(
+      server->output_layout, server->cursor->x, server->cursor->y);
+  struct osf_output *output;
+  wl_list_for_each(output, &server->outputs, link) {
+    if (output->wlr_output == wlr_output) {
+      return output;
+    }
+  }
+  /* Cursor between outputs: fall back to the primary one */
+  return wl_list_empty(&server->outputs)
+             ? NULL
+             : wl_container_of(server->outputs.next, output, link);
+}
+
 void osf_new_output(struct wl_listener *listener, void *data) {
   struct osf_server *server = wl_container_of(listener, server, new_output);
   struct wlr_output *wlr_output = data;
@@ -134,6 +187,9 @@ void osf_new_output(struct wl_listener *listener, void *data) {
 
   /* Add to server list */
   wl_list_insert(&server->outputs, &output->link);
+  osf_tiling_output_init(output);
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
 
   wlr_log(WLR_INFO, "Output '%s' configured successfully", wlr_output->name);
 
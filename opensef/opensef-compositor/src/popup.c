@@ -3,10 +3,49 @@
  */
 
 #include "server.h"
+#include <stdlib.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/util/log.h>
 
+/* The scene shows and places popups by itself; these only tell the
+ * pointer hit cache that something appeared, moved or went away */
+struct osf_popup {
+  struct osf_server *server;
+  struct wl_listener map;
+  struct wl_listener unmap;
+  struct wl_listener reposition;
+  struct wl_listener destroy;
+};
+
+static void popup_map(struct wl_listener *listener, void *data) {
+  struct osf_popup *popup = wl_container_of(listener, popup, map);
+  (void)data;
+  osf_cursor_invalidate_hit(popup->server);
+}
+
+static void popup_unmap(struct wl_listener *listener, void *data) {
+  struct osf_popup *popup = wl_container_of(listener, popup, unmap);
+  (void)data;
+  osf_cursor_invalidate_hit(popup->server);
+}
+
+static void popup_reposition(struct wl_listener *listener, void *data) {
+  struct osf_popup *popup = wl_container_of(listener, popup, reposition);
+  (void)data;
+  osf_cursor_invalidate_hit(popup->server);
+}
+
+static void popup_destroy(struct wl_listener *listener, void *data) {
+  struct osf_popup *popup = wl_container_of(listener, popup, destroy);
+  (void)data;
+  wl_list_remove(&popup->map.link);
+  wl_list_remove(&popup->unmap.link);
+  wl_list_remove(&popup->reposition.link);
+  wl_list_remove(&popup->destroy.link);
+  free(popup);
+}
+
 void osf_new_xdg_popup(struct wl_listener *listener, void *data) {
   struct wlr_xdg_popup *xdg_popup = data;
   struct osf_server *server = wl_container_of(listener, server, new_xdg_popup);
@@ -43,5 +82,18 @@ void osf_new_xdg_popup(struct wl_listener *listener, void *data) {
       wlr_scene_xdg_surface_create(parent_tree, xdg_popup->base);
   xdg_popup->base->data = popup_tree;
 
+  struct osf_popup *popup = calloc(1, sizeof(*popup));
+  if (popup) {
+    popup->server = server;
+    popup->map.notify = popup_map;
+    wl_signal_add(&xdg_popup->base->surface->events.map, &popup->map);
+    popup->unmap.notify = popup_unmap;
+    wl_signal_add(&xdg_popup->base->surface->events.unmap, &popup->unmap);
+    popup->reposition.notify = popup_reposition;
+    wl_signal_add(&xdg_popup->events.reposition, &popup->reposition);
+    popup->destroy.notify = popup_destroy;
+    wl_signal_add(&xdg_popup->events.destroy, &popup->destroy);
+  }
+
   wlr_log(WLR_INFO, "XDG popup scene node created");
 }
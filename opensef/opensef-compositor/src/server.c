@@ -7,8 +7,14 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include "server.h"
+#include "animation.h"
+#include "capture.h"
+#include "latency.h"
 #include "multitask.h"
+#include "thumbnail.h"
 #include "tiling.h"
+#include "visibility.h"
+#include "workspace.h"
 
 #ifndef _POSIX_C_SOURCE
 #define _POSIX_C_SOURCE 200809L
@@ -37,6 +43,7 @@
 #include <wlr/types/wlr_xdg_decoration_v1.h>
 #include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/util/log.h>
+#include <wlr/version.h>
 
 /* Forward declarations for handlers defined in other files */
 extern void osf_new_output(struct wl_listener *listener, void *data);
@@ -91,6 +98,12 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
     /* X11 window mode */
     wlr_log(WLR_INFO, "Using X11 backend (nested mode)");
     setenv("WLR_BACKENDS", "x11", 1);
+  } else if (backend_type && strcmp(backend_type, "headless") == 0) {
+    /* No display at all: capture and visual tests (see capture.h) */
+    wlr_log(WLR_INFO, "Using headless backend");
+    setenv("WLR_BACKENDS", "headless", 1);
+    setenv("WLR_LIBINPUT_NO_DEVICES", "1", 0);
+    setenv("WLR_HEADLESS_OUTPUTS", "1", 0);
   }
 
   /* wlroots 0.18 signature (Confirmed by build error) */
@@ -147,6 +160,11 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   server->layer_top = wlr_scene_tree_create(&server->scene->tree);
   server->layer_overlay = wlr_scene_tree_create(&server->scene->tree);
 
+  /* Workspaces: subtrees of layer_views */
+  osf_workspace_init(server);
+  osf_visibility_init(server);
+  osf_animation_init(server);
+
   /* Initialize lists */
   wl_list_init(&server->outputs);
   wl_list_init(&server->views);
@@ -157,8 +175,12 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   server->new_output.notify = osf_new_output;
   wl_signal_add(&server->backend->events.new_output, &server->new_output);
 
-  /* XDG shell for windows */
+  /* XDG shell for windows (v6 adds the suspended state) */
+#if WLR_VERSION_NUM >= ((0 << 16) | (18 << 8) | 0)
+  server->xdg_shell = wlr_xdg_shell_create(server->wl_display, 6);
+#else
   server->xdg_shell = wlr_xdg_shell_create(server->wl_display, 3);
+#endif
   server->new_xdg_toplevel.notify = osf_new_xdg_toplevel;
   wl_signal_add(&server->xdg_shell->events.new_toplevel,
                 &server->new_xdg_toplevel);
@@ -176,6 +198,7 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   wlr_cursor_attach_output_layout(server->cursor, server->output_layout);
 
   server->cursor_mgr = wlr_xcursor_manager_create(NULL, 24);
+  osf_cursor_hit_init(server);
 
   server->cursor_motion.notify = osf_cursor_motion;
   wl_signal_add(&server->cursor->events.motion, &server->cursor_motion);
@@ -199,6 +222,7 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   server->request_set_selection.notify = osf_seat_request_set_selection;
   wl_signal_add(&server->seat->events.request_set_selection,
                 &server->request_set_selection);
+  osf_virtual_input_init(server);
 
   /* Decorations - prefer server-side */
   server->xdg_decoration_mgr =
@@ -212,6 +236,9 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   wlr_server_decoration_manager_set_default_mode(
       server->server_decoration_mgr, WLR_SERVER_DECORATION_MANAGER_MODE_SERVER);
 
+  /* Screen capture for remote support and visual tests */
+  osf_capture_init(server);
+
   /* Add socket - use explicit name if provided, otherwise auto */
   if (socket_name && socket_name[0] != '\0') {
     if (wl_display_add_socket(server->wl_display, socket_name) != 0) {
@@ -249,6 +276,12 @@ bool osf_server_init(struct osf_server *server, const char *socket_name) {
   /* Tiling Engine */
   osf_tiling_init(server);
 
+  /* Live window thumbnails */
+  osf_thumbnail_init(server);
+
+  /* Input latency tracing (VITUS_LATENCY_TRACE=1) */
+  osf_latency_init(server);
+
   return true;
 
 error_backend:
@@ -267,6 +300,13 @@ void osf_server_finish(struct osf_server *server) {
   wlr_log(WLR_INFO, "Shutting down compositor...");
 
   wl_display_destroy_clients(server->wl_display);
+  osf_cursor_hit_finish(server);
+  osf_latency_finish(server);
+  osf_capture_finish(server);
+  osf_thumbnail_finish(server);
+  osf_animation_finish(server);
+  osf_visibility_finish(server);
+  osf_workspace_finish(server);
 
   wlr_scene_node_destroy(&server->scene->tree.node);
   wlr_xcursor_manager_destroy(server->cursor_mgr);
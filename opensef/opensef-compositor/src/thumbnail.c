@@ -0,0 +1,467 @@
+/**
+ * thumbnail.c - Live Window Thumbnails
+ *
+ * The snapshot covers the toplevel surface and its subsurfaces, cropped to
+ * the window geometry; popups are left out. Damage is taken from the
+ * toplevel's commits, which also carry synchronized subsurface updates.
+ *
+ * The memfds reach the shell through zvitus_thumbnail_manager_v1, so the
+ * fd rides on the Wayland socket (SCM_RIGHTS) to clients that bind it.
+ */
+
+#define _GNU_SOURCE /* memfd_create */
+
+#include "thumbnail.h"
+#include "vitus-thumbnail-unstable-v1-protocol.h"
+
+#include <drm_fourcc.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <opensef/OSFThumbnail.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <wlr/render/drm_format_set.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/util/log.h>
+#include <wlr/version.h>
+
+/* Render passes and texture read-back arrived with wlroots 0.18 */
+#if WLR_VERSION_NUM >= ((0 << 16) | (18 << 8) | 0)
+#define OSF_HAVE_RENDER_PASS 1
+#include <wlr/render/pass.h>
+#endif
+
+struct osf_thumbnail {
+  struct osf_view *view;
+  int fd;
+  void *map; /* OSF_THUMBNAIL_FILE_SIZE bytes */
+  char id[32]; /* "window-0x...", as announced to the shell */
+  bool dirty;
+  double last_ms; /* Last snapshot */
+  struct wlr_buffer *target; /* Render target at snapshot size */
+};
+
+static OSFThumbnailHeader *header(struct osf_thumbnail *thumb) {
+  return thumb->map;
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static bool enabled(struct osf_server *server) {
+  return server->thumbnail_ms > 0 && server->thumbnail_global;
+}
+
+/* ============================================================================
+ * Snapshot
+ * ============================================================================
+ */
+
+#ifdef OSF_HAVE_RENDER_PASS
+struct render_iter {
+  struct wlr_render_pass *pass;
+  struct wlr_box geo;
+  double scale;
+};
+
+static void render_surface(struct wlr_surface *surface, int sx, int sy,
+                           void *data) {
+  struct render_iter *iter = data;
+  struct wlr_texture *texture = wlr_surface_get_texture(surface);
+  if (!texture) {
+    return;
+  }
+
+  struct wlr_box dst = {
+      .x = (int)floor((sx - iter->geo.x) * iter->scale),
+      .y = (int)floor((sy - iter->geo.y) * iter->scale),
+      .width = (int)ceil(surface->current.width * iter->scale),
+      .height = (int)ceil(surface->current.height * iter->scale),
+  };
+  wlr_render_pass_add_texture(
+      iter->pass, &(struct wlr_render_texture_options){
+                      .texture = texture,
+                      .dst_box = dst,
+                      .transform = wlr_output_transform_invert(
+                          surface->current.transform),
+                      .filter_mode = WLR_SCALE_FILTER_BILINEAR,
+                      .blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED,
+                  });
+}
+
+static bool ensure_target(struct osf_thumbnail *thumb, int width,
+                          int height) {
+  if (thumb->target && thumb->target->width == width &&
+      thumb->target->height == height) {
+    return true;
+  }
+  wlr_buffer_drop(thumb->target);
+
+  /* Linear so every renderer can read it back */
+  struct wlr_drm_format format = {0};
+  format.format = DRM_FORMAT_ARGB8888;
+  wlr_drm_format_add(&format, DRM_FORMAT_MOD_LINEAR);
+  thumb->target = wlr_allocator_create_buffer(thumb->view->server->allocator,
+                                              width, height, &format);
+  wlr_drm_format_finish(&format);
+  return thumb->target != NULL;
+}
+
+/* Render the window scaled into `slot` of the memfd; false leaves the
+ * front slot as it was */
+static bool render_snapshot(struct osf_thumbnail *thumb, uint32_t slot,
+                            int *out_width, int *out_height) {
+  struct osf_view *view = thumb->view;
+  struct osf_server *server = view->server;
+  struct wlr_surface *surface = view->xdg_toplevel->base->surface;
+
+  struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+  if (geo.width <= 0 || geo.height <= 0) {
+    geo = (struct wlr_box){0, 0, surface->current.width,
+                           surface->current.height};
+  }
+  if (geo.width <= 0 || geo.height <= 0) {
+    return false;
+  }
+
+  double scale = fmin(1.0, fmin((double)OSF_THUMBNAIL_MAX_WIDTH / geo.width,
+                                (double)OSF_THUMBNAIL_MAX_HEIGHT / geo.height));
+  int width = (int)fmax(1.0, floor(geo.width * scale));
+  int height = (int)fmax(1.0, floor(geo.height * scale));
+  if (!ensure_target(thumb, width, height)) {
+    wlr_log(WLR_ERROR, "Thumbnail: cannot allocate a %dx%d buffer", width,
+            height);
+    return false;
+  }
+
+  struct wlr_render_pass *pass =
+      wlr_renderer_begin_buffer_pass(server->renderer, thumb->target, NULL);
+  if (!pass) {
+    return false;
+  }
+  wlr_render_pass_add_rect(pass, &(struct wlr_render_rect_options){
+                                     .box = {0, 0, width, height},
+                                     .color = {0, 0, 0, 0},
+                                     .blend_mode = WLR_RENDER_BLEND_MODE_NONE,
+                                 });
+  struct render_iter iter = {pass, geo, scale};
+  wlr_surface_for_each_surface(surface, render_surface, &iter);
+  if (!wlr_render_pass_submit(pass)) {
+    return false;
+  }
+
+  /* Only the downscaled pixels cross back to the CPU, straight into the
+   * shared slot */
+  struct wlr_texture *texture =
+      wlr_texture_from_buffer(server->renderer, thumb->target);
+  if (!texture) {
+    return false;
+  }
+  bool ok = wlr_texture_read_pixels(
+      texture, &(struct wlr_texture_read_pixels_options){
+                   .data = (char *)thumb->map + osf_thumbnail_slot_offset(slot),
+                   .format = DRM_FORMAT_ARGB8888,
+                   .stride = OSF_THUMBNAIL_STRIDE,
+                   .src_box = {0, 0, width, height},
+               });
+  wlr_texture_destroy(texture);
+
+  *out_width = width;
+  *out_height = height;
+  return ok;
+}
+#else
+static bool render_snapshot(struct osf_thumbnail *thumb, uint32_t slot,
+                            int *out_width, int *out_height) {
+  (void)thumb;
+  (void)slot;
+  (void)out_width;
+  (void)out_height;
+  return false;
+}
+#endif
+
+static void copy_labels(struct osf_thumbnail *thumb) {
+  struct wlr_xdg_toplevel *toplevel = thumb->view->xdg_toplevel;
+  OSFThumbnailHeader *hdr = header(thumb);
+  snprintf(hdr->title, sizeof(hdr->title), "%s",
+           toplevel->title ? toplevel->title : "");
+  snprintf(hdr->app_id, sizeof(hdr->app_id), "%s",
+           toplevel->app_id ? toplevel->app_id : "");
+}
+
+static void snapshot(struct osf_thumbnail *thumb, double now) {
+  OSFThumbnailHeader *hdr = header(thumb);
+  uint32_t back = hdr->front ^ 1;
+  uint32_t sequence = hdr->sequence;
+
+  thumb->dirty = false;
+  thumb->last_ms = now;
+
+  /* Seqlock: odd while writing, so a reader that copied across this
+   * window (e.g. after being descheduled for a whole interval) retries */
+  __atomic_store_n(&hdr->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  int width, height;
+  if (render_snapshot(thumb, back, &width, &height)) {
+    copy_labels(thumb);
+    hdr->slots[back].width = width;
+    hdr->slots[back].height = height;
+    hdr->front = back;
+  }
+
+  __atomic_store_n(&hdr->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/* ============================================================================
+ * Scheduling
+ * ============================================================================
+ */
+
+/* Wake up when the first dirty thumbnail may be redone */
+static void schedule(struct osf_server *server, double now) {
+  double next = -1;
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    struct osf_thumbnail *thumb = view->thumbnail;
+    if (thumb && thumb->dirty) {
+      double due = thumb->last_ms + server->thumbnail_ms;
+      if (next < 0 || due < next) {
+        next = due;
+      }
+    }
+  }
+  if (next >= 0) {
+    wl_event_source_timer_update(server->thumbnail_timer,
+                                 (int)fmax(1.0, ceil(next - now)));
+  }
+}
+
+static int thumbnail_timer_callback(void *data) {
+  struct osf_server *server = data;
+  double now = now_ms();
+
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    struct osf_thumbnail *thumb = view->thumbnail;
+    if (thumb && thumb->dirty &&
+        now - thumb->last_ms >= server->thumbnail_ms) {
+      snapshot(thumb, now);
+    }
+  }
+
+  schedule(server, now);
+  return 0;
+}
+
+void osf_thumbnail_view_commit(struct osf_view *view) {
+  struct osf_thumbnail *thumb = view->thumbnail;
+  struct wlr_surface *surface = view->xdg_toplevel->base->surface;
+  if (!thumb || thumb->dirty ||
+      !pixman_region32_not_empty(&surface->buffer_damage)) {
+    return;
+  }
+  thumb->dirty = true;
+  schedule(view->server, now_ms());
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================
+ */
+
+static void announce(struct osf_thumbnail *thumb,
+                     struct wl_resource *resource) {
+  zvitus_thumbnail_manager_v1_send_window(resource, thumb->id, thumb->fd,
+                                          OSF_THUMBNAIL_FILE_SIZE);
+}
+
+static void thumbnail_destroy(struct osf_thumbnail *thumb) {
+  if (thumb->map) {
+    munmap(thumb->map, OSF_THUMBNAIL_FILE_SIZE);
+  }
+  if (thumb->fd >= 0) {
+    close(thumb->fd);
+  }
+  wlr_buffer_drop(thumb->target);
+  free(thumb);
+}
+
+/* The shell gets the memfd read-only: no resizing, and (where the kernel
+ * has it) no writable mapping or write() beyond the one we already hold */
+static bool seal(int fd) {
+  int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+#ifdef F_SEAL_FUTURE_WRITE
+  if (fcntl(fd, F_ADD_SEALS, seals | F_SEAL_FUTURE_WRITE) == 0) {
+    return true;
+  }
+#endif
+  return fcntl(fd, F_ADD_SEALS, seals) == 0;
+}
+
+void osf_thumbnail_view_map(struct osf_view *view) {
+  struct osf_server *server = view->server;
+  const char *app_id = view->xdg_toplevel->app_id;
+  if (!enabled(server) || view->thumbnail ||
+      (app_id && strcmp(app_id, "vitusos.shell") == 0)) {
+    return;
+  }
+
+  struct osf_thumbnail *thumb = calloc(1, sizeof(*thumb));
+  if (!thumb) {
+    return;
+  }
+  thumb->view = view;
+  snprintf(thumb->id, sizeof(thumb->id), "window-%p", (void *)view);
+  thumb->fd = memfd_create("vitus-thumbnail", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (thumb->fd < 0 || ftruncate(thumb->fd, OSF_THUMBNAIL_FILE_SIZE) < 0) {
+    wlr_log(WLR_ERROR, "Thumbnail: memfd: %s", strerror(errno));
+    thumbnail_destroy(thumb);
+    return;
+  }
+  thumb->map = mmap(NULL, OSF_THUMBNAIL_FILE_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, thumb->fd, 0);
+  if (thumb->map == MAP_FAILED) {
+    wlr_log(WLR_ERROR, "Thumbnail: mmap: %s", strerror(errno));
+    thumb->map = NULL;
+    thumbnail_destroy(thumb);
+    return;
+  }
+  if (!seal(thumb->fd)) {
+    wlr_log(WLR_ERROR, "Thumbnail: seal: %s", strerror(errno));
+    thumbnail_destroy(thumb);
+    return;
+  }
+
+  OSFThumbnailHeader *hdr = header(thumb);
+  hdr->magic = OSF_THUMBNAIL_MAGIC;
+  hdr->version = OSF_THUMBNAIL_VERSION;
+  hdr->stride = OSF_THUMBNAIL_STRIDE;
+  hdr->format = DRM_FORMAT_ARGB8888;
+  copy_labels(thumb);
+
+  view->thumbnail = thumb;
+  thumb->dirty = true;
+  thumb->last_ms = -server->thumbnail_ms;
+  schedule(server, now_ms());
+
+  struct wl_resource *resource;
+  wl_resource_for_each(resource, &server->thumbnail_resources) {
+    announce(thumb, resource);
+  }
+}
+
+void osf_thumbnail_view_unmap(struct osf_view *view) {
+  struct osf_thumbnail *thumb = view->thumbnail;
+  if (!thumb) {
+    return;
+  }
+  struct wl_resource *resource;
+  wl_resource_for_each(resource, &view->server->thumbnail_resources) {
+    zvitus_thumbnail_manager_v1_send_closed(resource, thumb->id);
+  }
+  thumbnail_destroy(thumb);
+  view->thumbnail = NULL;
+}
+
+/* ============================================================================
+ * Protocol
+ * ============================================================================
+ */
+
+static void manager_handle_destroy(struct wl_client *client,
+                                   struct wl_resource *resource) {
+  (void)client;
+  wl_resource_destroy(resource);
+}
+
+static const struct zvitus_thumbnail_manager_v1_interface manager_impl = {
+    .destroy = manager_handle_destroy,
+};
+
+static void handle_resource_destroy(struct wl_resource *resource) {
+  wl_list_remove(wl_resource_get_link(resource));
+}
+
+static void thumbnail_bind(struct wl_client *client, void *data,
+                           uint32_t version, uint32_t id) {
+  struct osf_server *server = data;
+  struct wl_resource *resource = wl_resource_create(
+      client, &zvitus_thumbnail_manager_v1_interface, version, id);
+  if (!resource) {
+    wl_client_post_no_memory(client);
+    return;
+  }
+  wl_resource_set_implementation(resource, &manager_impl, server,
+                                 handle_resource_destroy);
+  wl_list_insert(&server->thumbnail_resources,
+                 wl_resource_get_link(resource));
+
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    if (view->thumbnail) {
+      announce(view->thumbnail, resource);
+    }
+  }
+}
+
+void osf_thumbnail_init(struct osf_server *server) {
+  wl_list_init(&server->thumbnail_resources);
+
+  server->thumbnail_ms = OSF_THUMBNAIL_INTERVAL_MS;
+  const char *env = getenv("VITUS_THUMBNAIL_MS");
+  if (env && env[0] != '\0') {
+    server->thumbnail_ms = atoi(env) > 0 ? atoi(env) : 0;
+  }
+  if (server->thumbnail_ms == 0) {
+    wlr_log(WLR_INFO, "Window thumbnails disabled");
+    return;
+  }
+
+#ifndef OSF_HAVE_RENDER_PASS
+  wlr_log(WLR_INFO, "Window thumbnails need wlroots 0.18");
+  server->thumbnail_ms = 0;
+  return;
+#endif
+
+  server->thumbnail_global = wl_global_create(
+      server->wl_display, &zvitus_thumbnail_manager_v1_interface,
+      OSF_THUMBNAIL_MANAGER_VERSION, server, thumbnail_bind);
+  if (!server->thumbnail_global) {
+    wlr_log(WLR_ERROR, "Window thumbnails: cannot create the global");
+    server->thumbnail_ms = 0;
+    return;
+  }
+
+  struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+  server->thumbnail_timer =
+      wl_event_loop_add_timer(loop, thumbnail_timer_callback, server);
+  wlr_log(WLR_INFO, "Window thumbnails at most every %d ms",
+          server->thumbnail_ms);
+}
+
+void osf_thumbnail_finish(struct osf_server *server) {
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    osf_thumbnail_view_unmap(view);
+  }
+  if (server->thumbnail_timer) {
+    wl_event_source_remove(server->thumbnail_timer);
+    server->thumbnail_timer = NULL;
+  }
+  if (server->thumbnail_global) {
+    wl_global_destroy(server->thumbnail_global);
+    server->thumbnail_global = NULL;
+  }
+}
@@ -3,6 +3,7 @@
  */
 
 #include "tiling.h"
+#include "transaction.h"
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_xdg_shell.h>
@@ -17,74 +18,255 @@ static struct osf_tiling_config config = {
 };
 
 void osf_tiling_init(struct osf_server *server) {
+  (void)server;
   wlr_log(WLR_INFO, "Tiling engine initialized (Gaps: %d/%d)", config.inner_gap,
           config.outer_gap);
 }
 
-static void apply_view_geometry(struct osf_view *view, int x, int y, int w,
+static struct osf_layout_rect output_area(struct osf_output *output) {
+  struct wlr_box box;
+  wlr_output_layout_get_box(output->server->output_layout, output->wlr_output,
+                            &box);
+  return (struct osf_layout_rect){box.x, box.y, box.width, box.height};
+}
+
+static void apply_view_geometry(struct osf_transaction *txn,
+                                struct osf_view *view, int x, int y, int w,
                                 int h) {
   int bw = config.border_width;
-  wlr_scene_node_set_position(&view->scene_tree->node, x, y);
 
-  // Resize to fit inside borders if we implement them as rects
-  wlr_xdg_toplevel_set_size(view->xdg_toplevel, w - bw * 2, h - bw * 2);
-
-  // Offset the content to center it within the "tile"
-  wlr_scene_node_set_position(&view->content_tree->node, bw, bw);
+  // Resize to fit inside borders if we implement them as rects, offsetting
+  // the content to center it within the "tile"
+  osf_transaction_set_geometry(txn, view, x, y, w - bw * 2, h - bw * 2, bw,
+                               bw);
 }
 
-void osf_tiling_arrange(struct osf_server *server, struct osf_output *output) {
-  int view_count = 0;
+// Every window of the layout, as one transaction
+static void apply_layout(struct osf_server *server,
+                         struct osf_layout *layout) {
+  struct osf_transaction *txn = osf_transaction_begin(server);
   struct osf_view *view;
   wl_list_for_each(view, &server->views, link) {
-    if (view->mapped && !view->xdg_toplevel->current.fullscreen) {
-      view_count++;
+    if (view->tile_layout == layout) {
+      struct osf_layout_rect rect = view->tile->rect;
+      apply_view_geometry(txn, view, rect.x, rect.y, rect.width, rect.height);
+    }
+  }
+  osf_transaction_commit(txn);
+}
+
+static int layout_index(struct osf_output *output,
+                        struct osf_layout *layout) {
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    if (output->layouts[i] == layout) {
+      return i;
     }
   }
+  return -1;
+}
 
-  if (view_count == 0)
+// Send the windows the last layout operation moved, as one transaction.
+// Clients on a hidden workspace don't draw, so they would hold the
+// transaction until its deadline; their layout is applied once shown
+static void apply_deltas(struct osf_server *server, struct osf_output *output,
+                         struct osf_layout *layout) {
+  if (layout->delta_count == 0) {
     return;
+  }
+  if (layout != output->layout) {
+    int index = layout_index(output, layout);
+    if (index >= 0) {
+      output->layout_dirty[index] = true;
+    }
+    return;
+  }
+  struct osf_transaction *txn = osf_transaction_begin(server);
+  for (size_t i = 0; i < layout->delta_count; i++) {
+    struct osf_layout_delta *delta = &layout->deltas[i];
+    apply_view_geometry(txn, delta->window, delta->rect.x, delta->rect.y,
+                        delta->rect.width, delta->rect.height);
+  }
+  osf_transaction_commit(txn);
+}
 
-  struct wlr_box box;
-  wlr_output_layout_get_box(server->output_layout, output->wlr_output, &box);
+static void tile_view(struct osf_output *output, struct osf_layout *layout,
+                      struct osf_view *view) {
+  view->tile = osf_layout_insert(layout, view);
+  if (!view->tile) {
+    return;
+  }
+  view->tile_layout = layout;
+  view->tile_output = output;
+  view->is_tiled = true;
+  osf_layout_focus(layout, view->tile);
+}
+
+static void untile_view(struct osf_view *view) {
+  osf_layout_remove(view->tile_layout, view->tile);
+  view->tile = NULL;
+  view->tile_layout = NULL;
+  view->tile_output = NULL;
+  view->is_tiled = false;
+}
+
+static int active_index(struct osf_server *server) {
+  return server->active_workspace ? server->active_workspace->index : 0;
+}
+
+void osf_tiling_output_init(struct osf_output *output) {
+  struct osf_layout_config layout_config = {
+      .inner_gap = config.inner_gap,
+      .outer_gap = config.outer_gap,
+      .master_ratio = 0.6f,
+      .master_count = 1,
+  };
+  struct osf_layout_rect area = output_area(output);
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    output->layouts[i] =
+        osf_layout_create(OSF_LAYOUT_MASTER_STACK, &layout_config, area);
+  }
+  output->layout = output->layouts[active_index(output->server)];
+}
 
-  int og = config.outer_gap;
-  int ig = config.inner_gap;
+void osf_tiling_output_destroy(struct osf_output *output) {
+  struct osf_view *view;
+  wl_list_for_each(view, &output->server->views, link) {
+    if (view->tile_output == output) {
+      untile_view(view);
+    }
+  }
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    osf_layout_destroy(output->layouts[i]);
+    output->layouts[i] = NULL;
+  }
+  output->layout = NULL;
+}
 
-  box.x += og;
-  box.y += og;
-  box.width -= og * 2;
-  box.height -= og * 2;
+void osf_tiling_toggle(struct osf_server *server, struct osf_output *output) {
+  if (!output->layout) {
+    return;
+  }
+  output->tiling = !output->tiling;
 
-  if (view_count == 1) {
+  if (!output->tiling) {
+    // Windows stay where they are, now floating
+    struct osf_view *view;
     wl_list_for_each(view, &server->views, link) {
-      if (view->mapped) {
-        apply_view_geometry(view, box.x, box.y, box.width, box.height);
-        break;
+      if (view->tile_output == output) {
+        untile_view(view);
       }
     }
+    for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+      output->layout_dirty[i] = false;
+    }
+    wlr_log(WLR_INFO, "Tiling disabled on %s", output->wlr_output->name);
     return;
   }
 
-  // Master/Stack layout: Master on left (60%), Stack on right
-  int master_w = (box.width * 0.6) - (ig / 2);
-  int stack_w = box.width - master_w - ig;
-  int stack_h = (box.height - (ig * (view_count - 2))) / (view_count - 1);
-
-  int i = 0;
-  wl_list_for_each(view, &server->views, link) {
-    if (!view->mapped)
+  // Oldest first, so the focused window ends up where new ones split.
+  // Hidden workspaces are tiled too, and configured once they are shown
+  struct osf_layout_rect area = output_area(output);
+  struct osf_view *view;
+  wl_list_for_each_reverse(view, &server->views, link) {
+    struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+    int cx = view->scene_tree->node.x + geo.width / 2;
+    int cy = view->scene_tree->node.y + geo.height / 2;
+    if (!view->mapped || view->tile ||
+        view->xdg_toplevel->current.fullscreen || cx < area.x ||
+        cy < area.y || cx >= area.x + area.width ||
+        cy >= area.y + area.height) {
       continue;
+    }
+    tile_view(output, output->layouts[view->workspace->index], view);
+  }
+
+  // One transaction for the whole visible layout
+  apply_layout(server, output->layout);
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    output->layout_dirty[i] = output->layouts[i] != output->layout &&
+                              output->layouts[i]->window_count > 0;
+  }
+
+  wlr_log(WLR_INFO, "Tiling enabled on %s (%s, %zu windows)",
+          output->wlr_output->name, osf_layout_kind_name(output->layout->kind),
+          output->layout->window_count);
+}
+
+void osf_tiling_cycle_layout(struct osf_server *server,
+                             struct osf_output *output) {
+  if (!output->layout) {
+    return;
+  }
+  enum osf_layout_kind kind =
+      (output->layout->kind + 1) % OSF_LAYOUT_KIND_COUNT;
+  osf_layout_set_kind(output->layout, kind);
+  apply_deltas(server, output, output->layout);
+  wlr_log(WLR_INFO, "Tiling layout on %s: %s", output->wlr_output->name,
+          osf_layout_kind_name(kind));
+}
+
+void osf_tiling_arrange(struct osf_server *server, struct osf_output *output) {
+  if (!output->layout) {
+    return;
+  }
+  struct osf_layout_rect area = output_area(output);
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    osf_layout_set_area(output->layouts[i], area);
+    apply_deltas(server, output, output->layouts[i]);
+  }
+}
 
-    if (i == 0) {
-      // Master
-      apply_view_geometry(view, box.x, box.y, master_w, box.height);
-    } else {
-      // Stack
-      int y = box.y + (i - 1) * (stack_h + ig);
-      apply_view_geometry(view, box.x + master_w + ig, y, stack_w, stack_h);
+void osf_tiling_workspace_activated(struct osf_server *server) {
+  struct osf_output *output;
+  int index = active_index(server);
+  wl_list_for_each(output, &server->outputs, link) {
+    if (!output->layout) {
+      continue;
+    }
+    output->layout = output->layouts[index];
+    if (output->layout_dirty[index]) {
+      output->layout_dirty[index] = false;
+      apply_layout(server, output->layout);
     }
-    i++;
+  }
+}
+
+void osf_tiling_view_map(struct osf_view *view) {
+  struct osf_server *server = view->server;
+  struct osf_output *output = osf_output_at_cursor(server);
+  if (!output || !output->tiling || !output->layout ||
+      view->xdg_toplevel->current.fullscreen) {
+    return;
+  }
+  struct osf_layout *layout = output->layouts[view->workspace->index];
+  tile_view(output, layout, view);
+  apply_deltas(server, output, layout);
+}
+
+void osf_tiling_view_unmap(struct osf_view *view) {
+  if (!view->tile) {
+    return;
+  }
+  struct osf_layout *layout = view->tile_layout;
+  struct osf_output *output = view->tile_output;
+  untile_view(view);
+  apply_deltas(view->server, output, layout);
+}
+
+void osf_tiling_view_workspace_changed(struct osf_view *view) {
+  struct osf_output *output = view->tile_output;
+  if (!output) {
+    return;
+  }
+  osf_tiling_view_unmap(view);
+  struct osf_layout *layout = output->layouts[view->workspace->index];
+  tile_view(output, layout, view);
+  apply_deltas(view->server, output, layout);
+}
+
+void osf_tiling_view_focus(struct osf_view *view) {
+  if (view->tile) {
+    osf_layout_focus(view->tile_layout, view->tile);
   }
 }
 
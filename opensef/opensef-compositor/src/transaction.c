@@ -0,0 +1,337 @@
+/**
+ * transaction.c - Atomic Layout Transactions
+ *
+ * While a view waits for its client, its current buffers are copied into a
+ * "saved" scene tree and the live surface tree is hidden, so the client
+ * can commit its new size without being seen at the old position.
+ */
+
+#include "transaction.h"
+#include "server.h"
+#include "animation.h"
+#include "visibility.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/util/log.h>
+
+struct osf_instruction {
+  struct osf_view *view;
+  struct wlr_box box; /* Target layout box; size <= 0 keeps the size */
+  int content_x, content_y;
+  bool configured;              /* Configure (if any) sent */
+  uint32_t serial;              /* 0 if no new size was needed */
+  bool ready;                   /* Client committed the new size */
+  struct wlr_scene_tree *saved; /* Old buffers shown while waiting */
+  struct wlr_box from;          /* Where the view was shown before */
+};
+
+struct osf_transaction {
+  struct osf_server *server;
+  struct osf_instruction *instructions;
+  size_t count;
+  size_t capacity;
+  size_t waiting; /* Instructions not ready yet */
+  uint32_t configures;
+  double started_ms;
+  struct wl_event_source *timer;
+};
+
+static double now_ms(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+static struct osf_instruction *find_instruction(struct osf_transaction *txn,
+                                                struct osf_view *view) {
+  for (size_t i = 0; i < txn->count; i++) {
+    if (txn->instructions[i].view == view) {
+      return &txn->instructions[i];
+    }
+  }
+  return NULL;
+}
+
+static struct osf_instruction *add_instruction(struct osf_transaction *txn,
+                                               struct osf_view *view) {
+  struct osf_instruction *instruction = find_instruction(txn, view);
+  if (instruction) {
+    return instruction;
+  }
+  if (txn->count == txn->capacity) {
+    size_t capacity = txn->capacity ? txn->capacity * 2 : 8;
+    struct osf_instruction *grown =
+        realloc(txn->instructions, capacity * sizeof(*grown));
+    if (!grown) {
+      return NULL;
+    }
+    txn->instructions = grown;
+    txn->capacity = capacity;
+  }
+  instruction = &txn->instructions[txn->count++];
+  *instruction = (struct osf_instruction){.view = view};
+  return instruction;
+}
+
+/* ============================================================================
+ * Saved buffers
+ * ============================================================================
+ */
+
+static void save_buffers(struct osf_instruction *instruction) {
+  struct osf_view *view = instruction->view;
+  struct wlr_scene_node *content = &view->content_tree->node;
+
+  instruction->saved = wlr_scene_tree_create(view->scene_tree);
+  if (!instruction->saved) {
+    return;
+  }
+  /* The copies keep the content offset; the saved tree stays at 0,0 */
+  osf_animation_copy_buffers(content, instruction->saved);
+  wlr_scene_node_set_enabled(content, false);
+}
+
+static void restore_buffers(struct osf_instruction *instruction) {
+  if (!instruction->saved) {
+    return;
+  }
+  wlr_scene_node_destroy(&instruction->saved->node);
+  instruction->saved = NULL;
+  wlr_scene_node_set_enabled(&instruction->view->content_tree->node, true);
+}
+
+/* ============================================================================
+ * Apply
+ * ============================================================================
+ */
+
+static void transaction_apply(struct osf_transaction *txn, bool timed_out) {
+  struct osf_server *server = txn->server;
+  server->pending_transaction = NULL;
+
+  for (size_t i = 0; i < txn->count; i++) {
+    struct osf_instruction *instruction = &txn->instructions[i];
+    struct osf_view *view = instruction->view;
+    wlr_scene_node_set_position(&view->scene_tree->node, instruction->box.x,
+                                instruction->box.y);
+    wlr_scene_node_set_position(&view->content_tree->node,
+                                instruction->content_x,
+                                instruction->content_y);
+    restore_buffers(instruction);
+    osf_animation_view_moved(view, instruction->from);
+  }
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
+
+  struct osf_transaction_stats *stats = &server->transaction_stats;
+  double wait_ms = now_ms() - txn->started_ms;
+  stats->applied++;
+  if (timed_out) {
+    stats->timed_out++;
+  }
+  stats->last_views = txn->count;
+  stats->last_configures = txn->configures;
+  stats->last_wait_ms = wait_ms;
+  if (wait_ms > stats->max_wait_ms) {
+    stats->max_wait_ms = wait_ms;
+  }
+  wlr_log(WLR_DEBUG,
+          "Transaction applied: %zu views, %u configures, %.1f ms%s",
+          txn->count, txn->configures, wait_ms,
+          timed_out ? " (timed out)" : "");
+
+  if (txn->timer) {
+    wl_event_source_remove(txn->timer);
+  }
+  free(txn->instructions);
+  free(txn);
+}
+
+static int transaction_timeout(void *data) {
+  struct osf_transaction *txn = data;
+  wlr_log(WLR_INFO, "Transaction timed out with %zu clients still resizing",
+          txn->waiting);
+  transaction_apply(txn, true);
+  return 0;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+struct osf_transaction *osf_transaction_begin(struct osf_server *server) {
+  struct osf_transaction *txn = calloc(1, sizeof(*txn));
+  if (!txn) {
+    wlr_log(WLR_ERROR, "Failed to allocate transaction");
+    return NULL;
+  }
+  txn->server = server;
+  return txn;
+}
+
+void osf_transaction_set_geometry(struct osf_transaction *txn,
+                                  struct osf_view *view, int x, int y,
+                                  int width, int height, int content_x,
+                                  int content_y) {
+  if (!txn || !view->mapped) {
+    return;
+  }
+  struct osf_instruction *instruction = add_instruction(txn, view);
+  if (!instruction) {
+    return;
+  }
+  instruction->box = (struct wlr_box){x, y, width, height};
+  instruction->content_x = content_x;
+  instruction->content_y = content_y;
+}
+
+/* Views of a transaction that hasn't been shown yet carry over into the
+ * new one, with their saved buffers and configure state; the earlier
+ * start keeps the deadline from being pushed back indefinitely */
+static void transaction_merge(struct osf_transaction *txn,
+                              struct osf_transaction *old) {
+  for (size_t i = 0; i < old->count; i++) {
+    struct osf_instruction *previous = &old->instructions[i];
+    struct osf_instruction *instruction =
+        find_instruction(txn, previous->view);
+    if (instruction) {
+      /* Superseded target, but the old buffers are still what's shown */
+      instruction->saved = previous->saved;
+      instruction->from = previous->from;
+      continue;
+    }
+    instruction = add_instruction(txn, previous->view);
+    if (!instruction) {
+      restore_buffers(previous);
+      continue;
+    }
+    *instruction = *previous;
+    if (!instruction->ready) {
+      txn->waiting++;
+    }
+  }
+  txn->started_ms = old->started_ms;
+  txn->configures += old->configures;
+
+  if (old->timer) {
+    wl_event_source_remove(old->timer);
+  }
+  free(old->instructions);
+  free(old);
+  txn->server->transaction_stats.superseded++;
+}
+
+void osf_transaction_commit(struct osf_transaction *txn) {
+  if (!txn) {
+    return;
+  }
+  struct osf_server *server = txn->server;
+  server->transaction_stats.committed++;
+  txn->started_ms = now_ms();
+
+  if (server->pending_transaction) {
+    transaction_merge(txn, server->pending_transaction);
+    server->pending_transaction = NULL;
+  }
+
+  for (size_t i = 0; i < txn->count; i++) {
+    struct osf_instruction *instruction = &txn->instructions[i];
+    if (instruction->configured) {
+      continue; /* Carried over */
+    }
+    instruction->configured = true;
+
+    struct osf_view *view = instruction->view;
+    if (!instruction->saved) {
+      instruction->from = osf_animation_view_box(view);
+    }
+    struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+    if (instruction->box.width <= 0 || instruction->box.height <= 0 ||
+        (instruction->box.width == geo.width &&
+         instruction->box.height == geo.height)) {
+      instruction->ready = true;
+      continue;
+    }
+
+    instruction->serial = wlr_xdg_toplevel_set_size(
+        view->xdg_toplevel, instruction->box.width, instruction->box.height);
+    instruction->ready = false;
+    txn->waiting++;
+    txn->configures++;
+    if (!instruction->saved) {
+      save_buffers(instruction);
+    }
+  }
+
+  if (txn->waiting == 0) {
+    transaction_apply(txn, false);
+    return;
+  }
+
+  server->pending_transaction = txn;
+  int remaining = OSF_TRANSACTION_TIMEOUT_MS -
+                  (int)(now_ms() - txn->started_ms);
+  txn->timer = wl_event_loop_add_timer(
+      wl_display_get_event_loop(server->wl_display), transaction_timeout, txn);
+  if (txn->timer) {
+    wl_event_source_timer_update(txn->timer, remaining > 1 ? remaining : 1);
+  } else {
+    transaction_apply(txn, true);
+  }
+}
+
+void osf_transaction_view_commit(struct osf_view *view) {
+  struct osf_transaction *txn = view->server->pending_transaction;
+  if (!txn) {
+    return;
+  }
+  struct osf_instruction *instruction = find_instruction(txn, view);
+  if (!instruction || instruction->ready) {
+    return;
+  }
+
+  /* Either the configure was acked, or the client already has the size */
+  struct wlr_xdg_surface *surface = view->xdg_toplevel->base;
+  bool acked = (int32_t)(surface->current.configure_serial -
+                         instruction->serial) >= 0;
+  bool sized = surface->current.geometry.width == instruction->box.width &&
+               surface->current.geometry.height == instruction->box.height;
+  if (!acked && !sized) {
+    return;
+  }
+
+  instruction->ready = true;
+  if (--txn->waiting == 0) {
+    transaction_apply(txn, false);
+  }
+}
+
+void osf_transaction_view_unmap(struct osf_view *view) {
+  struct osf_transaction *txn = view->server->pending_transaction;
+  if (!txn) {
+    return;
+  }
+  struct osf_instruction *instruction = find_instruction(txn, view);
+  if (!instruction) {
+    return;
+  }
+
+  restore_buffers(instruction);
+  if (!instruction->ready) {
+    txn->waiting--;
+  }
+  *instruction = txn->instructions[--txn->count];
+
+  if (txn->waiting == 0) {
+    transaction_apply(txn, false);
+  }
+}
+
+bool osf_transaction_has_view(struct osf_view *view) {
+  struct osf_transaction *txn = view->server->pending_transaction;
+  return txn && find_instruction(txn, view);
+}
@@ -6,7 +6,12 @@
 
 #include "server.h"
 
+#include "animation.h"
+#include "latency.h"
+#include "thumbnail.h"
 #include "tiling.h"
+#include "visibility.h"
+#include "workspace.h"
 // #include "titlebar.h" // Server-side decorations disabled
 #include <stdio.h>
 #include <stdlib.h>
@@ -67,6 +72,10 @@ void osf_focus_view(struct osf_view *view, struct wlr_surface *surface) {
   struct wlr_seat *seat = server->seat;
   struct wlr_surface *prev_surface = seat->keyboard_state.focused_surface;
 
+  if (view->minimized) {
+    osf_view_set_minimized(view, false);
+  }
+
   if (prev_surface == surface) {
     return; /* Already focused */
   }
@@ -88,15 +97,20 @@ void osf_focus_view(struct osf_view *view, struct wlr_surface *surface) {
   wlr_scene_node_raise_to_top(&view->scene_tree->node);
   wl_list_remove(&view->link);
   wl_list_insert(&server->views, &view->link);
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
 
   /* Activate view */
   wlr_xdg_toplevel_set_activated(view->xdg_toplevel, true);
   osf_view_update_borders(view, true);
+  osf_tiling_view_focus(view);
 
   /* Notify openSEF framework of window focus */
   char window_id[64];
   snprintf(window_id, sizeof(window_id), "window-%p", (void *)view);
+  osf_latency_framework_begin(server);
   osf_window_focus(window_id);
+  osf_latency_framework_end(server);
 
   wlr_log(WLR_DEBUG, "Framework notified: window focused - %s", window_id);
 
@@ -107,18 +121,23 @@ void osf_focus_view(struct osf_view *view, struct wlr_surface *surface) {
                                    keyboard->keycodes, keyboard->num_keycodes,
                                    &keyboard->modifiers);
   }
+  osf_latency_mark(server, OSF_LATENCY_FOCUS);
 }
 
 /* ============================================================================
  * View event handlers
  * ============================================================================
  */
+
+static void resize_cancel(struct osf_view *view);
+
 static void view_map(struct wl_listener *listener, void *data) {
   struct osf_view *view = wl_container_of(listener, view, map);
 
   (void)data;
 
   view->mapped = true;
+  view->workspace->view_count++;
   wl_list_insert(&view->server->views, &view->link);
 
   const char *app_id =
@@ -132,6 +151,15 @@ static void view_map(struct wl_listener *listener, void *data) {
   }
 
   wlr_scene_node_set_position(&view->scene_tree->node, x, y);
+  /* Unmaximizing a view that mapped maximized keeps this box */
+  struct wlr_box mapped_geo = view->xdg_toplevel->base->current.geometry;
+  view->unmaximized = (struct wlr_box){x, y, mapped_geo.width,
+                                       mapped_geo.height};
+  osf_tiling_view_map(view);
+  osf_visibility_mark_dirty(view->server);
+  osf_cursor_invalidate_hit(view->server);
+  osf_animation_view_map(view);
+  osf_thumbnail_view_map(view);
 
   if (view->xdg_toplevel->base->surface) {
     osf_focus_view(view, view->xdg_toplevel->base->surface);
@@ -174,8 +202,28 @@ static void view_unmap(struct wl_listener *listener, void *data) {
       view->xdg_toplevel->app_id ? view->xdg_toplevel->app_id : "unknown";
   wlr_log(WLR_INFO, "View unmapped: app_id='%s'", app_id);
 
+  /* Fades out from its last buffers */
+  osf_animation_view_unmap(view);
+  osf_thumbnail_view_unmap(view);
+
   view->mapped = false;
+  view->workspace->view_count--;
   wl_list_remove(&view->link);
+  osf_tiling_view_unmap(view);
+  osf_transaction_view_unmap(view);
+  resize_cancel(view);
+  osf_visibility_mark_dirty(view->server);
+  osf_cursor_invalidate_hit(view->server);
+
+  /* Mapped again, it starts out shown */
+  if (view->minimized) {
+    view->minimized = false;
+    wlr_scene_node_set_enabled(&view->scene_tree->node, true);
+  }
+  view->frame_output = NULL;
+  wlr_log(WLR_DEBUG, "View frame callbacks: %llu sent, %llu suppressed",
+          (unsigned long long)view->frames_sent,
+          (unsigned long long)view->frames_suppressed);
 
   /* Reset cursor mode if this was the grabbed view */
   if (view == view->server->grabbed_view) {
@@ -185,6 +233,110 @@ static void view_unmap(struct wl_listener *listener, void *data) {
   wlr_log(WLR_INFO, "View unmapped");
 }
 
+/* ============================================================================
+ * Interactive resize
+ * ============================================================================
+ */
+
+/* Place the view so the edges opposite the grabbed ones stay where `box`
+ * puts them, whatever size the client actually committed. A waiting
+ * transaction owns the position and sets it when it applies. */
+static void resize_place(struct osf_view *view, struct wlr_box box) {
+  if (osf_transaction_has_view(view)) {
+    return;
+  }
+  struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+  int x = box.x;
+  int y = box.y;
+
+  if (view->resize.edges & WLR_EDGE_LEFT) {
+    x = box.x + box.width - geo.width;
+  }
+  if (view->resize.edges & WLR_EDGE_TOP) {
+    y = box.y + box.height - geo.height;
+  }
+  wlr_scene_node_set_position(&view->scene_tree->node, x - geo.x, y - geo.y);
+  osf_visibility_mark_dirty(view->server);
+  osf_cursor_invalidate_hit(view->server);
+}
+
+static int resize_timeout(void *data);
+
+static void resize_send(struct osf_view *view, struct wlr_box box) {
+  struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+
+  view->resize.has_desired = false;
+  if (box.width == geo.width && box.height == geo.height) {
+    /* Nothing for the client to do; only the position changes */
+    resize_place(view, box);
+    return;
+  }
+  view->resize.sent = box;
+  view->resize.serial =
+      wlr_xdg_toplevel_set_size(view->xdg_toplevel, box.width, box.height);
+
+  if (!view->resize.timer) {
+    view->resize.timer = wl_event_loop_add_timer(
+        wl_display_get_event_loop(view->server->wl_display), resize_timeout,
+        view);
+  }
+  if (view->resize.timer) {
+    wl_event_source_timer_update(view->resize.timer, OSF_RESIZE_TIMEOUT_MS);
+  }
+}
+
+/* Forget the outstanding configure; the next box goes out now */
+static void resize_release(struct osf_view *view) {
+  view->resize.serial = 0;
+  if (view->resize.timer) {
+    wl_event_source_timer_update(view->resize.timer, 0);
+  }
+  resize_place(view, view->resize.sent);
+  if (view->resize.has_desired) {
+    resize_send(view, view->resize.desired);
+  }
+}
+
+static int resize_timeout(void *data) {
+  struct osf_view *view = data;
+  wlr_log(WLR_INFO, "Resize timed out waiting for configure %u",
+          view->resize.serial);
+  resize_release(view);
+  return 0;
+}
+
+static void resize_cancel(struct osf_view *view) {
+  if (view->resize.timer) {
+    wl_event_source_remove(view->resize.timer);
+    view->resize.timer = NULL;
+  }
+  view->resize.serial = 0;
+  view->resize.has_desired = false;
+}
+
+void osf_view_resize(struct osf_view *view, struct wlr_box box,
+                     uint32_t edges) {
+  view->resize.edges = edges;
+  if (view->resize.serial) {
+    /* Coalesce: only the latest box is sent once the client catches up */
+    view->resize.desired = box;
+    view->resize.has_desired = true;
+    return;
+  }
+  resize_send(view, box);
+}
+
+/* The commit applying the outstanding configure (or a later one) moves
+ * the view and releases the next size */
+static void resize_commit(struct osf_view *view) {
+  uint32_t acked = view->xdg_toplevel->base->current.configure_serial;
+  if (!view->resize.serial || (int32_t)(acked - view->resize.serial) < 0) {
+    return;
+  }
+
+  resize_release(view);
+}
+
 static void view_commit(struct wl_listener *listener, void *data) {
   struct osf_view *view = wl_container_of(listener, view, commit);
   (void)data;
@@ -193,6 +345,22 @@ static void view_commit(struct wl_listener *listener, void *data) {
     wlr_xdg_toplevel_set_size(view->xdg_toplevel, 0, 0);
   }
 
+  resize_commit(view);
+  osf_transaction_view_commit(view);
+  osf_animation_view_commit(view);
+  osf_thumbnail_view_commit(view);
+
+  /* What this view covers only changes with its size or opaque region */
+  struct wlr_surface *surface = view->xdg_toplevel->base->surface;
+  if (surface->current.width != view->committed_width ||
+      surface->current.height != view->committed_height ||
+      (surface->current.committed & WLR_SURFACE_STATE_OPAQUE_REGION)) {
+    view->committed_width = surface->current.width;
+    view->committed_height = surface->current.height;
+    osf_visibility_mark_dirty(view->server);
+    osf_cursor_invalidate_hit(view->server);
+  }
+
   /* Report geometry changes if mapped to support intelligent shell features
    * like autohide */
   if (view->mapped && view->framework_window) {
@@ -235,6 +403,8 @@ static void view_destroy(struct wl_listener *listener, void *data) {
   wl_list_remove(&view->request_resize.link);
   wl_list_remove(&view->request_maximize.link);
   wl_list_remove(&view->request_fullscreen.link);
+  wl_list_remove(&view->request_minimize.link);
+  resize_cancel(view);
 
   free(view);
 }
@@ -254,6 +424,13 @@ static void begin_interactive(struct osf_view *view, enum osf_cursor_mode mode,
     return; /* Not focused, ignore */
   }
 
+  if (view->is_tiled) {
+    return; /* The layout owns its geometry */
+  }
+
+  /* The grab works on the real position */
+  osf_animation_view_finish(view);
+
   server->grabbed_view = view;
   server->cursor_mode = mode;
 
@@ -298,22 +475,41 @@ static void view_request_maximize(struct wl_listener *listener, void *data) {
 
   if (view->xdg_toplevel->base->surface->mapped) {
     bool next_max = !view->xdg_toplevel->current.maximized;
+    struct osf_output *output = osf_output_at_cursor(view->server);
+    if (view->is_tiled || !output) {
+      /* The layout owns its geometry */
+      wlr_xdg_toplevel_set_maximized(view->xdg_toplevel, next_max);
+      return;
+    }
     wlr_xdg_toplevel_set_maximized(view->xdg_toplevel, next_max);
 
-    /* Report to framework */
-    char window_id[64];
-    snprintf(window_id, sizeof(window_id), "window-%p", (void *)view);
     struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
-
-    /* If maximizing, we assume it takes full screen (or output size)
-     * In this compositor, we'll report the output size if maxed.
-     */
+    struct wlr_box box;
     if (next_max) {
-      osf_window_set_geometry(window_id, 0, 28, 1920,
-                              1052); // Assuming 1080p - panel
+      /* The whole output below the panel */
+      int x, y;
+      osf_animation_view_position(view, &x, &y);
+      view->unmaximized = (struct wlr_box){x, y, geo.width, geo.height};
+      wlr_output_layout_get_box(view->server->output_layout,
+                                output->wlr_output, &box);
+      box.y += 28;
+      box.width -= view->content_tree->node.x;
+      box.height -= 28 + view->content_tree->node.y;
     } else {
-      osf_window_set_geometry(window_id, 50, 50, geo.width, geo.height);
+      box = view->unmaximized;
     }
+
+    /* Resized by the client, moved and animated once it has */
+    struct osf_transaction *txn = osf_transaction_begin(view->server);
+    osf_transaction_set_geometry(txn, view, box.x, box.y, box.width,
+                                 box.height, view->content_tree->node.x,
+                                 view->content_tree->node.y);
+    osf_transaction_commit(txn);
+
+    /* Report to framework */
+    char window_id[64];
+    snprintf(window_id, sizeof(window_id), "window-%p", (void *)view);
+    osf_window_set_geometry(window_id, box.x, box.y, box.width, box.height);
   }
 }
 
@@ -327,6 +523,43 @@ static void view_request_fullscreen(struct wl_listener *listener, void *data) {
   }
 }
 
+void osf_view_set_minimized(struct osf_view *view, bool minimized) {
+  if (view->minimized == minimized || !view->mapped) {
+    return;
+  }
+  struct osf_server *server = view->server;
+  view->minimized = minimized;
+  osf_animation_view_minimize(view, minimized);
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
+
+  char window_id[64];
+  snprintf(window_id, sizeof(window_id), "window-%p", (void *)view);
+
+  if (minimized) {
+    /* Its tile goes to the others until it comes back */
+    osf_tiling_view_unmap(view);
+    if (view == server->grabbed_view) {
+      osf_reset_cursor_mode(server);
+    }
+    if (server->seat->keyboard_state.focused_surface ==
+        view->xdg_toplevel->base->surface) {
+      osf_workspace_focus_top(server);
+    }
+    osf_window_minimize(window_id);
+    wlr_log(WLR_INFO, "View minimized: %s", window_id);
+  } else {
+    osf_tiling_view_map(view);
+    wlr_log(WLR_INFO, "View restored: %s", window_id);
+  }
+}
+
+static void view_request_minimize(struct wl_listener *listener, void *data) {
+  struct osf_view *view = wl_container_of(listener, view, request_minimize);
+  (void)data;
+  osf_view_set_minimized(view, true);
+}
+
 /* ============================================================================
  * New XDG toplevel
  * ============================================================================
@@ -365,8 +598,9 @@ void osf_new_xdg_toplevel(struct wl_listener *listener, void *data) {
   view->server = server;
   view->xdg_toplevel = xdg_toplevel;
 
-  /* Create scene tree in views layer */
-  view->scene_tree = wlr_scene_tree_create(server->layer_views);
+  /* Create scene tree in the active workspace */
+  view->workspace = server->active_workspace;
+  view->scene_tree = wlr_scene_tree_create(view->workspace->tree);
   view->content_tree =
       wlr_scene_xdg_surface_create(view->scene_tree, xdg_toplevel->base);
   view->scene_tree->node.data = view;
@@ -415,4 +649,8 @@ void osf_new_xdg_toplevel(struct wl_listener *listener, void *data) {
   view->request_fullscreen.notify = view_request_fullscreen;
   wl_signal_add(&xdg_toplevel->events.request_fullscreen,
                 &view->request_fullscreen);
+
+  view->request_minimize.notify = view_request_minimize;
+  wl_signal_add(&xdg_toplevel->events.request_minimize,
+                &view->request_minimize);
 }
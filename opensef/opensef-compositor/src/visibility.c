@@ -0,0 +1,315 @@
+/**
+ * visibility.c - Occlusion-aware Frame Callbacks
+ *
+ * Only the main surface's opaque region counts as covering what is below;
+ * subsurfaces, popups and layer surfaces never hide a view. That can leave
+ * a covered view at full rate, never the other way around.
+ */
+
+#include "visibility.h"
+
+#include <pixman.h>
+#include <stdlib.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/util/log.h>
+#include <wlr/version.h>
+
+/* xdg_toplevel.suspended arrived with xdg-shell v6 (wlroots 0.18) */
+#if WLR_VERSION_NUM >= ((0 << 16) | (18 << 8) | 0)
+#define OSF_HAVE_XDG_SUSPENDED 1
+#endif
+
+const char *osf_visibility_name(enum osf_view_visibility visibility) {
+  switch (visibility) {
+  case OSF_VIEW_VISIBLE:
+    return "visible";
+  case OSF_VIEW_OCCLUDED:
+    return "occluded";
+  case OSF_VIEW_OFFSCREEN:
+    return "off-screen";
+  case OSF_VIEW_MINIMIZED:
+    return "minimized";
+  case OSF_VIEW_HIDDEN:
+    return "hidden";
+  }
+  return "unknown";
+}
+
+static void set_suspended(struct osf_view *view, bool suspended) {
+#ifdef OSF_HAVE_XDG_SUSPENDED
+  wlr_xdg_toplevel_set_suspended(view->xdg_toplevel, suspended);
+#else
+  (void)view;
+  (void)suspended;
+#endif
+}
+
+static void send_frame_done(struct wlr_surface *surface, int sx, int sy,
+                            void *data) {
+  (void)sx;
+  (void)sy;
+  wlr_surface_send_frame_done(surface, data);
+}
+
+static void view_send_frame_done(struct osf_view *view,
+                                 const struct timespec *now) {
+  wlr_xdg_surface_for_each_surface(view->xdg_toplevel->base, send_frame_done,
+                                   (void *)now);
+  view->frames_sent++;
+}
+
+static bool has_throttled_views(struct osf_server *server) {
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    if (view->visibility != OSF_VIEW_VISIBLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void arm_throttle_timer(struct osf_server *server) {
+  if (server->throttled_frame_ms > 0 && has_throttled_views(server)) {
+    wl_event_source_timer_update(server->throttle_timer,
+                                 server->throttled_frame_ms);
+  }
+}
+
+/* A slow trickle of callbacks instead of none, so clients that ignore
+ * `suspended` still make progress without spinning */
+static int throttle_timer_callback(void *data) {
+  struct osf_server *server = data;
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    if (view->visibility != OSF_VIEW_VISIBLE) {
+      view_send_frame_done(view, &now);
+    }
+  }
+
+  arm_throttle_timer(server);
+  return 0;
+}
+
+void osf_visibility_init(struct osf_server *server) {
+  server->throttled_frame_ms = OSF_VISIBILITY_THROTTLED_FRAME_MS;
+  const char *env = getenv("VITUS_THROTTLED_FRAME_MS");
+  if (env && env[0] != '\0') {
+    server->throttled_frame_ms = atoi(env) > 0 ? atoi(env) : 0;
+  }
+
+  struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+  server->throttle_timer =
+      wl_event_loop_add_timer(loop, throttle_timer_callback, server);
+  server->visibility_dirty = true;
+
+  if (server->throttled_frame_ms > 0) {
+    wlr_log(WLR_INFO, "Hidden windows throttled to one frame per %d ms",
+            server->throttled_frame_ms);
+  } else {
+    wlr_log(WLR_INFO, "Hidden windows get no frame callbacks");
+  }
+}
+
+void osf_visibility_finish(struct osf_server *server) {
+  if (server->throttle_timer) {
+    wl_event_source_remove(server->throttle_timer);
+    server->throttle_timer = NULL;
+  }
+}
+
+void osf_visibility_mark_dirty(struct osf_server *server) {
+  server->visibility_dirty = true;
+}
+
+void osf_visibility_output_destroy(struct osf_output *output) {
+  struct osf_view *view;
+  wl_list_for_each(view, &output->server->views, link) {
+    if (view->frame_output == output) {
+      view->frame_output = NULL;
+    }
+  }
+  output->server->visibility_dirty = true;
+}
+
+/* Window geometry in layout coordinates; the surface origin goes to
+ * `origin` for translating its opaque region */
+static struct wlr_box view_box(struct osf_view *view, int *origin_x,
+                               int *origin_y) {
+  wlr_scene_node_coords(&view->content_tree->node, origin_x, origin_y);
+  struct wlr_surface *surface = view->xdg_toplevel->base->surface;
+  struct wlr_box geo = view->xdg_toplevel->base->current.geometry;
+  if (geo.width <= 0 || geo.height <= 0) {
+    geo = (struct wlr_box){0, 0, surface->current.width,
+                           surface->current.height};
+  }
+  geo.x += *origin_x;
+  geo.y += *origin_y;
+  return geo;
+}
+
+/* The output showing the largest part of `region` */
+static struct osf_output *frame_output_for(struct osf_server *server,
+                                           pixman_region32_t *region) {
+  struct osf_output *best = NULL;
+  int64_t best_area = 0;
+  struct osf_output *output;
+  wl_list_for_each(output, &server->outputs, link) {
+    struct wlr_box box;
+    wlr_output_layout_get_box(server->output_layout, output->wlr_output,
+                              &box);
+    pixman_region32_t part;
+    pixman_region32_init(&part);
+    pixman_region32_intersect_rect(&part, region, box.x, box.y, box.width,
+                                   box.height);
+    int n;
+    const pixman_box32_t *rects = pixman_region32_rectangles(&part, &n);
+    int64_t area = 0;
+    for (int i = 0; i < n; i++) {
+      area += (int64_t)(rects[i].x2 - rects[i].x1) *
+              (rects[i].y2 - rects[i].y1);
+    }
+    pixman_region32_fini(&part);
+    if (area > best_area) {
+      best = output;
+      best_area = area;
+    }
+  }
+  return best;
+}
+
+void osf_visibility_update(struct osf_server *server) {
+  if (!server->visibility_dirty) {
+    return;
+  }
+  server->visibility_dirty = false;
+
+  pixman_region32_t screen, covered, visible;
+  pixman_region32_init(&screen);
+  pixman_region32_init(&covered);
+  pixman_region32_init(&visible);
+
+  struct osf_output *output;
+  wl_list_for_each(output, &server->outputs, link) {
+    struct wlr_box box;
+    wlr_output_layout_get_box(server->output_layout, output->wlr_output,
+                              &box);
+    pixman_region32_union_rect(&screen, &screen, box.x, box.y, box.width,
+                               box.height);
+  }
+
+  bool overview = server->multitask && server->multitask->active;
+
+  /* Front to back */
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    enum osf_view_visibility visibility = OSF_VIEW_VISIBLE;
+    struct osf_output *frame_output = NULL;
+
+    if (view->workspace != server->active_workspace) {
+      visibility = OSF_VIEW_HIDDEN;
+    } else if (view->minimized) {
+      visibility = OSF_VIEW_MINIMIZED;
+    } else {
+      int ox, oy;
+      struct wlr_box box = view_box(view, &ox, &oy);
+      pixman_region32_intersect_rect(&visible, &screen, box.x, box.y,
+                                     box.width, box.height);
+      if (!pixman_region32_not_empty(&visible)) {
+        visibility = OSF_VIEW_OFFSCREEN;
+      } else {
+        /* The overview shows every window, however they overlap */
+        if (!overview) {
+          pixman_region32_subtract(&visible, &visible, &covered);
+        }
+        if (!pixman_region32_not_empty(&visible)) {
+          visibility = OSF_VIEW_OCCLUDED;
+        } else {
+          frame_output = frame_output_for(server, &visible);
+        }
+      }
+
+      pixman_region32_t opaque;
+      pixman_region32_init(&opaque);
+      pixman_region32_copy(&opaque,
+                           &view->xdg_toplevel->base->surface->opaque_region);
+      pixman_region32_translate(&opaque, ox, oy);
+      pixman_region32_intersect_rect(&opaque, &opaque, box.x, box.y,
+                                     box.width, box.height);
+      pixman_region32_union(&covered, &covered, &opaque);
+      pixman_region32_fini(&opaque);
+    }
+
+    view->frame_output = frame_output;
+    if (visibility == view->visibility) {
+      continue;
+    }
+
+    wlr_log(WLR_DEBUG,
+            "View %p %s -> %s (frames sent %llu, suppressed %llu)",
+            (void *)view, osf_visibility_name(view->visibility),
+            osf_visibility_name(visibility),
+            (unsigned long long)view->frames_sent,
+            (unsigned long long)view->frames_suppressed);
+    if (view->visibility == OSF_VIEW_VISIBLE) {
+      set_suspended(view, true);
+    } else if (visibility == OSF_VIEW_VISIBLE) {
+      set_suspended(view, false);
+    }
+    view->visibility = visibility;
+  }
+
+  pixman_region32_fini(&visible);
+  pixman_region32_fini(&covered);
+  pixman_region32_fini(&screen);
+
+  arm_throttle_timer(server);
+}
+
+struct frame_done_iter {
+  struct wlr_scene_output *scene_output;
+  const struct timespec *now;
+};
+
+/* Non-view surfaces (layer shell) keep the scene's rules */
+static void send_scene_frame_done(struct wlr_scene_buffer *buffer, int sx,
+                                  int sy, void *data) {
+  struct frame_done_iter *iter = data;
+  (void)sx;
+  (void)sy;
+
+  if (buffer->primary_output != iter->scene_output) {
+    return;
+  }
+  for (struct wlr_scene_tree *tree = buffer->node.parent; tree;
+       tree = tree->node.parent) {
+    if (tree->node.data) {
+      return; /* Part of a view */
+    }
+  }
+  wlr_scene_buffer_send_frame_done(buffer, iter->now);
+}
+
+void osf_visibility_send_frame_done(struct osf_output *output,
+                                    const struct timespec *now) {
+  struct osf_server *server = output->server;
+
+  struct frame_done_iter iter = {output->scene_output, now};
+  wlr_scene_output_for_each_buffer(output->scene_output,
+                                   send_scene_frame_done, &iter);
+
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    if (view->frame_output == output) {
+      view_send_frame_done(view, now);
+    } else if (view->visibility != OSF_VIEW_VISIBLE) {
+      /* Counted for every output that framed without it */
+      view->frames_suppressed++;
+    }
+  }
+}
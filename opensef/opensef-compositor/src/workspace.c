@@ -0,0 +1,138 @@
+/**
+ * workspace.c - Virtual Workspaces
+ *
+ * Switching only flips the enabled state of two scene trees; nothing is
+ * destroyed, so views come back with their buffers, positions and tiles
+ * exactly as they were left.
+ */
+
+#include "workspace.h"
+#include "server.h"
+#include "animation.h"
+#include "tiling.h"
+#include "visibility.h"
+
+#include <opensef/OSFFrameworkC.h>
+#include <stdlib.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/util/log.h>
+
+void osf_workspace_focus_top(struct osf_server *server) {
+  struct osf_view *view;
+  wl_list_for_each(view, &server->views, link) {
+    /* Views are kept front to back */
+    if (view->workspace == server->active_workspace && !view->minimized) {
+      osf_focus_view(view, view->xdg_toplevel->base->surface);
+      return;
+    }
+  }
+
+  struct wlr_surface *focused = server->seat->keyboard_state.focused_surface;
+  struct wlr_xdg_toplevel *toplevel =
+      focused ? wlr_xdg_toplevel_try_from_wlr_surface(focused) : NULL;
+  if (toplevel) {
+    wlr_xdg_toplevel_set_activated(toplevel, false);
+    if (toplevel->base->data) {
+      osf_view_update_borders(toplevel->base->data, false);
+    }
+  }
+  wlr_seat_keyboard_notify_clear_focus(server->seat);
+}
+
+void osf_workspace_init(struct osf_server *server) {
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    struct osf_workspace *ws = calloc(1, sizeof(*ws));
+    ws->server = server;
+    ws->index = i;
+    ws->tree = wlr_scene_tree_create(server->layer_views);
+    wlr_scene_node_set_enabled(&ws->tree->node, i == 0);
+    server->workspaces[i] = ws;
+  }
+  server->active_workspace = server->workspaces[0];
+
+  osf_workspace_set_count(OSF_WORKSPACE_COUNT);
+
+  wlr_log(WLR_INFO, "Workspaces initialized (%d)", OSF_WORKSPACE_COUNT);
+}
+
+void osf_workspace_finish(struct osf_server *server) {
+  /* Trees go with the scene */
+  for (int i = 0; i < OSF_WORKSPACE_COUNT; i++) {
+    free(server->workspaces[i]);
+    server->workspaces[i] = NULL;
+  }
+  server->active_workspace = NULL;
+}
+
+void osf_workspace_switch(struct osf_server *server, int index) {
+  if (index < 0 || index >= OSF_WORKSPACE_COUNT) {
+    return;
+  }
+  struct osf_workspace *prev = server->active_workspace;
+  struct osf_workspace *next = server->workspaces[index];
+  if (next == prev) {
+    return;
+  }
+
+  /* The overview only arranges the active workspace */
+  if (server->multitask && server->multitask->active) {
+    osf_multitask_toggle(server);
+  }
+  if (server->grabbed_view && server->grabbed_view->workspace == prev) {
+    osf_reset_cursor_mode(server);
+  }
+
+  wlr_scene_node_set_enabled(&prev->tree->node, false);
+  wlr_scene_node_set_enabled(&next->tree->node, true);
+  server->active_workspace = next;
+  osf_tiling_workspace_activated(server);
+
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
+
+  osf_workspace_focus_top(server);
+  /* Re-entered on the next motion event */
+  wlr_seat_pointer_notify_clear_focus(server->seat);
+
+  osf_workspace_activate(index);
+
+  wlr_log(WLR_INFO, "Workspace %d active", index + 1);
+}
+
+void osf_workspace_move_view(struct osf_view *view, int index) {
+  struct osf_server *server = view->server;
+  if (index < 0 || index >= OSF_WORKSPACE_COUNT) {
+    return;
+  }
+  struct osf_workspace *ws = server->workspaces[index];
+  if (view->workspace == ws) {
+    return;
+  }
+
+  if (view->mapped) {
+    view->workspace->view_count--;
+    ws->view_count++;
+  }
+  osf_animation_view_finish(view);
+  view->workspace = ws;
+  wlr_scene_node_reparent(&view->scene_tree->node, ws->tree);
+  osf_tiling_view_workspace_changed(view);
+
+  if (ws != server->active_workspace) {
+    if (view == server->grabbed_view) {
+      osf_reset_cursor_mode(server);
+    }
+    if (server->seat->keyboard_state.focused_surface ==
+        view->xdg_toplevel->base->surface) {
+      osf_workspace_focus_top(server);
+    }
+    if (server->seat->pointer_state.focused_surface) {
+      wlr_seat_pointer_notify_clear_focus(server->seat);
+    }
+  }
+  osf_visibility_mark_dirty(server);
+  osf_cursor_invalidate_hit(server);
+
+  wlr_log(WLR_INFO, "View moved to workspace %d", index + 1);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * OSFEventAwaiter.h - co_await an OSFEventBus event
+ *
+ * Bridges the event bus into OSFCoroutine:
+ *
+ *   OSFEvent e = co_await nextEvent(OSFEventBus::shared(),
+ *                                   OSFEventBus::THEME_CHANGED);
+ *
+ * The coroutine resumes on the given run loop with a copy of the first
+ * matching event, whichever thread published it. Requires C++20 and
+ * opensef-base headers.
+ */
+
+#include "OSFEventBus.h"
+
+#include <opensef/OSFCoroutine.h>
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <string>
+
+namespace OpenSEF {
+
+inline auto nextEvent(OSFEventBus &bus, std::string eventType,
+                      opensef::OSFRunLoop &runLoop =
+                          opensef::OSFApplication::shared().runLoop()) {
+  struct State {
+    std::atomic<bool> fired{false};
+    OSFEvent event;
+  };
+
+  struct Awaiter {
+    OSFEventBus &bus;
+    std::string eventType;
+    opensef::OSFRunLoop &loop;
+    std::shared_ptr<State> state = std::make_shared<State>();
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      OSFEventBus *eventBus = &bus;
+      opensef::OSFRunLoop *runLoop = &loop;
+      std::shared_ptr<State> shared = state;
+      bus.subscribe(
+          eventType,
+          [eventBus, runLoop, shared, handle](const OSFEvent &event) {
+            if (shared->fired.exchange(true))
+              return; // Only the first event resumes
+            shared->event = event;
+            // publish() holds the bus lock while calling us, so unsubscribe
+            // from the run loop rather than from inside the handler.
+            runLoop->postTask([eventBus, shared, handle]() {
+              eventBus->unsubscribeAll(shared.get());
+              handle.resume();
+            });
+          },
+          state.get());
+    }
+
+    OSFEvent await_resume() { return std::move(state->event); }
+  };
+
+  return Awaiter{bus, std::move(eventType), runLoop};
+}
+
+} // namespace OpenSEF
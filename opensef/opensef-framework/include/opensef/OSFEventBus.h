@@ -1,6 +1,7 @@
 #pragma once
 
 #include <any>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -78,6 +79,13 @@ public:
   void publish(const std::string &eventType, const OSFEvent &event);
   void publishAsync(const std::string &eventType, const OSFEvent &event);
 
+  // Input latency tracing: while the compositor handles an input event
+  // (osf_input_trace_begin), events published on that thread carry its
+  // CLOCK_MONOTONIC timestamp, in microseconds, as INPUT_TIME_KEY
+  static void setInputTimestamp(uint64_t usec); // 0: no input in flight
+  static uint64_t inputTimestamp();
+  static constexpr const char *INPUT_TIME_KEY = "input_time_us";
+
   // Standard event types - Windows
   static constexpr const char *WINDOW_CREATED = "window.created";
   static constexpr const char *WINDOW_DESTROYED = "window.destroyed";
@@ -1,6 +1,8 @@
 #ifndef OSF_FRAMEWORK_C_H
 #define OSF_FRAMEWORK_C_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,9 +36,18 @@ void osf_window_minimize(const char *id);
 void osf_window_maximize(const char *id);
 void osf_window_close(const char *id);
 
+// Workspaces
+void osf_workspace_set_count(int count);
+void osf_workspace_activate(int index);
+
 // Event publishing
 void osf_event_publish(const char *event_type, const char *data);
 
+// Input latency tracing: events published between begin and end carry the
+// input event's timestamp (CLOCK_MONOTONIC microseconds)
+void osf_input_trace_begin(uint64_t time_usec);
+void osf_input_trace_end(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -65,6 +65,17 @@ public:
   SearchResults search(const std::string &query);
   void setQuery(const std::string &query);
 
+  // Non-blocking search: shell-backed sources run on the shared task
+  // scheduler and results arrive via onResultsChanged through the executor.
+  // A newer query cancels the one still in flight.
+  void searchAsync(const std::string &query);
+
+  // Where searchAsync delivers results: runs each task on the host's UI
+  // thread, e.g. by posting to an OSFRunLoop or queueing it on a Qt event
+  // loop. Without one, searchAsync searches in place like search().
+  using Executor = std::function<void(std::function<void()>)>;
+  void setExecutor(Executor executor);
+
   // Execute result
   void execute(const SearchResult &result);
 
@@ -48,6 +48,10 @@ public:
   void addApplication(OSFApplication *app);
   void removeApplication(const std::string &id);
 
+  // Grows or shrinks the list to `count` workspaces ("Workspace N")
+  void setWorkspaceCount(int count);
+  void setCurrentWorkspace(int index);
+
 private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
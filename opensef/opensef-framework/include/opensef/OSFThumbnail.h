@@ -0,0 +1,68 @@
+#ifndef OSF_FRAMEWORK_THUMBNAIL_H
+#define OSF_FRAMEWORK_THUMBNAIL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Live Window Thumbnails - shared memory layout
+ *
+ * The compositor keeps one memfd per window holding a downscaled snapshot,
+ * refreshed only when the window is damaged and at most once per
+ * VITUS_THUMBNAIL_MS. It hands each one to the shell over Wayland
+ * (zvitus_thumbnail_manager_v1, keyed by the window id "window-0x..."),
+ * sealed against resizing, so the shell maps it read-only.
+ *
+ * The file is a header followed by two pixel slots. The compositor always
+ * writes the slot the header does not point at, then flips `front`.
+ * `sequence` works as a seqlock around each update: it is odd while the
+ * compositor writes and advances by two per snapshot. A reader loads it
+ * (acquire), copies the front slot out, and loads it again after an
+ * acquire fence; the copy is good if both loads returned the same even
+ * value, and is retried otherwise. Readers never draw from the mapping in
+ * place.
+ */
+
+#define OSF_THUMBNAIL_MAGIC 0x4d485456u /* "VTHM" */
+#define OSF_THUMBNAIL_VERSION 1
+
+// Largest snapshot; windows are scaled down to fit, keeping aspect
+#define OSF_THUMBNAIL_MAX_WIDTH 480
+#define OSF_THUMBNAIL_MAX_HEIGHT 320
+#define OSF_THUMBNAIL_STRIDE (OSF_THUMBNAIL_MAX_WIDTH * 4)
+#define OSF_THUMBNAIL_SLOT_SIZE                                                \
+  (OSF_THUMBNAIL_STRIDE * OSF_THUMBNAIL_MAX_HEIGHT)
+
+typedef struct OSFThumbnailSlot {
+  uint32_t width; // Snapshot size within the slot
+  uint32_t height;
+} OSFThumbnailSlot;
+
+typedef struct OSFThumbnailHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sequence; // Seqlock; 0 until the first snapshot, odd while writing
+  uint32_t front;    // Slot readers should show (0 or 1)
+  uint32_t stride;
+  uint32_t format; // DRM fourcc, premultiplied ARGB8888
+  OSFThumbnailSlot slots[2];
+  char title[128];
+  char app_id[64];
+} OSFThumbnailHeader;
+
+#define OSF_THUMBNAIL_HEADER_SIZE 4096 // Slots start page aligned
+#define OSF_THUMBNAIL_FILE_SIZE                                                \
+  (OSF_THUMBNAIL_HEADER_SIZE + 2 * OSF_THUMBNAIL_SLOT_SIZE)
+
+static inline uint32_t osf_thumbnail_slot_offset(uint32_t slot) {
+  return OSF_THUMBNAIL_HEADER_SIZE + slot * OSF_THUMBNAIL_SLOT_SIZE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OSF_FRAMEWORK_THUMBNAIL_H
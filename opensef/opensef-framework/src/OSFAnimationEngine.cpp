@@ -110,13 +110,13 @@ void AnimationEngine::transitionToOnboarding() {
 void AnimationEngine::fadeInWindow(void *windowHandle) {
   LOG("Window fade-in animation [200ms ease-out-cubic]");
   std::cout << "[AnimationEngine]   Window: " << windowHandle << std::endl;
-  // Shell will render actual fade using Qt Quick PropertyAnimation
+  // The compositor fades the scene node itself (animation.c)
 }
 
 void AnimationEngine::fadeOutWindow(void *windowHandle) {
   LOG("Window fade-out animation [200ms ease-in-cubic]");
   std::cout << "[AnimationEngine]   Window: " << windowHandle << std::endl;
-  // Shell will render actual fade using Qt Quick PropertyAnimation
+  // The compositor fades the scene node itself (animation.c)
 }
 
 void AnimationEngine::playWindowMinimize(void *windowHandle) {
@@ -124,7 +124,7 @@ void AnimationEngine::playWindowMinimize(void *windowHandle) {
   std::cout << "[AnimationEngine]   Window: " << windowHandle << std::endl;
   std::cout << "[AnimationEngine]   Effect: Scale down to dock icon"
             << std::endl;
-  // Shell will render scale + position animation using Qt Quick
+  // The compositor scales the scene node toward the dock (animation.c)
 }
 
 void AnimationEngine::playWindowMaximize(void *windowHandle) {
@@ -132,7 +132,7 @@ void AnimationEngine::playWindowMaximize(void *windowHandle) {
   std::cout << "[AnimationEngine]   Window: " << windowHandle << std::endl;
   std::cout << "[AnimationEngine]   Effect: Smooth expand to fullscreen"
             << std::endl;
-  // Shell will render geometry animation using Qt Quick
+  // The compositor morphs the scene node (animation.c)
 }
 
 void AnimationEngine::playWindowTileAnimation(void *windowHandle,
@@ -145,8 +145,8 @@ void AnimationEngine::playWindowTileAnimation(void *windowHandle,
   std::cout
       << "[AnimationEngine]   Curve: Ease-out cubic (0.25, 0.46, 0.45, 0.94)"
       << std::endl;
-  // Shell will render smooth geometry transition using Qt Quick NumberAnimation
-  // with easeOutCubic timing function
+  // The compositor morphs the scene node once the layout transaction
+  // applies, with the same ease-out cubic (animation.c)
 }
 
 void AnimationEngine::playShutdownSequence() {
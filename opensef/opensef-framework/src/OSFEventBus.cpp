@@ -58,12 +58,28 @@ void OSFEventBus::unsubscribeAll(void *owner) {
   }
 }
 
+namespace {
+thread_local uint64_t inputTimestampUsec = 0;
+}
+
+void OSFEventBus::setInputTimestamp(uint64_t usec) { inputTimestampUsec = usec; }
+
+uint64_t OSFEventBus::inputTimestamp() { return inputTimestampUsec; }
+
 void OSFEventBus::publish(const std::string &eventType, const OSFEvent &event) {
+  // Only events caused by input are copied to carry the timestamp
+  OSFEvent traced;
+  if (inputTimestampUsec) {
+    traced = event;
+    traced.set(INPUT_TIME_KEY, inputTimestampUsec);
+  }
+  const OSFEvent &delivered = inputTimestampUsec ? traced : event;
+
   std::lock_guard<std::mutex> lock(impl_->mutex);
   auto it = impl_->handlers.find(eventType);
   if (it != impl_->handlers.end()) {
     for (auto &entry : it->second) {
-      entry.handler(event);
+      entry.handler(delivered);
     }
   }
 }
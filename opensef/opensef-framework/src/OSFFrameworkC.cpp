@@ -101,6 +101,21 @@ void osf_window_close(const char *id) {
   desktop->windowManager()->closeWindow(id);
 }
 
+// Workspaces
+void osf_workspace_set_count(int count) {
+  auto *desktop = OSFDesktop::shared();
+  desktop->stateManager()->setWorkspaceCount(count);
+}
+
+void osf_workspace_activate(int index) {
+  auto *desktop = OSFDesktop::shared();
+  desktop->stateManager()->setCurrentWorkspace(index);
+
+  OSFEvent event;
+  event.set("index", index);
+  desktop->eventBus()->publish("workspace.changed", event);
+}
+
 // Event publishing
 void osf_event_publish(const char *event_type, const char *data) {
   auto *desktop = OSFDesktop::shared();
@@ -108,3 +123,10 @@ void osf_event_publish(const char *event_type, const char *data) {
   event.set("data", std::string(data));
   desktop->eventBus()->publish(event_type, event);
 }
+
+// Input latency tracing
+void osf_input_trace_begin(uint64_t time_usec) {
+  OSFEventBus::setInputTimestamp(time_usec);
+}
+
+void osf_input_trace_end() { OSFEventBus::setInputTimestamp(0); }
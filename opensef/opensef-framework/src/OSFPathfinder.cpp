@@ -11,6 +11,8 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <opensef/OSFTaskScheduler.h>
 #include <sstream>
 
 #define LOG(msg) std::cout << "[Pathfinder] " << msg << std::endl
@@ -21,6 +23,8 @@ struct Pathfinder::Implementation {
   bool visible = false;
   std::string currentQuery;
   ResultsCallback callback = nullptr;
+  Executor executor = nullptr; // Where async results are delivered
+  opensef::OSFCancellationToken inFlight; // Token of the running async query
 
   // Execute shell command and get output
   std::string exec(const char *cmd) {
@@ -126,7 +130,73 @@ SearchResults Pathfinder::search(const std::string &query) {
   return results;
 }
 
-void Pathfinder::setQuery(const std::string &query) { search(query); }
+void Pathfinder::setQuery(const std::string &query) { searchAsync(query); }
+
+void Pathfinder::searchAsync(const std::string &query) {
+  impl_->currentQuery = query;
+
+  // Supersede whatever is still running for the previous keystroke
+  impl_->inFlight.cancel();
+  impl_->inFlight = opensef::OSFCancellationToken::create();
+  opensef::OSFCancellationToken token = impl_->inFlight;
+
+  auto results = std::make_shared<SearchResults>();
+  if (query.empty()) {
+    if (impl_->callback) {
+      impl_->callback(*results);
+    }
+    return;
+  }
+
+  // Nothing to deliver async results on: answer right away
+  if (!impl_->executor) {
+    search(query);
+    return;
+  }
+
+  // Cheap sources read main-thread state (clipboard history): do them here.
+  results->clipboard = searchClipboard(query);
+  results->webActions = prepareWebSearch(query);
+  results->systemActions = searchSystemActions(query);
+
+  // Completions run on the host's executor, so the shared counter and
+  // result set are only ever touched from one thread.
+  auto pending = std::make_shared<int>(3);
+  auto finish = [this, results, pending]() {
+    if (--*pending == 0 && impl_->callback) {
+      impl_->callback(*results);
+    }
+  };
+
+  using opensef::OSFTaskPriority;
+  auto &scheduler = opensef::OSFTaskScheduler::shared();
+  const Executor &executor = impl_->executor;
+
+  scheduler.submit(
+      [this, query]() { return searchApplications(query); },
+      [results, finish](std::vector<SearchResult> found) {
+        results->apps = std::move(found);
+        finish();
+      },
+      executor, OSFTaskPriority::High, token);
+
+  scheduler.submit(
+      [this, query]() { return searchFiles(query); },
+      [results, finish](std::vector<SearchResult> found) {
+        results->files = std::move(found);
+        finish();
+      },
+      executor, OSFTaskPriority::Normal, token);
+
+  // nix search is by far the slowest source
+  scheduler.submit(
+      [this, query]() { return searchNixPackages(query); },
+      [results, finish](std::vector<SearchResult> found) {
+        results->packages = std::move(found);
+        finish();
+      },
+      executor, OSFTaskPriority::Low, token);
+}
 
 std::vector<SearchResult>
 Pathfinder::searchApplications(const std::string &query) {
@@ -401,6 +471,10 @@ void Pathfinder::onResultsChanged(ResultsCallback callback) {
   impl_->callback = callback;
 }
 
+void Pathfinder::setExecutor(Executor executor) {
+  impl_->executor = std::move(executor);
+}
+
 std::vector<SearchResult> SearchResults::sorted() const {
   std::vector<SearchResult> all;
 
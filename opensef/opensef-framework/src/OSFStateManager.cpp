@@ -137,4 +137,26 @@ void OSFStateManager::removeApplication(const std::string &id) {
   }
 }
 
+void OSFStateManager::setWorkspaceCount(int count) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  count = std::max(count, 1);
+  while ((int)impl_->workspaces.size() > count) {
+    delete impl_->workspaces.back();
+    impl_->workspaces.pop_back();
+  }
+  while ((int)impl_->workspaces.size() < count) {
+    int id = (int)impl_->workspaces.size();
+    impl_->workspaces.push_back(
+        new OSFWorkspace(id, "Workspace " + std::to_string(id + 1)));
+  }
+  impl_->currentWorkspace = std::min(impl_->currentWorkspace, count - 1);
+}
+
+void OSFStateManager::setCurrentWorkspace(int index) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  if (index >= 0 && index < (int)impl_->workspaces.size()) {
+    impl_->currentWorkspace = index;
+  }
+}
+
 } // namespace OpenSEF
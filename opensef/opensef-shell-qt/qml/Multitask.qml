@@ -205,10 +205,24 @@ Item {
                         anchors.right: parent.right
                         anchors.bottom: parent.bottom
                         color: "#F8FFFFFF"
-                        
+
+                        // Live snapshot from the compositor
+                        Image {
+                            id: thumbnail
+                            anchors.fill: parent
+                            anchors.margins: 12
+                            source: modelData.thumbnail + "/" + (multitaskController.thumbnailRevisions[modelData.id] || 0)
+                            fillMode: Image.PreserveAspectFit
+                            cache: false
+                            smooth: true
+                            visible: status === Image.Ready
+                        }
+
+                        // Until the first snapshot arrives
                         Column {
                             anchors.centerIn: parent
                             spacing: 32
+                            visible: !thumbnail.visible
                             
                             Image {
                                 width: 128; height: 128
@@ -11,10 +11,16 @@
 #include <QProcess>
 #include <algorithm>
 
+// Half the compositor's default snapshot interval (VITUS_THUMBNAIL_MS)
+static constexpr int kThumbnailPollMs = 100;
+
 MultitaskController::MultitaskController(QObject *parent)
     : QObject(parent), m_active(false), m_selectedIndex(0) {
   qDebug()
       << "[MultitaskController] Initializing. Active state forced to FALSE.";
+  m_thumbnailTimer.setInterval(kThumbnailPollMs);
+  connect(&m_thumbnailTimer, &QTimer::timeout, this,
+          &MultitaskController::pollThumbnails);
   connectToFramework();
 }
 
@@ -41,6 +47,9 @@ void MultitaskController::setActive(bool active) {
     m_active = active;
     if (m_active) {
       refreshWindows();
+      m_thumbnailTimer.start();
+    } else {
+      m_thumbnailTimer.stop();
     }
     emit activeChanged();
   }
@@ -53,33 +62,25 @@ void MultitaskController::toggle() {
 
 void MultitaskController::refreshWindows() {
   m_windows.clear();
-
-  // Native windows for Fusion environment
-  QVariantMap win1;
-  win1["id"] = "window-1";
-  win1["title"] = "Filer";
-  win1["appId"] = "com.vitusos.filer";
-  win1["thumbnail"] = "";
-  win1["name"] = "Filer";
-  m_windows.append(win1);
-
-  QVariantMap win2;
-  win2["id"] = "window-2";
-  win2["title"] = "Safari";
-  win2["appId"] = "com.vitusos.safari";
-  win2["thumbnail"] = "";
-  win2["name"] = "Safari";
-  m_windows.append(win2);
-
-  QVariantMap win3;
-  win3["id"] = "window-3";
-  win3["title"] = "Terminal";
-  win3["appId"] = "com.vitusos.terminal";
-  win3["thumbnail"] = "";
-  win3["name"] = "Terminal";
-  m_windows.append(win3);
+  m_thumbnails.takeWindowsChanged();
+
+  // Windows the compositor shares snapshots of
+  QVariantMap revisions;
+  for (const WindowThumbnails::Window &window : m_thumbnails.windows()) {
+    QVariantMap win;
+    win["id"] = window.id;
+    win["windowId"] = window.id;
+    win["title"] = window.title;
+    win["appId"] = window.appId;
+    win["thumbnail"] = "image://thumbnail/" + window.id;
+    win["name"] = window.title.isEmpty() ? window.appId : window.title;
+    m_windows.append(win);
+    revisions[window.id] = m_thumbnailRevisions.value(window.id, 0);
+  }
+  m_thumbnailRevisions = revisions;
 
   emit windowsChanged();
+  updateThumbnails();
   qDebug() << "[MultitaskController] Refreshed windows:" << m_windows.size();
 
   if (m_selectedIndex >= m_windows.size()) {
@@ -87,6 +88,25 @@ void MultitaskController::refreshWindows() {
   }
 }
 
+void MultitaskController::pollThumbnails() {
+  if (m_thumbnails.takeWindowsChanged()) {
+    refreshWindows();
+  } else {
+    updateThumbnails();
+  }
+}
+
+void MultitaskController::updateThumbnails() {
+  QStringList updated = m_thumbnails.takeUpdated();
+  if (updated.isEmpty()) {
+    return;
+  }
+  for (const QString &id : updated) {
+    m_thumbnailRevisions[id] = m_thumbnailRevisions.value(id, 0).toInt() + 1;
+  }
+  emit thumbnailsChanged();
+}
+
 void MultitaskController::setSelectedIndex(int index) {
   if (index >= 0 && index < m_windows.size() && m_selectedIndex != index) {
     m_selectedIndex = index;
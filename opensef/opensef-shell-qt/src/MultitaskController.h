@@ -1,15 +1,18 @@
 #ifndef MULTITASK_CONTROLLER_H
 #define MULTITASK_CONTROLLER_H
 
+#include "WindowThumbnails.h"
 #include <QObject>
+#include <QTimer>
 #include <QVariantList>
+#include <QVariantMap>
 
 /**
  * MultitaskController - Ares Hybrid Mission Control controller
  *
  * Features:
  * - Panoramic horizontal spread
- * - Real-time window thumbnails via OSFEventBus
+ * - Live window thumbnails shared by the compositor (WindowThumbnails)
  * - High-precision keyboard navigation
  * - Spring-physics driven focus
  */
@@ -20,6 +23,9 @@ class MultitaskController : public QObject {
   Q_PROPERTY(QVariantList windows READ windows NOTIFY windowsChanged)
   Q_PROPERTY(int selectedIndex READ selectedIndex WRITE setSelectedIndex NOTIFY
                  selectedIndexChanged)
+  // Window id -> snapshot count; only bumped windows reload their image
+  Q_PROPERTY(QVariantMap thumbnailRevisions READ thumbnailRevisions NOTIFY
+                 thumbnailsChanged)
 
 public:
   explicit MultitaskController(QObject *parent = nullptr);
@@ -33,6 +39,9 @@ public:
   int selectedIndex() const { return m_selectedIndex; }
   void setSelectedIndex(int index);
 
+  QVariantMap thumbnailRevisions() const { return m_thumbnailRevisions; }
+  WindowThumbnails *thumbnails() { return &m_thumbnails; }
+
 public slots:
   void toggle();
   void focusWindow(const QString &windowId);
@@ -52,13 +61,21 @@ signals:
   void activeChanged();
   void windowsChanged();
   void selectedIndexChanged();
+  void thumbnailsChanged();
 
 private:
   void connectToFramework();
+  void pollThumbnails();
+  void updateThumbnails();
 
   bool m_active = false;
   QVariantList m_windows;
   int m_selectedIndex = 0;
+
+  // Snapshots are only checked while the overview is shown
+  WindowThumbnails m_thumbnails;
+  QVariantMap m_thumbnailRevisions;
+  QTimer m_thumbnailTimer;
 };
 
 #endif // MULTITASK_CONTROLLER_H
@@ -0,0 +1,37 @@
+#ifndef THUMBNAIL_PROVIDER_H
+#define THUMBNAIL_PROVIDER_H
+
+#include "WindowThumbnails.h"
+#include <QQuickImageProvider>
+
+/**
+ * ThumbnailProvider - Resolves image://thumbnail/<window-id>/<revision> URLs
+ *
+ * Serves the live snapshot the compositor shares for a window. The
+ * revision only makes QML ask again after a new snapshot.
+ */
+class ThumbnailProvider : public QQuickImageProvider {
+public:
+  explicit ThumbnailProvider(WindowThumbnails *thumbnails)
+      : QQuickImageProvider(QQuickImageProvider::Image),
+        m_thumbnails(thumbnails) {}
+
+  QImage requestImage(const QString &id, QSize *size,
+                      const QSize &requestedSize) override {
+    QImage image = m_thumbnails->image(id.section('/', 0, 0));
+    if (size) {
+      *size = image.size();
+    }
+    if (!image.isNull() && requestedSize.isValid() &&
+        image.size() != requestedSize) {
+      image = image.scaled(requestedSize, Qt::KeepAspectRatio,
+                           Qt::SmoothTransformation);
+    }
+    return image;
+  }
+
+private:
+  WindowThumbnails *m_thumbnails;
+};
+
+#endif // THUMBNAIL_PROVIDER_H
@@ -0,0 +1,204 @@
+#include "WindowThumbnails.h"
+#include "qwayland-vitus-thumbnail-unstable-v1.h"
+#include <opensef/OSFThumbnail.h>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtWaylandClient/QWaylandClientExtension>
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+// A reader racing the compositor retries; more than a few misses in a
+// row means it is busy, and the previous copy will do
+static constexpr int kCopyAttempts = 4;
+
+struct WindowThumbnails::Mapping {
+  const uchar *data = nullptr;
+  QImage last; // Copy of the front slot at lastSequence
+  quint32 lastSequence = 0;
+
+  ~Mapping() {
+    if (data) {
+      munmap(const_cast<uchar *>(data), OSF_THUMBNAIL_FILE_SIZE);
+    }
+  }
+
+  const OSFThumbnailHeader *header() const {
+    return reinterpret_cast<const OSFThumbnailHeader *>(data);
+  }
+
+  quint32 sequence() const {
+    return __atomic_load_n(&header()->sequence, __ATOMIC_ACQUIRE);
+  }
+
+  // Runs `read` until it saw no snapshot being written; false if the
+  // compositor kept writing
+  template <typename Read> bool readConsistent(Read read) const {
+    for (int attempt = 0; attempt < kCopyAttempts; ++attempt) {
+      quint32 before = sequence();
+      if (before & 1) {
+        QThread::yieldCurrentThread();
+        continue;
+      }
+      bool ok = read(before);
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&header()->sequence, __ATOMIC_RELAXED) == before) {
+        return ok;
+      }
+    }
+    return false;
+  }
+};
+
+namespace {
+
+QString fromHeader(const char *text, size_t size) {
+  return QString::fromUtf8(text, static_cast<int>(strnlen(text, size)));
+}
+
+} // namespace
+
+/* ============================================================================
+ * zvitus_thumbnail_manager_v1
+ * ============================================================================
+ */
+
+class WindowThumbnails::Manager
+    : public QWaylandClientExtensionTemplate<Manager>,
+      public QtWayland::zvitus_thumbnail_manager_v1 {
+public:
+  explicit Manager(WindowThumbnails *owner)
+      : QWaylandClientExtensionTemplate<Manager>(1), m_owner(owner) {
+    initialize();
+  }
+
+protected:
+  void zvitus_thumbnail_manager_v1_window(const QString &id, int32_t fd,
+                                          uint32_t size) override {
+    void *data = MAP_FAILED;
+    if (size == OSF_THUMBNAIL_FILE_SIZE) {
+      data =
+          mmap(nullptr, OSF_THUMBNAIL_FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+      qWarning() << "[WindowThumbnails] Cannot map thumbnail:" << id;
+      return;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->data = static_cast<const uchar *>(data);
+    if (mapping->header()->magic != OSF_THUMBNAIL_MAGIC ||
+        mapping->header()->version != OSF_THUMBNAIL_VERSION) {
+      qWarning() << "[WindowThumbnails] Unknown thumbnail format:" << id;
+      return;
+    }
+
+    QMutexLocker lock(&m_owner->m_mutex);
+    m_owner->m_mappings.insert(id, mapping);
+    m_owner->m_windowsChanged = true;
+  }
+
+  void zvitus_thumbnail_manager_v1_closed(const QString &id) override {
+    QMutexLocker lock(&m_owner->m_mutex);
+    m_owner->m_sequences.remove(id);
+    m_owner->m_mappings.remove(id);
+    m_owner->m_windowsChanged = true;
+  }
+
+private:
+  WindowThumbnails *m_owner;
+};
+
+/* ============================================================================
+ * WindowThumbnails
+ * ============================================================================
+ */
+
+WindowThumbnails::WindowThumbnails()
+    : m_manager(std::make_unique<Manager>(this)) {}
+
+WindowThumbnails::~WindowThumbnails() = default;
+
+bool WindowThumbnails::takeWindowsChanged() {
+  QMutexLocker lock(&m_mutex);
+  return std::exchange(m_windowsChanged, false);
+}
+
+QStringList WindowThumbnails::takeUpdated() {
+  QMutexLocker lock(&m_mutex);
+  QStringList updated;
+  for (auto it = m_mappings.cbegin(); it != m_mappings.cend(); ++it) {
+    quint32 sequence = it.value()->sequence();
+    // Mid-write: the finished snapshot shows up on the next call
+    if (!(sequence & 1) && sequence != m_sequences.value(it.key())) {
+      m_sequences.insert(it.key(), sequence);
+      updated.append(it.key());
+    }
+  }
+  return updated;
+}
+
+QList<WindowThumbnails::Window> WindowThumbnails::windows() const {
+  QMutexLocker lock(&m_mutex);
+  QList<Window> windows;
+  for (auto it = m_mappings.cbegin(); it != m_mappings.cend(); ++it) {
+    const OSFThumbnailHeader *header = it.value()->header();
+    Window window{it.key(), QString(), QString()};
+    it.value()->readConsistent([&](quint32) {
+      window.title = fromHeader(header->title, sizeof(header->title));
+      window.appId = fromHeader(header->app_id, sizeof(header->app_id));
+      return true;
+    });
+    windows.append(window);
+  }
+  std::sort(windows.begin(), windows.end(),
+            [](const Window &a, const Window &b) { return a.id < b.id; });
+  return windows;
+}
+
+QImage WindowThumbnails::image(const QString &id) const {
+  QMutexLocker lock(&m_mutex);
+  std::shared_ptr<Mapping> mapping = m_mappings.value(id);
+  if (!mapping) {
+    return QImage();
+  }
+  if (mapping->sequence() == mapping->lastSequence) {
+    return mapping->last;
+  }
+
+  const OSFThumbnailHeader *header = mapping->header();
+  QImage copy;
+  quint32 sequence = 0;
+  bool ok = mapping->readConsistent([&](quint32 before) {
+    quint32 front = __atomic_load_n(&header->front, __ATOMIC_RELAXED) & 1;
+    const OSFThumbnailSlot &slot = header->slots[front];
+    quint32 width = __atomic_load_n(&slot.width, __ATOMIC_RELAXED);
+    quint32 height = __atomic_load_n(&slot.height, __ATOMIC_RELAXED);
+    if (before == 0 || width == 0 || height == 0 ||
+        width > OSF_THUMBNAIL_MAX_WIDTH || height > OSF_THUMBNAIL_MAX_HEIGHT) {
+      return false;
+    }
+
+    // DRM ARGB8888 is Qt's ARGB32 on little-endian
+    const uchar *pixels = mapping->data + osf_thumbnail_slot_offset(front);
+    copy = QImage(static_cast<int>(width), static_cast<int>(height),
+                  QImage::Format_ARGB32_Premultiplied);
+    for (quint32 y = 0; y < height; ++y) {
+      memcpy(copy.scanLine(static_cast<int>(y)),
+             pixels + y * OSF_THUMBNAIL_STRIDE, width * 4);
+    }
+    sequence = before;
+    return true;
+  });
+  if (!ok) {
+    return mapping->last; // Null until a first snapshot copied cleanly
+  }
+
+  mapping->last = copy;
+  mapping->lastSequence = sequence;
+  return copy;
+}
@@ -0,0 +1,53 @@
+#ifndef WINDOW_THUMBNAILS_H
+#define WINDOW_THUMBNAILS_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+/**
+ * WindowThumbnails - Live window snapshots shared by the compositor
+ *
+ * Receives each window's thumbnail memfd over zvitus_thumbnail_manager_v1
+ * and maps it read-only (see <opensef/OSFThumbnail.h>). Images are copied
+ * out of the mapping under the header's seqlock, so one never shows a
+ * snapshot the compositor is halfway through rewriting. Must be created
+ * after the QGuiApplication.
+ */
+class WindowThumbnails {
+public:
+  struct Window {
+    QString id; // "window-0x..." as known to the framework
+    QString title;
+    QString appId;
+  };
+
+  WindowThumbnails();
+  ~WindowThumbnails();
+
+  // True once after windows appeared or went away
+  bool takeWindowsChanged();
+
+  // Windows with a new snapshot since the last call
+  QStringList takeUpdated();
+
+  QList<Window> windows() const;
+
+  // Null until the compositor has rendered a first snapshot
+  QImage image(const QString &id) const;
+
+private:
+  struct Mapping;
+  class Manager;
+
+  mutable QMutex m_mutex; // image() also runs on QML loader threads
+  QHash<QString, std::shared_ptr<Mapping>> m_mappings;
+  QHash<QString, quint32> m_sequences; // Last seen by takeUpdated()
+  bool m_windowsChanged = false;
+  std::unique_ptr<Manager> m_manager; // Last: gone before the mappings
+};
+
+#endif // WINDOW_THUMBNAILS_H
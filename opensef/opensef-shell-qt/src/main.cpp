@@ -20,6 +20,7 @@
 #include "MultitaskController.h"
 #include "PanelController.h"
 #include "SystemTrayController.h"
+#include "ThumbnailProvider.h"
 #include <opensef/OSFDesktop.h>
 
 // Import GNUstep Bridge
@@ -86,6 +87,9 @@ int main(int argc, char *argv[]) {
 
   // Register image providers
   engine.addImageProvider(QLatin1String("icon"), new IconProvider());
+  engine.addImageProvider(
+      QLatin1String("thumbnail"),
+      new ThumbnailProvider(multitaskController.thumbnails()));
 
   // Expose controllers to QML
   QQmlContext *context = engine.rootContext();
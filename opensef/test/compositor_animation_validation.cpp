@@ -0,0 +1,119 @@
+/**
+ * compositor_animation_validation.cpp - Window Animation Validation
+ *
+ * Runs opensef-compositor headless (headless_compositor.h) and checks on
+ * captured frames that a closed window fades out where it was, shrinking
+ * toward its own center, and is gone once OSF_ANIM_UNMAP_MS has passed;
+ * and that a window maximized while tiled unmaximizes back to where it
+ * was mapped.
+ */
+
+#include "headless_compositor.h"
+
+#include <iostream>
+
+using namespace osftest;
+
+namespace {
+
+// Durations from animation.h
+constexpr int kMapMs = 200;
+constexpr int kUnmapMs = 200;
+constexpr int kGeometryMs = 200;
+
+constexpr uint32_t kColor = 0xffff00ffu;
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+
+} // namespace
+
+int main() {
+  printBanner("Animation");
+
+  HeadlessCompositor compositor;
+  if (!compositor.start())
+    return 1;
+
+  // 1. The close animation draws the last frame over the window's place
+  std::cout << "[1] Testing the close animation...\n";
+  {
+    Image background;
+    if (!compositor.capture(background)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    Rect box;
+    Window *window =
+        compositor.showWindow(kWidth, kHeight, kColor, true, box, kMapMs + 100);
+    if (!window)
+      return 1;
+
+    // The next frame after the unmap: the ghost, barely faded
+    compositor.destroyWindow(window);
+    Image closing;
+    if (!compositor.capture(closing)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    const Rect ghost = closing.diff(background);
+    const int cx = box.x + box.width / 2, cy = box.y + box.height / 2;
+    if (ghost.empty() || !ghost.contains(cx, cy)) {
+      std::cout << "    ✗ No ghost over the window's center (" << ghost
+                << ")\n";
+      return 1;
+    }
+    if (!box.contains(ghost)) {
+      std::cout << "    ✗ Ghost at " << ghost << ", window was at " << box
+                << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Ghost " << ghost << " inside the window's " << box
+              << "\n";
+
+    compositor.dispatch(kUnmapMs + 100);
+    Image closed;
+    compositor.capture(closed);
+    const Rect left = closed.diff(background);
+    if (!left.empty()) {
+      std::cout << "    ✗ " << left << " still differs after the fade\n";
+      return 1;
+    }
+    std::cout << "    ✓ Gone after " << kUnmapMs << " ms\n\n";
+  }
+
+  // 2. Maximized while tiled, then unmaximized while floating
+  std::cout << "[2] Testing unmaximize without a saved geometry...\n";
+  {
+    Rect mapped;
+    Window *window = compositor.showWindow(kWidth, kHeight, kColor, true,
+                                           mapped, kMapMs + 100);
+    if (!window)
+      return 1;
+    Image image;
+
+    compositor.superKey(KEY_T); // Tile
+    compositor.dispatch(400);
+    xdg_toplevel_set_maximized(window->toplevel);
+    compositor.dispatch(200);
+    compositor.superKey(KEY_T); // Float again
+    compositor.dispatch(400);
+    xdg_toplevel_unset_maximized(window->toplevel);
+    compositor.dispatch(kGeometryMs + 300);
+
+    compositor.capture(image);
+    const Rect restored = image.find(kColor);
+    if (restored.x != mapped.x || restored.y != mapped.y) {
+      std::cout << "    ✗ Restored to " << restored << ", mapped at "
+                << mapped << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Back at " << restored << "\n";
+    compositor.destroyWindow(window);
+  }
+
+  compositor.stop();
+
+  printPassed("Animation");
+
+  return 0;
+}
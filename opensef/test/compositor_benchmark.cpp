@@ -0,0 +1,1101 @@
+/**
+ * compositor_benchmark.cpp - Headless Compositor Benchmark
+ *
+ * Starts opensef-compositor on the wlroots headless backend with the pixman
+ * renderer, loads it with synthetic Wayland clients and drives scripted
+ * scenarios through a virtual keyboard and pointer:
+ *
+ *   steady    N toplevels (plus popups and layer surfaces) committing
+ *   storm     toplevels opened and closed as fast as they map
+ *   drag      pointer hover over a window, then the window dragged around
+ *   tiling    tiling toggled on, its layouts cycled, toggled off
+ *   overview  the overview toggled in and out
+ *   click     clicks across tiled windows, moving focus, and typing
+ *
+ * Frame times come from a small overlay layer surface that redraws on every
+ * frame callback; CPU and memory are read from /proc for the compositor.
+ * The compositor runs with VITUS_LATENCY_TRACE=1, and its per-stage input
+ * latency report (latency.h, over the whole run) is included as
+ * "compositor_latency". Results are printed as one JSON object, to compare
+ * across commits. Globals, shm buffers and virtual input come from the
+ * test harness (headless_compositor.h).
+ *
+ * Usage: compositor-benchmark [--compositor PATH] [--clients N]
+ *          [--size WxH] [--rate HZ] [--popups] [--layers N]
+ *          [--duration SECONDS] [--scenarios steady,storm,...]
+ *          [--output FILE] [--verbose]
+ */
+
+#include "headless_compositor.h"
+
+#include <cmath>
+
+using namespace osftest;
+
+namespace {
+
+// Where the compositor maps new floating windows (view.c)
+constexpr int kMapX = 50;
+constexpr int kMapY = 50;
+
+struct Options {
+  std::string compositor = OSF_COMPOSITOR_PATH;
+  int clients = 8;
+  int width = 640;
+  int height = 480;
+  double rateHz = 30;
+  bool popups = false;
+  int layers = 1;
+  double durationS = 3;
+  std::vector<std::string> scenarios = {
+      "steady", "storm", "drag", "tiling", "overview", "click"};
+  std::string output;
+  bool verbose = false;
+};
+
+// ============================================================================
+// Statistics and JSON
+// ============================================================================
+
+class Stats {
+public:
+  void add(double value) { samples_.push_back(value); }
+  size_t count() const { return samples_.size(); }
+
+  std::string json() const {
+    std::ostringstream out;
+    out << "{\"count\": " << samples_.size();
+    if (!samples_.empty()) {
+      std::vector<double> sorted = samples_;
+      std::sort(sorted.begin(), sorted.end());
+      double sum = 0;
+      for (double v : sorted)
+        sum += v;
+      out << ", \"mean\": " << sum / sorted.size()
+          << ", \"p50\": " << percentile(sorted, 0.50)
+          << ", \"p95\": " << percentile(sorted, 0.95)
+          << ", \"p99\": " << percentile(sorted, 0.99)
+          << ", \"max\": " << sorted.back();
+    }
+    out << "}";
+    return out.str();
+  }
+
+private:
+  static double percentile(const std::vector<double> &sorted, double p) {
+    size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+  }
+
+  std::vector<double> samples_;
+};
+
+// ============================================================================
+// Compositor process
+// ============================================================================
+
+struct ProcessSample {
+  double cpuMs = 0;
+  long rssKb = 0;
+  long peakRssKb = 0;
+};
+
+ProcessSample sampleProcess(pid_t pid) {
+  ProcessSample sample;
+  std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  if (std::getline(stat, line)) {
+    // Fields after the parenthesized command; utime and stime are 14, 15
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    for (int i = 3; fields >> field; ++i) {
+      if (i == 14)
+        utime = std::stoull(field);
+      if (i == 15) {
+        stime = std::stoull(field);
+        break;
+      }
+    }
+    sample.cpuMs = (utime + stime) * 1000.0 / sysconf(_SC_CLK_TCK);
+  }
+
+  std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+  while (std::getline(status, line)) {
+    if (line.rfind("VmRSS:", 0) == 0)
+      sample.rssKb = std::atol(line.c_str() + 6);
+    else if (line.rfind("VmHWM:", 0) == 0)
+      sample.peakRssKb = std::atol(line.c_str() + 6);
+  }
+  return sample;
+}
+
+// ============================================================================
+// Synthetic clients
+// ============================================================================
+
+class Benchmark;
+struct Surface;
+
+// One client process's connection; its pointer events go to the benchmark
+struct Connection : PointerSink {
+  Benchmark *bench = nullptr;
+  wl_display *display = nullptr;
+  wl_registry *registry = nullptr;
+  Globals globals;
+  Surface *pointerFocus = nullptr;
+  std::vector<std::unique_ptr<Surface>> surfaces;
+
+  void pointerEnter(wl_surface *surface) override;
+  void pointerLeave() override { pointerFocus = nullptr; }
+  void pointerMotion() override;
+  void pointerButton(uint32_t serial, uint32_t state) override;
+};
+
+enum class Role { Toplevel, Popup, Layer, Probe };
+
+struct Surface {
+  Connection *conn = nullptr;
+  Role role = Role::Toplevel;
+  wl_surface *surface = nullptr;
+  xdg_surface *xdgSurface = nullptr;
+  xdg_toplevel *toplevel = nullptr;
+  xdg_popup *popup = nullptr;
+  zwlr_layer_surface_v1 *layer = nullptr;
+
+  int width = 0, height = 0;               // Size of the next buffer
+  int defaultWidth = 0, defaultHeight = 0; // When the compositor says 0
+  bool configured = false;
+  bool mapped = false;
+  bool closed = false;
+  double createdAt = 0;
+  double configuredAt = 0;
+
+  double periodMs = 0; // 0: only commits when told to
+  double nextCommit = 0;
+  unsigned frame = 0;
+  std::vector<ShmBuffer *> buffers;
+
+  wl_callback *frameCallback = nullptr;
+  double committedAt = 0;
+};
+
+void destroySurface(Surface *s) {
+  if (s->frameCallback)
+    wl_callback_destroy(s->frameCallback);
+  for (ShmBuffer *buffer : s->buffers) {
+    if (buffer->busy)
+      buffer->retired = true;
+    else
+      destroyShmBuffer(buffer);
+  }
+  s->buffers.clear();
+  if (s->popup)
+    xdg_popup_destroy(s->popup);
+  if (s->toplevel)
+    xdg_toplevel_destroy(s->toplevel);
+  if (s->xdgSurface)
+    xdg_surface_destroy(s->xdgSurface);
+  if (s->layer)
+    zwlr_layer_surface_v1_destroy(s->layer);
+  wl_surface_destroy(s->surface);
+  s->surface = nullptr;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+class Benchmark {
+public:
+  explicit Benchmark(const Options &options) : opts_(options) {}
+  ~Benchmark() { shutdown(); }
+
+  bool start();
+  void shutdown();
+  std::string runScenario(const std::string &name);
+  bool failed() const { return failed_; }
+  const std::string &compositorLatency() const { return latencyReport_; }
+
+  // Event hooks, called from the protocol listeners
+  void surfaceConfigured(Surface *s);
+  void frameDone(Surface *s);
+  void pointerMotion();
+  void pointerButton(Surface *s, uint32_t serial, uint32_t state);
+
+private:
+  bool spawnCompositor();
+  Connection *connect();
+  Surface *createToplevel(Connection *conn, double periodMs);
+  Surface *createPopup(Surface *parent);
+  Surface *createLayer(Connection *conn, Role role, double periodMs);
+  void draw(Surface *s);
+  ShmBuffer *freeBuffer(Surface *s);
+
+  bool pump(double durationMs, const std::function<void(double)> &tick = {});
+  void removeClosed();
+
+  void key(uint32_t keycode, uint32_t state);
+  void superKey(uint32_t keycode);
+  void pointerTo(double x, double y);
+  void button(uint32_t state);
+
+  std::string scenarioSteady();
+  std::string scenarioStorm();
+  std::string scenarioDrag();
+  std::string scenarioTiling();
+  std::string scenarioOverview();
+  std::string scenarioClick();
+
+  Options opts_;
+  pid_t pid_ = -1;
+  std::string runtimeDir_;
+  std::string socket_;
+  bool ownRuntimeDir_ = false;
+  std::vector<std::unique_ptr<Connection>> connections_;
+  Connection *control_ = nullptr; // Virtual input, layers, probe
+  zwp_virtual_keyboard_v1 *keyboard_ = nullptr;
+  zwlr_virtual_pointer_v1 *pointer_ = nullptr;
+  std::vector<Surface *> toplevels_;
+
+  // Probe: output frame intervals
+  double lastProbeFrame_ = 0;
+  Stats frameIntervals_;
+  size_t probeFrames_ = 0;
+
+  // Per scenario
+  Stats callbackLatency_; // Commit to frame callback, load clients
+  Stats inputLatency_;    // Virtual pointer motion to wl_pointer.motion
+  Stats mapLatency_;      // Toplevel created to first frame shown
+  double motionSentAt_ = 0;
+  double buttonSentAt_ = 0;
+  Stats buttonLatency_; // Virtual button to wl_pointer.button
+  bool dragArmed_ = false;
+  int configuresSinceMark_ = 0;
+  Connection *storm_ = nullptr;
+  bool failed_ = false;
+  std::string latencyReport_;
+};
+
+// ---- Listeners -------------------------------------------------------------
+
+void Connection::pointerEnter(wl_surface *surface) {
+  pointerFocus = nullptr;
+  for (auto &s : surfaces) {
+    if (s->surface == surface)
+      pointerFocus = s.get();
+  }
+}
+
+void Connection::pointerMotion() { bench->pointerMotion(); }
+
+void Connection::pointerButton(uint32_t serial, uint32_t state) {
+  if (pointerFocus)
+    bench->pointerButton(pointerFocus, serial, state);
+}
+
+void xdgSurfaceConfigure(void *data, xdg_surface *xdgSurface,
+                         uint32_t serial) {
+  Surface *s = static_cast<Surface *>(data);
+  xdg_surface_ack_configure(xdgSurface, serial);
+  s->conn->bench->surfaceConfigured(s);
+}
+
+const xdg_surface_listener kXdgSurfaceListener = {xdgSurfaceConfigure};
+
+void toplevelConfigure(void *data, xdg_toplevel *, int32_t width,
+                       int32_t height, wl_array *) {
+  Surface *s = static_cast<Surface *>(data);
+  s->width = width > 0 ? width : s->defaultWidth;
+  s->height = height > 0 ? height : s->defaultHeight;
+}
+
+void toplevelClose(void *data, xdg_toplevel *) {
+  static_cast<Surface *>(data)->closed = true;
+}
+
+const xdg_toplevel_listener kToplevelListener = [] {
+  xdg_toplevel_listener listener{};
+  listener.configure = toplevelConfigure;
+  listener.close = toplevelClose;
+  return listener;
+}();
+
+void popupConfigure(void *data, xdg_popup *, int32_t, int32_t, int32_t width,
+                    int32_t height) {
+  Surface *s = static_cast<Surface *>(data);
+  s->width = width;
+  s->height = height;
+}
+
+void popupDone(void *data, xdg_popup *) {
+  static_cast<Surface *>(data)->closed = true;
+}
+
+const xdg_popup_listener kPopupListener = [] {
+  xdg_popup_listener listener{};
+  listener.configure = popupConfigure;
+  listener.popup_done = popupDone;
+  return listener;
+}();
+
+void layerConfigure(void *data, zwlr_layer_surface_v1 *layer, uint32_t serial,
+                    uint32_t width, uint32_t height) {
+  Surface *s = static_cast<Surface *>(data);
+  zwlr_layer_surface_v1_ack_configure(layer, serial);
+  s->width = width > 0 ? static_cast<int>(width) : s->defaultWidth;
+  s->height = height > 0 ? static_cast<int>(height) : s->defaultHeight;
+  s->conn->bench->surfaceConfigured(s);
+}
+
+void layerClosed(void *data, zwlr_layer_surface_v1 *) {
+  static_cast<Surface *>(data)->closed = true;
+}
+
+const zwlr_layer_surface_v1_listener kLayerListener = {layerConfigure,
+                                                       layerClosed};
+
+void frameCallbackDone(void *data, wl_callback *callback, uint32_t) {
+  Surface *s = static_cast<Surface *>(data);
+  wl_callback_destroy(callback);
+  s->frameCallback = nullptr;
+  s->conn->bench->frameDone(s);
+}
+
+const wl_callback_listener kFrameListener = {frameCallbackDone};
+
+// ---- Process and connections -----------------------------------------------
+
+bool Benchmark::spawnCompositor() {
+  const char *runtime = getenv("XDG_RUNTIME_DIR");
+  if (runtime && runtime[0] != '\0') {
+    runtimeDir_ = runtime;
+  } else {
+    char dir[] = "/tmp/osf-bench-XXXXXX";
+    if (!mkdtemp(dir))
+      return false;
+    runtimeDir_ = dir;
+    ownRuntimeDir_ = true;
+    setenv("XDG_RUNTIME_DIR", dir, 1);
+  }
+  socket_ = "osf-bench-" + std::to_string(getpid());
+
+  pid_ = fork();
+  if (pid_ < 0)
+    return false;
+  if (pid_ == 0) {
+    setenv("VITUS_BACKEND", "headless", 1);
+    setenv("WLR_RENDERER", "pixman", 1);
+    setenv("WLR_HEADLESS_OUTPUTS", "1", 1);
+    setenv("WLR_LIBINPUT_NO_DEVICES", "1", 1);
+    setenv("VITUS_VIRTUAL_INPUT", "1", 1);
+    setenv("VITUS_LATENCY_TRACE", "1", 1);
+    if (!opts_.verbose) {
+      FILE *null = fopen("/dev/null", "w");
+      if (null) {
+        dup2(fileno(null), STDOUT_FILENO);
+        dup2(fileno(null), STDERR_FILENO);
+      }
+    }
+    execl(opts_.compositor.c_str(), opts_.compositor.c_str(), "-s",
+          socket_.c_str(), static_cast<char *>(nullptr));
+    _exit(127);
+  }
+  return true;
+}
+
+Connection *Benchmark::connect() {
+  auto conn = std::make_unique<Connection>();
+  conn->bench = this;
+  conn->display = wl_display_connect(socket_.c_str());
+  if (!conn->display)
+    return nullptr;
+  conn->registry = wl_display_get_registry(conn->display);
+  conn->globals.sink = conn.get();
+  wl_registry_add_listener(conn->registry, &kHarnessRegistryListener,
+                           &conn->globals);
+  wl_display_roundtrip(conn->display); // Globals
+  wl_display_roundtrip(conn->display); // Seat capabilities
+  if (!conn->globals.compositor || !conn->globals.shm ||
+      !conn->globals.wmBase)
+    return nullptr;
+  connections_.push_back(std::move(conn));
+  return connections_.back().get();
+}
+
+bool Benchmark::start() {
+  if (!spawnCompositor()) {
+    std::cerr << "Cannot start " << opts_.compositor << "\n";
+    return false;
+  }
+
+  // The socket shows up once the compositor is initialized
+  double deadline = nowMs() + 10000;
+  while (!(control_ = connect())) {
+    int status;
+    if (waitpid(pid_, &status, WNOHANG) == pid_) {
+      std::cerr << opts_.compositor << " exited during startup\n";
+      pid_ = -1;
+      return false;
+    }
+    if (nowMs() > deadline) {
+      std::cerr << "Timed out waiting for the compositor socket\n";
+      return false;
+    }
+    usleep(20000);
+  }
+  const Globals &g = control_->globals;
+  if (!g.layerShell || !g.keyboardManager || !g.pointerManager || !g.seat) {
+    std::cerr << "Compositor lacks layer shell or virtual input\n";
+    return false;
+  }
+
+  keyboard_ = createVirtualKeyboard(g.keyboardManager, g.seat);
+  pointer_ = zwlr_virtual_pointer_manager_v1_create_virtual_pointer(
+      g.pointerManager, g.seat);
+
+  // Frame clock probe, always on top and always damaged
+  createLayer(control_, Role::Probe, 0);
+  for (int i = 0; i < opts_.layers; ++i)
+    createLayer(control_, Role::Layer, 1000.0 / opts_.rateHz);
+
+  // Client load, one connection each like real applications
+  for (int i = 0; i < opts_.clients; ++i) {
+    Connection *conn = connect();
+    if (!conn) {
+      std::cerr << "Client " << i << " could not connect\n";
+      return false;
+    }
+    toplevels_.push_back(createToplevel(conn, 1000.0 / opts_.rateHz));
+  }
+
+  // Until everything is mapped
+  return pump(1000);
+}
+
+void Benchmark::shutdown() {
+  for (auto &conn : connections_) {
+    for (auto &s : conn->surfaces) {
+      if (s->surface)
+        destroySurface(s.get());
+    }
+    wl_display_flush(conn->display);
+    wl_display_disconnect(conn->display);
+  }
+  connections_.clear();
+  if (pid_ > 0) {
+    kill(pid_, SIGTERM);
+    waitpid(pid_, nullptr, 0);
+    pid_ = -1;
+
+    // Written by the compositor on its way out
+    const std::string report =
+        runtimeDir_ + "/vitus-latency-" + socket_ + ".json";
+    std::ifstream in(report);
+    std::getline(in, latencyReport_);
+    unlink(report.c_str());
+  }
+  if (ownRuntimeDir_) {
+    rmdir(runtimeDir_.c_str());
+    ownRuntimeDir_ = false;
+  }
+}
+
+// ---- Surfaces --------------------------------------------------------------
+
+Surface *Benchmark::createToplevel(Connection *conn, double periodMs) {
+  auto s = std::make_unique<Surface>();
+  s->conn = conn;
+  s->role = Role::Toplevel;
+  s->defaultWidth = opts_.width;
+  s->defaultHeight = opts_.height;
+  s->periodMs = periodMs;
+  s->createdAt = nowMs();
+  s->surface = wl_compositor_create_surface(conn->globals.compositor);
+  s->xdgSurface = xdg_wm_base_get_xdg_surface(conn->globals.wmBase, s->surface);
+  xdg_surface_add_listener(s->xdgSurface, &kXdgSurfaceListener, s.get());
+  s->toplevel = xdg_surface_get_toplevel(s->xdgSurface);
+  xdg_toplevel_add_listener(s->toplevel, &kToplevelListener, s.get());
+  xdg_toplevel_set_title(s->toplevel, "compositor-benchmark");
+  xdg_toplevel_set_app_id(s->toplevel, "org.opensef.benchmark");
+  wl_surface_commit(s->surface);
+  conn->surfaces.push_back(std::move(s));
+  return conn->surfaces.back().get();
+}
+
+Surface *Benchmark::createPopup(Surface *parent) {
+  Connection *conn = parent->conn;
+  auto s = std::make_unique<Surface>();
+  s->conn = conn;
+  s->role = Role::Popup;
+  s->periodMs = parent->periodMs;
+  s->createdAt = nowMs();
+  s->surface = wl_compositor_create_surface(conn->globals.compositor);
+  s->xdgSurface = xdg_wm_base_get_xdg_surface(conn->globals.wmBase, s->surface);
+  xdg_surface_add_listener(s->xdgSurface, &kXdgSurfaceListener, s.get());
+
+  xdg_positioner *positioner =
+      xdg_wm_base_create_positioner(conn->globals.wmBase);
+  xdg_positioner_set_size(positioner, 200, 120);
+  xdg_positioner_set_anchor_rect(positioner, 20, 20, 1, 1);
+  xdg_positioner_set_anchor(positioner, XDG_POSITIONER_ANCHOR_BOTTOM_RIGHT);
+  xdg_positioner_set_gravity(positioner, XDG_POSITIONER_GRAVITY_BOTTOM_RIGHT);
+  s->popup = xdg_surface_get_popup(s->xdgSurface, parent->xdgSurface,
+                                   positioner);
+  xdg_positioner_destroy(positioner);
+  xdg_popup_add_listener(s->popup, &kPopupListener, s.get());
+  wl_surface_commit(s->surface);
+  conn->surfaces.push_back(std::move(s));
+  return conn->surfaces.back().get();
+}
+
+Surface *Benchmark::createLayer(Connection *conn, Role role, double periodMs) {
+  auto s = std::make_unique<Surface>();
+  s->conn = conn;
+  s->role = role;
+  s->periodMs = periodMs;
+  s->createdAt = nowMs();
+  s->surface = wl_compositor_create_surface(conn->globals.compositor);
+  if (role == Role::Probe) {
+    s->defaultWidth = s->defaultHeight = 32;
+    s->layer = zwlr_layer_shell_v1_get_layer_surface(
+        conn->globals.layerShell, s->surface, nullptr,
+        ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY, "benchmark-probe");
+    zwlr_layer_surface_v1_set_size(s->layer, 32, 32);
+    zwlr_layer_surface_v1_set_anchor(s->layer,
+                                     ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM |
+                                         ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+  } else {
+    // Panel-like strip along the top
+    s->defaultWidth = kOutputWidth;
+    s->defaultHeight = 28;
+    s->layer = zwlr_layer_shell_v1_get_layer_surface(
+        conn->globals.layerShell, s->surface, nullptr,
+        ZWLR_LAYER_SHELL_V1_LAYER_TOP, "benchmark-panel");
+    zwlr_layer_surface_v1_set_size(s->layer, 0, 28);
+    zwlr_layer_surface_v1_set_anchor(s->layer,
+                                     ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP |
+                                         ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT |
+                                         ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+  }
+  zwlr_layer_surface_v1_add_listener(s->layer, &kLayerListener, s.get());
+  wl_surface_commit(s->surface);
+  conn->surfaces.push_back(std::move(s));
+  return conn->surfaces.back().get();
+}
+
+ShmBuffer *Benchmark::freeBuffer(Surface *s) {
+  for (auto it = s->buffers.begin(); it != s->buffers.end();) {
+    ShmBuffer *buffer = *it;
+    if (buffer->width == s->width && buffer->height == s->height) {
+      if (!buffer->busy)
+        return buffer;
+      ++it;
+    } else {
+      // Resized: drop buffers of the old size
+      it = s->buffers.erase(it);
+      if (buffer->busy)
+        buffer->retired = true;
+      else
+        destroyShmBuffer(buffer);
+    }
+  }
+  if (s->buffers.size() >= 3)
+    return nullptr; // Compositor holds them all; skip this commit
+  ShmBuffer *buffer =
+      createShmBuffer(s->conn->globals.shm, s->width, s->height, s->width * 4,
+                      WL_SHM_FORMAT_XRGB8888);
+  if (buffer)
+    s->buffers.push_back(buffer);
+  return buffer;
+}
+
+// A moving band of new pixels: partial damage, like a typical app update
+void Benchmark::draw(Surface *s) {
+  if (s->width <= 0 || s->height <= 0)
+    return;
+  ShmBuffer *buffer = freeBuffer(s);
+  if (!buffer)
+    return;
+
+  uint32_t *pixels = static_cast<uint32_t *>(buffer->data);
+  const int band = std::max(1, s->height / 8);
+  const int y0 = static_cast<int>((s->frame * 7) % s->height);
+  const uint32_t color = 0xff203040u + (s->frame * 0x00010203u);
+  if (!s->mapped) {
+    std::fill(pixels, pixels + s->width * s->height, 0xff202020u);
+  }
+  for (int y = y0; y < std::min(s->height, y0 + band); ++y)
+    std::fill(pixels + y * s->width, pixels + (y + 1) * s->width, color);
+
+  wl_surface_attach(s->surface, buffer->buffer, 0, 0);
+  if (s->mapped) {
+    wl_surface_damage_buffer(s->surface, 0, y0, s->width, band);
+  } else {
+    wl_surface_damage_buffer(s->surface, 0, 0, s->width, s->height);
+  }
+  if (!s->frameCallback) {
+    s->frameCallback = wl_surface_frame(s->surface);
+    wl_callback_add_listener(s->frameCallback, &kFrameListener, s);
+    s->committedAt = nowMs();
+  }
+  buffer->busy = true;
+  wl_surface_commit(s->surface);
+  s->mapped = true;
+  s->frame++;
+}
+
+void Benchmark::surfaceConfigured(Surface *s) {
+  if (!s->configured) {
+    s->configured = true;
+    s->configuredAt = nowMs();
+    if (s->role == Role::Toplevel && opts_.popups && s->conn != storm_)
+      createPopup(s);
+  }
+  configuresSinceMark_++;
+  // Every configure gets an immediate answer, like a responsive client
+  draw(s);
+  if (s->periodMs > 0)
+    s->nextCommit = nowMs() + s->periodMs;
+}
+
+void Benchmark::frameDone(Surface *s) {
+  const double now = nowMs();
+  if (s->role == Role::Probe) {
+    if (lastProbeFrame_ > 0)
+      frameIntervals_.add(now - lastProbeFrame_);
+    lastProbeFrame_ = now;
+    probeFrames_++;
+    draw(s);
+    return;
+  }
+  if (s->conn == storm_) {
+    // First frame on screen: the storm window has mapped; close it
+    mapLatency_.add(now - s->createdAt);
+    s->closed = true;
+    return;
+  }
+  callbackLatency_.add(now - s->committedAt);
+}
+
+void Benchmark::pointerMotion() {
+  if (motionSentAt_ > 0) {
+    inputLatency_.add(nowMs() - motionSentAt_);
+    motionSentAt_ = 0;
+  }
+}
+
+void Benchmark::pointerButton(Surface *s, uint32_t serial, uint32_t state) {
+  if (buttonSentAt_ > 0) {
+    buttonLatency_.add(nowMs() - buttonSentAt_);
+    buttonSentAt_ = 0;
+  }
+  if (dragArmed_ && state == WL_POINTER_BUTTON_STATE_PRESSED && s->toplevel) {
+    xdg_toplevel_move(s->toplevel, s->conn->globals.seat, serial);
+    dragArmed_ = false;
+  }
+}
+
+// ---- Event loop ------------------------------------------------------------
+
+void Benchmark::removeClosed() {
+  for (auto &conn : connections_) {
+    auto &list = conn->surfaces;
+    for (auto &s : list) {
+      if (s->closed && s->surface) {
+        if (conn->pointerFocus == s.get())
+          conn->pointerFocus = nullptr;
+        toplevels_.erase(
+            std::remove(toplevels_.begin(), toplevels_.end(), s.get()),
+            toplevels_.end());
+        destroySurface(s.get());
+      }
+    }
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [](const std::unique_ptr<Surface> &s) {
+                                return s->surface == nullptr;
+                              }),
+               list.end());
+  }
+}
+
+bool Benchmark::pump(double durationMs,
+                     const std::function<void(double)> &tick) {
+  const double end = nowMs() + durationMs;
+  std::vector<pollfd> fds(connections_.size());
+
+  while (!failed_) {
+    double now = nowMs();
+    if (now >= end)
+      return true;
+
+    // Periodic commits of the synthetic load
+    double next = end;
+    for (auto &conn : connections_) {
+      for (auto &s : conn->surfaces) {
+        if (!s->configured || s->periodMs <= 0)
+          continue;
+        if (s->nextCommit <= now) {
+          draw(s.get());
+          s->nextCommit = std::max(s->nextCommit + s->periodMs, now);
+        }
+        next = std::min(next, s->nextCommit);
+      }
+    }
+    if (tick)
+      tick(now);
+    removeClosed();
+
+    fds.resize(connections_.size());
+    for (size_t i = 0; i < connections_.size(); ++i) {
+      wl_display_dispatch_pending(connections_[i]->display);
+      wl_display_flush(connections_[i]->display);
+      fds[i] = {wl_display_get_fd(connections_[i]->display), POLLIN, 0};
+    }
+
+    // Scenario ticks run at least every 4 ms
+    int timeout = static_cast<int>(std::max(0.0, std::min(next - now, 4.0)));
+    if (poll(fds.data(), fds.size(), timeout) < 0)
+      continue;
+    for (size_t i = 0; i < fds.size(); ++i) {
+      if (fds[i].revents & (POLLERR | POLLHUP)) {
+        std::cerr << "Compositor connection lost\n";
+        failed_ = true;
+      } else if ((fds[i].revents & POLLIN) &&
+          wl_display_dispatch(connections_[i]->display) < 0) {
+        std::cerr << "Protocol error on connection " << i << "\n";
+        failed_ = true;
+      }
+    }
+  }
+  return false;
+}
+
+// ---- Virtual input ---------------------------------------------------------
+
+void Benchmark::key(uint32_t keycode, uint32_t state) {
+  zwp_virtual_keyboard_v1_key(keyboard_, protocolTime(), keycode, state);
+}
+
+void Benchmark::superKey(uint32_t keycode) {
+  key(KEY_LEFTMETA, WL_KEYBOARD_KEY_STATE_PRESSED);
+  key(keycode, WL_KEYBOARD_KEY_STATE_PRESSED);
+  key(keycode, WL_KEYBOARD_KEY_STATE_RELEASED);
+  key(KEY_LEFTMETA, WL_KEYBOARD_KEY_STATE_RELEASED);
+}
+
+void Benchmark::pointerTo(double x, double y) {
+  x = std::clamp(x, 0.0, kOutputWidth - 1.0);
+  y = std::clamp(y, 0.0, kOutputHeight - 1.0);
+  zwlr_virtual_pointer_v1_motion_absolute(
+      pointer_, protocolTime(), static_cast<uint32_t>(x),
+      static_cast<uint32_t>(y), kOutputWidth, kOutputHeight);
+  zwlr_virtual_pointer_v1_frame(pointer_);
+  motionSentAt_ = nowMs();
+}
+
+void Benchmark::button(uint32_t state) {
+  zwlr_virtual_pointer_v1_button(pointer_, protocolTime(), BTN_LEFT, state);
+  zwlr_virtual_pointer_v1_frame(pointer_);
+  if (state == WL_POINTER_BUTTON_STATE_PRESSED)
+    buttonSentAt_ = nowMs();
+}
+
+// ---- Scenarios -------------------------------------------------------------
+
+std::string Benchmark::runScenario(const std::string &name) {
+  frameIntervals_ = Stats();
+  callbackLatency_ = Stats();
+  inputLatency_ = Stats();
+  mapLatency_ = Stats();
+  buttonLatency_ = Stats();
+  lastProbeFrame_ = 0;
+  probeFrames_ = 0;
+
+  const ProcessSample before = sampleProcess(pid_);
+  const double start = nowMs();
+
+  std::string extra;
+  if (name == "steady")
+    extra = scenarioSteady();
+  else if (name == "storm")
+    extra = scenarioStorm();
+  else if (name == "drag")
+    extra = scenarioDrag();
+  else if (name == "tiling")
+    extra = scenarioTiling();
+  else if (name == "overview")
+    extra = scenarioOverview();
+  else if (name == "click")
+    extra = scenarioClick();
+  else
+    return "";
+
+  const double wallMs = nowMs() - start;
+  const ProcessSample after = sampleProcess(pid_);
+  const double cpuMs = after.cpuMs - before.cpuMs;
+
+  std::ostringstream out;
+  out << "{\"name\": \"" << name << "\", \"wall_ms\": " << wallMs
+      << ", \"frames\": " << probeFrames_
+      << ", \"frame_interval_ms\": " << frameIntervals_.json()
+      << ", \"cpu_ms\": " << cpuMs << ", \"cpu_ms_per_frame\": "
+      << (probeFrames_ ? cpuMs / probeFrames_ : 0.0)
+      << ", \"cpu_percent\": " << (wallMs > 0 ? 100.0 * cpuMs / wallMs : 0.0)
+      << ", \"rss_kb\": " << after.rssKb
+      << ", \"peak_rss_kb\": " << after.peakRssKb
+      << ", \"frame_callback_latency_ms\": " << callbackLatency_.json();
+  if (inputLatency_.count())
+    out << ", \"input_latency_ms\": " << inputLatency_.json();
+  if (mapLatency_.count())
+    out << ", \"map_latency_ms\": " << mapLatency_.json();
+  if (buttonLatency_.count())
+    out << ", \"button_latency_ms\": " << buttonLatency_.json();
+  out << extra << "}";
+  return out.str();
+}
+
+std::string Benchmark::scenarioSteady() {
+  pump(opts_.durationS * 1000);
+  return "";
+}
+
+// Keep a few toplevels in flight on one connection; each closes as soon
+// as its first frame is shown
+std::string Benchmark::scenarioStorm() {
+  storm_ = connect();
+  if (!storm_)
+    return ", \"error\": \"connect\"";
+  constexpr size_t kInFlight = 4;
+  size_t opened = 0;
+  pump(opts_.durationS * 1000, [&](double) {
+    while (storm_->surfaces.size() < kInFlight) {
+      createToplevel(storm_, 0);
+      opened++;
+    }
+  });
+
+  // Let the last ones map and close, then hang up
+  pump(200);
+  for (auto &s : storm_->surfaces)
+    destroySurface(s.get());
+  storm_->surfaces.clear();
+  wl_display_flush(storm_->display);
+  wl_display_disconnect(storm_->display);
+  connections_.erase(
+      std::remove_if(connections_.begin(), connections_.end(),
+                     [&](const std::unique_ptr<Connection> &c) {
+                       return c.get() == storm_;
+                     }),
+      connections_.end());
+  storm_ = nullptr;
+  pump(200);
+
+  std::ostringstream out;
+  out << ", \"windows_opened\": " << opened << ", \"windows_per_second\": "
+      << opened / opts_.durationS;
+  return out.str();
+}
+
+// Hover over the top window, then drag it around the output
+std::string Benchmark::scenarioDrag() {
+  const double cx = kMapX + opts_.width / 2.0;
+  const double cy = kMapY + opts_.height / 2.0;
+  double phase = 0;
+  double last = 0;
+
+  pointerTo(cx, cy);
+  pump(100);
+  pump(opts_.durationS * 1000 / 3, [&](double now) {
+    if (now - last >= 8) {
+      last = now;
+      phase += 0.2;
+      pointerTo(cx + 40 * std::cos(phase), cy + 40 * std::sin(phase));
+    }
+  });
+  const size_t hoverEvents = inputLatency_.count();
+
+  dragArmed_ = true;
+  button(WL_POINTER_BUTTON_STATE_PRESSED);
+  pump(50);
+  pump(opts_.durationS * 1000 * 2 / 3, [&](double now) {
+    if (now - last >= 8) {
+      last = now;
+      phase += 0.05;
+      pointerTo(kOutputWidth / 2.0 + 400 * std::cos(phase),
+                kOutputHeight / 2.0 + 200 * std::sin(phase * 2));
+    }
+  });
+  button(WL_POINTER_BUTTON_STATE_RELEASED);
+  dragArmed_ = false;
+  pump(100);
+
+  std::ostringstream out;
+  out << ", \"hover_events\": " << hoverEvents;
+  return out.str();
+}
+
+// Time from the key press until every loaded toplevel was reconfigured
+std::string Benchmark::scenarioTiling() {
+  Stats layoutLatency;
+  auto relayout = [&](uint32_t keycode) {
+    configuresSinceMark_ = 0;
+    const double sent = nowMs();
+    const int expected = static_cast<int>(toplevels_.size());
+    double done = 0;
+    superKey(keycode);
+    pump(opts_.durationS * 1000 / 5, [&](double now) {
+      if (!done && configuresSinceMark_ >= expected)
+        done = now;
+    });
+    if (done)
+      layoutLatency.add(done - sent);
+  };
+
+  relayout(KEY_T); // Tile
+  for (int i = 0; i < 3; ++i)
+    relayout(KEY_SPACE); // Next layout
+  relayout(KEY_T);       // Float again
+
+  return ", \"layout_latency_ms\": " + layoutLatency.json();
+}
+
+std::string Benchmark::scenarioOverview() {
+  const int toggles = 4;
+  for (int i = 0; i < toggles; ++i) {
+    superKey(KEY_TAB);
+    pump(opts_.durationS * 1000 / toggles);
+  }
+  return ", \"toggles\": " + std::to_string(toggles);
+}
+
+// Tiled, the windows sit side by side, so clicks at spread-out points keep
+// moving focus: the path osf_cursor_button → osf_focus_view →
+// osf_window_focus → EventBus the compositor's latency report breaks down
+std::string Benchmark::scenarioClick() {
+  superKey(KEY_T);
+  pump(300);
+
+  const int clicks = std::max(8, static_cast<int>(opts_.durationS * 10));
+  const double step = opts_.durationS * 1000 / clicks;
+  for (int i = 0; i < clicks; ++i) {
+    // Golden-ratio walk over the area below the panel
+    const double fx = std::fmod(0.1 + i * 0.618034, 1.0);
+    const double fy = std::fmod(0.3 + i * 0.381966, 1.0);
+    pointerTo(fx * kOutputWidth, 40 + fy * (kOutputHeight - 40));
+    pump(step / 4);
+    button(WL_POINTER_BUTTON_STATE_PRESSED);
+    button(WL_POINTER_BUTTON_STATE_RELEASED);
+    pump(step / 4);
+    key(KEY_A, WL_KEYBOARD_KEY_STATE_PRESSED);
+    key(KEY_A, WL_KEYBOARD_KEY_STATE_RELEASED);
+    pump(step / 2);
+  }
+
+  superKey(KEY_T);
+  pump(300);
+  return ", \"clicks\": " + std::to_string(clicks);
+}
+
+// ============================================================================
+// Command line
+// ============================================================================
+
+std::vector<std::string> split(const std::string &text, char separator) {
+  std::vector<std::string> parts;
+  std::istringstream in(text);
+  std::string part;
+  while (std::getline(in, part, separator)) {
+    if (!part.empty())
+      parts.push_back(part);
+  }
+  return parts;
+}
+
+bool parseOptions(int argc, char **argv, Options &opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      return i + 1 < argc ? argv[++i] : "";
+    };
+    if (arg == "--compositor") {
+      opts.compositor = value();
+    } else if (arg == "--clients") {
+      opts.clients = std::max(0, std::atoi(value().c_str()));
+    } else if (arg == "--size") {
+      if (sscanf(value().c_str(), "%dx%d", &opts.width, &opts.height) != 2)
+        return false;
+    } else if (arg == "--rate") {
+      opts.rateHz = std::max(0.1, std::atof(value().c_str()));
+    } else if (arg == "--popups") {
+      opts.popups = true;
+    } else if (arg == "--layers") {
+      opts.layers = std::max(0, std::atoi(value().c_str()));
+    } else if (arg == "--duration") {
+      opts.durationS = std::max(0.1, std::atof(value().c_str()));
+    } else if (arg == "--scenarios") {
+      opts.scenarios = split(value(), ',');
+    } else if (arg == "--output") {
+      opts.output = value();
+    } else if (arg == "--verbose") {
+      opts.verbose = true;
+    } else {
+      return false;
+    }
+  }
+  return opts.width > 0 && opts.height > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--compositor PATH] [--clients N] [--size WxH]"
+                 " [--rate HZ] [--popups] [--layers N] [--duration SECONDS]"
+                 " [--scenarios steady,storm,drag,tiling,overview,click]"
+                 " [--output FILE] [--verbose]\n";
+    return 2;
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  Benchmark bench(opts);
+  if (!bench.start())
+    return 1;
+
+  std::ostringstream json;
+  json << "{\"compositor\": \"" << opts.compositor
+       << "\", \"renderer\": \"pixman\", \"output\": [" << kOutputWidth << ", "
+       << kOutputHeight << "], \"clients\": " << opts.clients
+       << ", \"size\": [" << opts.width << ", " << opts.height
+       << "], \"rate_hz\": " << opts.rateHz
+       << ", \"popups\": " << (opts.popups ? "true" : "false")
+       << ", \"layers\": " << opts.layers
+       << ", \"duration_s\": " << opts.durationS << ", \"scenarios\": [";
+  bool first = true;
+  for (const std::string &name : opts.scenarios) {
+    std::cerr << "[compositor-benchmark] " << name << "...\n";
+    std::string result = bench.runScenario(name);
+    if (result.empty()) {
+      std::cerr << "Unknown scenario: " << name << "\n";
+      return 2;
+    }
+    if (bench.failed())
+      return 1;
+    json << (first ? "" : ", ") << result;
+    first = false;
+  }
+  bench.shutdown();
+  json << "]";
+  if (!bench.compositorLatency().empty())
+    json << ", \"compositor_latency\": " << bench.compositorLatency();
+  json << "}\n";
+
+  if (opts.output.empty()) {
+    std::cout << json.str();
+  } else {
+    std::ofstream(opts.output) << json.str();
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * compositor_capture_validation.cpp - Screen Capture Validation
+ *
+ * Runs opensef-compositor headless (headless_compositor.h), animations
+ * off, and captures its output through wlr-screencopy:
+ *
+ * - the first copy_with_damage reports the whole output
+ * - after a window changes, the damage covers that window only, only its
+ *   pixels are read back, and the reused buffer matches a full copy
+ * - an idle output completes no copy_with_damage at all
+ */
+
+#include "headless_compositor.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace osftest;
+
+namespace {
+
+constexpr uint32_t kFirstColor = 0xff3050e0u;
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+
+const char *const kCopied = "Screencopy: copied ";
+
+Rect bounds(const std::vector<Rect> &rects) {
+  Rect box;
+  for (const Rect &r : rects)
+    box = box.united(r);
+  return box;
+}
+
+// Pixels read back by the compositor's latest copy, -1 if none logged
+long long lastCopiedPixels(const HeadlessCompositor &compositor) {
+  const std::string log = compositor.log();
+  const size_t at = log.rfind(kCopied);
+  long long pixels = -1;
+  if (at != std::string::npos)
+    std::sscanf(log.c_str() + at + strlen(kCopied), "%lld", &pixels);
+  return pixels;
+}
+
+} // namespace
+
+int main() {
+  printBanner("Capture");
+
+  HeadlessCompositor compositor(withoutAnimations());
+  if (!compositor.start())
+    return 1;
+
+  // 1. A new client has seen nothing yet
+  std::cout << "[1] Testing the first damage copy...\n";
+  Image image;
+  std::vector<Rect> damage;
+  {
+    if (!compositor.capture(image, &damage)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    const Rect all = bounds(damage);
+    if (image.width != kOutputWidth || image.height != kOutputHeight ||
+        !all.contains({0, 0, kOutputWidth, kOutputHeight})) {
+      std::cout << "    ✗ " << image.width << "x" << image.height
+                << " frame, damage " << all << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << image.width << "x" << image.height
+              << ", damage " << all << "\n\n";
+  }
+
+  // 2. Only the window that changed is copied
+  std::cout << "[2] Testing an incremental copy...\n";
+  {
+    Window *window = compositor.mapWindow(kWidth, kHeight, kFirstColor);
+    if (!window)
+      return 1;
+    compositor.dispatch(50);
+    if (!compositor.capture(image, &damage)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    const Rect box = image.find(kFirstColor);
+    if (box.width != kWidth || box.height != kHeight) {
+      std::cout << "    ✗ Window shown as " << box << "\n";
+      return 1;
+    }
+
+    // The capture buffer holds the first color now; repaint the window
+    window->color = 0xffe0a020u;
+    compositor.commit(window);
+    compositor.dispatch(50);
+    if (!compositor.capture(image, &damage)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    const Rect changed = bounds(damage);
+    const long long copied = lastCopiedPixels(compositor);
+    if (changed.empty() || !box.contains(changed)) {
+      std::cout << "    ✗ Damage " << changed << " for the window at " << box
+                << "\n";
+      return 1;
+    }
+    if (copied < 0 || copied > static_cast<long long>(kWidth) * kHeight) {
+      std::cout << "    ✗ Copied " << copied << " pixels for a " << kWidth
+                << "x" << kHeight << " change\n";
+      return 1;
+    }
+
+    Image full;
+    if (!compositor.capture(full)) {
+      std::cout << "    ✗ Capture failed\n";
+      return 1;
+    }
+    const Rect stale = image.diff(full, 0);
+    const Rect repainted = image.find(window->color);
+    if (!stale.empty() || repainted.width != kWidth ||
+        repainted.height != kHeight) {
+      std::cout << "    ✗ Incremental frame differs from a full copy at "
+                << stale << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Damage " << changed << ", " << copied << " of "
+              << kOutputWidth * kOutputHeight << " pixels copied\n\n";
+  }
+
+  // 3. Nothing changes: the copy waits
+  std::cout << "[3] Testing an idle output...\n";
+  {
+    compositor.dispatch(100);
+    if (compositor.capture(image, &damage)) {
+      std::cout << "    ✗ Idle output completed a damage copy ("
+                << bounds(damage) << ")\n";
+      return 1;
+    }
+    std::cout << "    ✓ No frame without damage\n";
+  }
+
+  compositor.stop();
+
+  printPassed("Capture");
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * compositor_resize_validation.cpp - Interactive Resize Validation
+ *
+ * Runs opensef-compositor headless (headless_compositor.h), animations
+ * off, and drags a window's bottom-right corner through xdg_toplevel.resize:
+ *
+ * - while a configure is unanswered, pointer motion sends no new one
+ * - a client that never answers gets the latest size anyway at the
+ *   deadline (OSF_RESIZE_TIMEOUT_MS)
+ * - a client that answers at once follows the pointer, with the grabbed
+ *   window's top-left corner staying put
+ */
+
+#include "headless_compositor.h"
+
+#include <iostream>
+
+using namespace osftest;
+
+namespace {
+
+// server.h
+constexpr double kTimeoutMs = 200;
+
+constexpr uint32_t kColor = 0xff40a0e0u;
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+
+const char *const kTimedOut = "Resize timed out";
+
+} // namespace
+
+int main() {
+  printBanner("Resize");
+
+  HeadlessCompositor compositor(withoutAnimations());
+  if (!compositor.start())
+    return 1;
+
+  Rect mapped;
+  Window *window =
+      compositor.showWindow(kWidth, kHeight, kColor, false, mapped);
+  if (!window)
+    return 1;
+  Image image;
+
+  // Grab the bottom-right corner
+  const int grabX = mapped.x + mapped.width - 5;
+  const int grabY = mapped.y + mapped.height - 5;
+  compositor.pointerTo(grabX, grabY);
+  compositor.dispatch(50);
+  compositor.button(WL_POINTER_BUTTON_STATE_PRESSED);
+  compositor.dispatch(50);
+  compositor.ack(window); // Activation, if the click sent one
+  xdg_toplevel_resize(window->toplevel, compositor.seat(),
+                      compositor.buttonSerial(),
+                      XDG_TOPLEVEL_RESIZE_EDGE_BOTTOM_RIGHT);
+  compositor.dispatch(50);
+
+  // 1. Motion while the client holds its configure is coalesced
+  std::cout << "[1] Testing motion during an unanswered configure...\n";
+  const int configures = window->configures;
+  {
+    compositor.pointerTo(grabX + 40, grabY + 30);
+    compositor.dispatch(20);
+    compositor.pointerTo(grabX + 80, grabY + 60);
+    compositor.dispatch(20);
+    compositor.pointerTo(grabX + 120, grabY + 90);
+    compositor.dispatch(20);
+    if (window->configures != configures + 1) {
+      std::cout << "    ✗ " << window->configures - configures
+                << " configures for 3 motions\n";
+      return 1;
+    }
+    if (window->configureWidth != kWidth + 40 ||
+        window->configureHeight != kHeight + 30) {
+      std::cout << "    ✗ First configure " << window->configureWidth << "x"
+                << window->configureHeight << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ One configure (" << window->configureWidth << "x"
+              << window->configureHeight << ") for 3 motions\n\n";
+  }
+
+  // 2. The client never answers: the latest size goes out at the deadline
+  std::cout << "[2] Testing a client that never answers...\n";
+  {
+    const double start = nowMs();
+    if (!compositor.waitFor(
+            [&] { return window->configures == configures + 2; },
+            kTimeoutMs * 5)) {
+      std::cout << "    ✗ No configure after the deadline\n";
+      return 1;
+    }
+    const double waited = nowMs() - start;
+    if (!compositor.logContains(kTimedOut)) {
+      std::cout << "    ✗ Configure sent without a timeout\n";
+      return 1;
+    }
+    if (window->configureWidth != kWidth + 120 ||
+        window->configureHeight != kHeight + 90) {
+      std::cout << "    ✗ Sent " << window->configureWidth << "x"
+                << window->configureHeight << ", pointer asked for "
+                << kWidth + 120 << "x" << kHeight + 90 << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Latest size sent after " << waited << " ms\n\n";
+  }
+
+  // 3. The client answers at once: the window follows the pointer
+  std::cout << "[3] Testing a client that answers at once...\n";
+  {
+    window->autoAck = true;
+    compositor.ack(window);
+    compositor.dispatch(20);
+    const size_t timeouts = compositor.logCount(kTimedOut);
+    const double sent = nowMs();
+    compositor.pointerTo(grabX + 160, grabY + 120);
+
+    Rect shown;
+    const bool resized = compositor.waitFor(
+        [&] {
+          if (!compositor.capture(image))
+            return false;
+          shown = image.find(kColor);
+          return shown.width == kWidth + 160 && shown.height == kHeight + 120;
+        },
+        kTimeoutMs * 5);
+    const double waited = nowMs() - sent;
+    if (!resized) {
+      std::cout << "    ✗ Shown as " << shown << "\n";
+      return 1;
+    }
+    if (compositor.logCount(kTimedOut) != timeouts || waited >= kTimeoutMs) {
+      std::cout << "    ✗ Waited for the deadline (" << waited << " ms)\n";
+      return 1;
+    }
+    if (shown.x != mapped.x || shown.y != mapped.y) {
+      std::cout << "    ✗ Moved to " << shown << ", mapped at " << mapped
+                << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << shown << " after " << waited << " ms\n";
+  }
+
+  compositor.button(WL_POINTER_BUTTON_STATE_RELEASED);
+  compositor.dispatch(50);
+  compositor.stop();
+
+  printPassed("Resize");
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * compositor_transaction_validation.cpp - Layout Transaction Validation
+ *
+ * Runs opensef-compositor headless (headless_compositor.h), animations
+ * off, and maximizes a window through a layout transaction:
+ *
+ * - while the client holds its configure, the old frame stays exactly
+ *   where it was shown
+ * - a client that never answers is moved anyway at the deadline
+ *   (OSF_TRANSACTION_TIMEOUT_MS)
+ * - a client that answers at once is shown at its new box well before
+ *   the deadline
+ */
+
+#include "headless_compositor.h"
+
+#include <iostream>
+
+using namespace osftest;
+
+namespace {
+
+// transaction.h
+constexpr double kTimeoutMs = 200;
+// Maximized views start below the panel (view.c)
+constexpr int kPanelHeight = 28;
+
+constexpr uint32_t kColor = 0xff20c040u;
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+
+const char *const kTimedOut = "Transaction timed out";
+
+} // namespace
+
+int main() {
+  printBanner("Transaction");
+
+  HeadlessCompositor compositor(withoutAnimations());
+  if (!compositor.start())
+    return 1;
+
+  Rect mapped;
+  Window *window =
+      compositor.showWindow(kWidth, kHeight, kColor, false, mapped);
+  if (!window)
+    return 1;
+  Image image;
+
+  // 1. Client holds the configure: the saved frame, then the deadline
+  std::cout << "[1] Testing a client that never answers...\n";
+  {
+    xdg_toplevel_set_maximized(window->toplevel);
+    if (!compositor.waitFor([&] { return window->configurePending; },
+                            1000)) {
+      std::cout << "    ✗ No configure for the maximize\n";
+      return 1;
+    }
+    const double sent = nowMs();
+
+    compositor.capture(image);
+    const Rect waiting = image.find(kColor);
+    if (nowMs() - sent < kTimeoutMs && waiting != mapped) {
+      std::cout << "    ✗ Old frame at " << waiting << " while waiting, was "
+                << mapped << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Old frame kept at " << waiting << "\n";
+
+    if (!compositor.waitFor([&] { return compositor.logContains(kTimedOut); },
+                            kTimeoutMs * 5)) {
+      std::cout << "    ✗ Transaction never timed out\n";
+      return 1;
+    }
+    const double waited = nowMs() - sent;
+    compositor.dispatch(50);
+    compositor.capture(image);
+    const Rect moved = image.find(kColor);
+    // Still the old buffer, at the maximized position
+    if (moved.x != 0 || moved.y != kPanelHeight || moved.width != kWidth) {
+      std::cout << "    ✗ After the deadline shown at " << moved << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Applied after " << waited << " ms, at " << moved
+              << "\n";
+
+    // The late answer lands in place
+    compositor.ack(window);
+    compositor.dispatch(100);
+    compositor.capture(image);
+    const Rect resized = image.find(kColor);
+    if (resized.width != window->width || resized.height != window->height) {
+      std::cout << "    ✗ Late buffer shown as " << resized << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ Late buffer shown as " << resized << "\n\n";
+  }
+
+  // 2. Client answers at once: applied on its commit
+  std::cout << "[2] Testing a client that answers at once...\n";
+  {
+    window->autoAck = true;
+    const size_t timeouts = compositor.logCount(kTimedOut);
+    const double sent = nowMs();
+    xdg_toplevel_unset_maximized(window->toplevel);
+
+    Rect shown;
+    const bool restored = compositor.waitFor(
+        [&] {
+          if (!compositor.capture(image))
+            return false;
+          shown = image.find(kColor);
+          return shown == mapped;
+        },
+        kTimeoutMs * 5);
+    const double waited = nowMs() - sent;
+    if (!restored) {
+      std::cout << "    ✗ Shown at " << shown << ", expected " << mapped
+                << "\n";
+      return 1;
+    }
+    if (compositor.logCount(kTimedOut) != timeouts || waited >= kTimeoutMs) {
+      std::cout << "    ✗ Waited for the deadline (" << waited << " ms)\n";
+      return 1;
+    }
+    std::cout << "    ✓ Restored to " << shown << " after " << waited
+              << " ms\n";
+  }
+
+  compositor.stop();
+
+  printPassed("Transaction");
+
+  return 0;
+}
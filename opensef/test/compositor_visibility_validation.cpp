@@ -0,0 +1,133 @@
+/**
+ * compositor_visibility_validation.cpp - Hidden Window Frame Callbacks
+ *
+ * Runs opensef-compositor headless (headless_compositor.h) with two
+ * outputs, animations off and the hidden-window trickle disabled
+ * (VITUS_THROTTLED_FRAME_MS=0), and keeps a window asking for frames:
+ *
+ * - on the active workspace its callbacks arrive at full rate
+ * - on a hidden workspace none arrive, while frames of the second output
+ *   are counted as suppressed for it
+ * - switching back resumes its callbacks
+ */
+
+#include "headless_compositor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace osftest;
+
+namespace {
+
+constexpr uint32_t kColor = 0xff50c070u;
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+constexpr int kCaptures = 10;
+
+const char *const kShown = "hidden -> visible (frames sent ";
+
+// Commits a new buffer whenever the last frame callback arrived; returns
+// the callbacks received in `ms`
+uint64_t animate(HeadlessCompositor &compositor, Window *window, double ms) {
+  const uint64_t before = window->frames;
+  const double end = nowMs() + ms;
+  while (nowMs() < end) {
+    if (!window->frameCallback)
+      compositor.commit(window);
+    compositor.dispatch(5);
+  }
+  return window->frames - before;
+}
+
+// Suppressed frames logged when the view was last shown again, -1 if none
+long long lastSuppressed(const HeadlessCompositor &compositor) {
+  const std::string log = compositor.log();
+  const size_t at = log.rfind(kShown);
+  long long sent = -1, suppressed = -1;
+  if (at != std::string::npos)
+    std::sscanf(log.c_str() + at + strlen(kShown), "%lld, suppressed %lld",
+                &sent, &suppressed);
+  return suppressed;
+}
+
+} // namespace
+
+int main() {
+  printBanner("Visibility");
+
+  HeadlessCompositor compositor(withoutAnimations(
+      {{"VITUS_THROTTLED_FRAME_MS", "0"}, {"WLR_HEADLESS_OUTPUTS", "2"}}));
+  if (!compositor.start())
+    return 1;
+  if (compositor.outputCount() != 2) {
+    std::cout << "    ✗ " << compositor.outputCount()
+              << " outputs, wanted 2\n";
+    return 1;
+  }
+
+  Window *window = compositor.mapWindow(kWidth, kHeight, kColor);
+  if (!window)
+    return 1;
+
+  // 1. Visible: every frame answers
+  std::cout << "[1] Testing a window on the active workspace...\n";
+  {
+    const uint64_t frames = animate(compositor, window, 300);
+    if (frames < 5) {
+      std::cout << "    ✗ " << frames << " frame callbacks in 300 ms\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << frames << " frame callbacks in 300 ms\n\n";
+  }
+
+  // 2. Hidden: nothing answers, whichever output frames
+  std::cout << "[2] Testing the window on a hidden workspace...\n";
+  Image image;
+  {
+    compositor.superKey(KEY_2);
+    compositor.dispatch(100);
+    const uint64_t before = window->frames;
+    compositor.commit(window); // Asks for a frame
+    for (int i = 0; i < kCaptures; ++i) {
+      if (!compositor.capture(image, nullptr, 1)) {
+        std::cout << "    ✗ Capture of the second output failed\n";
+        return 1;
+      }
+    }
+    animate(compositor, window, 300);
+    const uint64_t frames = window->frames - before;
+    if (frames != 0) {
+      std::cout << "    ✗ " << frames << " frame callbacks while hidden\n";
+      return 1;
+    }
+    std::cout << "    ✓ No frame callbacks across " << kCaptures
+              << " frames of the second output\n\n";
+  }
+
+  // 3. Shown again: callbacks resume, suppressed frames were counted
+  std::cout << "[3] Testing the switch back...\n";
+  {
+    const uint64_t before = window->frames;
+    compositor.superKey(KEY_1);
+    if (!compositor.waitFor([&] { return window->frames > before; }, 1000)) {
+      std::cout << "    ✗ No frame callback after switching back\n";
+      return 1;
+    }
+    const long long suppressed = lastSuppressed(compositor);
+    if (suppressed < kCaptures) {
+      std::cout << "    ✗ " << suppressed << " frames counted as suppressed, "
+                << kCaptures << " on the second output alone\n";
+      return 1;
+    }
+    std::cout << "    ✓ Callbacks resumed; " << suppressed
+              << " output frames suppressed\n";
+  }
+
+  compositor.stop();
+
+  printPassed("Visibility");
+
+  return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * display_list_validation.cpp - OSFDisplayList Validation and Benchmark
+ *
+ * Records a view tree, checks that unchanged views are replayed rather
+ * than rendered, that invalidating, moving, re-stacking or removing views
+ * produces exactly the affected damage rects, and that replay matches
+ * direct rendering. Then compares frame times of both paths.
+ */
+
+#include <opensef/OSFDisplayList.h>
+#include <opensef/OSFLayer.h>
+#include <opensef/OSFView.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace opensef;
+
+namespace {
+
+constexpr int kWidth = 1280;
+constexpr int kHeight = 800;
+constexpr int kCell = 80;
+
+int renders = 0;
+
+class TileView : public OSFView {
+public:
+  explicit TileView(double shade) : shade_(shade) {}
+
+  void render(cairo_t *cr) override {
+    ++renders;
+    cairo_set_source_rgb(cr, shade_, 0.4, 1 - shade_);
+    cairo_rectangle(cr, 4, 4, frame_.width - 8, frame_.height - 8);
+    cairo_fill(cr);
+    OSFView::render(cr);
+  }
+
+  void setShade(double shade) {
+    shade_ = shade;
+    setNeedsDisplay();
+  }
+
+private:
+  double shade_;
+};
+
+bool sameRect(const OSFRect &a, const OSFRect &b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height;
+}
+
+// Build `next` against `current`, swap, and return the damage
+std::vector<OSFRect> frame(OSFView &root, OSFDisplayList &current,
+                           OSFDisplayList &next) {
+  next.build(root, OSFPoint(0, 0), OSFRect(0, 0, kWidth, kHeight), &current);
+  std::swap(current, next);
+  return current.damage(next);
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Display List Validation & Benchmark          ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  OSFLayer::setDisableImplicitAnimations(true);
+
+  auto root = std::make_shared<OSFView>();
+  root->setFrame(OSFRect(0, 0, kWidth, kHeight));
+  std::vector<std::shared_ptr<TileView>> tiles;
+  for (int y = 0; y + kCell <= kHeight; y += kCell) {
+    for (int x = 0; x + kCell <= kWidth; x += kCell) {
+      auto tile = std::make_shared<TileView>((x + y) % 9 / 9.0);
+      tile->setFrame(OSFRect(x, y, kCell, kCell));
+      root->addSubview(tile);
+      tiles.push_back(tile);
+    }
+  }
+  const int count = static_cast<int>(tiles.size());
+
+  OSFDisplayList current;
+  OSFDisplayList next;
+
+  // 1. First build records everything
+  std::cout << "[1] Testing initial recording (" << count << " views)...\n";
+  renders = 0;
+  auto damage = frame(*root, current, next);
+  if (renders != count || current.size() != tiles.size() + 1 ||
+      damage.empty()) {
+    std::cout << "    ✗ Rendered " << renders << ", " << current.size()
+              << " items\n";
+    return 1;
+  }
+  std::cout << "    ✓ " << current.size() << " items, "
+            << current.recordedCount() << " recorded\n\n";
+
+  // 2. Nothing changed: nothing renders, nothing is damaged
+  std::cout << "[2] Testing unchanged frame...\n";
+  renders = 0;
+  damage = frame(*root, current, next);
+  if (renders != 0 || current.recordedCount() != 0 || !damage.empty()) {
+    std::cout << "    ✗ " << renders << " renders, " << damage.size()
+              << " damage rects\n";
+    return 1;
+  }
+  std::cout << "    ✓ Replayed without rendering, no damage\n\n";
+
+  // 3. One invalidated view: one render, its own rect
+  std::cout << "[3] Testing setNeedsDisplay damage...\n";
+  tiles[17]->setShade(0.5);
+  renders = 0;
+  damage = frame(*root, current, next);
+  OSFRect frame17 = tiles[17]->frame();
+  OSFRect expected(frame17.x + 4, frame17.y + 4, kCell - 8, kCell - 8);
+  if (renders != 1 || damage.size() != 1 ||
+      !sameRect(damage[0], expected)) {
+    std::cout << "    ✗ " << renders << " renders, " << damage.size()
+              << " damage rects\n";
+    return 1;
+  }
+  std::cout << "    ✓ 1 render, damage (" << damage[0].x << ", "
+            << damage[0].y << ", " << damage[0].width << "x"
+            << damage[0].height << ")\n\n";
+
+  // 4. Moving, re-stacking and removing views damage old and new spots
+  std::cout << "[4] Testing move, restack and remove...\n";
+  OSFRect from = tiles[0]->frame();
+  tiles[0]->setFrame(OSFRect(from.x + 2 * kCell, from.y + 3 * kCell, kCell,
+                             kCell));
+  damage = frame(*root, current, next);
+  bool moveOk = damage.size() == 2;
+
+  // Bring tile 5 to the front: only its rect changes stacking
+  auto front = tiles[5];
+  front->removeFromSuperview();
+  root->addSubview(front);
+  damage = frame(*root, current, next);
+  bool restackOk = damage.size() == 1;
+
+  tiles[40]->removeFromSuperview();
+  damage = frame(*root, current, next);
+  bool removeOk = damage.size() == 1 && current.size() == tiles.size();
+
+  tiles[41]->setHidden(true);
+  damage = frame(*root, current, next);
+  bool hideOk = damage.size() == 1 && current.size() == tiles.size() - 1;
+
+  if (!moveOk || !restackOk || !removeOk || !hideOk) {
+    std::cout << "    ✗ move=" << moveOk << " restack=" << restackOk
+              << " remove=" << removeOk << " hide=" << hideOk << "\n";
+    return 1;
+  }
+  std::cout << "    ✓ Exact damage for each change\n\n";
+
+  // 5. Many scattered changes collapse to a bounded rect count
+  std::cout << "[5] Testing damage rect budget...\n";
+  for (std::size_t i = 0; i < tiles.size(); i += 3)
+    tiles[i]->setShade(0.25);
+  damage = frame(*root, current, next);
+  if (damage.empty() || damage.size() > OSFDisplayList::kMaxDamageRects) {
+    std::cout << "    ✗ " << damage.size() << " rects\n";
+    return 1;
+  }
+  std::cout << "    ✓ " << damage.size() << " rect(s)\n\n";
+
+  // 6. Replay draws what direct rendering draws
+  std::cout << "[6] Testing replay vs. direct rendering...\n";
+  cairo_surface_t *direct =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, kWidth, kHeight);
+  cairo_surface_t *replayed =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, kWidth, kHeight);
+  {
+    cairo_t *cr = cairo_create(direct);
+    root->render(cr);
+    cairo_destroy(cr);
+    cr = cairo_create(replayed);
+    current.replay(cr);
+    cairo_destroy(cr);
+  }
+  cairo_surface_flush(direct);
+  cairo_surface_flush(replayed);
+  const int stride = cairo_image_surface_get_stride(direct);
+  if (std::memcmp(cairo_image_surface_get_data(direct),
+                  cairo_image_surface_get_data(replayed),
+                  static_cast<size_t>(stride) * kHeight) != 0) {
+    std::cout << "    ✗ Replayed frame differs\n";
+    return 1;
+  }
+  std::cout << "    ✓ Byte-identical\n\n";
+
+  // 7. Benchmark: render everything vs. rebuild + replay one change
+  constexpr int kFrames = 50;
+  std::cout << "[7] Benchmarking " << kFrames << " frames, 1 change each...\n";
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    cairo_t *cr = cairo_create(direct);
+    root->render(cr);
+    cairo_destroy(cr);
+  }
+  double directUs = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count() /
+                    kFrames;
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    tiles[i % tiles.size()]->setShade(i % 2 ? 0.1 : 0.9);
+    damage = frame(*root, current, next);
+    cairo_t *cr = cairo_create(replayed);
+    for (const OSFRect &rect : damage) {
+      cairo_save(cr);
+      cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+      cairo_clip(cr);
+      current.replay(cr);
+      cairo_restore(cr);
+    }
+    cairo_destroy(cr);
+  }
+  double listUs = std::chrono::duration<double, std::micro>(
+                      std::chrono::steady_clock::now() - begin)
+                      .count() /
+                  kFrames;
+
+  std::cout << "    direct render:        " << directUs << " us/frame\n";
+  std::cout << "    display list + damage: " << listUs << " us/frame\n";
+  std::cout << "    ✓ Speedup " << (directUs / listUs) << "x\n";
+
+  cairo_surface_destroy(direct);
+  cairo_surface_destroy(replayed);
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║           DISPLAY LIST VALIDATION: PASSED                   ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * glyph_atlas_validation.cpp - OSFGlyphAtlas Validation and Benchmark
+ *
+ * Checks that packed glyphs stay inside their pages without overlapping,
+ * that bitmaps land where their entries say, that full atlases spill into
+ * new pages and then evict the least recently used one without touching
+ * glyphs pinned by the current frame, and that uploads are batched. Then
+ * compares skyline packing density against the old row packer.
+ */
+
+#include <opensef/OSFGlyphAtlas.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace opensef;
+
+namespace {
+
+struct Size {
+  int width, height;
+};
+
+// Glyph-like sizes: mostly small, some tall (CJK, emoji-sized) ones
+std::vector<Size> glyphSizes(size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> small(4, 14);
+  std::uniform_int_distribution<int> large(16, 40);
+  std::vector<Size> sizes;
+  for (size_t i = 0; i < count; ++i) {
+    bool big = (rng() % 8) == 0;
+    sizes.push_back({big ? large(rng) : small(rng),
+                     big ? large(rng) : small(rng) + 4});
+  }
+  return sizes;
+}
+
+std::vector<uint8_t> bitmap(const Size &size, uint8_t value, int pitch) {
+  return std::vector<uint8_t>(static_cast<size_t>(pitch) * size.height, value);
+}
+
+// The pre-atlas packer: left to right, new row at the tallest glyph
+int rowPacked(const std::vector<Size> &sizes, int pageSize) {
+  int x = 0, y = 0, rowHeight = 0, packed = 0;
+  for (const Size &size : sizes) {
+    if (x + size.width + 1 >= pageSize) {
+      x = 0;
+      y += rowHeight + 1;
+      rowHeight = 0;
+    }
+    if (y + size.height >= pageSize)
+      break;
+    x += size.width + 1;
+    rowHeight = std::max(rowHeight, size.height);
+    ++packed;
+  }
+  return packed;
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Glyph Atlas Validation & Benchmark           ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  // 1. Packed glyphs are in bounds, disjoint and hold their pixels
+  std::cout << "[1] Testing packing and pixel placement...\n";
+  {
+    OSFGlyphAtlas atlas(256, 8);
+    std::vector<Size> sizes = glyphSizes(600, 1);
+    std::vector<const OSFGlyphEntry *> entries;
+    for (uint32_t i = 0; i < sizes.size(); ++i) {
+      const int pitch = sizes[i].width + 3; // Rows wider than the glyph
+      std::vector<uint8_t> pixels =
+          bitmap(sizes[i], static_cast<uint8_t>(1 + i % 250), pitch);
+      const OSFGlyphEntry *entry =
+          atlas.insert({1, 14, i}, sizes[i].width, sizes[i].height,
+                       pixels.data(), pitch, 0, 0);
+      if (!entry) {
+        std::cout << "    ✗ Glyph " << i << " not packed\n";
+        return 1;
+      }
+      entries.push_back(entry);
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+      const OSFGlyphEntry &a = *entries[i];
+      if (a.x < OSFGlyphAtlas::kPadding || a.y < OSFGlyphAtlas::kPadding ||
+          a.x + a.width + OSFGlyphAtlas::kPadding > atlas.pageSize() ||
+          a.y + a.height + OSFGlyphAtlas::kPadding > atlas.pageSize()) {
+        std::cout << "    ✗ Glyph " << i << " out of bounds\n";
+        return 1;
+      }
+      for (size_t j = i + 1; j < entries.size(); ++j) {
+        const OSFGlyphEntry &b = *entries[j];
+        if (a.page == b.page && a.x < b.x + b.width + 1 &&
+            b.x < a.x + a.width + 1 && a.y < b.y + b.height + 1 &&
+            b.y < a.y + a.height + 1) {
+          std::cout << "    ✗ Glyphs " << i << " and " << j << " overlap\n";
+          return 1;
+        }
+      }
+      const uint8_t *page = atlas.pagePixels(a.page);
+      const uint8_t expected = static_cast<uint8_t>(1 + i % 250);
+      if (page[a.y * atlas.pageSize() + a.x] != expected ||
+          page[(a.y + a.height - 1) * atlas.pageSize() + a.x + a.width - 1] !=
+              expected ||
+          page[(a.y - 1) * atlas.pageSize() + a.x] != 0) {
+        std::cout << "    ✗ Glyph " << i << " pixels misplaced\n";
+        return 1;
+      }
+    }
+    if (atlas.pageCount() < 2) {
+      std::cout << "    ✗ Expected the glyphs to spill into a second page\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << entries.size() << " glyphs on "
+              << atlas.pageCount() << " pages, disjoint, "
+              << static_cast<int>(atlas.occupancy() * 100) << "% occupied\n\n";
+  }
+
+  // 2. Lookups hit; blank glyphs take no space
+  std::cout << "[2] Testing lookups...\n";
+  {
+    OSFGlyphAtlas atlas(128, 1);
+    std::vector<uint8_t> pixels(64, 255);
+    const OSFGlyphEntry *inserted =
+        atlas.insert({1, 14, 36}, 8, 8, pixels.data(), 8, 1, 7);
+    const OSFGlyphEntry *space =
+        atlas.insert({1, 14, 3}, 0, 0, nullptr, 0, 0, 0);
+    if (atlas.find({1, 14, 36}) != inserted || atlas.find({1, 15, 36}) ||
+        atlas.find({2, 14, 36}) || !space ||
+        space->page != OSFGlyphEntry::kNoPage || inserted->bearingY != 7) {
+      std::cout << "    ✗ Lookup mismatch\n";
+      return 1;
+    }
+    std::cout << "    ✓ Keyed by font, size and glyph\n\n";
+  }
+
+  // 3. Full atlases evict the least recently used unpinned page
+  std::cout << "[3] Testing LRU page eviction...\n";
+  {
+    OSFGlyphAtlas atlas(64, 2);
+    std::vector<uint8_t> pixels(30 * 30, 200);
+    // Four 30x30 glyphs fill a 64x64 page (32x32 cells)
+    uint32_t glyph = 0;
+    for (int i = 0; i < 8; ++i)
+      atlas.insert({1, 30, glyph++}, 30, 30, pixels.data(), 30, 0, 0);
+    atlas.takeDirtyRegions();
+    if (atlas.pageCount() != 2 || atlas.evictions() != 0) {
+      std::cout << "    ✗ Expected two full pages\n";
+      return 1;
+    }
+
+    atlas.beginFrame();
+    atlas.find({1, 30, 0}); // Page 0 is used this frame
+    const OSFGlyphEntry *fresh =
+        atlas.insert({1, 30, glyph++}, 30, 30, pixels.data(), 30, 0, 0);
+    if (!fresh || fresh->page != 1 || atlas.evictions() != 1 ||
+        !atlas.find({1, 30, 0}) || atlas.find({1, 30, 4})) {
+      std::cout << "    ✗ Evicted the wrong page\n";
+      return 1;
+    }
+
+    // Both pages pinned and page 1 still has room for three more
+    for (int i = 0; i < 3; ++i)
+      atlas.insert({1, 30, glyph++}, 30, 30, pixels.data(), 30, 0, 0);
+    if (atlas.insert({1, 30, glyph++}, 30, 30, pixels.data(), 30, 0, 0)) {
+      std::cout << "    ✗ Evicted a page pinned by this frame\n";
+      return 1;
+    }
+    if (atlas.insert({1, 30, glyph++}, 90, 90, pixels.data(), 90, 0, 0)) {
+      std::cout << "    ✗ Accepted a glyph larger than a page\n";
+      return 1;
+    }
+    std::cout << "    ✓ Unpinned LRU page reused, pinned pages kept\n\n";
+  }
+
+  // 4. Uploads are batched: whole new pages, then per-cell rects
+  std::cout << "[4] Testing dirty regions...\n";
+  {
+    OSFGlyphAtlas atlas(256, 2);
+    std::vector<uint8_t> pixels(100, 1);
+    atlas.insert({1, 10, 0}, 10, 10, pixels.data(), 10, 0, 0);
+    atlas.insert({1, 10, 1}, 10, 10, pixels.data(), 10, 0, 0);
+    auto first = atlas.takeDirtyRegions();
+    for (uint32_t g = 2; g < 5; ++g)
+      atlas.insert({1, 10, g}, 10, 10, pixels.data(), 10, 0, 0);
+    auto second = atlas.takeDirtyRegions();
+    for (uint32_t g = 5; g < 105; ++g)
+      atlas.insert({1, 10, g}, 10, 10, pixels.data(), 10, 0, 0);
+    auto third = atlas.takeDirtyRegions();
+    if (first.size() != 1 || first[0].width != 256 || second.size() != 3 ||
+        second[0].width != 12 || third.size() != 1 ||
+        !atlas.takeDirtyRegions().empty()) {
+      std::cout << "    ✗ Unexpected regions: " << first.size() << ", "
+                << second.size() << ", " << third.size() << "\n";
+      return 1;
+    }
+    std::cout << "    ✓ New page whole, 3 cells, 100 cells merged to 1\n\n";
+  }
+
+  // 5. Benchmark: packing density and insert cost
+  std::cout << "[5] Benchmarking packing...\n";
+  {
+    constexpr int kPage = 1024;
+    std::vector<Size> sizes = glyphSizes(20000, 7);
+    OSFGlyphAtlas atlas(kPage, 1);
+    std::vector<uint8_t> pixels(40 * 40, 128);
+    size_t skyline = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < sizes.size(); ++i) {
+      if (!atlas.insert({1, 14, i}, sizes[i].width, sizes[i].height,
+                        pixels.data(), 40, 0, 0))
+        break;
+      ++skyline;
+    }
+    double us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+    int rows = rowPacked(sizes, kPage);
+    std::cout << "    row packer: " << rows << " glyphs per page\n";
+    std::cout << "    skyline:    " << skyline << " glyphs per page ("
+              << static_cast<int>(atlas.occupancy() * 100) << "% occupied, "
+              << us / skyline << " us/insert)\n";
+    if (static_cast<int>(skyline) < rows) {
+      std::cout << "    ✗ Skyline packed fewer glyphs\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << (100.0 * skyline / rows - 100)
+              << "% more glyphs per page\n";
+  }
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║          GLYPH ATLAS VALIDATION: PASSED                     ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
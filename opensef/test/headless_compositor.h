@@ -0,0 +1,988 @@
+/**
+ * headless_compositor.h - Headless Compositor Test Harness
+ *
+ * Starts opensef-compositor on the wlroots headless backend with the pixman
+ * renderer and talks to it as an ordinary Wayland client: solid-color
+ * toplevels whose configures can be held back, virtual pointer and
+ * keyboard, and wlr-screencopy captures of the outputs. The compositor's
+ * log goes to a file the test can search.
+ *
+ * Header-only; shared by the compositor validation tests, along with
+ * their banners and the map-and-find setup most of them start with.
+ */
+
+#ifndef OSF_TEST_HEADLESS_COMPOSITOR_H
+#define OSF_TEST_HEADLESS_COMPOSITOR_H
+
+#include "virtual-keyboard-unstable-v1-client-protocol.h"
+#include "wlr-layer-shell-unstable-v1-client-protocol.h"
+#include "wlr-screencopy-unstable-v1-client-protocol.h"
+#include "wlr-virtual-pointer-unstable-v1-client-protocol.h"
+#include "xdg-shell-client-protocol.h"
+
+#include <linux/input-event-codes.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include <xkbcommon/xkbcommon.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef OSF_COMPOSITOR_PATH
+#define OSF_COMPOSITOR_PATH "opensef-compositor"
+#endif
+
+namespace osftest {
+
+// wlroots' headless outputs
+constexpr int kOutputWidth = 1280;
+constexpr int kOutputHeight = 720;
+
+inline double nowMs() {
+  using namespace std::chrono;
+  return duration<double, std::milli>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+inline uint32_t protocolTime() { return static_cast<uint32_t>(nowMs()); }
+
+inline int createShmFile(size_t size) {
+  int fd = memfd_create("osf-test", MFD_CLOEXEC);
+  if (fd >= 0 && ftruncate(fd, static_cast<off_t>(size)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// ============================================================================
+// Images
+// ============================================================================
+
+struct Rect {
+  int x = 0, y = 0, width = 0, height = 0;
+
+  bool operator==(const Rect &r) const {
+    return x == r.x && y == r.y && width == r.width && height == r.height;
+  }
+  bool operator!=(const Rect &r) const { return !(*this == r); }
+  bool empty() const { return width <= 0 || height <= 0; }
+  bool contains(int px, int py) const {
+    return px >= x && py >= y && px < x + width && py < y + height;
+  }
+  bool contains(const Rect &r) const {
+    return r.empty() || (r.x >= x && r.y >= y && r.x + r.width <= x + width &&
+                         r.y + r.height <= y + height);
+  }
+  Rect united(const Rect &r) const {
+    if (empty())
+      return r;
+    if (r.empty())
+      return *this;
+    const int x0 = std::min(x, r.x), y0 = std::min(y, r.y);
+    const int x1 = std::max(x + width, r.x + r.width);
+    const int y1 = std::max(y + height, r.y + r.height);
+    return {x0, y0, x1 - x0, y1 - y0};
+  }
+};
+
+inline std::ostream &operator<<(std::ostream &out, const Rect &r) {
+  return out << r.width << "x" << r.height << "+" << r.x << "+" << r.y;
+}
+
+// XRGB8888, top row first
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels;
+
+  uint32_t at(int x, int y) const {
+    return pixels[static_cast<size_t>(y) * width + x];
+  }
+
+  static bool similar(uint32_t a, uint32_t b, int tolerance) {
+    for (int shift = 0; shift < 24; shift += 8) {
+      const int ca = (a >> shift) & 0xff, cb = (b >> shift) & 0xff;
+      if (std::abs(ca - cb) > tolerance)
+        return false;
+    }
+    return true;
+  }
+
+  // Bounding box of the pixels that differ from `base`
+  Rect diff(const Image &base, int tolerance = 24) const {
+    Rect box;
+    if (base.width != width || base.height != height)
+      return {0, 0, width, height};
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        if (!similar(at(x, y), base.at(x, y), tolerance))
+          box = box.united({x, y, 1, 1});
+      }
+    }
+    return box;
+  }
+
+  // Bounding box of the pixels close to `color`
+  Rect find(uint32_t color, int tolerance = 8) const {
+    Rect box;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        if (similar(at(x, y), color, tolerance))
+          box = box.united({x, y, 1, 1});
+      }
+    }
+    return box;
+  }
+};
+
+// ============================================================================
+// Connections
+// ============================================================================
+
+// Gets the pointer events of a Globals' seat
+class PointerSink {
+public:
+  virtual ~PointerSink() = default;
+  virtual void pointerEnter(wl_surface *) {}
+  virtual void pointerLeave() {}
+  virtual void pointerMotion() {}
+  virtual void pointerButton(uint32_t /*serial*/, uint32_t /*state*/) {}
+};
+
+// The globals of one client connection, bound through
+// kHarnessRegistryListener. The seat's pointer is created once the seat
+// has one; its events go to `sink`
+struct Globals {
+  PointerSink *sink = nullptr;
+  wl_compositor *compositor = nullptr;
+  wl_shm *shm = nullptr;
+  wl_seat *seat = nullptr;
+  wl_pointer *pointer = nullptr;
+  xdg_wm_base *wmBase = nullptr;
+  zwlr_layer_shell_v1 *layerShell = nullptr;
+  zwlr_screencopy_manager_v1 *screencopy = nullptr;
+  zwp_virtual_keyboard_manager_v1 *keyboardManager = nullptr;
+  zwlr_virtual_pointer_manager_v1 *pointerManager = nullptr;
+  std::vector<wl_output *> outputs;
+};
+
+inline void harnessWmBasePing(void *, xdg_wm_base *base, uint32_t serial) {
+  xdg_wm_base_pong(base, serial);
+}
+
+inline const xdg_wm_base_listener kHarnessWmBaseListener = {harnessWmBasePing};
+
+inline PointerSink *harnessSink(void *data) {
+  return static_cast<Globals *>(data)->sink;
+}
+
+// Listener structs grow with protocol versions; only the bound version's
+// events are set, the rest stay null
+inline const wl_pointer_listener kHarnessPointerListener = [] {
+  wl_pointer_listener listener{};
+  listener.enter = [](void *data, wl_pointer *, uint32_t, wl_surface *surface,
+                      wl_fixed_t, wl_fixed_t) {
+    if (PointerSink *sink = harnessSink(data))
+      sink->pointerEnter(surface);
+  };
+  listener.leave = [](void *data, wl_pointer *, uint32_t, wl_surface *) {
+    if (PointerSink *sink = harnessSink(data))
+      sink->pointerLeave();
+  };
+  listener.motion = [](void *data, wl_pointer *, uint32_t, wl_fixed_t,
+                       wl_fixed_t) {
+    if (PointerSink *sink = harnessSink(data))
+      sink->pointerMotion();
+  };
+  listener.button = [](void *data, wl_pointer *, uint32_t serial, uint32_t,
+                       uint32_t, uint32_t state) {
+    if (PointerSink *sink = harnessSink(data))
+      sink->pointerButton(serial, state);
+  };
+  listener.axis = [](void *, wl_pointer *, uint32_t, uint32_t, wl_fixed_t) {};
+  return listener;
+}();
+
+inline const wl_seat_listener kHarnessSeatListener = [] {
+  wl_seat_listener listener{};
+  listener.capabilities = [](void *data, wl_seat *seat, uint32_t caps) {
+    Globals *globals = static_cast<Globals *>(data);
+    if ((caps & WL_SEAT_CAPABILITY_POINTER) && !globals->pointer) {
+      globals->pointer = wl_seat_get_pointer(seat);
+      wl_pointer_add_listener(globals->pointer, &kHarnessPointerListener,
+                              globals);
+    }
+  };
+  return listener;
+}();
+
+inline void harnessRegistryGlobal(void *data, wl_registry *registry,
+                                  uint32_t name, const char *interface,
+                                  uint32_t version) {
+  Globals *g = static_cast<Globals *>(data);
+  if (strcmp(interface, wl_compositor_interface.name) == 0) {
+    g->compositor = static_cast<wl_compositor *>(
+        wl_registry_bind(registry, name, &wl_compositor_interface, 4));
+  } else if (strcmp(interface, wl_shm_interface.name) == 0) {
+    g->shm = static_cast<wl_shm *>(
+        wl_registry_bind(registry, name, &wl_shm_interface, 1));
+  } else if (strcmp(interface, wl_seat_interface.name) == 0 && !g->seat) {
+    g->seat = static_cast<wl_seat *>(
+        wl_registry_bind(registry, name, &wl_seat_interface, 1));
+    wl_seat_add_listener(g->seat, &kHarnessSeatListener, g);
+  } else if (strcmp(interface, wl_output_interface.name) == 0) {
+    g->outputs.push_back(static_cast<wl_output *>(
+        wl_registry_bind(registry, name, &wl_output_interface, 1)));
+  } else if (strcmp(interface, xdg_wm_base_interface.name) == 0) {
+    g->wmBase = static_cast<xdg_wm_base *>(
+        wl_registry_bind(registry, name, &xdg_wm_base_interface, 1));
+    xdg_wm_base_add_listener(g->wmBase, &kHarnessWmBaseListener, g);
+  } else if (strcmp(interface, zwlr_layer_shell_v1_interface.name) == 0) {
+    g->layerShell = static_cast<zwlr_layer_shell_v1 *>(
+        wl_registry_bind(registry, name, &zwlr_layer_shell_v1_interface, 1));
+  } else if (strcmp(interface, zwlr_screencopy_manager_v1_interface.name) ==
+                 0 &&
+             version >= 2) {
+    // copy_with_damage needs version 2
+    g->screencopy = static_cast<zwlr_screencopy_manager_v1 *>(wl_registry_bind(
+        registry, name, &zwlr_screencopy_manager_v1_interface, 2));
+  } else if (strcmp(interface,
+                    zwp_virtual_keyboard_manager_v1_interface.name) == 0) {
+    g->keyboardManager = static_cast<zwp_virtual_keyboard_manager_v1 *>(
+        wl_registry_bind(registry, name,
+                         &zwp_virtual_keyboard_manager_v1_interface, 1));
+  } else if (strcmp(interface,
+                    zwlr_virtual_pointer_manager_v1_interface.name) == 0) {
+    g->pointerManager = static_cast<zwlr_virtual_pointer_manager_v1 *>(
+        wl_registry_bind(registry, name,
+                         &zwlr_virtual_pointer_manager_v1_interface, 1));
+  }
+}
+
+inline const wl_registry_listener kHarnessRegistryListener = {
+    harnessRegistryGlobal, [](void *, wl_registry *, uint32_t) {}};
+
+// A virtual keyboard with the default keymap
+inline zwp_virtual_keyboard_v1 *
+createVirtualKeyboard(zwp_virtual_keyboard_manager_v1 *manager,
+                      wl_seat *seat) {
+  zwp_virtual_keyboard_v1 *keyboard =
+      zwp_virtual_keyboard_manager_v1_create_virtual_keyboard(manager, seat);
+  xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+  xkb_keymap *keymap =
+      xkb_keymap_new_from_names(context, nullptr, XKB_KEYMAP_COMPILE_NO_FLAGS);
+  char *text = xkb_keymap_get_as_string(keymap, XKB_KEYMAP_FORMAT_TEXT_V1);
+  const size_t size = strlen(text) + 1;
+  int fd = createShmFile(size);
+  if (fd >= 0 && write(fd, text, size) == static_cast<ssize_t>(size)) {
+    zwp_virtual_keyboard_v1_keymap(keyboard, WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1,
+                                   fd, static_cast<uint32_t>(size));
+  }
+  if (fd >= 0)
+    close(fd);
+  free(text);
+  xkb_keymap_unref(keymap);
+  xkb_context_unref(context);
+  return keyboard;
+}
+
+// ============================================================================
+// Clients
+// ============================================================================
+
+class HeadlessCompositor;
+
+struct ShmBuffer {
+  wl_buffer *buffer = nullptr;
+  void *data = nullptr;
+  size_t size = 0;
+  int width = 0;
+  int height = 0;
+  int stride = 0;
+  uint32_t format = 0;
+  bool busy = false;
+  bool retired = false; // Destroy once the compositor lets go
+};
+
+inline void destroyShmBuffer(ShmBuffer *buffer) {
+  wl_buffer_destroy(buffer->buffer);
+  munmap(buffer->data, buffer->size);
+  delete buffer;
+}
+
+inline void shmBufferRelease(void *data, wl_buffer *) {
+  ShmBuffer *buffer = static_cast<ShmBuffer *>(data);
+  buffer->busy = false;
+  if (buffer->retired)
+    destroyShmBuffer(buffer);
+}
+
+inline const wl_buffer_listener kShmBufferListener = {shmBufferRelease};
+
+inline ShmBuffer *createShmBuffer(wl_shm *shm, int width, int height,
+                                  int stride, uint32_t format) {
+  const size_t size = static_cast<size_t>(stride) * height;
+  int fd = createShmFile(size);
+  if (fd < 0)
+    return nullptr;
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  wl_shm_pool *pool = wl_shm_create_pool(shm, fd, static_cast<int>(size));
+  close(fd);
+
+  ShmBuffer *buffer = new ShmBuffer;
+  buffer->buffer =
+      wl_shm_pool_create_buffer(pool, 0, width, height, stride, format);
+  wl_shm_pool_destroy(pool);
+  buffer->data = data;
+  buffer->size = size;
+  buffer->width = width;
+  buffer->height = height;
+  buffer->stride = stride;
+  buffer->format = format;
+  wl_buffer_add_listener(buffer->buffer, &kShmBufferListener, buffer);
+  return buffer;
+}
+
+// A toplevel filled with one color. With autoAck (the default) every
+// configure is answered at once with a buffer of the configured size;
+// otherwise the test decides when, through HeadlessCompositor::ack()
+struct Window {
+  HeadlessCompositor *host = nullptr;
+  wl_surface *surface = nullptr;
+  xdg_surface *xdgSurface = nullptr;
+  xdg_toplevel *toplevel = nullptr;
+
+  uint32_t color = 0xff000000u;
+  int width = 0, height = 0; // Size of the next buffer
+  int defaultWidth = 0, defaultHeight = 0;
+  bool autoAck = true;
+
+  // Latest configure, and whether it is still unanswered
+  uint32_t configureSerial = 0;
+  int configureWidth = 0, configureHeight = 0;
+  bool configurePending = false;
+  int configures = 0;
+  bool maximized = false;
+
+  bool mapped = false;
+  bool closed = false;
+  uint64_t frames = 0; // Frame callbacks received
+  wl_callback *frameCallback = nullptr;
+  std::vector<ShmBuffer *> buffers;
+};
+
+// ============================================================================
+// Report
+// ============================================================================
+
+// The title box every validation test opens with, e.g. "Resize"
+inline void printBanner(const std::string &test) {
+  const std::string title = "openSEF Compositor " + test + " Validation";
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout << "║     " << title
+            << std::string(title.size() < 55 ? 55 - title.size() : 0, ' ')
+            << "║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+}
+
+inline void printPassed(const std::string &test) {
+  std::string title = "COMPOSITOR " + test + " VALIDATION: PASSED";
+  std::transform(title.begin(), title.end(), title.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+  const size_t pad = title.size() < 60 ? 60 - title.size() : 0;
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout << "║" << std::string(pad / 2, ' ') << title
+            << std::string(pad - pad / 2, ' ') << "║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+}
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+// Extra environment for the compositor, e.g. {{"WLR_HEADLESS_OUTPUTS", "2"}}
+using Environment = std::vector<std::pair<std::string, std::string>>;
+
+// `extra` with animations turned off, so windows show up at once
+inline Environment withoutAnimations(Environment extra = {}) {
+  extra.insert(extra.begin(), {"VITUS_ANIMATIONS", "0"});
+  return extra;
+}
+
+class HeadlessCompositor : public PointerSink {
+public:
+  explicit HeadlessCompositor(Environment env = {}) : env_(std::move(env)) {}
+  ~HeadlessCompositor() { stop(); }
+
+  HeadlessCompositor(const HeadlessCompositor &) = delete;
+  HeadlessCompositor &operator=(const HeadlessCompositor &) = delete;
+
+  bool start();
+  void stop();
+
+  // Runs the client side for `ms`; false once the connection is gone
+  bool dispatch(double ms);
+  // Dispatches until `done` returns true or `timeoutMs` passes
+  bool waitFor(const std::function<bool()> &done, double timeoutMs);
+
+  Window *createWindow(int width, int height, uint32_t color,
+                       bool autoAck = true);
+  // Created, configured and its first frame shown
+  Window *mapWindow(int width, int height, uint32_t color,
+                    bool autoAck = true);
+  // Mapped, then after `settleMs` found on output 0 at its own size; the
+  // box it was found at goes to `shown`
+  Window *showWindow(int width, int height, uint32_t color, bool autoAck,
+                     Rect &shown, double settleMs = 50);
+  // Answers the latest configure with a buffer of its size
+  void ack(Window *w);
+  // New buffer at the current size, with a frame callback
+  void commit(Window *w);
+  void destroyWindow(Window *w);
+
+  // One frame of output `output`. With `damage`, waits for the next frame
+  // with new damage (copy_with_damage) and returns its rectangles. Each
+  // output has one capture buffer that is reused, like a VNC server's, so
+  // damage copies only refresh what changed in it
+  bool capture(Image &image, std::vector<Rect> *damage = nullptr,
+               size_t output = 0);
+  size_t outputCount() const { return globals_.outputs.size(); }
+
+  void pointerTo(double x, double y);
+  void button(uint32_t state, uint32_t code = BTN_LEFT);
+  void key(uint32_t keycode, uint32_t state);
+  void superKey(uint32_t keycode);
+
+  // Serial of the last wl_pointer.button, for move/resize requests
+  uint32_t buttonSerial() const { return buttonSerial_; }
+  wl_seat *seat() const { return globals_.seat; }
+
+  // Everything the compositor logged so far
+  std::string log() const;
+  bool logContains(const std::string &text) const {
+    return log().find(text) != std::string::npos;
+  }
+  size_t logCount(const std::string &text) const {
+    const std::string all = log();
+    size_t count = 0;
+    for (size_t at = all.find(text); at != std::string::npos;
+         at = all.find(text, at + text.size()))
+      count++;
+    return count;
+  }
+
+  // ---- Listener hooks ----
+  void pointerButton(uint32_t serial, uint32_t) override {
+    buttonSerial_ = serial;
+  }
+  void surfaceConfigure(Window *w, uint32_t serial);
+
+private:
+  bool spawn();
+  void draw(Window *w);
+  ShmBuffer *freeBuffer(Window *w);
+
+  Environment env_;
+  pid_t pid_ = -1;
+  std::string runtimeDir_;
+  std::string socket_;
+  std::string logPath_;
+  bool ownRuntimeDir_ = false;
+  bool failed_ = false;
+
+  wl_display *display_ = nullptr;
+  wl_registry *registry_ = nullptr;
+  Globals globals_;
+  zwp_virtual_keyboard_v1 *keyboard_ = nullptr;
+  zwlr_virtual_pointer_v1 *virtualPointer_ = nullptr;
+  std::vector<ShmBuffer *> captureBuffers_; // Per output
+  std::vector<std::unique_ptr<Window>> windows_;
+  uint32_t buttonSerial_ = 0;
+};
+
+// ---- Listeners -------------------------------------------------------------
+
+inline const xdg_surface_listener kHarnessXdgSurfaceListener = {
+    [](void *data, xdg_surface *, uint32_t serial) {
+      Window *w = static_cast<Window *>(data);
+      w->host->surfaceConfigure(w, serial);
+    }};
+
+inline void harnessToplevelConfigure(void *data, xdg_toplevel *, int32_t width,
+                                     int32_t height, wl_array *states) {
+  Window *w = static_cast<Window *>(data);
+  w->configureWidth = width > 0 ? width : w->defaultWidth;
+  w->configureHeight = height > 0 ? height : w->defaultHeight;
+  w->maximized = false;
+  const uint32_t *state = static_cast<const uint32_t *>(states->data);
+  for (size_t i = 0; i < states->size / sizeof(uint32_t); ++i) {
+    if (state[i] == XDG_TOPLEVEL_STATE_MAXIMIZED)
+      w->maximized = true;
+  }
+}
+
+inline const xdg_toplevel_listener kHarnessToplevelListener = [] {
+  xdg_toplevel_listener listener{};
+  listener.configure = harnessToplevelConfigure;
+  listener.close = [](void *data, xdg_toplevel *) {
+    static_cast<Window *>(data)->closed = true;
+  };
+  return listener;
+}();
+
+inline const wl_callback_listener kHarnessFrameListener = {
+    [](void *data, wl_callback *callback, uint32_t) {
+      Window *w = static_cast<Window *>(data);
+      wl_callback_destroy(callback);
+      w->frameCallback = nullptr;
+      w->frames++;
+    }};
+
+// One screencopy frame in flight
+struct CaptureState {
+  wl_shm *shm = nullptr;
+  bool withDamage = false;
+  ShmBuffer **buffer = nullptr; // The output's, replaced if it doesn't fit
+  bool requested = false;
+  uint32_t flags = 0;
+  std::vector<Rect> damage;
+  bool ready = false;
+  bool failed = false;
+};
+
+inline const zwlr_screencopy_frame_v1_listener kHarnessCaptureListener = [] {
+  zwlr_screencopy_frame_v1_listener listener{};
+  listener.buffer = [](void *data, zwlr_screencopy_frame_v1 *frame,
+                       uint32_t format, uint32_t width, uint32_t height,
+                       uint32_t stride) {
+    CaptureState *state = static_cast<CaptureState *>(data);
+    if (state->requested)
+      return;
+    state->requested = true;
+    ShmBuffer *&buffer = *state->buffer;
+    if (buffer && (buffer->width != static_cast<int>(width) ||
+                   buffer->height != static_cast<int>(height) ||
+                   buffer->stride != static_cast<int>(stride) ||
+                   buffer->format != format)) {
+      destroyShmBuffer(buffer);
+      buffer = nullptr;
+    }
+    if (!buffer)
+      buffer = createShmBuffer(state->shm, static_cast<int>(width),
+                               static_cast<int>(height),
+                               static_cast<int>(stride), format);
+    if (!buffer) {
+      state->failed = true;
+      return;
+    }
+    if (state->withDamage)
+      zwlr_screencopy_frame_v1_copy_with_damage(frame, buffer->buffer);
+    else
+      zwlr_screencopy_frame_v1_copy(frame, buffer->buffer);
+  };
+  listener.flags = [](void *data, zwlr_screencopy_frame_v1 *, uint32_t flags) {
+    static_cast<CaptureState *>(data)->flags = flags;
+  };
+  listener.ready = [](void *data, zwlr_screencopy_frame_v1 *, uint32_t,
+                      uint32_t, uint32_t) {
+    static_cast<CaptureState *>(data)->ready = true;
+  };
+  listener.failed = [](void *data, zwlr_screencopy_frame_v1 *) {
+    static_cast<CaptureState *>(data)->failed = true;
+  };
+  listener.damage = [](void *data, zwlr_screencopy_frame_v1 *, uint32_t x,
+                       uint32_t y, uint32_t width, uint32_t height) {
+    static_cast<CaptureState *>(data)->damage.push_back(
+        {static_cast<int>(x), static_cast<int>(y), static_cast<int>(width),
+         static_cast<int>(height)});
+  };
+  return listener;
+}();
+
+// ---- Process ---------------------------------------------------------------
+
+inline bool HeadlessCompositor::spawn() {
+  const char *runtime = getenv("XDG_RUNTIME_DIR");
+  if (runtime && runtime[0] != '\0') {
+    runtimeDir_ = runtime;
+  } else {
+    char dir[] = "/tmp/osf-test-XXXXXX";
+    if (!mkdtemp(dir))
+      return false;
+    runtimeDir_ = dir;
+    ownRuntimeDir_ = true;
+    setenv("XDG_RUNTIME_DIR", dir, 1);
+  }
+  static int instance = 0;
+  socket_ = "osf-test-" + std::to_string(getpid()) + "-" +
+            std::to_string(instance++);
+  logPath_ = runtimeDir_ + "/" + socket_ + ".log";
+
+  pid_ = fork();
+  if (pid_ < 0)
+    return false;
+  if (pid_ == 0) {
+    setenv("VITUS_BACKEND", "headless", 1);
+    setenv("WLR_RENDERER", "pixman", 1);
+    setenv("WLR_LIBINPUT_NO_DEVICES", "1", 1);
+    setenv("VITUS_VIRTUAL_INPUT", "1", 1);
+    for (const auto &var : env_)
+      setenv(var.first.c_str(), var.second.c_str(), 1);
+    FILE *log = fopen(logPath_.c_str(), "w");
+    if (log) {
+      dup2(fileno(log), STDOUT_FILENO);
+      dup2(fileno(log), STDERR_FILENO);
+    }
+    execl(OSF_COMPOSITOR_PATH, OSF_COMPOSITOR_PATH, "-s", socket_.c_str(),
+          static_cast<char *>(nullptr));
+    _exit(127);
+  }
+  return true;
+}
+
+inline bool HeadlessCompositor::start() {
+  if (!spawn()) {
+    std::cerr << "Cannot start " << OSF_COMPOSITOR_PATH << "\n";
+    return false;
+  }
+
+  // The socket shows up once the compositor is initialized
+  const double deadline = nowMs() + 10000;
+  while (!(display_ = wl_display_connect(socket_.c_str()))) {
+    int status;
+    if (waitpid(pid_, &status, WNOHANG) == pid_) {
+      std::cerr << OSF_COMPOSITOR_PATH << " exited during startup\n";
+      pid_ = -1;
+      return false;
+    }
+    if (nowMs() > deadline) {
+      std::cerr << "Timed out waiting for the compositor socket\n";
+      return false;
+    }
+    usleep(20000);
+  }
+  registry_ = wl_display_get_registry(display_);
+  globals_.sink = this;
+  wl_registry_add_listener(registry_, &kHarnessRegistryListener, &globals_);
+  wl_display_roundtrip(display_); // Globals
+  wl_display_roundtrip(display_); // Seat capabilities, outputs
+  const Globals &g = globals_;
+  if (!g.compositor || !g.shm || !g.wmBase || !g.seat || !g.screencopy ||
+      !g.keyboardManager || !g.pointerManager || g.outputs.empty()) {
+    std::cerr << "Compositor lacks a global the tests need\n";
+    return false;
+  }
+
+  keyboard_ = createVirtualKeyboard(g.keyboardManager, g.seat);
+  virtualPointer_ = zwlr_virtual_pointer_manager_v1_create_virtual_pointer(
+      g.pointerManager, g.seat);
+
+  // Out of the way of the windows the tests map
+  pointerTo(kOutputWidth - 1, kOutputHeight - 1);
+  return dispatch(100);
+}
+
+inline void HeadlessCompositor::stop() {
+  if (display_) {
+    for (auto &w : windows_) {
+      if (w->surface)
+        destroyWindow(w.get());
+    }
+    windows_.clear();
+    for (ShmBuffer *buffer : captureBuffers_) {
+      if (buffer)
+        destroyShmBuffer(buffer);
+    }
+    captureBuffers_.clear();
+    wl_display_flush(display_);
+    wl_display_disconnect(display_);
+    display_ = nullptr;
+  }
+  if (pid_ > 0) {
+    kill(pid_, SIGTERM);
+    waitpid(pid_, nullptr, 0);
+    pid_ = -1;
+  }
+  if (!logPath_.empty()) {
+    unlink(logPath_.c_str());
+    logPath_.clear();
+  }
+  if (ownRuntimeDir_) {
+    rmdir(runtimeDir_.c_str());
+    ownRuntimeDir_ = false;
+  }
+}
+
+inline std::string HeadlessCompositor::log() const {
+  std::ifstream in(logPath_);
+  std::ostringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+// ---- Event loop ------------------------------------------------------------
+
+inline bool HeadlessCompositor::dispatch(double ms) {
+  return waitFor([] { return false; }, ms) || !failed_;
+}
+
+inline bool HeadlessCompositor::waitFor(const std::function<bool()> &done,
+                                        double timeoutMs) {
+  const double end = nowMs() + timeoutMs;
+  while (!failed_) {
+    wl_display_dispatch_pending(display_);
+    if (done())
+      return true;
+    const double now = nowMs();
+    if (now >= end)
+      return false;
+    wl_display_flush(display_);
+
+    pollfd fd = {wl_display_get_fd(display_), POLLIN, 0};
+    const int timeout = static_cast<int>(std::min(end - now, 10.0)) + 1;
+    if (poll(&fd, 1, timeout) < 0)
+      continue;
+    if (fd.revents & (POLLERR | POLLHUP)) {
+      std::cerr << "Compositor connection lost\n";
+      failed_ = true;
+    } else if ((fd.revents & POLLIN) && wl_display_dispatch(display_) < 0) {
+      std::cerr << "Protocol error\n";
+      failed_ = true;
+    }
+  }
+  return false;
+}
+
+// ---- Windows ---------------------------------------------------------------
+
+inline Window *HeadlessCompositor::createWindow(int width, int height,
+                                                uint32_t color, bool autoAck) {
+  auto w = std::make_unique<Window>();
+  w->host = this;
+  w->color = color;
+  w->defaultWidth = width;
+  w->defaultHeight = height;
+  w->autoAck = autoAck;
+  w->surface = wl_compositor_create_surface(globals_.compositor);
+  w->xdgSurface = xdg_wm_base_get_xdg_surface(globals_.wmBase, w->surface);
+  xdg_surface_add_listener(w->xdgSurface, &kHarnessXdgSurfaceListener,
+                           w.get());
+  w->toplevel = xdg_surface_get_toplevel(w->xdgSurface);
+  xdg_toplevel_add_listener(w->toplevel, &kHarnessToplevelListener, w.get());
+  xdg_toplevel_set_title(w->toplevel, "headless-test");
+  xdg_toplevel_set_app_id(w->toplevel, "org.opensef.test");
+  wl_surface_commit(w->surface);
+  windows_.push_back(std::move(w));
+  return windows_.back().get();
+}
+
+inline Window *HeadlessCompositor::mapWindow(int width, int height,
+                                             uint32_t color, bool autoAck) {
+  Window *w = createWindow(width, height, color, true);
+  if (!waitFor([w] { return w->frames > 0; }, 2000)) {
+    std::cout << "    ✗ Window never mapped\n";
+    return nullptr;
+  }
+  w->autoAck = autoAck;
+  return w;
+}
+
+inline Window *HeadlessCompositor::showWindow(int width, int height,
+                                              uint32_t color, bool autoAck,
+                                              Rect &shown, double settleMs) {
+  Window *w = mapWindow(width, height, color, autoAck);
+  if (!w)
+    return nullptr;
+  dispatch(settleMs);
+  Image image;
+  if (!capture(image)) {
+    std::cout << "    ✗ Capture failed\n";
+    return nullptr;
+  }
+  shown = image.find(color);
+  if (shown.width != width || shown.height != height) {
+    std::cout << "    ✗ Window shown as " << shown << "\n";
+    return nullptr;
+  }
+  return w;
+}
+
+inline void HeadlessCompositor::surfaceConfigure(Window *w, uint32_t serial) {
+  w->configureSerial = serial;
+  w->configurePending = true;
+  w->configures++;
+  if (w->autoAck || !w->mapped)
+    ack(w);
+}
+
+inline void HeadlessCompositor::ack(Window *w) {
+  if (!w->configurePending)
+    return;
+  xdg_surface_ack_configure(w->xdgSurface, w->configureSerial);
+  w->configurePending = false;
+  w->width = w->configureWidth;
+  w->height = w->configureHeight;
+  commit(w);
+}
+
+inline ShmBuffer *HeadlessCompositor::freeBuffer(Window *w) {
+  for (auto it = w->buffers.begin(); it != w->buffers.end();) {
+    ShmBuffer *buffer = *it;
+    if (buffer->width == w->width && buffer->height == w->height) {
+      if (!buffer->busy)
+        return buffer;
+      ++it;
+    } else {
+      it = w->buffers.erase(it);
+      if (buffer->busy)
+        buffer->retired = true;
+      else
+        destroyShmBuffer(buffer);
+    }
+  }
+  ShmBuffer *buffer = createShmBuffer(globals_.shm, w->width, w->height,
+                                      w->width * 4, WL_SHM_FORMAT_XRGB8888);
+  if (buffer)
+    w->buffers.push_back(buffer);
+  return buffer;
+}
+
+inline void HeadlessCompositor::commit(Window *w) {
+  if (w->width <= 0 || w->height <= 0)
+    return;
+  ShmBuffer *buffer = freeBuffer(w);
+  if (!buffer)
+    return;
+  uint32_t *pixels = static_cast<uint32_t *>(buffer->data);
+  std::fill(pixels, pixels + w->width * w->height, w->color);
+  wl_surface_attach(w->surface, buffer->buffer, 0, 0);
+  wl_surface_damage_buffer(w->surface, 0, 0, w->width, w->height);
+  if (!w->frameCallback) {
+    w->frameCallback = wl_surface_frame(w->surface);
+    wl_callback_add_listener(w->frameCallback, &kHarnessFrameListener, w);
+  }
+  buffer->busy = true;
+  wl_surface_commit(w->surface);
+  w->mapped = true;
+}
+
+inline void HeadlessCompositor::destroyWindow(Window *w) {
+  if (w->frameCallback)
+    wl_callback_destroy(w->frameCallback);
+  w->frameCallback = nullptr;
+  for (ShmBuffer *buffer : w->buffers) {
+    if (buffer->busy)
+      buffer->retired = true;
+    else
+      destroyShmBuffer(buffer);
+  }
+  w->buffers.clear();
+  xdg_toplevel_destroy(w->toplevel);
+  xdg_surface_destroy(w->xdgSurface);
+  wl_surface_destroy(w->surface);
+  w->toplevel = nullptr;
+  w->xdgSurface = nullptr;
+  w->surface = nullptr;
+  wl_display_flush(display_);
+}
+
+// ---- Capture ---------------------------------------------------------------
+
+inline bool HeadlessCompositor::capture(Image &image,
+                                        std::vector<Rect> *damage,
+                                        size_t output) {
+  if (output >= globals_.outputs.size())
+    return false;
+  captureBuffers_.resize(globals_.outputs.size(), nullptr);
+  CaptureState state;
+  state.shm = globals_.shm;
+  state.withDamage = damage != nullptr;
+  state.buffer = &captureBuffers_[output];
+  zwlr_screencopy_frame_v1 *frame = zwlr_screencopy_manager_v1_capture_output(
+      globals_.screencopy, 0, globals_.outputs[output]);
+  zwlr_screencopy_frame_v1_add_listener(frame, &kHarnessCaptureListener,
+                                        &state);
+  const bool done =
+      waitFor([&] { return state.ready || state.failed; }, 2000);
+  zwlr_screencopy_frame_v1_destroy(frame);
+
+  bool ok = done && state.ready && *state.buffer;
+  if (ok) {
+    const ShmBuffer *buffer = *state.buffer;
+    const bool flip = state.flags & ZWLR_SCREENCOPY_FRAME_V1_FLAGS_Y_INVERT;
+    image.width = buffer->width;
+    image.height = buffer->height;
+    image.pixels.resize(static_cast<size_t>(buffer->width) * buffer->height);
+    for (int y = 0; y < buffer->height; ++y) {
+      const int row = flip ? buffer->height - 1 - y : y;
+      const uint32_t *src = reinterpret_cast<const uint32_t *>(
+          static_cast<const uint8_t *>(buffer->data) +
+          static_cast<size_t>(row) * buffer->stride);
+      std::copy(src, src + buffer->width,
+                image.pixels.begin() + static_cast<size_t>(y) * buffer->width);
+    }
+    if (damage)
+      *damage = state.damage;
+  }
+  return ok;
+}
+
+// ---- Virtual input ---------------------------------------------------------
+
+inline void HeadlessCompositor::pointerTo(double x, double y) {
+  x = std::clamp(x, 0.0, kOutputWidth - 1.0);
+  y = std::clamp(y, 0.0, kOutputHeight - 1.0);
+  zwlr_virtual_pointer_v1_motion_absolute(
+      virtualPointer_, protocolTime(), static_cast<uint32_t>(x),
+      static_cast<uint32_t>(y), kOutputWidth, kOutputHeight);
+  zwlr_virtual_pointer_v1_frame(virtualPointer_);
+  wl_display_flush(display_);
+}
+
+inline void HeadlessCompositor::button(uint32_t state, uint32_t code) {
+  zwlr_virtual_pointer_v1_button(virtualPointer_, protocolTime(), code, state);
+  zwlr_virtual_pointer_v1_frame(virtualPointer_);
+  wl_display_flush(display_);
+}
+
+inline void HeadlessCompositor::key(uint32_t keycode, uint32_t state) {
+  zwp_virtual_keyboard_v1_key(keyboard_, protocolTime(), keycode, state);
+  wl_display_flush(display_);
+}
+
+inline void HeadlessCompositor::superKey(uint32_t keycode) {
+  key(KEY_LEFTMETA, WL_KEYBOARD_KEY_STATE_PRESSED);
+  key(keycode, WL_KEYBOARD_KEY_STATE_PRESSED);
+  key(keycode, WL_KEYBOARD_KEY_STATE_RELEASED);
+  key(KEY_LEFTMETA, WL_KEYBOARD_KEY_STATE_RELEASED);
+}
+
+} // namespace osftest
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * layer_cache_validation.cpp - OSFLayer Backing Store Validation
+ *
+ * Counts draw() calls to check that transform and opacity changes only
+ * re-composite the cached bitmap, while drawing-affecting properties and
+ * setNeedsDisplay() re-rasterize it, that a draw() override which
+ * doesn't opt in still runs every frame, unclipped, and that plain layers
+ * from create() are cached without opting in.
+ */
+
+#include <opensef/OSFLayer.h>
+
+#include <iostream>
+
+using namespace opensef;
+
+namespace {
+
+class CountingLayer : public OSFLayer {
+public:
+  int draws = 0;
+
+  void draw(cairo_t *cr) override {
+    ++draws;
+    cairo_set_source_rgba(cr, 1, 0, 0, 1);
+    cairo_rectangle(cr, 10, 10, 20, 20);
+    cairo_fill(cr);
+  }
+};
+
+// Paints a green square outside its 40x40 bounds
+class OverhangLayer : public CountingLayer {
+public:
+  void draw(cairo_t *cr) override {
+    ++draws;
+    cairo_set_source_rgba(cr, 0, 1, 0, 1);
+    cairo_rectangle(cr, 60, 60, 10, 10);
+    cairo_fill(cr);
+  }
+};
+
+uint32_t pixelAt(cairo_surface_t *surface, int x, int y) {
+  cairo_surface_flush(surface);
+  const unsigned char *row = cairo_image_surface_get_data(surface) +
+                             y * cairo_image_surface_get_stride(surface);
+  return reinterpret_cast<const uint32_t *>(row)[x];
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Layer Backing Store Validation               ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  cairo_surface_t *target =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256);
+  cairo_t *cr = cairo_create(target);
+
+  OSFLayer::setDisableImplicitAnimations(true);
+  auto layer = std::make_shared<CountingLayer>();
+  layer->setCachesDrawing(true);
+  layer->setBounds(OSFRect(0, 0, 100, 60));
+  layer->setBackgroundColor(OSFColor(0.2, 0.4, 0.8, 1.0));
+  layer->setCornerRadius(8);
+  layer->setShadowOpacity(0.4);
+  layer->setShadowRadius(6);
+
+  // 1. Rasterize once, then reuse
+  std::cout << "[1] Testing cached re-render...\n";
+  layer->render(cr);
+  layer->render(cr);
+  layer->render(cr);
+  if (layer->draws != 1 || !layer->hasBackingStore()) {
+    std::cout << "    ✗ Expected 1 draw, got " << layer->draws << "\n";
+    return 1;
+  }
+  std::cout << "    ✓ Three renders, one rasterization\n\n";
+
+  // 2. Compositing-only properties
+  std::cout << "[2] Testing transform/opacity changes...\n";
+  for (int frame = 1; frame <= 30; ++frame) {
+    layer->setPosition(frame * 2.0, frame * 1.5);
+    layer->setOpacity(1.0 - frame / 60.0);
+    layer->setScale(1.0 + frame / 100.0);
+    layer->setRotation(frame * 0.01);
+    layer->render(cr);
+  }
+  if (layer->draws != 1) {
+    std::cout << "    ✗ Re-rasterized " << layer->draws - 1 << " times\n";
+    return 1;
+  }
+  std::cout << "    ✓ 30 animated frames re-composited the cached bitmap\n\n";
+
+  // 3. Drawing-affecting properties and explicit invalidation
+  std::cout << "[3] Testing invalidation...\n";
+  layer->setBackgroundColor(OSFColor(0.9, 0.1, 0.1, 1.0));
+  layer->render(cr);
+  bool propertyOk = layer->draws == 2;
+
+  layer->setNeedsDisplay();
+  layer->render(cr);
+  bool displayOk = layer->draws == 3;
+
+  layer->setNeedsDisplayInRect(OSFRect(10, 10, 20, 20));
+  bool pendingOk = layer->needsDisplay();
+  layer->render(cr);
+  bool rectOk = layer->draws == 4 && !layer->needsDisplay();
+
+  layer->setBounds(OSFRect(0, 0, 120, 60));
+  layer->render(cr);
+  bool boundsOk = layer->draws == 5;
+
+  if (!propertyOk || !displayOk || !pendingOk || !rectOk || !boundsOk) {
+    std::cout << "    ✗ Invalidation FAILED (draws=" << layer->draws << ")\n";
+    return 1;
+  }
+  std::cout << "    ✓ Color, bounds and setNeedsDisplay re-rasterize once\n\n";
+
+  // 4. Sublayers keep their own stores
+  std::cout << "[4] Testing sublayers...\n";
+  auto child = std::make_shared<CountingLayer>();
+  child->setCachesDrawing(true);
+  child->setBounds(OSFRect(0, 0, 40, 40));
+  layer->addSublayer(child);
+  layer->setOpacity(0.5);
+  layer->render(cr);
+  layer->setPosition(5, 5);
+  layer->render(cr);
+  child->setNeedsDisplay();
+  layer->render(cr);
+  if (layer->draws != 5 || child->draws != 2) {
+    std::cout << "    ✗ Sublayer caching FAILED (parent=" << layer->draws
+              << ", child=" << child->draws << ")\n";
+    return 1;
+  }
+  layer->discardBackingStore();
+  if (layer->hasBackingStore() || !layer->needsDisplay()) {
+    std::cout << "    ✗ discardBackingStore FAILED\n";
+    return 1;
+  }
+  std::cout << "    ✓ Child invalidation leaves the parent cached\n\n";
+
+  // 5. Without setCachesDrawing(), draw() behaves as it always did
+  std::cout << "[5] Testing a draw() override that doesn't opt in...\n";
+  {
+    cairo_surface_t *plain =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 128, 128);
+    cairo_t *plainCr = cairo_create(plain);
+    auto overhang = std::make_shared<OverhangLayer>();
+    overhang->setBounds(OSFRect(0, 0, 40, 40));
+    overhang->setBackgroundColor(OSFColor(0.2, 0.4, 0.8, 1.0));
+    for (int frame = 0; frame < 3; ++frame) {
+      overhang->render(plainCr);
+    }
+    const bool everyFrame = overhang->draws == 3;
+    const bool unclipped = pixelAt(plain, 65, 65) == 0xff00ff00u;
+    cairo_destroy(plainCr);
+    cairo_surface_destroy(plain);
+    if (!everyFrame || !unclipped) {
+      std::cout << "    ✗ " << overhang->draws << " draws for 3 renders"
+                << (unclipped ? "" : ", clipped to its bounds") << "\n";
+      return 1;
+    }
+  }
+  std::cout << "    ✓ Drawn on every render, outside its bounds too\n\n";
+
+  // 6. Plain layers cache their style from the start
+  std::cout << "[6] Testing a plain layer...\n";
+  OSFLayerPtr plain = OSFLayer::create();
+  plain->setBounds(OSFRect(0, 0, 40, 40));
+  plain->render(cr);
+  const bool emptySkipped = !plain->hasBackingStore();
+  plain->setBackgroundColor(OSFColor(0.2, 0.4, 0.8, 1.0));
+  plain->render(cr);
+  if (!plain->cachesDrawing() || !emptySkipped ||
+      !plain->hasBackingStore()) {
+    std::cout << "    ✗ Plain layer caching FAILED\n";
+    return 1;
+  }
+  std::cout << "    ✓ Cached; no store until it has a style to draw\n";
+
+  cairo_destroy(cr);
+  cairo_surface_destroy(target);
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║           LAYER CACHE VALIDATION: PASSED                    ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * notification_queue_validation.cpp - OSFNotificationQueue Validation
+ *
+ * Drives a queue on OSFRunLoop::main() and counts deliveries from the
+ * default center: bursts coalesce by name and by sender, a burst costs
+ * one run loop task, WhenIdle waits for regular tasks, and Now and
+ * dequeueNotifications() drop what is queued.
+ */
+
+#include <opensef/OpenSEFBase.h>
+
+#include <iostream>
+
+using namespace opensef;
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Notification Queue Validation                ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  auto &center = OSFNotificationCenter::defaultCenter();
+  OSFRunLoop &loop = OSFRunLoop::main();
+  OSFNotificationQueue queue(center, loop);
+
+  int layoutCount = 0;
+  int themeCount = 0;
+  auto layoutToken = center.addObserver(
+      "LayoutChanged", [&layoutCount]() { layoutCount++; });
+  auto themeToken =
+      center.addObserver("ThemeChanged", [&themeCount]() { themeCount++; });
+
+  // 1. Coalescing on name
+  std::cout << "[1] Testing name coalescing...\n";
+  for (int i = 0; i < 100; ++i) {
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP);
+    queue.enqueueNotification("ThemeChanged", OSFPostingStyle::WhenIdle);
+  }
+  std::size_t tasks = loop.runPendingTasks();
+  std::size_t idleTasks = loop.runIdleTasks();
+  if (layoutCount != 1 || themeCount != 1) {
+    std::cout << "    ✗ Coalescing FAILED (layout " << layoutCount
+              << ", theme " << themeCount << ")\n";
+    return 1;
+  }
+  if (tasks != 1 || idleTasks != 1) {
+    std::cout << "    ✗ " << tasks << " tasks and " << idleTasks
+              << " idle tasks for one burst\n";
+    return 1;
+  }
+  std::cout << "    ✓ 200 posts, 2 run loop tasks, 2 deliveries\n\n";
+
+  // 2. Coalescing on sender
+  std::cout << "[2] Testing sender coalescing...\n";
+  {
+    int first = 0;
+    int second = 0;
+    layoutCount = 0;
+    for (int i = 0; i < 10; ++i) {
+      queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                                OSFNotificationCoalescingOnName |
+                                    OSFNotificationCoalescingOnSender,
+                                &first);
+      queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                                OSFNotificationCoalescingOnName |
+                                    OSFNotificationCoalescingOnSender,
+                                &second);
+    }
+    loop.runPendingTasks();
+    const int perSender = layoutCount;
+
+    layoutCount = 0;
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                              OSFNotificationCoalescingOnName, &first);
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                              OSFNotificationCoalescingOnName, &second);
+    loop.runPendingTasks();
+    const int perName = layoutCount;
+
+    layoutCount = 0;
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                              OSFNotificationNoCoalescing);
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP,
+                              OSFNotificationNoCoalescing);
+    loop.runPendingTasks();
+    const int uncoalesced = layoutCount;
+
+    if (perSender != 2 || perName != 1 || uncoalesced != 2) {
+      std::cout << "    ✗ Deliveries: " << perSender << " per sender, "
+                << perName << " per name, " << uncoalesced
+                << " uncoalesced\n";
+      return 1;
+    }
+  }
+  std::cout << "    ✓ One delivery per sender, per name, or per post\n\n";
+
+  // 3. WhenIdle waits for regular tasks
+  std::cout << "[3] Testing WhenIdle ordering...\n";
+  {
+    themeCount = 0;
+    bool taskRan = false;
+    queue.enqueueNotification("ThemeChanged", OSFPostingStyle::WhenIdle);
+    loop.postTask([&taskRan]() { taskRan = true; });
+    const std::size_t early = loop.runIdleTasks();
+    const bool waited = early == 0 && themeCount == 0;
+    loop.runPendingTasks();
+    loop.runIdleTasks();
+    if (!waited || !taskRan || themeCount != 1) {
+      std::cout << "    ✗ Idle delivery " << (waited ? "late" : "early")
+                << " (theme " << themeCount << ")\n";
+      return 1;
+    }
+  }
+  std::cout << "    ✓ Delivered only once no regular task was queued\n\n";
+
+  // 4. Now and dequeueNotifications() drop queued posts
+  std::cout << "[4] Testing Now and dequeue...\n";
+  {
+    layoutCount = 0;
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::ASAP);
+    queue.enqueueNotification("LayoutChanged", OSFPostingStyle::Now);
+    const int immediate = layoutCount;
+    loop.runPendingTasks();
+    const int afterNow = layoutCount;
+
+    themeCount = 0;
+    queue.enqueueNotification("ThemeChanged", OSFPostingStyle::WhenIdle);
+    queue.dequeueNotifications("ThemeChanged", nullptr,
+                               OSFNotificationCoalescingOnName);
+    loop.runPendingTasks();
+    loop.runIdleTasks();
+
+    if (immediate != 1 || afterNow != 1 || themeCount != 0) {
+      std::cout << "    ✗ Now delivered " << immediate << " then "
+                << afterNow - immediate << ", dequeued delivered "
+                << themeCount << "\n";
+      return 1;
+    }
+  }
+  std::cout << "    ✓ Queued posts dropped, nothing delivered twice\n";
+
+  center.removeObserver(layoutToken);
+  center.removeObserver(themeToken);
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║         NOTIFICATION QUEUE VALIDATION: PASSED              ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
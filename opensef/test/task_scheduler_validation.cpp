@@ -0,0 +1,140 @@
+/**
+ * task_scheduler_validation.cpp - OSFTaskScheduler Validation
+ *
+ * Exercises the work-stealing pool: fan-out, nested submission, priorities,
+ * cancellation, and continuations posted back to the application run loop.
+ */
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <opensef/OSFTaskScheduler.h>
+#include <opensef/OpenSEFBase.h>
+#include <string>
+#include <thread>
+
+using namespace opensef;
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Task Scheduler Validation                    ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  OSFTaskScheduler scheduler(4);
+
+  // 1. Fan-out
+  std::cout << "[1] Testing fan-out on " << scheduler.threadCount()
+            << " workers...\n";
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 10000; ++i) {
+    scheduler.submit([&counter]() { counter++; });
+  }
+  scheduler.waitIdle();
+  if (counter != 10000) {
+    std::cout << "    ✗ Fan-out FAILED (" << counter << "/10000)\n";
+    return 1;
+  }
+  std::cout << "    ✓ 10000 tasks executed\n\n";
+
+  // 2. Nested submission (tasks spawning tasks land on the local deque)
+  std::cout << "[2] Testing nested submission...\n";
+  std::atomic<int> leaves{0};
+  for (int i = 0; i < 64; ++i) {
+    scheduler.submit([&scheduler, &leaves]() {
+      for (int j = 0; j < 64; ++j) {
+        scheduler.submit([&leaves]() { leaves++; });
+      }
+    });
+  }
+  scheduler.waitIdle();
+  if (leaves != 64 * 64) {
+    std::cout << "    ✗ Nested submission FAILED (" << leaves << ")\n";
+    return 1;
+  }
+  std::cout << "    ✓ 4096 nested tasks executed\n\n";
+
+  // 3. Cancellation
+  std::cout << "[3] Testing cancellation...\n";
+  OSFTaskScheduler single(1);
+  std::atomic<bool> release{false};
+  std::atomic<int> ran{0};
+  single.submit([&release]() {
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  auto token = OSFCancellationToken::create();
+  single.submit([&ran]() { ran++; }, OSFTaskPriority::Normal, token);
+  token.cancel();
+  release = true;
+  single.waitIdle();
+  if (ran != 0) {
+    std::cout << "    ✗ Cancelled task ran\n";
+    return 1;
+  }
+  std::cout << "    ✓ Cancelled task was dropped\n\n";
+
+  // 4. Priorities (single worker, queued behind a blocker)
+  std::cout << "[4] Testing priorities...\n";
+  std::string order;
+  std::mutex orderMutex;
+  release = false;
+  single.submit([&release]() {
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  auto record = [&order, &orderMutex](char c) {
+    return [&order, &orderMutex, c]() {
+      std::lock_guard<std::mutex> lock(orderMutex);
+      order += c;
+    };
+  };
+  single.submit(record('L'), OSFTaskPriority::Low);
+  single.submit(record('N'), OSFTaskPriority::Normal);
+  single.submit(record('H'), OSFTaskPriority::High);
+  release = true;
+  single.waitIdle();
+  if (order != "HNL") {
+    std::cout << "    ✗ Priority order FAILED (" << order << ")\n";
+    return 1;
+  }
+  std::cout << "    ✓ Executed in priority order (" << order << ")\n\n";
+
+  // 5. Continuation on the run loop
+  std::cout << "[5] Testing main-thread continuation...\n";
+  auto &app = OSFApplication::shared();
+  const auto mainThread = std::this_thread::get_id();
+  bool continuedOnMain = false;
+  int result = 0;
+
+  app.setOnLaunch([&]() {
+    scheduler.submit(
+        []() { return 6 * 7; },
+        [&](int value) {
+          result = value;
+          continuedOnMain = (std::this_thread::get_id() == mainThread);
+          app.stop();
+        },
+        app.runLoop(), OSFTaskPriority::High);
+  });
+  app.run();
+
+  if (result != 42 || !continuedOnMain) {
+    std::cout << "    ✗ Continuation FAILED\n";
+    return 1;
+  }
+  std::cout << "    ✓ Result delivered on the run loop thread\n";
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║           TASK SCHEDULER VALIDATION: PASSED                 ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
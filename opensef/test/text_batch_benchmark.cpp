@@ -0,0 +1,399 @@
+/**
+ * text_batch_benchmark.cpp - VulkanTextRenderer Frame Batching Benchmark
+ *
+ * Renders the same frames of text offscreen twice: once with one
+ * drawText() per string, once queueing every string and flushing once per
+ * frame. Reports draw calls, atlas upload submissions and CPU time per
+ * frame, and checks that the batched path issues at most one upload
+ * submission and one draw per atlas page each frame.
+ *
+ * Needs a Vulkan device (lavapipe is fine) and a system font; without
+ * them the benchmark is skipped.
+ */
+
+#include <opensef/VulkanTextRenderer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace opensef;
+
+namespace {
+
+constexpr uint32_t kWidth = 1280;
+constexpr uint32_t kHeight = 720;
+constexpr int kFrames = 60;
+constexpr int kStringsPerFrame = 200;
+
+struct Offscreen {
+  VkInstance instance = VK_NULL_HANDLE;
+  VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+  VkDevice device = VK_NULL_HANDLE;
+  VkQueue queue = VK_NULL_HANDLE;
+  VkCommandPool commandPool = VK_NULL_HANDLE;
+  VkRenderPass renderPass = VK_NULL_HANDLE;
+  VkImage image = VK_NULL_HANDLE;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkImageView view = VK_NULL_HANDLE;
+  VkFramebuffer framebuffer = VK_NULL_HANDLE;
+  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+  VkFence fence = VK_NULL_HANDLE;
+};
+
+bool createOffscreen(Offscreen &vk) {
+  VkApplicationInfo appInfo{};
+  appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+  appInfo.pApplicationName = "text-batch-benchmark";
+  appInfo.apiVersion = VK_API_VERSION_1_0;
+
+  VkInstanceCreateInfo instanceInfo{};
+  instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+  instanceInfo.pApplicationInfo = &appInfo;
+  if (vkCreateInstance(&instanceInfo, nullptr, &vk.instance) != VK_SUCCESS)
+    return false;
+
+  uint32_t deviceCount = 0;
+  vkEnumeratePhysicalDevices(vk.instance, &deviceCount, nullptr);
+  if (deviceCount == 0)
+    return false;
+  std::vector<VkPhysicalDevice> devices(deviceCount);
+  vkEnumeratePhysicalDevices(vk.instance, &deviceCount, devices.data());
+
+  uint32_t queueFamily = UINT32_MAX;
+  for (VkPhysicalDevice candidate : devices) {
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount,
+                                             families.data());
+    for (uint32_t i = 0; i < familyCount; ++i) {
+      if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        vk.physicalDevice = candidate;
+        queueFamily = i;
+        break;
+      }
+    }
+    if (vk.physicalDevice)
+      break;
+  }
+  if (!vk.physicalDevice)
+    return false;
+
+  float priority = 1.0f;
+  VkDeviceQueueCreateInfo queueInfo{};
+  queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+  queueInfo.queueFamilyIndex = queueFamily;
+  queueInfo.queueCount = 1;
+  queueInfo.pQueuePriorities = &priority;
+
+  VkDeviceCreateInfo deviceInfo{};
+  deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  deviceInfo.queueCreateInfoCount = 1;
+  deviceInfo.pQueueCreateInfos = &queueInfo;
+  if (vkCreateDevice(vk.physicalDevice, &deviceInfo, nullptr, &vk.device) !=
+      VK_SUCCESS)
+    return false;
+  vkGetDeviceQueue(vk.device, queueFamily, 0, &vk.queue);
+
+  VkCommandPoolCreateInfo poolInfo{};
+  poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  poolInfo.queueFamilyIndex = queueFamily;
+  vkCreateCommandPool(vk.device, &poolInfo, nullptr, &vk.commandPool);
+
+  VkAttachmentDescription color{};
+  color.format = VK_FORMAT_R8G8B8A8_UNORM;
+  color.samples = VK_SAMPLE_COUNT_1_BIT;
+  color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  color.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+  VkSubpassDescription subpass{};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &colorRef;
+
+  VkRenderPassCreateInfo renderPassInfo{};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  renderPassInfo.attachmentCount = 1;
+  renderPassInfo.pAttachments = &color;
+  renderPassInfo.subpassCount = 1;
+  renderPassInfo.pSubpasses = &subpass;
+  if (vkCreateRenderPass(vk.device, &renderPassInfo, nullptr,
+                         &vk.renderPass) != VK_SUCCESS)
+    return false;
+
+  VkImageCreateInfo imageInfo{};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+  imageInfo.extent = {kWidth, kHeight, 1};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(vk.device, &imageInfo, nullptr, &vk.image) != VK_SUCCESS)
+    return false;
+
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(vk.device, vk.image, &requirements);
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(vk.physicalDevice, &memoryProperties);
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = requirements.size;
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+    if (requirements.memoryTypeBits & (1u << i)) {
+      allocInfo.memoryTypeIndex = i;
+      break;
+    }
+  }
+  if (vkAllocateMemory(vk.device, &allocInfo, nullptr, &vk.memory) !=
+      VK_SUCCESS)
+    return false;
+  vkBindImageMemory(vk.device, vk.image, vk.memory, 0);
+
+  VkImageViewCreateInfo viewInfo{};
+  viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewInfo.image = vk.image;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.levelCount = 1;
+  viewInfo.subresourceRange.layerCount = 1;
+  vkCreateImageView(vk.device, &viewInfo, nullptr, &vk.view);
+
+  VkFramebufferCreateInfo framebufferInfo{};
+  framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  framebufferInfo.renderPass = vk.renderPass;
+  framebufferInfo.attachmentCount = 1;
+  framebufferInfo.pAttachments = &vk.view;
+  framebufferInfo.width = kWidth;
+  framebufferInfo.height = kHeight;
+  framebufferInfo.layers = 1;
+  vkCreateFramebuffer(vk.device, &framebufferInfo, nullptr, &vk.framebuffer);
+
+  VkCommandBufferAllocateInfo commandInfo{};
+  commandInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  commandInfo.commandPool = vk.commandPool;
+  commandInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  commandInfo.commandBufferCount = 1;
+  vkAllocateCommandBuffers(vk.device, &commandInfo, &vk.commandBuffer);
+
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+  vkCreateFence(vk.device, &fenceInfo, nullptr, &vk.fence);
+  return true;
+}
+
+void destroyOffscreen(Offscreen &vk) {
+  if (vk.device) {
+    vkDeviceWaitIdle(vk.device);
+    vkDestroyFence(vk.device, vk.fence, nullptr);
+    vkDestroyFramebuffer(vk.device, vk.framebuffer, nullptr);
+    vkDestroyImageView(vk.device, vk.view, nullptr);
+    vkDestroyImage(vk.device, vk.image, nullptr);
+    vkFreeMemory(vk.device, vk.memory, nullptr);
+    vkDestroyRenderPass(vk.device, vk.renderPass, nullptr);
+    vkDestroyCommandPool(vk.device, vk.commandPool, nullptr);
+    vkDestroyDevice(vk.device, nullptr);
+  }
+  if (vk.instance)
+    vkDestroyInstance(vk.instance, nullptr);
+}
+
+// Append a code point as UTF-8
+void appendUtf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+// A UI-like frame: mostly cached ASCII labels, plus a few strings with
+// Latin, Greek and Cyrillic letters no earlier frame used
+std::vector<std::string> frameStrings(int frame) {
+  std::vector<std::string> strings;
+  for (int i = 0; i < kStringsPerFrame; ++i) {
+    std::string text = "Item " + std::to_string(i) + " - Settings";
+    if (i % 25 == 0) {
+      text += ' ';
+      for (int k = 0; k < 3; ++k)
+        appendUtf8(text, 0x100 + ((frame * 24 + i / 25 * 3 + k) % 0x380));
+    }
+    strings.push_back(text);
+  }
+  return strings;
+}
+
+struct Result {
+  double drawCalls = 0;
+  double submits = 0; // Atlas uploads plus the frame itself
+  double cpuMs = 0;
+  uint32_t maxBatchedSubmits = 0;
+  uint32_t maxDrawsPerFrame = 0;
+};
+
+Result run(Offscreen &vk, bool batched) {
+  VulkanTextRenderer &text = VulkanTextRenderer::shared();
+  text.initialize(vk.device, vk.physicalDevice, vk.queue, vk.commandPool,
+                  vk.renderPass);
+  text.setScreenSize(kWidth, kHeight);
+
+  Result result;
+  const glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+  for (int frame = 0; frame < kFrames; ++frame) {
+    std::vector<std::string> strings = frameStrings(frame);
+
+    // One frame in flight
+    vkWaitForFences(vk.device, 1, &vk.fence, VK_TRUE, UINT64_MAX);
+    vkResetFences(vk.device, 1, &vk.fence);
+
+    auto begin = std::chrono::steady_clock::now();
+    text.beginFrame();
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(vk.commandBuffer, &beginInfo);
+
+    VkClearValue clear{};
+    VkRenderPassBeginInfo passInfo{};
+    passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    passInfo.renderPass = vk.renderPass;
+    passInfo.framebuffer = vk.framebuffer;
+    passInfo.renderArea.extent = {kWidth, kHeight};
+    passInfo.clearValueCount = 1;
+    passInfo.pClearValues = &clear;
+    vkCmdBeginRenderPass(vk.commandBuffer, &passInfo,
+                         VK_SUBPASS_CONTENTS_INLINE);
+
+    for (int i = 0; i < kStringsPerFrame; ++i) {
+      float x = 10.0f + (i % 4) * 300.0f;
+      float y = 20.0f + (i / 4) * 14.0f;
+      if (batched)
+        text.queueText(strings[i], x, y, 1.0f, color);
+      else
+        text.drawText(vk.commandBuffer, strings[i], x, y, 1.0f, color);
+    }
+    if (batched)
+      text.flush(vk.commandBuffer);
+
+    vkCmdEndRenderPass(vk.commandBuffer);
+    vkEndCommandBuffer(vk.commandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &vk.commandBuffer;
+    vkQueueSubmit(vk.queue, 1, &submitInfo, vk.fence);
+    result.cpuMs += std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count();
+
+    const VulkanTextRenderer::FrameStats &stats = text.frameStats();
+    result.drawCalls += stats.drawCalls;
+    result.submits += stats.submits + 1;
+    result.maxBatchedSubmits = std::max(result.maxBatchedSubmits, stats.submits);
+    result.maxDrawsPerFrame = std::max(result.maxDrawsPerFrame, stats.drawCalls);
+  }
+  vkQueueWaitIdle(vk.queue);
+  text.shutdown();
+
+  result.drawCalls /= kFrames;
+  result.submits /= kFrames;
+  result.cpuMs /= kFrames;
+  return result;
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║     openSEF Text Batching Benchmark (VulkanTextRenderer)   ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  Offscreen vk;
+  if (!createOffscreen(vk)) {
+    std::cout << "No Vulkan device available; skipping\n";
+    destroyOffscreen(vk);
+    return 0;
+  }
+
+  // Probe for a font: without one nothing is drawn
+  {
+    VulkanTextRenderer &text = VulkanTextRenderer::shared();
+    text.initialize(vk.device, vk.physicalDevice, vk.queue, vk.commandPool,
+                    vk.renderPass);
+    bool hasFont = text.measureTextWidth("A", 1.0f) > 0.0f;
+    text.shutdown();
+    if (!hasFont) {
+      std::cout << "No usable font (set OSF_FONT_PATH); skipping\n";
+      destroyOffscreen(vk);
+      return 0;
+    }
+  }
+
+  std::cout << "[1] Immediate: drawText() per string (" << kStringsPerFrame
+            << " strings, " << kFrames << " frames)...\n";
+  Result immediate = run(vk, false);
+  std::cout << "    draw calls/frame: " << immediate.drawCalls
+            << "  submits/frame: " << immediate.submits
+            << "  cpu: " << immediate.cpuMs << " ms/frame\n\n";
+
+  std::cout << "[2] Batched: queueText() per string, one flush()...\n";
+  Result batched = run(vk, true);
+  std::cout << "    draw calls/frame: " << batched.drawCalls
+            << "  submits/frame: " << batched.submits
+            << "  cpu: " << batched.cpuMs << " ms/frame\n\n";
+
+  destroyOffscreen(vk);
+
+  std::cout << "[3] Checking batched submission...\n";
+  if (batched.maxBatchedSubmits > 1) {
+    std::cout << "    ✗ " << batched.maxBatchedSubmits
+              << " atlas uploads in one frame\n";
+    return 1;
+  }
+  if (batched.maxDrawsPerFrame > OSFGlyphAtlas::kDefaultMaxPages) {
+    std::cout << "    ✗ " << batched.maxDrawsPerFrame
+              << " draws in one frame, more than one per atlas page\n";
+    return 1;
+  }
+  if (batched.drawCalls >= immediate.drawCalls) {
+    std::cout << "    ✗ Batching did not reduce draw calls\n";
+    return 1;
+  }
+  std::cout << "    ✓ At most one upload and one draw per page per frame ("
+            << immediate.drawCalls / batched.drawCalls
+            << "x fewer draw calls)\n";
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║          TEXT BATCHING BENCHMARK: PASSED                    ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * text_layout_cache_validation.cpp - OSFTextLayoutCache Validation and
+ * Benchmark
+ *
+ * Checks that repeated text is shaped once per style, that eviction and
+ * invalidation drop layouts, that widgets measure through the cache, and
+ * compares per-frame cost of shaping every string against cache lookups.
+ */
+
+#include <opensef/OSFTextLayoutCache.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace opensef;
+
+namespace {
+
+// Strings a typical window redraws every frame
+std::vector<std::string> frameStrings() {
+  std::vector<std::string> strings;
+  for (int i = 0; i < 40; ++i) {
+    strings.push_back("Setting " + std::to_string(i) + " - Description");
+  }
+  return strings;
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║     openSEF Text Layout Cache Validation & Benchmark       ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  OSFTextLayoutCache cache;
+  OSFTextStyle style;
+
+  // 1. Same text and style shapes once
+  std::cout << "[1] Testing lookup reuse...\n";
+  auto first = cache.layout("Hello, Ares", style);
+  auto second = cache.layout("Hello, Ares", style);
+  if (!first || first != second || cache.misses() != 1 ||
+      cache.hits() != 1) {
+    std::cout << "    ✗ Expected one miss and one hit (" << cache.misses()
+              << "/" << cache.hits() << ")\n";
+    return 1;
+  }
+  if (first->width() <= 0 || first->height() <= 0) {
+    std::cout << "    ✗ Empty measurement\n";
+    return 1;
+  }
+  std::cout << "    ✓ One shaping, " << first->width() << "x"
+            << first->height() << "\n\n";
+
+  // 2. Every key field separates entries
+  std::cout << "[2] Testing key fields...\n";
+  OSFTextStyle variants[5] = {style, style, style, style, style};
+  variants[0].family = "sans-serif";
+  variants[1].size = 16.0;
+  variants[2].weight = FontWeight::Bold;
+  variants[3].width = 120.0;
+  variants[4].alignment = TextAlignment::Center;
+  for (const OSFTextStyle &variant : variants) {
+    if (cache.layout("Hello, Ares", variant) == first) {
+      std::cout << "    ✗ Style change returned the same layout\n";
+      return 1;
+    }
+  }
+  if (cache.size() != 6) {
+    std::cout << "    ✗ " << cache.size() << " entries, expected 6\n";
+    return 1;
+  }
+  std::cout << "    ✓ Family, size, weight, width and alignment are keyed\n\n";
+
+  // 3. Least recently used entries are evicted
+  std::cout << "[3] Testing LRU eviction...\n";
+  cache.clear();
+  cache.setCapacity(3);
+  auto kept = cache.layout("a", style);
+  cache.layout("b", style);
+  cache.layout("c", style);
+  cache.layout("a", style); // Refresh "a"
+  cache.layout("d", style); // Evicts "b"
+  uint64_t misses = cache.misses();
+  cache.layout("a", style);
+  cache.layout("c", style);
+  if (cache.misses() != misses || cache.size() != 3) {
+    std::cout << "    ✗ Recently used entries were evicted\n";
+    return 1;
+  }
+  cache.layout("b", style);
+  if (cache.misses() != misses + 1) {
+    std::cout << "    ✗ Least recently used entry was kept\n";
+    return 1;
+  }
+  std::cout << "    ✓ Capacity 3 keeps the three most recent\n\n";
+
+  // 4. Invalidation drops everything; held layouts stay usable
+  std::cout << "[4] Testing invalidation...\n";
+  cache.invalidate();
+  if (cache.size() != 0 || cache.layout("a", style) == kept ||
+      kept->width() <= 0) {
+    std::cout << "    ✗ Layouts survived invalidate()\n";
+    return 1;
+  }
+  std::cout << "    ✓ Reshaped after invalidate()\n\n";
+  cache.setCapacity(512);
+
+  // 5. Concurrent lookups agree
+  std::cout << "[5] Testing concurrent lookups...\n";
+  cache.clear();
+  const std::vector<std::string> strings = frameStrings();
+  std::atomic<bool> mismatch{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 50; ++round) {
+        for (const std::string &text : strings) {
+          auto layout = cache.layout(text, style);
+          if (!layout || layout != cache.layout(text, style))
+            mismatch = true;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  if (mismatch || cache.size() != strings.size()) {
+    std::cout << "    ✗ Threads saw different layouts\n";
+    return 1;
+  }
+  std::cout << "    ✓ 4 threads, " << cache.size() << " shared layouts\n\n";
+
+  // 6. Widgets measure through the shared cache
+  std::cout << "[6] Testing intrinsic content sizes...\n";
+  auto label = OSFLabel::create("Hello, Ares");
+  auto button = OSFButton::create("Hello, Ares");
+  OSFRect labelSize = label->intrinsicContentSize();
+  OSFRect buttonSize = button->intrinsicContentSize();
+  if (labelSize.width <= 0 || buttonSize.width <= labelSize.width ||
+      buttonSize.height <= labelSize.height) {
+    std::cout << "    ✗ Bad sizes: label " << labelSize.width << "x"
+              << labelSize.height << ", button " << buttonSize.width << "x"
+              << buttonSize.height << "\n";
+    return 1;
+  }
+  uint64_t sharedMisses = OSFTextLayoutCache::shared().misses();
+  label->intrinsicContentSize();
+  if (OSFTextLayoutCache::shared().misses() != sharedMisses) {
+    std::cout << "    ✗ Measuring again shaped again\n";
+    return 1;
+  }
+  std::cout << "    ✓ Label " << labelSize.width << "x" << labelSize.height
+            << ", button " << buttonSize.width << "x" << buttonSize.height
+            << "\n\n";
+
+  // 7. Benchmark: a frame's strings shaped from scratch vs. looked up
+  constexpr int kFrames = 200;
+  std::cout << "[7] Benchmarking " << kFrames << " frames of "
+            << strings.size() << " strings...\n";
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    cache.clear();
+    for (const std::string &text : strings)
+      cache.layout(text, style);
+  }
+  double shapedUs = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count() /
+                    kFrames;
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    for (const std::string &text : strings)
+      cache.layout(text, style);
+  }
+  double cachedUs = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count() /
+                    kFrames;
+
+  std::cout << "    shaped: " << shapedUs << " us/frame\n";
+  std::cout << "    cached: " << cachedUs << " us/frame\n";
+  std::cout << "    ✓ Speedup " << (shapedUs / cachedUs) << "x\n";
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║        TEXT LAYOUT CACHE VALIDATION: PASSED                 ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
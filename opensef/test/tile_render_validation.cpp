@@ -0,0 +1,232 @@
+/**
+ * tile_render_validation.cpp - OSFTileRenderer Validation and Benchmark
+ *
+ * Draws a large OSFView tree serially and in parallel tiles, checks that
+ * both buffers are byte-identical and that views are culled per tile,
+ * that a busy pool does not hold the caller up, then compares the two
+ * paths' frame times.
+ */
+
+#include <opensef/OSFTaskScheduler.h>
+#include <opensef/OSFTileRenderer.h>
+#include <opensef/OSFView.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace opensef;
+
+namespace {
+
+constexpr int kWidth = 1920;
+constexpr int kHeight = 1080;
+constexpr int kCell = 96;
+// How long the only worker is kept busy in [4]
+constexpr int kBusyMs = 2000;
+
+std::atomic<int> renders{0};
+
+class CardView : public OSFView {
+public:
+  explicit CardView(double hue) : hue_(hue) {}
+
+  void render(cairo_t *cr) override {
+    renders.fetch_add(1, std::memory_order_relaxed);
+    double w = frame_.width;
+    double h = frame_.height;
+
+    cairo_pattern_t *gradient = cairo_pattern_create_linear(0, 0, 0, h);
+    cairo_pattern_add_color_stop_rgba(gradient, 0, hue_, 0.5, 1 - hue_, 1);
+    cairo_pattern_add_color_stop_rgba(gradient, 1, 1 - hue_, hue_, 0.3, 0.8);
+    cairo_set_source(cr, gradient);
+    cairo_new_sub_path(cr);
+    cairo_arc(cr, w - 12, 12, 12, -M_PI / 2, 0);
+    cairo_arc(cr, w - 12, h - 12, 12, 0, M_PI / 2);
+    cairo_arc(cr, 12, h - 12, 12, M_PI / 2, M_PI);
+    cairo_arc(cr, 12, 12, 12, M_PI, 3 * M_PI / 2);
+    cairo_close_path(cr);
+    cairo_fill(cr);
+    cairo_pattern_destroy(gradient);
+
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.6);
+    cairo_set_line_width(cr, 1.5);
+    cairo_arc(cr, w / 2, h / 2, w / 3, 0, 2 * M_PI);
+    cairo_stroke(cr);
+
+    OSFView::render(cr);
+  }
+
+private:
+  double hue_;
+};
+
+std::shared_ptr<OSFView> buildTree() {
+  auto root = std::make_shared<OSFView>();
+  root->setFrame(OSFRect(0, 0, kWidth, kHeight));
+  for (int y = 0; y + kCell <= kHeight; y += kCell) {
+    for (int x = 0; x + kCell <= kWidth; x += kCell) {
+      // Offset by a fraction so edges straddle tile boundaries
+      auto card = std::make_shared<CardView>((x + y) % 7 / 7.0);
+      card->setFrame(OSFRect(x + 3.5, y + 2.25, kCell - 6, kCell - 6));
+      root->addSubview(card);
+    }
+  }
+  return root;
+}
+
+void drawFrame(cairo_t *cr, OSFView &root) {
+  cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_rgba(cr, 0, 0, 0, 0);
+  cairo_paint(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+  cairo_set_source_rgb(cr, 0.96, 0.96, 0.96);
+  cairo_paint(cr);
+  root.render(cr);
+}
+
+cairo_surface_t *newTarget() {
+  return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, kWidth, kHeight);
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║       openSEF Tile Renderer Validation & Benchmark         ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  auto root = buildTree();
+  const int cards = static_cast<int>(root->subviews().size());
+  auto draw = [&root](cairo_t *cr) { drawFrame(cr, *root); };
+
+  // 1. Identical output
+  std::cout << "[1] Testing serial vs. tiled output (" << cards
+            << " views, " << OSFTaskScheduler::shared().threadCount()
+            << " workers)...\n";
+  cairo_surface_t *serial = newTarget();
+  {
+    cairo_t *cr = cairo_create(serial);
+    draw(cr);
+    cairo_destroy(cr);
+  }
+  cairo_surface_flush(serial);
+
+  cairo_surface_t *tiled = newTarget();
+  OSFTileRenderer renderer(256);
+  renders = 0;
+  renderer.render(tiled, OSFRect(0, 0, kWidth, kHeight), draw);
+  cairo_surface_flush(tiled);
+
+  const int stride = cairo_image_surface_get_stride(serial);
+  if (renderer.lastTileCount() < 2 ||
+      std::memcmp(cairo_image_surface_get_data(serial),
+                  cairo_image_surface_get_data(tiled),
+                  static_cast<size_t>(stride) * kHeight) != 0) {
+    std::cout << "    ✗ Buffers differ (tiles=" << renderer.lastTileCount()
+              << ")\n";
+    return 1;
+  }
+  std::cout << "    ✓ " << renderer.lastTileCount()
+            << " tiles, byte-identical to serial\n\n";
+
+  // 2. Per-tile culling: every card touches at most four tiles
+  std::cout << "[2] Testing per-tile culling...\n";
+  int tiledRenders = renders.load();
+  if (tiledRenders < cards || tiledRenders > 4 * cards) {
+    std::cout << "    ✗ " << tiledRenders << " card renders for " << cards
+              << " cards\n";
+    return 1;
+  }
+  std::cout << "    ✓ " << tiledRenders << " card renders across "
+            << renderer.lastTileCount() << " tiles (no culling: "
+            << cards * renderer.lastTileCount() << ")\n\n";
+
+  // 3. Partial area stays serial-identical too
+  std::cout << "[3] Testing damaged sub-area...\n";
+  OSFRect damage(300, 200, 900, 600);
+  renderer.render(tiled, damage, draw);
+  cairo_surface_flush(tiled);
+  if (std::memcmp(cairo_image_surface_get_data(serial),
+                  cairo_image_surface_get_data(tiled),
+                  static_cast<size_t>(stride) * kHeight) != 0) {
+    std::cout << "    ✗ Sub-area redraw changed the buffer\n";
+    return 1;
+  }
+  std::cout << "    ✓ Redrawing " << renderer.lastTileCount()
+            << " damaged tiles left the frame unchanged\n\n";
+
+  // 4. A busy pool: the caller draws the tiles no worker picked up
+  std::cout << "[4] Testing with every worker busy...\n";
+  {
+    OSFTaskScheduler busy(1);
+    busy.submit([] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kBusyMs));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    OSFTileRenderer blocked(256);
+    blocked.setScheduler(&busy);
+    auto begin = std::chrono::steady_clock::now();
+    blocked.render(tiled, OSFRect(0, 0, kWidth, kHeight), draw);
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+    cairo_surface_flush(tiled);
+    if (ms >= kBusyMs / 2 ||
+        std::memcmp(cairo_image_surface_get_data(serial),
+                    cairo_image_surface_get_data(tiled),
+                    static_cast<size_t>(stride) * kHeight) != 0) {
+      std::cout << "    ✗ Waited " << ms << " ms for the busy worker\n";
+      return 1;
+    }
+    std::cout << "    ✓ Drawn by the caller in " << ms << " ms\n\n";
+    busy.waitIdle();
+  }
+
+  // 5. Benchmark
+  constexpr int kFrames = 20;
+  std::cout << "[5] Benchmarking " << kWidth << "x" << kHeight << " frames...\n";
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    cairo_t *cr = cairo_create(serial);
+    draw(cr);
+    cairo_destroy(cr);
+  }
+  double serialMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count() /
+                    kFrames;
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kFrames; ++i) {
+    renderer.render(tiled, OSFRect(0, 0, kWidth, kHeight), draw);
+  }
+  double tiledMs = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count() /
+                   kFrames;
+
+  std::cout << "    serial: " << serialMs << " ms/frame\n";
+  std::cout << "    tiled:  " << tiledMs << " ms/frame\n";
+  std::cout << "    ✓ Speedup " << (serialMs / tiledMs) << "x\n";
+
+  cairo_surface_destroy(serial);
+  cairo_surface_destroy(tiled);
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║           TILE RENDERER VALIDATION: PASSED                  ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * tiling_layout_validation.cpp - Tiling Layout Tree Validation and
+ * Benchmark
+ *
+ * Checks master/stack, dwindle and columns geometry, that each operation
+ * reports only the windows it moved, and that random incremental changes
+ * over hundreds of windows end in the same state a full recompute gives.
+ * Compares incremental updates with recomputing the whole tree per change.
+ */
+
+#include "layout.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+const osf_layout_config kConfig = {10, 15, 0.6f, 1};
+const osf_layout_rect kArea = {0, 0, 2560, 1440};
+
+// Window handles are just indices
+void *windowId(size_t i) { return reinterpret_cast<void *>(i + 1); }
+
+bool overlaps(const osf_layout_rect &a, const osf_layout_rect &b) {
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+         b.y < a.y + a.height;
+}
+
+// Tiles lie inside the usable area and don't overlap
+bool tilesValid(const std::vector<osf_layout_node *> &leaves) {
+  const int og = kConfig.outer_gap;
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    const osf_layout_rect &r = leaves[i]->rect;
+    if (r.x < og || r.y < og || r.x + r.width > kArea.width - og ||
+        r.y + r.height > kArea.height - og)
+      return false;
+    for (size_t j = i + 1; j < leaves.size(); ++j) {
+      if (overlaps(r, leaves[j]->rect))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool sameRect(const osf_layout_rect &a, const osf_layout_rect &b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height;
+}
+
+// Random inserts, removals and focus changes. A shadow copy built only
+// from the reported deltas must match every tile, and a full recompute
+// must find nothing left to change
+bool randomOps(osf_layout_kind kind, size_t target, int ops, uint32_t seed) {
+  osf_layout *layout = osf_layout_create(kind, &kConfig, kArea);
+  std::mt19937 rng(seed);
+  std::vector<osf_layout_node *> leaves;
+  std::map<void *, osf_layout_rect> shadow;
+  size_t next = 0;
+
+  auto applyDeltas = [&] {
+    for (size_t i = 0; i < layout->delta_count; ++i)
+      shadow[layout->deltas[i].window] = layout->deltas[i].rect;
+  };
+
+  for (int op = 0; op < ops; ++op) {
+    const uint32_t roll = rng() % 10;
+    if (leaves.empty() || (roll < 5 && leaves.size() < target) ||
+        leaves.size() < target / 2) {
+      leaves.push_back(osf_layout_insert(layout, windowId(next++)));
+    } else if (roll < 8) {
+      const size_t index = rng() % leaves.size();
+      shadow.erase(leaves[index]->window);
+      osf_layout_remove(layout, leaves[index]);
+      leaves.erase(leaves.begin() + index);
+    } else {
+      osf_layout_focus(layout, leaves[rng() % leaves.size()]);
+    }
+    applyDeltas();
+    if (op % 97 == 0) {
+      osf_layout_set_kind(layout, static_cast<osf_layout_kind>(
+                                      rng() % OSF_LAYOUT_KIND_COUNT));
+      applyDeltas();
+      osf_layout_set_kind(layout, kind);
+      applyDeltas();
+    }
+  }
+
+  bool ok = layout->window_count == leaves.size() &&
+            shadow.size() == leaves.size();
+  for (osf_layout_node *leaf : leaves)
+    ok = ok && sameRect(shadow[leaf->window], leaf->rect);
+  osf_layout_arrange(layout);
+  ok = ok && layout->delta_count == 0 && tilesValid(leaves);
+
+  osf_layout_destroy(layout);
+  return ok;
+}
+
+double microsecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main() {
+  std::cout
+      << "╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║     openSEF Tiling Layout Validation & Benchmark           ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+  // 1. Master/stack geometry and minimal deltas
+  std::cout << "[1] Testing master/stack...\n";
+  {
+    osf_layout *layout =
+        osf_layout_create(OSF_LAYOUT_MASTER_STACK, &kConfig, kArea);
+    osf_layout_node *master = osf_layout_insert(layout, windowId(0));
+    const osf_layout_rect full = master->rect;
+    if (layout->delta_count != 1 || full.x != 15 || full.width != 2530 ||
+        full.height != 1410) {
+      std::cout << "    ✗ Single window is " << full.width << "x"
+                << full.height << "\n";
+      return 1;
+    }
+    osf_layout_node *second = osf_layout_insert(layout, windowId(1));
+    // Master narrows to 60% of the width left after the gap
+    if (layout->delta_count != 2 || master->rect.width != 1512 ||
+        second->rect.x != 15 + 1512 + 10) {
+      std::cout << "    ✗ Master " << master->rect.width << " wide\n";
+      return 1;
+    }
+    osf_layout_insert(layout, windowId(2));
+    // Only the stack re-splits
+    if (layout->delta_count != 2 || second->rect.height != 700) {
+      std::cout << "    ✗ " << layout->delta_count
+                << " deltas for a stack insert\n";
+      return 1;
+    }
+    // Removing the master promotes the first stacked window
+    osf_layout_remove(layout, master);
+    if (second->rect.x != 15 || second->rect.width != 1512 ||
+        second->rect.height != 1410) {
+      std::cout << "    ✗ Stack not promoted\n";
+      return 1;
+    }
+    osf_layout_destroy(layout);
+  }
+  std::cout << "    ✓ Geometry, promotion, stack-only deltas\n\n";
+
+  // 2. Dwindle: inserts and removals touch one subtree
+  std::cout << "[2] Testing dwindle...\n";
+  {
+    osf_layout *layout = osf_layout_create(OSF_LAYOUT_DWINDLE, &kConfig, kArea);
+    std::vector<osf_layout_node *> leaves;
+    for (size_t i = 0; i < 8; ++i) {
+      leaves.push_back(osf_layout_insert(layout, windowId(i)));
+      if (i > 0 && layout->delta_count != 2) {
+        std::cout << "    ✗ Insert " << i << " moved "
+                  << layout->delta_count << " windows\n";
+        return 1;
+      }
+      osf_layout_focus(layout, leaves.back());
+    }
+    // The first split is side by side, the next stacked
+    if (leaves[1]->rect.x <= leaves[0]->rect.x ||
+        leaves[2]->rect.y <= leaves[1]->rect.y) {
+      std::cout << "    ✗ Splits don't alternate\n";
+      return 1;
+    }
+    // Removing the first window hands its half to the rest of the spiral
+    const uint64_t before = layout->nodes_arranged;
+    osf_layout_remove(layout, leaves[0]);
+    leaves.erase(leaves.begin());
+    if (layout->delta_count != 7 || !tilesValid(leaves)) {
+      std::cout << "    ✗ " << layout->delta_count << " deltas on removal\n";
+      return 1;
+    }
+    // The newest window's removal only grows its sibling
+    osf_layout_remove(layout, leaves.back());
+    leaves.pop_back();
+    if (layout->delta_count != 1) {
+      std::cout << "    ✗ " << layout->delta_count
+                << " deltas removing a leaf\n";
+      return 1;
+    }
+    std::cout << "    ✓ 2 deltas per insert, "
+              << (layout->nodes_arranged - before)
+              << " nodes arranged for 2 removals\n\n";
+    osf_layout_destroy(layout);
+  }
+
+  // 3. Columns
+  std::cout << "[3] Testing columns...\n";
+  {
+    osf_layout *layout = osf_layout_create(OSF_LAYOUT_COLUMNS, &kConfig, kArea);
+    std::vector<osf_layout_node *> leaves;
+    for (size_t i = 0; i < 4; ++i)
+      leaves.push_back(osf_layout_insert(layout, windowId(i)));
+    // (2530 - 3 * 10) / 4 = 625
+    for (size_t i = 0; i < leaves.size(); ++i) {
+      if (leaves[i]->rect.width != 625 ||
+          leaves[i]->rect.x != static_cast<int>(15 + i * 635)) {
+        std::cout << "    ✗ Column " << i << " at " << leaves[i]->rect.x
+                  << "\n";
+        return 1;
+      }
+    }
+    // Switching kind keeps the windows, reporting only what moved
+    osf_layout_set_kind(layout, OSF_LAYOUT_MASTER_STACK);
+    if (layout->window_count != 4 || layout->delta_count != 4 ||
+        !tilesValid(leaves)) {
+      std::cout << "    ✗ Kind switch\n";
+      return 1;
+    }
+    osf_layout_set_kind(layout, OSF_LAYOUT_MASTER_STACK);
+    if (layout->delta_count != 0) {
+      std::cout << "    ✗ No-op kind switch reported changes\n";
+      return 1;
+    }
+    osf_layout_destroy(layout);
+  }
+  std::cout << "    ✓ Equal columns, kind switch\n\n";
+
+  // 4. Random operations with hundreds of windows
+  std::cout << "[4] Testing random operations (300 windows)...\n";
+  for (int k = 0; k < OSF_LAYOUT_KIND_COUNT; ++k) {
+    const osf_layout_kind kind = static_cast<osf_layout_kind>(k);
+    if (!randomOps(kind, 300, 3000, 42 + k)) {
+      std::cout << "    ✗ " << osf_layout_kind_name(kind)
+                << " diverged from a full recompute\n";
+      return 1;
+    }
+    std::cout << "    ✓ " << osf_layout_kind_name(kind)
+              << ": deltas and tree match a full recompute\n";
+  }
+  std::cout << "\n";
+
+  // 5. Benchmark: incremental vs. full recompute per change
+  constexpr size_t kWindows = 500;
+  std::cout << "[5] Benchmarking " << kWindows
+            << " inserts + removals per layout...\n";
+  for (int k = 0; k < OSF_LAYOUT_KIND_COUNT; ++k) {
+    const osf_layout_kind kind = static_cast<osf_layout_kind>(k);
+    double us[2];
+    double nodes[2];
+    for (int full = 0; full < 2; ++full) {
+      osf_layout *layout = osf_layout_create(kind, &kConfig, kArea);
+      std::vector<osf_layout_node *> leaves;
+      auto begin = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < kWindows; ++i) {
+        leaves.push_back(osf_layout_insert(layout, windowId(i)));
+        osf_layout_focus(layout, leaves.back());
+        if (full)
+          osf_layout_arrange(layout);
+      }
+      for (size_t i = kWindows; i-- > 0;) {
+        osf_layout_remove(layout, leaves[i]);
+        if (full)
+          osf_layout_arrange(layout);
+      }
+      us[full] = microsecondsSince(begin) / (kWindows * 2);
+      nodes[full] =
+          static_cast<double>(layout->nodes_arranged) / (kWindows * 2);
+      osf_layout_destroy(layout);
+    }
+    std::cout << "    " << osf_layout_kind_name(kind) << ": incremental "
+              << us[0] << " us/op (" << nodes[0] << " nodes), full " << us[1]
+              << " us/op (" << nodes[1] << " nodes)\n";
+  }
+  std::cout << "    ✓ Done\n";
+
+  std::cout
+      << "\n╔════════════════════════════════════════════════════════════╗\n";
+  std::cout
+      << "║         TILING LAYOUT VALIDATION: PASSED                    ║\n";
+  std::cout
+      << "╚════════════════════════════════════════════════════════════╝\n";
+
+  return 0;
+}